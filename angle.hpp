@@ -21,6 +21,8 @@
 
 #include "euclib_math.hpp"
 
+namespace euclib {
+
 class angle {
 // Variables
 private:
@@ -33,7 +35,6 @@ public:
 
 	angle( ) : m_radians( 0 ) { }
 	angle( double radians ) : m_radians( radians ) { clamp( ); }
-	angle( double degrees ) : m_degrees( degrees*EUCLIB_PI_180 ) { clamp( ); }
 
 
 // Methods
@@ -42,11 +43,15 @@ public:
 	double radians( ) const { return m_radians; }
 	double degrees( ) const { return m_radians * EUCLIB_180_PI; }
 
+	static angle from_degrees( double degrees ) {
+		return angle( degrees * EUCLIB_PI_180 );
+	}
+
 	void set( double radians ) {
 		m_radians = radians;
 		clamp( );
 	}
-	void set( double degrees ) {
+	void set_degrees( double degrees ) {
 		m_radians = degrees * EUCLIB_PI_180;
 		clamp( );
 	}
@@ -55,7 +60,7 @@ public:
 		m_radians += radians;
 		clamp( );
 	}
-	void add( double degrees ) {
+	void add_degrees( double degrees ) {
 		m_radians += degrees * EUCLIB_PI_180;
 		clamp( );
 	}
@@ -70,11 +75,11 @@ private:
 
 	// clamp value to be from 0 to 2pi
 	void clamp( ) {
-		while( less_than( m_radians, 0 ) ) {
-			m_radians += EUCLIB_2_PI;
+		while( less_than( m_radians, 0.0 ) ) {
+			m_radians += 2 * EUCLIB_PI;
 		}
-		while( greater_equal( m_radians, EUCLIB_2_PI ) ) {
-			m_radians -= EUCLIB_2_PI;
+		while( greater_than_eq( m_radians, 2 * EUCLIB_PI ) ) {
+			m_radians -= 2 * EUCLIB_PI;
 		}
 	}
 
@@ -0,0 +1,885 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_BOOLEAN_HPP
+#define EUBLIB_BOOLEAN_HPP
+
+#include <vector>
+#include <deque>
+#include <set>
+#include <map>
+#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "euclib_math.hpp"
+#include "point.hpp"
+#include "euclib_parallel.hpp"
+
+/*
+ * Boolean operations on general polygons
+ *
+ *   A polygon here is a set of rings, std::vector<std::vector<point2<T>>>,
+ *   each ring listed once without repeating its first point. Rings may
+ *   be in any orientation and may cross. By default a point is inside
+ *   when it is inside an odd number of rings, so holes are just rings
+ *   inside others; fill_nonzero and fill_positive count windings
+ *   instead. Edges may overlap, within one polygon as well as between
+ *   the two.
+ *
+ *   combine( ) sweeps a vertical line over the edges of both polygons,
+ *   splitting edges where they cross or where a vertex lies on another
+ *   edge, and deciding from the edge below whether each piece bounds the
+ *   result. Runs in O((n+k) log n) for n edges and k crossings. Rings
+ *   are traced taking the sharpest turn at points where they meet, and
+ *   split there, so none visits a point twice. The rings written back
+ *   are each exterior ring counter-clockwise followed by its holes
+ *   clockwise.
+ *
+ * References
+ *   [1] F. Martinez, A.J. Rueda, F.R. Feito. "A new algorithm for
+ *         computing Boolean operations on polygons". Computers &
+ *         Geosciences, vol. 35, no. 6, pp. 1177-1185, 2009.
+ *   [2] F. Martinez, C. Ogayar, J.R. Jimenez, A.J. Rueda. "A simple
+ *         algorithm for Boolean operations on polygons". Advances in
+ *         Engineering Software, vol. 64, pp. 11-19, 2013.
+ */
+
+namespace euclib {
+
+	enum boolean_op {
+		op_intersection,
+		op_union,
+		op_difference,  // first minus second
+		op_xor
+	};
+
+	// which points a set of rings covers, by their winding number
+	enum fill_rule {
+		fill_even_odd,  // odd
+		fill_nonzero,   // not zero
+		fill_positive   // above zero, inside counter-clockwise rings
+	};
+
+	namespace detail {
+
+		// the sweep works in double precision whatever T is
+		class martinez {
+		// Typedefs
+		public:
+
+			typedef point2<double>               point_t;
+			typedef std::vector<point_t>         ring_t;
+			typedef std::vector<ring_t>          rings_t;
+
+		private:
+
+			struct sweep_event;
+
+			struct segment_less {
+				bool operator () ( const sweep_event* e1, const sweep_event* e2 ) const {
+					return compare_segments( e1, e2 ) < 0;
+				}
+			};
+
+			typedef std::set<sweep_event*, segment_less> status_t;
+
+			struct sweep_event {
+				point_t        point;
+				bool           left;
+				sweep_event*   other;
+				bool           subject;
+				int            wind;          // +1 when its ring runs left to right, else -1
+				int            winding[2];    // of the subject and the clip just below the edge
+				bool           below_in;      // is the result below the lowest edge equal to this one
+				sweep_event*   lowest_equal;  // the lowest edge equal to this one, maybe itself
+				sweep_event*   prev_in_result;
+				int            result_transition;
+				int            contour_id;
+				int            output_contour;
+				unsigned int   other_pos;
+				bool           in_status;
+				status_t::iterator  position;  // in the status, while in_status
+
+				bool in_result( ) const { return result_transition != 0; }
+				bool vertical( ) const { return point.x == other->point.x; }
+
+				bool below( const point_t& pt ) const {
+					return left ? signed_area( point, other->point, pt ) > 0.0
+					            : signed_area( other->point, point, pt ) > 0.0;
+				}
+			};
+
+			struct event_later {
+				bool operator () ( const sweep_event* e1, const sweep_event* e2 ) const {
+					return compare_events( e1, e2 ) > 0;
+				}
+			};
+
+			typedef std::priority_queue<sweep_event*, std::vector<sweep_event*>, event_later> queue_t;
+
+			struct contour {
+				ring_t            points;
+				std::vector<int>  holes;
+				int               hole_of;
+				int               depth;
+				bool              pinched;  // passes a point where more than two result edges meet
+			};
+
+
+		// Constructors
+		public:
+
+			martinez( ) { }
+
+		private:
+
+			martinez( const martinez& );
+			martinez& operator = ( const martinez& );
+
+
+		// Methods
+		public:
+
+			void run( const rings_t& subject, const rings_t& clip, boolean_op op, rings_t& result,
+			          fill_rule fill = fill_even_odd ) {
+				result.clear( );
+				m_op = op;
+				m_fill = fill;
+				m_events.clear( );
+				m_queue = queue_t( );
+				m_status.clear( );
+				m_sorted.clear( );
+
+				double sbox[4], cbox[4];
+				bounds( subject, sbox );
+				bounds( clip, cbox );
+				// one side empty or the bounding boxes disjoint, so nothing crosses
+				const bool apart = empty( subject ) || empty( clip ) ||
+				                   sbox[0] > cbox[2] || cbox[0] > sbox[2] || sbox[1] > cbox[3] || cbox[1] > sbox[3];
+				if( apart && op == op_intersection ) { return; }
+
+				// the rings still go through the sweep to come out normalized,
+				//   leaving out the clip when it cannot touch the result
+				int contour_id = 0;
+				for( unsigned int r = 0; r < subject.size( ); ++r ) { add_ring( subject[r], true, contour_id++ ); }
+				if( !apart || op != op_difference ) {
+					for( unsigned int r = 0; r < clip.size( ); ++r ) { add_ring( clip[r], false, contour_id++ ); }
+				}
+
+				subdivide( op, std::min( sbox[2], cbox[2] ), sbox[2] );
+				connect( result );
+			}
+
+		private:
+
+			static double signed_area( const point_t& p0, const point_t& p1, const point_t& p2 ) {
+				return ( p0.x - p2.x ) * ( p1.y - p2.y ) - ( p1.x - p2.x ) * ( p0.y - p2.y );
+			}
+
+			// sweep order: left to right, bottom to top, right ends first,
+			//   lower edges first
+			static int compare_events( const sweep_event* e1, const sweep_event* e2 ) {
+				const point_t& p1 = e1->point;
+				const point_t& p2 = e2->point;
+				if( p1.x != p2.x ) { return p1.x > p2.x ? 1 : -1; }
+				if( p1.y != p2.y ) { return p1.y > p2.y ? 1 : -1; }
+				if( e1->left != e2->left ) { return e1->left ? 1 : -1; }
+				if( signed_area( p1, e1->other->point, e2->other->point ) != 0.0 ) {
+					return !e1->below( e2->other->point ) ? 1 : -1;
+				}
+				if( e1->subject != e2->subject ) { return e1->subject ? -1 : 1; }
+				if( e1->contour_id != e2->contour_id ) { return e1->contour_id > e2->contour_id ? 1 : -1; }
+				return e1 == e2 ? 0 : ( e1 > e2 ? 1 : -1 );
+			}
+
+			// vertical order of two edges in the sweep line
+			static int compare_segments( const sweep_event* le1, const sweep_event* le2 ) {
+				if( le1 == le2 ) { return 0; }
+
+				if( signed_area( le1->point, le1->other->point, le2->point ) != 0.0 ||
+				    signed_area( le1->point, le1->other->point, le2->other->point ) != 0.0 ) {
+					// shared left end, the right ends decide
+					if( le1->point == le2->point ) { return le1->below( le2->other->point ) ? -1 : 1; }
+					if( le1->point.x == le2->point.x ) { return le1->point.y < le2->point.y ? -1 : 1; }
+					// compare at the left end of the later edge, or at its
+					//   right end when the left end lies on the other edge
+					if( compare_events( le1, le2 ) == 1 ) {
+						const point_t& pt = signed_area( le2->point, le2->other->point, le1->point ) != 0.0
+						                    ? le1->point : le1->other->point;
+						return !le2->below( pt ) ? -1 : 1;
+					}
+					const point_t& pt = signed_area( le1->point, le1->other->point, le2->point ) != 0.0
+					                    ? le2->point : le2->other->point;
+					return le1->below( pt ) ? -1 : 1;
+				}
+
+				// collinear
+				if( le1->subject == le2->subject ) {
+					if( le1->point == le2->point ) {
+						if( le1->contour_id != le2->contour_id ) { return le1->contour_id > le2->contour_id ? 1 : -1; }
+						return le1 > le2 ? 1 : -1;
+					}
+				}
+				else {
+					return le1->subject ? -1 : 1;
+				}
+				return compare_events( le1, le2 ) == 1 ? 1 : -1;
+			}
+
+			static bool empty( const rings_t& rings ) {
+				for( unsigned int r = 0; r < rings.size( ); ++r ) {
+					if( rings[r].size( ) >= 3 ) { return false; }
+				}
+				return true;
+			}
+
+			static void bounds( const rings_t& rings, double box[4] ) {
+				box[0] = box[1] = std::numeric_limits<double>::max( );
+				box[2] = box[3] = -std::numeric_limits<double>::max( );
+				for( unsigned int r = 0; r < rings.size( ); ++r ) {
+					for( unsigned int i = 0; i < rings[r].size( ); ++i ) {
+						box[0] = std::min( box[0], rings[r][i].x );
+						box[1] = std::min( box[1], rings[r][i].y );
+						box[2] = std::max( box[2], rings[r][i].x );
+						box[3] = std::max( box[3], rings[r][i].y );
+					}
+				}
+			}
+
+			sweep_event* make_event( const point_t& pt, bool left, sweep_event* other, bool subject ) {
+				sweep_event e;
+				e.point = pt;
+				e.left = left;
+				e.other = other;
+				e.subject = subject;
+				e.wind = 1;
+				e.winding[0] = e.winding[1] = 0;
+				e.below_in = false;
+				e.lowest_equal = 0;
+				e.prev_in_result = 0;
+				e.result_transition = 0;
+				e.contour_id = 0;
+				e.output_contour = -1;
+				e.other_pos = 0;
+				e.in_status = false;
+				m_events.push_back( e );
+				return &m_events.back( );
+			}
+
+			void add_ring( const ring_t& ring, bool subject, int contour_id ) {
+				if( ring.size( ) < 3 ) { return; }
+				for( unsigned int i = 0; i < ring.size( ); ++i ) {
+					const point_t& s1 = ring[i];
+					const point_t& s2 = ring[i + 1 == ring.size( ) ? 0 : i + 1];
+					if( s1 == s2 ) { continue; }
+					sweep_event* e1 = make_event( s1, false, 0, subject );
+					sweep_event* e2 = make_event( s2, false, e1, subject );
+					e1->other = e2;
+					e1->contour_id = e2->contour_id = contour_id;
+					if( compare_events( e1, e2 ) > 0 ) { e2->left = true; }
+					else { e1->left = true; }
+					e1->wind = e2->wind = e1->left ? 1 : -1;
+					m_queue.push( e1 );
+					m_queue.push( e2 );
+				}
+			}
+
+			bool filled( int winding ) const {
+				switch( m_fill ) {
+					case fill_even_odd: return ( winding & 1 ) != 0;
+					case fill_nonzero:  return winding != 0;
+					case fill_positive: return winding > 0;
+				}
+				return false;
+			}
+
+			bool is_in( const int winding[2] ) const {
+				const bool subject_in = filled( winding[0] ), clip_in = filled( winding[1] );
+				switch( m_op ) {
+					case op_intersection: return subject_in && clip_in;
+					case op_union:        return subject_in || clip_in;
+					case op_difference:   return subject_in && !clip_in;
+					case op_xor:          return subject_in != clip_in;
+				}
+				return false;
+			}
+
+			static bool equal_edges( const sweep_event* e1, const sweep_event* e2 ) {
+				return e1->point == e2->point && e1->other->point == e2->other->point;
+			}
+
+			// An edge bounds the result when the result differs either side
+			//   of it. Equal edges, of either polygon, are crossed together
+			//   so only the top one of them can: the result below the
+			//   lowest is carried up to compare with the result above.
+			void compute_fields( sweep_event* e, sweep_event* prev ) {
+				e->prev_in_result = 0;
+				const bool equal = prev != 0 && equal_edges( e, prev );
+				e->lowest_equal = equal ? prev->lowest_equal : e;
+				if( prev == 0 ) {
+					e->winding[0] = e->winding[1] = 0;
+				}
+				else if( prev->vertical( ) && prev->point != e->point ) {
+					// an edge starting part way up a vertical one has the
+					//   region right of it, below the lowest of any equal
+					//   vertical edges in sweep order, beneath
+					e->winding[0] = prev->lowest_equal->winding[0];
+					e->winding[1] = prev->lowest_equal->winding[1];
+				}
+				else {
+					e->winding[0] = prev->winding[0];
+					e->winding[1] = prev->winding[1];
+					e->winding[prev->subject ? 0 : 1] += prev->wind;
+				}
+
+				if( equal ) { prev->result_transition = 0; }
+				if( prev != 0 ) {
+					e->prev_in_result = ( !prev->in_result( ) || prev->vertical( ) )
+					                    ? prev->prev_in_result : prev;
+				}
+				e->below_in = equal ? prev->below_in : is_in( e->winding );
+				int above[2] = { e->winding[0], e->winding[1] };
+				above[e->subject ? 0 : 1] += e->wind;
+				const bool above_in = is_in( above );
+				e->result_transition = above_in == e->below_in ? 0 : ( above_in ? 1 : -1 );
+			}
+
+			// 0, 1 or 2 intersection points of the two segments
+			static int intersect( const point_t& a1, const point_t& a2, const point_t& b1,
+			                      const point_t& b2, point_t& i0, point_t& i1 ) {
+				double vax = a2.x - a1.x, vay = a2.y - a1.y;
+				double vbx = b2.x - b1.x, vby = b2.y - b1.y;
+				double ex = b1.x - a1.x, ey = b1.y - a1.y;
+				double kross = vax * vby - vay * vbx;
+				if( kross * kross > 0.0 ) {
+					// split points are rounded, so an edge ending on another
+					//   may miss it by a few ulps either way
+					const double eps = 1e-9;
+					double s = ( ex * vby - ey * vbx ) / kross;
+					if( s < -eps || s > 1.0 + eps ) { return 0; }
+					double t = ( ex * vay - ey * vax ) / kross;
+					if( t < -eps || t > 1.0 + eps ) { return 0; }
+					s = std::min( std::max( s, 0.0 ), 1.0 );
+					i0 = point_t( a1.x + s * vax, a1.y + s * vay );
+					// and must not leave a sliver next to an end point
+					double tol = eps * ( std::fabs( vax ) + std::fabs( vay ) + std::fabs( vbx ) + std::fabs( vby ) );
+					const point_t* ends[4] = { &a1, &a2, &b1, &b2 };
+					for( int k = 0; k < 4; ++k ) {
+						if( std::fabs( i0.x - ends[k]->x ) <= tol && std::fabs( i0.y - ends[k]->y ) <= tol ) {
+							i0 = *ends[k];
+							break;
+						}
+					}
+					return 1;
+				}
+
+				// parallel, check they are on one line
+				kross = ex * vay - ey * vax;
+				if( kross * kross > 0.0 ) { return 0; }
+				double len_sq = vax * vax + vay * vay;
+				double sa = ( vax * ex + vay * ey ) / len_sq;
+				double sb = sa + ( vax * vbx + vay * vby ) / len_sq;
+				double smin = std::min( sa, sb ), smax = std::max( sa, sb );
+				if( smin <= 1.0 && smax >= 0.0 ) {
+					if( smin == 1.0 ) {
+						i0 = point_t( a1.x + vax, a1.y + vay );
+						return 1;
+					}
+					if( smax == 0.0 ) {
+						i0 = a1;
+						return 1;
+					}
+					smin = std::max( smin, 0.0 );
+					smax = std::min( smax, 1.0 );
+					i0 = point_t( a1.x + smin * vax, a1.y + smin * vay );
+					i1 = point_t( a1.x + smax * vax, a1.y + smax * vay );
+					return 2;
+				}
+				return 0;
+			}
+
+			// splits the edge of left event 'e' at 'pt'
+			// Overlapping edges starting at the same point, of either polygon,
+			//   sit together in the status. Cut them all to the shortest so
+			//   they are crossed together, and recompute their fields from
+			//   the lowest up.
+			void equalize( sweep_event* e ) {
+				status_t::iterator first = e->position;
+				while( first != m_status.begin( ) ) {
+					status_t::iterator below = first;
+					if( !collinear_from( *--below, e ) ) { break; }
+					first = below;
+				}
+				status_t::iterator last = e->position;
+				while( ++last != m_status.end( ) && collinear_from( *last, e ) ) { }
+
+				sweep_event* shortest = e;
+				for( status_t::iterator itr = first; itr != last; ++itr ) {
+					if( compare_events( ( *itr )->other, shortest->other ) < 0 ) { shortest = *itr; }
+				}
+				const point_t end = shortest->other->point;
+				sweep_event* prev = 0;
+				if( first != m_status.begin( ) ) {
+					status_t::iterator below = first;
+					prev = *--below;
+				}
+				for( status_t::iterator itr = first; itr != last; ++itr ) {
+					if( ( *itr )->other->point != end ) { divide( *itr, end ); }
+					compute_fields( *itr, prev );
+					prev = *itr;
+				}
+			}
+
+			static bool collinear_from( const sweep_event* e1, const sweep_event* e2 ) {
+				return e1->point == e2->point &&
+				       signed_area( e2->point, e2->other->point, e1->other->point ) == 0.0;
+			}
+
+			// equal edges are crossed together, so are cut together
+			void divide( sweep_event* e, const point_t& pt ) {
+				if( e->in_status ) {
+					status_t::iterator itr = e->position;
+					while( itr != m_status.begin( ) && equal_edges( *--itr, e ) ) { split( *itr, pt ); }
+					itr = e->position;
+					while( ++itr != m_status.end( ) && equal_edges( *itr, e ) ) { split( *itr, pt ); }
+				}
+				split( e, pt );
+			}
+
+			void split( sweep_event* e, const point_t& pt ) {
+				sweep_event* r = make_event( pt, false, e, e->subject );
+				sweep_event* l = make_event( pt, true, e->other, e->subject );
+				r->contour_id = l->contour_id = e->contour_id;
+				r->wind = l->wind = e->wind;
+				// rounding can put the new left end past the old right end
+				if( compare_events( l, e->other ) > 0 ) {
+					e->other->left = true;
+					l->left = false;
+					l->wind = e->other->wind = -e->wind;
+				}
+				e->other->other = l;
+				e->other = r;
+				m_queue.push( l );
+				m_queue.push( r );
+			}
+
+			int possible_intersection( sweep_event* se1, sweep_event* se2 ) {
+				point_t i0, i1;
+				int count = intersect( se1->point, se1->other->point, se2->point, se2->other->point, i0, i1 );
+				if( count == 0 ) { return 0; }
+				// meet at an end point of both
+				if( count == 1 && ( se1->point == se2->point || se1->other->point == se2->other->point ) ) {
+					return 0;
+				}
+
+				if( count == 1 ) {
+					if( se1->point != i0 && se1->other->point != i0 ) { divide( se1, i0 ); }
+					if( se2->point != i0 && se2->other->point != i0 ) { divide( se2, i0 ); }
+					return 1;
+				}
+
+				// the edges overlap
+				sweep_event* events[4];
+				unsigned int n = 0;
+				bool left_same = false, right_same = false;
+				if( se1->point == se2->point ) { left_same = true; }
+				else if( compare_events( se1, se2 ) == 1 ) { events[n++] = se2; events[n++] = se1; }
+				else { events[n++] = se1; events[n++] = se2; }
+
+				if( se1->other->point == se2->other->point ) { right_same = true; }
+				else if( compare_events( se1->other, se2->other ) == 1 ) {
+					events[n++] = se2->other;
+					events[n++] = se1->other;
+				}
+				else {
+					events[n++] = se1->other;
+					events[n++] = se2->other;
+				}
+
+				if( left_same ) {
+					// split the longer so the two are equal
+					if( !right_same ) { divide( events[1]->other, events[0]->point ); }
+					return 2;
+				}
+				if( right_same ) {
+					divide( events[0], events[1]->point );
+					return 3;
+				}
+				// neither contains the other
+				if( events[0] != events[3]->other ) {
+					divide( events[0], events[1]->point );
+					divide( events[1], events[2]->point );
+					return 3;
+				}
+				// one contains the other
+				divide( events[0], events[1]->point );
+				divide( events[3]->other, events[2]->point );
+				return 3;
+			}
+
+			void subdivide( boolean_op op, double min_right, double subject_right ) {
+				while( !m_queue.empty( ) ) {
+					sweep_event* e = m_queue.top( );
+					m_queue.pop( );
+					m_sorted.push_back( e );
+
+					// nothing further right can change the result
+					if( ( op == op_intersection && e->point.x > min_right ) ||
+					    ( op == op_difference && e->point.x > subject_right ) ) {
+						break;
+					}
+
+					if( e->left ) {
+						std::pair<status_t::iterator, bool> ins = m_status.insert( e );
+						status_t::iterator itr = ins.first;
+						if( ins.second ) {
+							e->in_status = true;
+							e->position = itr;
+						}
+						sweep_event* prev = 0;
+						sweep_event* next = 0;
+						status_t::iterator prev_itr = itr;
+						if( itr != m_status.begin( ) ) { prev = *--prev_itr; }
+						status_t::iterator next_itr = itr;
+						if( ++next_itr != m_status.end( ) ) { next = *next_itr; }
+
+						compute_fields( e, prev );
+						bool overlap = next && possible_intersection( e, next ) == 2;
+						if( prev && possible_intersection( prev, e ) == 2 ) { overlap = true; }
+						if( overlap ) { equalize( e ); }
+					}
+					else {
+						sweep_event* left = e->other;
+						if( !left->in_status ) { continue; }
+						status_t::iterator itr = left->position;
+						left->in_status = false;
+						sweep_event* prev = 0;
+						sweep_event* next = 0;
+						status_t::iterator prev_itr = itr;
+						if( itr != m_status.begin( ) ) { prev = *--prev_itr; }
+						status_t::iterator next_itr = itr;
+						if( ++next_itr != m_status.end( ) ) { next = *next_itr; }
+						m_status.erase( itr );
+						if( prev && next ) { possible_intersection( prev, next ); }
+					}
+				}
+			}
+
+			// the events of result edges, in sweep order, linked to their
+			//   partner's position
+			void order_events( std::vector<sweep_event*>& result ) {
+				result.clear( );
+				for( unsigned int i = 0; i < m_sorted.size( ); ++i ) {
+					sweep_event* e = m_sorted[i];
+					if( ( e->left && e->in_result( ) ) || ( !e->left && e->other->in_result( ) ) ) {
+						result.push_back( e );
+					}
+				}
+				// overlapping edges can leave it slightly out of order,
+				//   insertion sort is linear on nearly sorted input
+				for( unsigned int i = 1; i < result.size( ); ++i ) {
+					sweep_event* e = result[i];
+					unsigned int j = i;
+					while( j > 0 && compare_events( result[j - 1], e ) == 1 ) {
+						result[j] = result[j - 1];
+						--j;
+					}
+					result[j] = e;
+				}
+				for( unsigned int i = 0; i < result.size( ); ++i ) { result[i]->other_pos = i; }
+				for( unsigned int i = 0; i < result.size( ); ++i ) {
+					sweep_event* e = result[i];
+					if( !e->left ) { std::swap( e->other_pos, e->other->other_pos ); }
+				}
+			}
+
+			// does the edge of 'e' run from 'e' to its partner, keeping the
+			//   result on its left
+			static bool starts_edge( const sweep_event* e ) {
+				const sweep_event* l = e->left ? e : e->other;
+				return e->left == ( l->result_transition > 0 );
+			}
+
+			// the edge leaving the point of 'pos' that turns furthest left
+			//   from the edge arriving there, so where more than two result
+			//   edges meet each ring keeps to one side of the point. 'start'
+			//   is a candidate to close the ring, size( ) when there is none.
+			static unsigned int next_pos( unsigned int pos, const std::vector<sweep_event*>& events,
+			                              const std::vector<unsigned int>& first,
+			                              const std::vector<char>& processed, unsigned int start ) {
+				const point_t& pt = events[pos]->point;
+				const point_t& from = events[events[pos]->other_pos]->point;
+				const double rx = from.x - pt.x, ry = from.y - pt.y;
+				unsigned int best = events.size( );
+				double best_turn = 0.0;
+				for( unsigned int q = first[pos]; q < events.size( ) && events[q]->point == pt; ++q ) {
+					if( q == pos || ( processed[q] && q != start ) || !starts_edge( events[q] ) ) { continue; }
+					const point_t& to = events[events[q]->other_pos]->point;
+					const double cx = to.x - pt.x, cy = to.y - pt.y;
+					// clockwise angle from the way back to the way on, in (0, 2pi]
+					double turn = std::atan2( cx * ry - cy * rx, rx * cx + ry * cy );
+					if( turn <= 0.0 ) { turn += 2 * EUCLIB_PI; }
+					if( best == events.size( ) || turn < best_turn ) {
+						best = q;
+						best_turn = turn;
+					}
+				}
+				if( best != events.size( ) ) { return best; }
+				// rounding left the ring without a way on, take any edge
+				for( unsigned int q = first[pos]; q < events.size( ) && events[q]->point == pt; ++q ) {
+					if( q != pos && !processed[q] ) { return q; }
+				}
+				return events.size( );
+			}
+
+			// the edge below a new ring says whether it is a hole and of what
+			void start_contour( const sweep_event* e, std::vector<contour>& contours, contour& c ) {
+				c.hole_of = -1;
+				c.depth = 0;
+				const sweep_event* below = e->prev_in_result;
+				if( below == 0 || below->output_contour < 0 ) { return; }
+				int lower = below->output_contour;
+				if( below->result_transition > 0 ) {
+					// inside, a hole of whatever holds the lower ring
+					int parent = contours[lower].hole_of >= 0 ? contours[lower].hole_of : lower;
+					contours[parent].holes.push_back( contours.size( ) );
+					c.hole_of = parent;
+					c.depth = contours[parent].depth + 1;
+				}
+				else {
+					c.depth = contours[lower].depth;
+				}
+			}
+
+			void connect( rings_t& result ) {
+				std::vector<sweep_event*> events;
+				order_events( events );
+				std::vector<char> processed( events.size( ), 0 );
+				std::vector<contour> contours;
+
+				// the first event at each event's point
+				std::vector<unsigned int> first( events.size( ) );
+				for( unsigned int i = 0; i < events.size( ); ++i ) {
+					first[i] = ( i > 0 && events[i - 1]->point == events[i]->point ) ? first[i - 1] : i;
+				}
+
+				for( unsigned int i = 0; i < events.size( ); ++i ) {
+					if( processed[i] ) { continue; }
+					const int id = contours.size( );
+					contour c;
+					c.pinched = false;
+					start_contour( events[i], contours, c );
+
+					// walk each edge the way that keeps the result on the left
+					const unsigned int start = starts_edge( events[i] ) ? i : events[i]->other_pos;
+					unsigned int pos = start;
+					c.points.push_back( events[pos]->point );
+					for( ;; ) {
+						processed[pos] = 1;
+						events[pos]->output_contour = id;
+						pos = events[pos]->other_pos;
+						processed[pos] = 1;
+						events[pos]->output_contour = id;
+						c.points.push_back( events[pos]->point );
+						const unsigned int f = first[pos];
+						if( f + 2 < events.size( ) && events[f + 2]->point == events[pos]->point ) { c.pinched = true; }
+						pos = next_pos( pos, events, first, processed, start );
+						if( pos == start || pos >= events.size( ) ) { break; }
+					}
+					contours.push_back( c );
+				}
+
+				// each exterior ring counter-clockwise, then its holes clockwise.
+				//   Islands split from a hole's ring follow as exteriors.
+				rings_t islands;
+				for( unsigned int i = 0; i < contours.size( ); ++i ) {
+					if( contours[i].hole_of >= 0 ) { continue; }
+					rings_t outer, inner;
+					split_contour( contours[i], outer, inner );
+					for( unsigned int h = 0; h < contours[i].holes.size( ); ++h ) {
+						split_contour( contours[contours[i].holes[h]], islands, inner );
+					}
+					for( unsigned int k = 0; k < outer.size( ); ++k ) { add_output( outer[k], true, result ); }
+					for( unsigned int k = 0; k < inner.size( ); ++k ) { add_output( inner[k], false, result ); }
+				}
+				for( unsigned int k = 0; k < islands.size( ); ++k ) { add_output( islands[k], true, result ); }
+			}
+
+			// a ring that touches itself is split into loops where it does,
+			//   those turning counter-clockwise, with the result inside,
+			//   going to 'ccw'
+			static void split_contour( const contour& c, rings_t& ccw, rings_t& cw ) {
+				if( !c.pinched ) {
+					( c.hole_of < 0 ? ccw : cw ).push_back( c.points );
+					return;
+				}
+				std::map<std::pair<double,double>, unsigned int> seen;
+				ring_t loop;
+				unsigned int n = c.points.size( );
+				if( n > 1 && c.points.back( ) == c.points.front( ) ) { --n; }
+				for( unsigned int i = 0; i <= n; ++i ) {
+					if( i < n ) {
+						const std::pair<double,double> key( c.points[i].x, c.points[i].y );
+						std::map<std::pair<double,double>, unsigned int>::iterator itr = seen.find( key );
+						if( itr == seen.end( ) ) {
+							seen.insert( std::make_pair( key, loop.size( ) ) );
+							loop.push_back( c.points[i] );
+							continue;
+						}
+						// back at a point already passed, close the loop from there
+						const unsigned int from = itr->second;
+						ring_t closed( loop.begin( ) + from, loop.end( ) );
+						for( unsigned int j = from + 1; j < loop.size( ); ++j ) {
+							seen.erase( std::make_pair( loop[j].x, loop[j].y ) );
+						}
+						loop.resize( from + 1 );
+						( area( closed ) > 0.0 ? ccw : cw ).push_back( closed );
+					}
+					else if( !loop.empty( ) ) {
+						( area( loop ) > 0.0 ? ccw : cw ).push_back( loop );
+					}
+				}
+			}
+
+			// twice the signed area, positive when counter-clockwise
+			static double area( const ring_t& points ) {
+				double sum = 0.0;
+				for( unsigned int i = 0, j = points.size( ) - 1; i < points.size( ); j = i++ ) {
+					sum += points[j].x * points[i].y - points[i].x * points[j].y;
+				}
+				return sum;
+			}
+
+			static void add_output( ring_t points, bool ccw, rings_t& result ) {
+				if( points.size( ) > 1 && points.back( ) == points.front( ) ) { points.pop_back( ); }
+				// split points along a straight boundary are not vertices
+				ring_t kept;
+				kept.reserve( points.size( ) );
+				for( unsigned int i = 0; i < points.size( ); ++i ) {
+					const point_t& next = points[( i + 1 ) % points.size( )];
+					if( !kept.empty( ) && signed_area( kept.back( ), points[i], next ) == 0.0 ) { continue; }
+					kept.push_back( points[i] );
+				}
+				while( kept.size( ) > 2 && signed_area( kept[kept.size( ) - 2], kept.back( ), kept[0] ) == 0.0 ) {
+					kept.pop_back( );
+				}
+				while( kept.size( ) > 2 && signed_area( kept.back( ), kept[0], kept[1] ) == 0.0 ) {
+					kept.erase( kept.begin( ) );
+				}
+				points.swap( kept );
+				if( points.size( ) < 3 ) { return; }
+				if( ( area( points ) > 0.0 ) != ccw ) { std::reverse( points.begin( ), points.end( ) ); }
+				result.push_back( points );
+			}
+
+
+		// Variables
+		private:
+
+			boolean_op                 m_op;
+			fill_rule                  m_fill;
+			std::deque<sweep_event>    m_events;
+			queue_t                    m_queue;
+			status_t                   m_status;
+			std::vector<sweep_event*>  m_sorted;
+		};
+
+		template<typename T>
+		void to_double( const std::vector<std::vector<point2<T>>>& rings, martinez::rings_t& out ) {
+			out.resize( rings.size( ) );
+			for( unsigned int r = 0; r < rings.size( ); ++r ) {
+				out[r].resize( rings[r].size( ) );
+				for( unsigned int i = 0; i < rings[r].size( ); ++i ) {
+					out[r][i] = martinez::point_t( double(rings[r][i].x), double(rings[r][i].y) );
+				}
+			}
+		}
+
+		template<typename T>
+		void from_double( const martinez::rings_t& rings, std::vector<std::vector<point2<T>>>& out ) {
+			out.clear( );
+			out.reserve( rings.size( ) );
+			for( unsigned int r = 0; r < rings.size( ); ++r ) {
+				std::vector<point2<T>> ring;
+				ring.reserve( rings[r].size( ) );
+				for( unsigned int i = 0; i < rings[r].size( ); ++i ) {
+					point2<T> pt( round_to<T>( rings[r][i].x ), round_to<T>( rings[r][i].y ) );
+					if( ring.empty( ) || ring.back( ) != pt ) { ring.push_back( pt ); }
+				}
+				while( ring.size( ) > 1 && ring.back( ) == ring.front( ) ) { ring.pop_back( ); }
+				if( ring.size( ) >= 3 ) { out.push_back( ring ); }
+			}
+		}
+
+		template<>
+		inline void to_double( const martinez::rings_t& rings, martinez::rings_t& out ) {
+			out = rings;
+		}
+
+		template<>
+		inline void from_double( const martinez::rings_t& rings, martinez::rings_t& out ) {
+			out = rings;
+		}
+
+	} // End namespace detail
+
+
+	// writes 'subject' op 'clip' to 'result', each polygon covering the
+	//   points 'fill' says
+	template<typename T>
+	void combine( const std::vector<std::vector<point2<T>>>& subject,
+	              const std::vector<std::vector<point2<T>>>& clip, boolean_op op,
+	              std::vector<std::vector<point2<T>>>& result, fill_rule fill = fill_even_odd ) {
+		detail::martinez::rings_t s, c, r;
+		detail::to_double( subject, s );
+		detail::to_double( clip, c );
+		detail::martinez sweep;
+		sweep.run( s, c, op, r, fill );
+		detail::from_double( r, result );
+	}
+
+	// union of many polygons, merged in pairs so each edge takes part in
+	//   O(log n) sweeps, the pairs of each round are shared over 'threads'
+	//   threads (0 for one per core)
+	template<typename T>
+	void combine( const std::vector<std::vector<std::vector<point2<T>>>>& polys,
+	              std::vector<std::vector<point2<T>>>& result, unsigned int threads = 0 ) {
+		typedef std::vector<std::vector<point2<T>>> rings_t;
+		result.clear( );
+		if( polys.empty( ) ) { return; }
+
+		std::vector<rings_t> level( polys );
+		while( level.size( ) > 1 ) {
+			std::vector<rings_t> merged( ( level.size( ) + 1 ) / 2 );
+			parallel_for( 0, merged.size( ), [&]( unsigned int i ) {
+				if( 2 * i + 1 < level.size( ) ) {
+					combine( level[2 * i], level[2 * i + 1], op_union, merged[i] );
+				}
+				else {
+					merged[i].swap( level[2 * i] );
+				}
+			}, threads, 1 );
+			level.swap( merged );
+		}
+		result.swap( level[0] );
+	}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_BOOLEAN_HPP
@@ -0,0 +1,664 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_CLIP_HPP
+#define EUBLIB_CLIP_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include "euclib_math.hpp"
+#include "point.hpp"
+#include "rect.hpp"
+#include "segment.hpp"
+#include "polygon.hpp"
+
+/*
+ * Polygon clipping engine
+ *
+ *   Sutherland-Hodgman is used whenever the clip region is convex (rect2,
+ *   polygon2), it works for any subject polygon but a concave subject that
+ *   leaves and re-enters the region comes back as one ring joined along the
+ *   region's boundary.  Greiner-Hormann handles an arbitrary simple subject
+ *   against an arbitrary simple clip region and returns every piece.  Both
+ *   are turned counter-clockwise first, and the crossings are found by
+ *   sweeping the edge bounding boxes in order of their left sides, so only
+ *   edges that overlap in x are ever compared.
+ *
+ *   Results are written as rings of points.  A clipper keeps its scratch
+ *   buffers between calls, so clipping many polygons with the same clipper
+ *   does not allocate once the buffers have grown.
+ *
+ * References
+ *   [1] I.E. Sutherland, G.W. Hodgman. "Reentrant polygon clipping".
+ *         Communications of the ACM, vol. 17, no. 1, pp. 32-42, 1974.
+ *   [2] G. Greiner, K. Hormann. "Efficient clipping of arbitrary polygons".
+ *         ACM Transactions on Graphics, vol. 17, no. 2, pp. 71-83, 1998.
+ *   [3] Y. Liang, B.A. Barsky. "A new concept and method for line clipping".
+ *         ACM Transactions on Graphics, vol. 3, no. 1, pp. 1-22, 1984.
+ */
+
+namespace euclib {
+
+template<typename T>
+class clipper {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+public:
+
+	typedef std::vector<point2<T>>  ring_t;
+
+
+// Constructors
+public:
+
+	clipper( ) { }
+
+
+// Methods
+public:
+
+	////////////////////////////////////////
+	// Sutherland-Hodgman, convex regions
+
+	// clips 'subject' to 'rect', returns false if nothing is left
+	template<typename Ring>
+	bool clip( const Ring& subject, const rect2<T>& rect, ring_t& result ) {
+		result.clear( );
+		if( subject.size( ) < 3 || rect == rect2<T>::null( ) ) { return false; }
+
+		m_buffer.assign( subject.begin( ), subject.end( ) );
+		clip_axis( m_buffer, result, 0, rect.l, false );
+		clip_axis( result, m_buffer, 0, rect.r, true );
+		clip_axis( m_buffer, result, 1, rect.t, false );
+		clip_axis( result, m_buffer, 1, rect.b, true );
+		result.swap( m_buffer );
+
+		return result.size( ) >= 3;
+	}
+
+	// clips 'subject' to the convex hull of 'region'
+	template<typename Ring>
+	bool clip( const Ring& subject, const polygon2<T>& region, ring_t& result ) {
+		result.clear( );
+		if( subject.size( ) < 3 || region == polygon2<T>::null( ) ) { return false; }
+
+		m_buffer.assign( subject.begin( ), subject.end( ) );
+		for( unsigned int i = 0; i < region.size( ) && !m_buffer.empty( ); ++i ) {
+			clip_edge( m_buffer, result, region[i],
+			           region[i + 1 == region.size( ) ? 0 : i + 1] );
+			result.swap( m_buffer );
+		}
+		result.swap( m_buffer );
+
+		return result.size( ) >= 3;
+	}
+
+	// clips every ring of 'layer' to 'tile' in one pass, the pieces are
+	//   stored back to back in 'vertices' and piece i is the range
+	//   [offsets[i], offsets[i+1]), 'source' gets the layer index of each
+	void clip( const std::vector<ring_t>& layer, const rect2<T>& tile,
+	           ring_t& vertices, std::vector<unsigned int>& offsets,
+	           std::vector<unsigned int>& source ) {
+		vertices.clear( );
+		offsets.assign( 1, 0 );
+		source.clear( );
+		if( tile == rect2<T>::null( ) ) { return; }
+
+		for( unsigned int i = 0; i < layer.size( ); ++i ) {
+			const ring_t& ring = layer[i];
+			if( ring.size( ) < 3 ) { continue; }
+
+			// bounding box decides between reject, accept, and clip
+			T l = ring[0].x, r = ring[0].x, t = ring[0].y, b = ring[0].y;
+			for( unsigned int j = 1; j < ring.size( ); ++j ) {
+				l = std::min( l, ring[j].x );
+				r = std::max( r, ring[j].x );
+				t = std::min( t, ring[j].y );
+				b = std::max( b, ring[j].y );
+			}
+			if( r < tile.l || tile.r < l || b < tile.t || tile.b < t ) {
+				continue;
+			}
+			if( tile.l <= l && r <= tile.r && tile.t <= t && b <= tile.b ) {
+				vertices.insert( vertices.end( ), ring.begin( ), ring.end( ) );
+			}
+			else if( clip( ring, tile, m_piece ) ) {
+				vertices.insert( vertices.end( ), m_piece.begin( ), m_piece.end( ) );
+			}
+			else {
+				continue;
+			}
+			offsets.push_back( vertices.size( ) );
+			source.push_back( i );
+		}
+	}
+
+
+	////////////////////////////////////////
+	// Greiner-Hormann, arbitrary regions
+
+	// intersects two simple polygons of any shape, the pieces are stored
+	//   back to back in 'vertices' with piece i in [offsets[i], offsets[i+1])
+	//   Vertices lying exactly on the other boundary are nudged off it
+	//   first and written out where they were given, so input that only
+	//   touches gives no pieces.  Either may be given in either
+	//   orientation, pieces are counter-clockwise.
+	bool clip( const ring_t& subject, const ring_t& region,
+	           ring_t& vertices, std::vector<unsigned int>& offsets ) {
+		vertices.clear( );
+		offsets.assign( 1, 0 );
+		if( subject.size( ) < 3 || region.size( ) < 3 ) { return false; }
+
+		build_lists( subject, region );
+
+		// no crossings, one contains the other or they are apart
+		if( m_crossings.empty( ) ) {
+			const ring_t* inner = nullptr;
+			if( contains( m_region, m_subject[0] ) ) { inner = &subject; }
+			else if( contains( m_subject, m_region[0] ) ) { inner = &region; }
+			if( inner == nullptr ) { return false; }
+			vertices.assign( inner->begin( ), inner->end( ) );
+			if( area( vertices ) < 0.0 ) { std::reverse( vertices.begin( ), vertices.end( ) ); }
+			offsets.push_back( vertices.size( ) );
+			return true;
+		}
+
+		mark_entries( );
+		trace( vertices, offsets );
+		return offsets.size( ) > 1;
+	}
+
+
+	////////////////////////////////////////
+	// segment clipping
+
+	// Liang-Barsky, returns false if the segment misses the rect
+	bool clip( const segment2<T>& segment, const rect2<T>& rect, segment2<T>& result ) const {
+		if( rect == rect2<T>::null( ) ) { return false; }
+
+		double t0 = 0.0, t1 = 1.0;
+		double dx = double(segment.pt2.x) - double(segment.pt1.x);
+		double dy = double(segment.pt2.y) - double(segment.pt1.y);
+		if( !clip_param( -dx, double(segment.pt1.x) - double(rect.l), t0, t1 ) ||
+		    !clip_param(  dx, double(rect.r) - double(segment.pt1.x), t0, t1 ) ||
+		    !clip_param( -dy, double(segment.pt1.y) - double(rect.t), t0, t1 ) ||
+		    !clip_param(  dy, double(rect.b) - double(segment.pt1.y), t0, t1 ) ) {
+			return false;
+		}
+
+		result = segment2<T>{ lerp( segment.pt1, segment.pt2, t0 ),
+		                      lerp( segment.pt1, segment.pt2, t1 ) };
+		return true;
+	}
+
+	// Cyrus-Beck against the convex hull of 'region'
+	bool clip( const segment2<T>& segment, const polygon2<T>& region, segment2<T>& result ) const {
+		if( region == polygon2<T>::null( ) ) { return false; }
+
+		double t0 = 0.0, t1 = 1.0;
+		double dx = double(segment.pt2.x) - double(segment.pt1.x);
+		double dy = double(segment.pt2.y) - double(segment.pt1.y);
+		for( unsigned int i = 0; i < region.size( ); ++i ) {
+			point2<T> pt0 = region[i];
+			point2<T> pt1 = region[i + 1 == region.size( ) ? 0 : i + 1];
+			// outward normal of a counter-clockwise edge
+			double nx = double(pt1.y) - double(pt0.y);
+			double ny = double(pt0.x) - double(pt1.x);
+			double denom = nx * dx + ny * dy;
+			double num = nx * ( double(pt0.x) - double(segment.pt1.x) ) +
+			             ny * ( double(pt0.y) - double(segment.pt1.y) );
+			if( !clip_param( denom, num, t0, t1 ) ) { return false; }
+		}
+
+		result = segment2<T>{ lerp( segment.pt1, segment.pt2, t0 ),
+		                      lerp( segment.pt1, segment.pt2, t1 ) };
+		return true;
+	}
+
+
+private:
+
+	// keeps the side of the line 'coord[axis] == value' facing inward
+	static void clip_axis( const ring_t& in, ring_t& out, int axis, T value, bool upper ) {
+		out.clear( );
+		if( in.empty( ) ) { return; }
+
+		point2<T> prev = in.back( );
+		bool prev_in = inside_axis( prev, axis, value, upper );
+		for( unsigned int i = 0; i < in.size( ); ++i ) {
+			const point2<T>& curr = in[i];
+			bool curr_in = inside_axis( curr, axis, value, upper );
+			if( curr_in != prev_in ) {
+				double c0 = axis == 0 ? double(prev.x) : double(prev.y);
+				double c1 = axis == 0 ? double(curr.x) : double(curr.y);
+				point2<T> hit = lerp( prev, curr, ( double(value) - c0 ) / ( c1 - c0 ) );
+				// land exactly on the clip line
+				if( axis == 0 ) { hit.x = value; } else { hit.y = value; }
+				out.push_back( hit );
+			}
+			if( curr_in ) { out.push_back( curr ); }
+			prev = curr;
+			prev_in = curr_in;
+		}
+	}
+
+	static bool inside_axis( const point2<T>& pt, int axis, T value, bool upper ) {
+		T c = ( axis == 0 ? pt.x : pt.y );
+		return upper ? !(value < c) : !(c < value);
+	}
+
+	// keeps the left side of the directed edge pt0 -> pt1
+	static void clip_edge( const ring_t& in, ring_t& out,
+	                       const point2<T>& pt0, const point2<T>& pt1 ) {
+		out.clear( );
+		if( in.empty( ) ) { return; }
+
+		point2<T> prev = in.back( );
+		double prev_side = side( pt0, pt1, prev );
+		for( unsigned int i = 0; i < in.size( ); ++i ) {
+			const point2<T>& curr = in[i];
+			double curr_side = side( pt0, pt1, curr );
+			if( ( curr_side >= 0.0 ) != ( prev_side >= 0.0 ) ) {
+				out.push_back( lerp( prev, curr, prev_side / ( prev_side - curr_side ) ) );
+			}
+			if( curr_side >= 0.0 ) { out.push_back( curr ); }
+			prev = curr;
+			prev_side = curr_side;
+		}
+	}
+
+	static double side( const point2<T>& pt0, const point2<T>& pt1, const point2<T>& pt ) {
+		return ( double(pt1.x) - double(pt0.x) ) * ( double(pt.y) - double(pt0.y) ) -
+		       ( double(pt1.y) - double(pt0.y) ) * ( double(pt.x) - double(pt0.x) );
+	}
+
+	static point2<T> lerp( const point2<T>& pt0, const point2<T>& pt1, double t ) {
+		return point2<T>{ round_to<T>( double(pt0.x) + t * ( double(pt1.x) - double(pt0.x) ) ),
+		                  round_to<T>( double(pt0.y) + t * ( double(pt1.y) - double(pt0.y) ) ) };
+	}
+
+	// one Liang-Barsky/Cyrus-Beck step for the constraint p*t <= q
+	static bool clip_param( double p, double q, double& t0, double& t1 ) {
+		if( p == 0.0 ) { return q >= 0.0; }
+		double t = q / p;
+		if( p < 0.0 ) {
+			if( t > t1 ) { return false; }
+			if( t > t0 ) { t0 = t; }
+		}
+		else {
+			if( t < t0 ) { return false; }
+			if( t < t1 ) { t1 = t; }
+		}
+		return true;
+	}
+
+	// twice the signed area of ring[first, last), positive when counter-clockwise
+	template<typename P>
+	static double area( const std::vector<P>& ring, unsigned int first, unsigned int last ) {
+		double sum = 0.0;
+		for( unsigned int i = first, j = last - 1; i < last; j = i++ ) {
+			sum += double(ring[j].x) * double(ring[i].y) - double(ring[i].x) * double(ring[j].y);
+		}
+		return sum;
+	}
+
+	template<typename P>
+	static double area( const std::vector<P>& ring ) {
+		return area( ring, 0, ring.size( ) );
+	}
+
+	// length of the boundary of ring[first, last)
+	static double perimeter( const ring_t& ring, unsigned int first, unsigned int last ) {
+		double sum = 0.0;
+		for( unsigned int i = first, j = last - 1; i < last; j = i++ ) {
+			sum += std::hypot( double(ring[i].x) - double(ring[j].x), double(ring[i].y) - double(ring[j].y) );
+		}
+		return sum;
+	}
+
+	// even-odd point in polygon
+	template<typename P>
+	static bool contains( const std::vector<P>& ring, const P& pt ) {
+		bool in = false;
+		for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+			if( ( ring[i].y > pt.y ) != ( ring[j].y > pt.y ) &&
+			    pt.x < ( ring[j].x - ring[i].x ) * ( pt.y - ring[i].y ) /
+			           ( ring[j].y - ring[i].y ) + ring[i].x ) {
+				in = !in;
+			}
+		}
+		return in;
+	}
+
+
+	////////////////////////////////////////
+	// Greiner-Hormann internals
+
+	struct node {
+		point2<double> pt;
+		point2<double> out;       // written in place of pt, before nudging
+		unsigned int   next, prev;
+		unsigned int   neighbor;  // matching node in the other list
+		bool           crossing;
+		bool           entry;
+		bool           visited;
+	};
+
+	struct crossing_rec {
+		unsigned int   edge_s, edge_c;    // edge of subject/region
+		double         alpha_s, alpha_c;  // position along each edge
+		point2<double> pt, out;
+		unsigned int   node_s, node_c;
+	};
+
+	struct edge_box {
+		double        l, r, t, b;
+		unsigned int  index;  // edge from vertex 'index', or the vertex itself
+	};
+
+	// copies 'ring' as doubles, counter-clockwise
+	static void copy_ccw( const ring_t& ring, std::vector<point2<double>>& out ) {
+		out.resize( ring.size( ) );
+		for( unsigned int i = 0; i < ring.size( ); ++i ) {
+			out[i] = point2<double>{ double(ring[i].x), double(ring[i].y) };
+		}
+		if( area( out ) < 0.0 ) { std::reverse( out.begin( ), out.end( ) ); }
+	}
+
+	// the boxes of the edges of 'ring', or of its vertices, grown by 'pad'
+	//   and sorted by their left sides
+	static void make_boxes( const std::vector<point2<double>>& ring, bool vertices, double pad,
+	                        std::vector<edge_box>& boxes ) {
+		const unsigned int n = ring.size( );
+		boxes.resize( n );
+		for( unsigned int i = 0; i < n; ++i ) {
+			const point2<double>& a = ring[i];
+			const point2<double>& b = vertices ? a : ring[i + 1 == n ? 0 : i + 1];
+			boxes[i].l = std::min( a.x, b.x ) - pad;
+			boxes[i].r = std::max( a.x, b.x ) + pad;
+			boxes[i].t = std::min( a.y, b.y ) - pad;
+			boxes[i].b = std::max( a.y, b.y ) + pad;
+			boxes[i].index = i;
+		}
+		std::sort( boxes.begin( ), boxes.end( ),
+			[]( const edge_box& a, const edge_box& b ) { return a.l < b.l; } );
+	}
+
+	// calls 'report' with the indices of every pair of overlapping boxes,
+	//   one from each list. Whichever box starts first is compared with
+	//   those starting before it ends, so pairs apart in x are never seen.
+	template<typename F>
+	static void box_pairs( const std::vector<edge_box>& a, const std::vector<edge_box>& b, F report ) {
+		unsigned int i = 0, j = 0;
+		while( i < a.size( ) && j < b.size( ) ) {
+			if( a[i].l <= b[j].l ) {
+				for( unsigned int k = j; k < b.size( ) && b[k].l <= a[i].r; ++k ) {
+					if( b[k].t <= a[i].b && a[i].t <= b[k].b ) { report( a[i].index, b[k].index ); }
+				}
+				++i;
+			}
+			else {
+				for( unsigned int k = i; k < a.size( ) && a[k].l <= b[j].r; ++k ) {
+					if( a[k].t <= b[j].b && b[j].t <= a[k].b ) { report( a[k].index, b[j].index ); }
+				}
+				++j;
+			}
+		}
+	}
+
+	// copies 'ring' into 'out', moving vertices within 'nudge' of the
+	//   boundary of 'other' toward its inside, both counter-clockwise
+	void nudge( const std::vector<point2<double>>& ring, const std::vector<point2<double>>& other,
+	            double nudge, std::vector<point2<double>>& out ) {
+		// edges near each vertex, allowing for a vertex moved a few times
+		make_boxes( ring, true, nudge * 16.0, m_boxes_s );
+		make_boxes( other, false, 0.0, m_boxes_c );
+		m_near.clear( );
+		box_pairs( m_boxes_s, m_boxes_c, [this]( unsigned int i, unsigned int j ) {
+			m_near.push_back( std::make_pair( i, j ) );
+		} );
+		std::sort( m_near.begin( ), m_near.end( ) );
+
+		out.assign( ring.begin( ), ring.end( ) );
+		for( unsigned int k = 0; k < m_near.size( ); ++k ) {
+			point2<double>& pt = out[m_near[k].first];
+			const unsigned int j = m_near[k].second;
+			const point2<double>& a = other[j];
+			const point2<double>& b = other[j + 1 == other.size( ) ? 0 : j + 1];
+			double ex = b.x - a.x, ey = b.y - a.y;
+			double len = std::sqrt( ex*ex + ey*ey );
+			if( len == 0.0 ) { continue; }
+			double dist = ( ex * ( pt.y - a.y ) - ey * ( pt.x - a.x ) ) / len;
+			double along = ( ex * ( pt.x - a.x ) + ey * ( pt.y - a.y ) ) / len;
+			if( std::abs( dist ) <= nudge && along >= -nudge && along <= len + nudge ) {
+				// step off the edge along its inward normal
+				pt.x += -ey / len * nudge * 4.0;
+				pt.y +=  ex / len * nudge * 4.0;
+			}
+		}
+	}
+
+	void build_lists( const ring_t& subject, const ring_t& region ) {
+		copy_ccw( subject, m_subject_given );
+		copy_ccw( region, m_region_given );
+		double scale = 0.0;
+		for( unsigned int i = 0; i < m_subject_given.size( ); ++i ) {
+			scale = std::max( scale, std::max( std::abs( m_subject_given[i].x ), std::abs( m_subject_given[i].y ) ) );
+		}
+		for( unsigned int i = 0; i < m_region_given.size( ); ++i ) {
+			scale = std::max( scale, std::max( std::abs( m_region_given[i].x ), std::abs( m_region_given[i].y ) ) );
+		}
+		m_nudge = ( scale + 1.0 ) * 1e-9;
+		// the region first, then the subject off the moved region, so edges
+		//   lying on each other are not both moved the same way
+		nudge( m_region_given, m_subject_given, m_nudge, m_region );
+		nudge( m_subject_given, m_region, m_nudge, m_subject );
+		const unsigned int n = m_subject.size( );
+		const unsigned int m = m_region.size( );
+		// a vertex moves at most a few nudges, a crossing that close to the
+		//   given end of either edge is that vertex
+		const double reach = m_nudge * 16.0;
+
+		// every proper crossing of a subject edge with a region edge
+		m_crossings.clear( );
+		make_boxes( m_subject, false, 0.0, m_boxes_s );
+		make_boxes( m_region, false, 0.0, m_boxes_c );
+		box_pairs( m_boxes_s, m_boxes_c, [this, n, m, reach]( unsigned int i, unsigned int j ) {
+			const point2<double>& s0 = m_subject[i];
+			const point2<double>& s1 = m_subject[i + 1 == n ? 0 : i + 1];
+			const point2<double>& c0 = m_region[j];
+			const point2<double>& c1 = m_region[j + 1 == m ? 0 : j + 1];
+			double denom = ( s1.x - s0.x ) * ( c1.y - c0.y ) - ( s1.y - s0.y ) * ( c1.x - c0.x );
+			if( denom == 0.0 ) { return; }
+			double as = ( ( c0.x - s0.x ) * ( c1.y - c0.y ) - ( c0.y - s0.y ) * ( c1.x - c0.x ) ) / denom;
+			double ac = ( ( c0.x - s0.x ) * ( s1.y - s0.y ) - ( c0.y - s0.y ) * ( s1.x - s0.x ) ) / denom;
+			if( as <= 0.0 || as >= 1.0 || ac <= 0.0 || ac >= 1.0 ) { return; }
+			crossing_rec rec;
+			rec.edge_s = i;
+			rec.edge_c = j;
+			rec.alpha_s = as;
+			rec.alpha_c = ac;
+			rec.pt = point2<double>{ s0.x + as * ( s1.x - s0.x ), s0.y + as * ( s1.y - s0.y ) };
+			rec.out = rec.pt;
+			const point2<double>* ends[4] = { &m_subject_given[i], &m_subject_given[i + 1 == n ? 0 : i + 1],
+			                                  &m_region_given[j], &m_region_given[j + 1 == m ? 0 : j + 1] };
+			for( unsigned int e = 0; e < 4; ++e ) {
+				if( std::abs( ends[e]->x - rec.pt.x ) <= reach && std::abs( ends[e]->y - rec.pt.y ) <= reach ) {
+					rec.out = *ends[e];
+					break;
+				}
+			}
+			m_crossings.push_back( rec );
+		} );
+
+		// lay out the subject list then the region list, each with its
+		//   crossings sorted along the edges
+		m_nodes.clear( );
+		m_order.resize( m_crossings.size( ) );
+		for( unsigned int k = 0; k < m_order.size( ); ++k ) { m_order[k] = k; }
+
+		const std::vector<crossing_rec>& recs = m_crossings;
+		std::sort( m_order.begin( ), m_order.end( ),
+			[&recs]( unsigned int a, unsigned int b ) {
+				return recs[a].edge_s != recs[b].edge_s ? recs[a].edge_s < recs[b].edge_s
+				                                        : recs[a].alpha_s < recs[b].alpha_s;
+			} );
+		m_subject_head = 0;
+		build_list( m_subject, m_subject_given, m_order, true );
+
+		std::sort( m_order.begin( ), m_order.end( ),
+			[&recs]( unsigned int a, unsigned int b ) {
+				return recs[a].edge_c != recs[b].edge_c ? recs[a].edge_c < recs[b].edge_c
+				                                        : recs[a].alpha_c < recs[b].alpha_c;
+			} );
+		m_region_head = m_nodes.size( );
+		build_list( m_region, m_region_given, m_order, false );
+
+		for( unsigned int k = 0; k < m_crossings.size( ); ++k ) {
+			m_nodes[m_crossings[k].node_s].neighbor = m_crossings[k].node_c;
+			m_nodes[m_crossings[k].node_c].neighbor = m_crossings[k].node_s;
+		}
+	}
+
+	void build_list( const std::vector<point2<double>>& ring, const std::vector<point2<double>>& given,
+	                 const std::vector<unsigned int>& order, bool subject ) {
+		const unsigned int head = m_nodes.size( );
+		unsigned int k = 0;
+		for( unsigned int i = 0; i < ring.size( ); ++i ) {
+			push_node( ring[i], given[i], false );
+			while( k < order.size( ) &&
+			       ( subject ? m_crossings[order[k]].edge_s : m_crossings[order[k]].edge_c ) == i ) {
+				crossing_rec& rec = m_crossings[order[k]];
+				( subject ? rec.node_s : rec.node_c ) = m_nodes.size( );
+				push_node( rec.pt, rec.out, true );
+				++k;
+			}
+		}
+		// close the loop
+		m_nodes.back( ).next = head;
+		m_nodes[head].prev = m_nodes.size( ) - 1;
+	}
+
+	void push_node( const point2<double>& pt, const point2<double>& out, bool crossing ) {
+		node nd;
+		nd.pt = pt;
+		nd.out = out;
+		nd.next = m_nodes.size( ) + 1;
+		nd.prev = m_nodes.size( ) - 1;
+		nd.neighbor = 0;
+		nd.crossing = crossing;
+		nd.entry = false;
+		nd.visited = false;
+		m_nodes.push_back( nd );
+	}
+
+	// alternates entry/exit flags starting from whether the first
+	//   vertex of each list lies inside the other polygon
+	void mark_entries( ) {
+		mark_list( m_subject_head, m_region );
+		mark_list( m_region_head, m_subject );
+	}
+
+	void mark_list( unsigned int head, const std::vector<point2<double>>& other ) {
+		bool entry = !contains( other, m_nodes[head].pt );
+		unsigned int idx = head;
+		do {
+			if( m_nodes[idx].crossing ) {
+				m_nodes[idx].entry = entry;
+				entry = !entry;
+			}
+			idx = m_nodes[idx].next;
+		} while( idx != head );
+	}
+
+	void trace( ring_t& vertices, std::vector<unsigned int>& offsets ) {
+		unsigned int idx = m_subject_head;
+		do {
+			if( m_nodes[idx].crossing && !m_nodes[idx].visited ) {
+				unsigned int curr = idx;
+				do {
+					m_nodes[curr].visited = true;
+					m_nodes[m_nodes[curr].neighbor].visited = true;
+					bool forward = m_nodes[curr].entry;
+					do {
+						append( vertices, offsets.back( ), m_nodes[curr].out );
+						curr = forward ? m_nodes[curr].next : m_nodes[curr].prev;
+					} while( !m_nodes[curr].crossing );
+					curr = m_nodes[curr].neighbor;
+				} while( !m_nodes[curr].visited );
+
+				// pieces thinner than a nudge are where the input only touched
+				const double twice = area( vertices, offsets.back( ), vertices.size( ) );
+				if( vertices.size( ) - offsets.back( ) >= 3 &&
+				    std::abs( twice ) > m_nudge * perimeter( vertices, offsets.back( ), vertices.size( ) ) ) {
+					// an exit can lead round the other list backwards
+					if( twice < 0.0 ) {
+						std::reverse( vertices.begin( ) + offsets.back( ), vertices.end( ) );
+					}
+					offsets.push_back( vertices.size( ) );
+				}
+				else {
+					vertices.resize( offsets.back( ) );
+				}
+			}
+			idx = m_nodes[idx].next;
+		} while( idx != m_subject_head );
+	}
+
+	static void append( ring_t& vertices, unsigned int start, const point2<double>& pt ) {
+		point2<T> out{ round_to<T>( pt.x ), round_to<T>( pt.y ) };
+		if( vertices.size( ) == start || vertices.back( ) != out ) {
+			vertices.push_back( out );
+		}
+	}
+
+
+// Variables
+private:
+
+	ring_t                       m_buffer;   // Sutherland-Hodgman ping-pong
+	ring_t                       m_piece;    // single result for batches
+
+	std::vector<point2<double>>  m_subject;  // Greiner-Hormann working set
+	std::vector<point2<double>>  m_region;
+	std::vector<point2<double>>  m_subject_given;  // before nudging
+	std::vector<point2<double>>  m_region_given;
+	double                       m_nudge;
+	std::vector<edge_box>        m_boxes_s;  // boxes for the sweeps
+	std::vector<edge_box>        m_boxes_c;
+	std::vector<std::pair<unsigned int, unsigned int>>  m_near;  // vertex, edge pairs to nudge
+	std::vector<node>            m_nodes;
+	std::vector<crossing_rec>    m_crossings;
+	std::vector<unsigned int>    m_order;
+	unsigned int                 m_subject_head;
+	unsigned int                 m_region_head;
+
+}; // End class clipper<T>
+
+}  // End namespace euclib
+
+#endif // EUBLIB_CLIP_HPP
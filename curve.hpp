@@ -0,0 +1,409 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_CURVE_HPP
+#define EUBLIB_CURVE_HPP
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include "point.hpp"
+#include "euclib_parallel.hpp"
+
+#ifdef __BMI2__
+	#include <immintrin.h>
+#endif
+
+/*
+ * Space filling curve keys and sorting by them
+ *
+ *   A curve_box maps points inside it onto a grid of 2^bits cells a side,
+ *   bits being 64 / D (at most 32) so a key fits in 64 bits. Points
+ *   outside the box are clamped to its edge. Morton keys interleave the
+ *   cell coordinates [1], using BMI2 pdep when the compiler targets it.
+ *   Hilbert keys follow the curve of [2], which never jumps between cells
+ *   so neighbours in key order are neighbours in space.
+ *
+ *   radix_sort( ) sorts any payload by 32 or 64 bit keys, stably and in
+ *   parallel, skipping the bytes every key shares. spatial_sort( )
+ *   reorders points, and optionally a payload alongside them, by curve
+ *   key to restore locality before hull, index or neighbour passes.
+ *
+ * References
+ *   [1] G. M. Morton. "A computer oriented geodetic data base and a new
+ *         technique in file sequencing". IBM Technical Report, 1966.
+ *   [2] J. Skilling. "Programming the Hilbert curve". AIP Conference
+ *         Proceedings 707, pp. 381-387, 2004.
+ *   [3] V. Agafonkin. "Flatbush", https://github.com/mourner/flatbush
+ */
+
+namespace euclib {
+
+enum curve_type {
+	morton_curve,
+	hilbert_curve
+};
+
+namespace detail {
+
+	// spreads the low 16 bits of x to the even bits
+	inline uint32_t spread_bits( uint32_t x ) {
+		x = ( x | ( x << 8 ) ) & 0x00FF00FF;
+		x = ( x | ( x << 4 ) ) & 0x0F0F0F0F;
+		x = ( x | ( x << 2 ) ) & 0x33333333;
+		x = ( x | ( x << 1 ) ) & 0x55555555;
+		return x;
+	}
+
+	// spreads the 32 bits of x to the even bits
+	inline uint64_t spread_bits2( uint32_t x ) {
+		#ifdef __BMI2__
+			return _pdep_u64( x, 0x5555555555555555ull );
+		#else
+			uint64_t v = x;
+			v = ( v | ( v << 16 ) ) & 0x0000FFFF0000FFFFull;
+			v = ( v | ( v << 8 ) )  & 0x00FF00FF00FF00FFull;
+			v = ( v | ( v << 4 ) )  & 0x0F0F0F0F0F0F0F0Full;
+			v = ( v | ( v << 2 ) )  & 0x3333333333333333ull;
+			v = ( v | ( v << 1 ) )  & 0x5555555555555555ull;
+			return v;
+		#endif
+	}
+
+	// spreads the low 21 bits of x to every third bit
+	inline uint64_t spread_bits3( uint32_t x ) {
+		#ifdef __BMI2__
+			return _pdep_u64( x, 0x1249249249249249ull );
+		#else
+			uint64_t v = x & 0x1FFFFF;
+			v = ( v | ( v << 32 ) ) & 0x001F00000000FFFFull;
+			v = ( v | ( v << 16 ) ) & 0x001F0000FF0000FFull;
+			v = ( v | ( v << 8 ) )  & 0x100F00F00F00F00Full;
+			v = ( v | ( v << 4 ) )  & 0x10C30C30C30C30C3ull;
+			v = ( v | ( v << 2 ) )  & 0x1249249249249249ull;
+			return v;
+		#endif
+	}
+
+	// bit b of cell[a] goes to bit b * D + ( D - 1 - a )
+	template<std::size_t D> inline
+	uint64_t interleave( const std::array<uint32_t,D>& cell, unsigned int bits ) {
+		uint64_t key = 0;
+		for( unsigned int b = bits; b-- > 0; ) {
+			for( std::size_t a = 0; a < D; ++a ) { key = ( key << 1 ) | ( ( cell[a] >> b ) & 1 ); }
+		}
+		return key;
+	}
+
+	template<> inline
+	uint64_t interleave<2>( const std::array<uint32_t,2>& cell, unsigned int ) {
+		return ( spread_bits2( cell[0] ) << 1 ) | spread_bits2( cell[1] );
+	}
+
+	template<> inline
+	uint64_t interleave<3>( const std::array<uint32_t,3>& cell, unsigned int ) {
+		return ( spread_bits3( cell[0] ) << 2 ) | ( spread_bits3( cell[1] ) << 1 ) | spread_bits3( cell[2] );
+	}
+
+	// distance along a Hilbert curve through a 65536 x 65536 grid, with
+	//   no loop over the 16 levels of the curve [3]
+	inline uint32_t hilbert_index( uint32_t x, uint32_t y ) {
+		uint32_t a = x ^ y;
+		uint32_t b = 0xFFFF ^ a;
+		uint32_t c = 0xFFFF ^ ( x | y );
+		uint32_t d = x & ( y ^ 0xFFFF );
+
+		uint32_t A = a | ( b >> 1 );
+		uint32_t B = ( a >> 1 ) ^ a;
+		uint32_t C = ( ( c >> 1 ) ^ ( b & ( d >> 1 ) ) ) ^ c;
+		uint32_t D = ( ( a & ( c >> 1 ) ) ^ ( d >> 1 ) ) ^ d;
+
+		a = A; b = B; c = C; d = D;
+		A = ( a & ( a >> 2 ) ) ^ ( b & ( b >> 2 ) );
+		B = ( a & ( b >> 2 ) ) ^ ( b & ( ( a ^ b ) >> 2 ) );
+		C ^= ( a & ( c >> 2 ) ) ^ ( b & ( d >> 2 ) );
+		D ^= ( b & ( c >> 2 ) ) ^ ( ( a ^ b ) & ( d >> 2 ) );
+
+		a = A; b = B; c = C; d = D;
+		A = ( a & ( a >> 4 ) ) ^ ( b & ( b >> 4 ) );
+		B = ( a & ( b >> 4 ) ) ^ ( b & ( ( a ^ b ) >> 4 ) );
+		C ^= ( a & ( c >> 4 ) ) ^ ( b & ( d >> 4 ) );
+		D ^= ( b & ( c >> 4 ) ) ^ ( ( a ^ b ) & ( d >> 4 ) );
+
+		a = A; b = B; c = C; d = D;
+		C ^= ( a & ( c >> 8 ) ) ^ ( b & ( d >> 8 ) );
+		D ^= ( b & ( c >> 8 ) ) ^ ( ( a ^ b ) & ( d >> 8 ) );
+
+		a = C ^ ( C >> 1 );
+		b = D ^ ( D >> 1 );
+
+		uint32_t i0 = x ^ y;
+		uint32_t i1 = b | ( 0xFFFF ^ ( i0 | a ) );
+		return ( spread_bits( i1 & 0xFFFF ) << 1 ) | spread_bits( i0 & 0xFFFF );
+	}
+
+	// Hilbert distance of 'cell' on a grid of 2^bits a side, by turning
+	//   the coordinates into the curve's transposed form [2]
+	template<std::size_t D> inline
+	uint64_t hilbert_index( std::array<uint32_t,D> cell, unsigned int bits ) {
+		const uint32_t top = uint32_t(1) << ( bits - 1 );
+		for( uint32_t q = top; q > 1; q >>= 1 ) {
+			const uint32_t p = q - 1;
+			for( std::size_t a = 0; a < D; ++a ) {
+				// invert the low bits of cell[0] if bit q is set, else swap
+				//   them with cell[a], without branching
+				uint32_t set = 0u - uint32_t( ( cell[a] & q ) != 0 );
+				uint32_t t = ( cell[0] ^ cell[a] ) & p & ~set;
+				cell[0] ^= ( p & set ) | t;
+				cell[a] ^= t;
+			}
+		}
+		for( std::size_t a = 1; a < D; ++a ) { cell[a] ^= cell[a - 1]; }
+		uint32_t t = 0;
+		for( uint32_t q = top; q > 1; q >>= 1 ) {
+			if( cell[D - 1] & q ) { t ^= q - 1; }
+		}
+		for( std::size_t a = 0; a < D; ++a ) { cell[a] ^= t; }
+		return interleave<D>( cell, bits );
+	}
+
+} // End namespace detail
+
+
+template<typename T, std::size_t D>
+class curve_box {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+	static_assert( D >= 1 && D <= 64, "keys hold at most 64 axes" );
+
+public:
+
+	// grid bits a side
+	static const unsigned int bits = 64 / D > 32 ? 32 : 64 / D;
+
+
+// Variables
+private:
+
+	std::array<double,D>  m_low;
+	std::array<double,D>  m_scale;
+
+
+// Constructors
+public:
+
+	curve_box( ) {
+		m_low.fill( 0.0 );
+		m_scale.fill( 1.0 );
+	}
+
+	curve_box( const point<T,D>& low, const point<T,D>& high ) {
+		set( low, high );
+	}
+
+	// the bounding box of 'points'
+	explicit curve_box( const std::vector<point<T,D>>& points ) {
+		if( points.empty( ) ) {
+			m_low.fill( 0.0 );
+			m_scale.fill( 1.0 );
+			return;
+		}
+		point<T,D> low = points[0], high = points[0];
+		for( std::size_t i = 1; i < points.size( ); ++i ) {
+			for( std::size_t a = 0; a < D; ++a ) {
+				low[a] = std::min( low[a], points[i][a] );
+				high[a] = std::max( high[a], points[i][a] );
+			}
+		}
+		set( low, high );
+	}
+
+
+// Methods
+public:
+
+	void set( const point<T,D>& low, const point<T,D>& high ) {
+		const double cells = double( ( uint64_t(1) << bits ) - 1 );
+		for( std::size_t a = 0; a < D; ++a ) {
+			m_low[a] = low[a];
+			double extent = double(high[a]) - double(low[a]);
+			m_scale[a] = extent > 0.0 ? cells / extent : 0.0;
+		}
+	}
+
+	// grid cell of 'pt', clamped to the box
+	std::array<uint32_t,D> cell( const point<T,D>& pt ) const {
+		const double top = double( ( uint64_t(1) << bits ) - 1 );
+		std::array<uint32_t,D> result;
+		for( std::size_t a = 0; a < D; ++a ) {
+			double c = ( double(pt[a]) - m_low[a] ) * m_scale[a];
+			result[a] = c > 0.0 ? uint32_t( std::min( c, top ) ) : 0;
+		}
+		return result;
+	}
+
+}; // End class curve_box
+
+template<typename T, std::size_t D>
+const unsigned int curve_box<T,D>::bits;
+
+
+template<typename T, std::size_t D> inline
+uint64_t morton_key( const point<T,D>& pt, const curve_box<T,D>& box ) {
+	return detail::interleave<D>( box.cell( pt ), curve_box<T,D>::bits );
+}
+
+template<typename T, std::size_t D> inline
+uint64_t hilbert_key( const point<T,D>& pt, const curve_box<T,D>& box ) {
+	return detail::hilbert_index<D>( box.cell( pt ), curve_box<T,D>::bits );
+}
+
+// key of every point, 'threads' as for parallel_for( )
+template<typename T, std::size_t D>
+void curve_keys( const std::vector<point<T,D>>& points, const curve_box<T,D>& box,
+                 std::vector<uint64_t>& keys, curve_type curve = hilbert_curve,
+                 unsigned int threads = 0 ) {
+	keys.resize( points.size( ) );
+	if( curve == morton_curve ) {
+		parallel_for( 0, points.size( ), [&]( unsigned int i ) {
+			keys[i] = morton_key( points[i], box );
+		}, threads, 4096 );
+	}
+	else {
+		parallel_for( 0, points.size( ), [&]( unsigned int i ) {
+			keys[i] = hilbert_key( points[i], box );
+		}, threads, 4096 );
+	}
+}
+
+// sorts 'keys' and moves 'values' with them, equal keys keeping their
+//   order. K is an unsigned integer, a byte is sorted per pass.
+template<typename K, typename V>
+void radix_sort( std::vector<K>& keys, std::vector<V>& values, unsigned int threads = 0 ) {
+	const unsigned int n = keys.size( );
+	if( n < 2 ) { return; }
+	if( threads == 0 ) { threads = default_threads( ); }
+	#ifdef EUCLIB_NO_THREADS
+		threads = 1;
+	#endif
+
+	// each chunk is counted and scattered by one worker
+	const unsigned int chunks = std::max( 1u, std::min( 4 * threads, n / 65536 ) );
+	const unsigned int chunk = ( n + chunks - 1 ) / chunks;
+
+	// bytes where the keys differ
+	std::vector<K> any( chunks, 0 ), all( chunks, ~K(0) );
+	parallel_for( 0, chunks, [&]( unsigned int c ) {
+		for( unsigned int i = c * chunk, e = std::min( n, i + chunk ); i < e; ++i ) {
+			any[c] |= keys[i];
+			all[c] &= keys[i];
+		}
+	}, threads, 1 );
+	K any_bits = 0, all_bits = ~K(0);
+	for( unsigned int c = 0; c < chunks; ++c ) {
+		any_bits |= any[c];
+		all_bits &= all[c];
+	}
+	const K differ = any_bits ^ all_bits;
+
+	std::vector<K> keys2( n );
+	std::vector<V> values2( n );
+	std::vector<unsigned int> offset( 256 * chunks );
+	for( unsigned int shift = 0; shift < 8 * sizeof(K); shift += 8 ) {
+		if( ( ( differ >> shift ) & 0xFF ) == 0 ) { continue; }
+
+		parallel_for( 0, chunks, [&]( unsigned int c ) {
+			unsigned int* count = &offset[256 * c];
+			std::fill( count, count + 256, 0 );
+			for( unsigned int i = c * chunk, e = std::min( n, i + chunk ); i < e; ++i ) {
+				++count[( keys[i] >> shift ) & 0xFF];
+			}
+		}, threads, 1 );
+
+		// digits in order, chunks in order within a digit, keeps it stable
+		unsigned int sum = 0;
+		for( unsigned int digit = 0; digit < 256; ++digit ) {
+			for( unsigned int c = 0; c < chunks; ++c ) {
+				unsigned int count = offset[256 * c + digit];
+				offset[256 * c + digit] = sum;
+				sum += count;
+			}
+		}
+
+		parallel_for( 0, chunks, [&]( unsigned int c ) {
+			unsigned int* next = &offset[256 * c];
+			for( unsigned int i = c * chunk, e = std::min( n, i + chunk ); i < e; ++i ) {
+				unsigned int pos = next[( keys[i] >> shift ) & 0xFF]++;
+				keys2[pos] = keys[i];
+				values2[pos] = std::move( values[i] );
+			}
+		}, threads, 1 );
+		keys.swap( keys2 );
+		values.swap( values2 );
+	}
+}
+
+// positions of 'points' in curve order: points[order[0]] comes first
+template<typename T, std::size_t D>
+void spatial_order( const std::vector<point<T,D>>& points, std::vector<unsigned int>& order,
+                    curve_type curve = hilbert_curve, unsigned int threads = 0 ) {
+	std::vector<uint64_t> keys;
+	curve_keys( points, curve_box<T,D>( points ), keys, curve, threads );
+	order.resize( points.size( ) );
+	for( unsigned int i = 0; i < order.size( ); ++i ) { order[i] = i; }
+	radix_sort( keys, order, threads );
+}
+
+// reorders 'points' along the curve through their bounding box
+template<typename T, std::size_t D>
+void spatial_sort( std::vector<point<T,D>>& points, curve_type curve = hilbert_curve,
+                   unsigned int threads = 0 ) {
+	std::vector<uint64_t> keys;
+	curve_keys( points, curve_box<T,D>( points ), keys, curve, threads );
+	radix_sort( keys, points, threads );
+}
+
+// reorders 'points' and 'payload', one value per point, together
+template<typename T, std::size_t D, typename V>
+void spatial_sort( std::vector<point<T,D>>& points, std::vector<V>& payload,
+                   curve_type curve = hilbert_curve, unsigned int threads = 0 ) {
+	std::vector<unsigned int> order;
+	spatial_order( points, order, curve, threads );
+	std::vector<point<T,D>> sorted_points( points.size( ) );
+	std::vector<V> sorted_payload( payload.size( ) );
+	parallel_for( 0, order.size( ), [&]( unsigned int i ) {
+		sorted_points[i] = std::move( points[order[i]] );
+		sorted_payload[i] = std::move( payload[order[i]] );
+	}, threads, 4096 );
+	points.swap( sorted_points );
+	payload.swap( sorted_payload );
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_CURVE_HPP
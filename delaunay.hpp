@@ -0,0 +1,682 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_DELAUNAY_HPP
+#define EUBLIB_DELAUNAY_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <cstdint>
+#include <cmath>
+#include "point.hpp"
+#include "euclib_parallel.hpp"
+#include "curve.hpp"
+#include "predicates.hpp"
+
+/*
+ * Delaunay triangulation of point2 sets
+ *
+ *   Points are inserted one at a time [1], each replacing the triangles
+ *   whose circumcircle holds it with a fan around it. Triangles outside
+ *   the hull are kept as ghost triangles with a vertex at infinity, so
+ *   points beyond the hull need no special case. The insertion order is
+ *   biased randomized [2]: rounds of doubling size, each along a Hilbert
+ *   curve, so every point is found by a short walk from the last one
+ *   while the expected work stays O(n log n).
+ *
+ *   orient2d( ) and incircle( ) are exact, and points on a common circle
+ *   are resolved by symbolic perturbation [3] in order of input index,
+ *   so the triangulation is unique for any input, with no two triangles
+ *   disagreeing about degenerate cases.
+ *
+ *   With more than one thread and enough points, the points are cut into
+ *   vertical strips triangulated in parallel. A strip triangle whose
+ *   circumcircle stays inside the strip's slab is also a triangle of the
+ *   whole set. The others, near the seams, are retriangulated together
+ *   with the strip hulls, and that triangulation fills the gaps between
+ *   the kept triangles. As the triangulation is unique, this gives the
+ *   same triangles as one thread, though stored in another order.
+ *
+ *   The output is two arrays indexed by half edge, as in [4]: triangle t
+ *   is half edges 3t, 3t+1 and 3t+2, counterclockwise, triangles( )[e]
+ *   is the input index of the point half edge e starts at, and
+ *   halfedges( )[e] is the opposite half edge, or npos on the hull.
+ *   Duplicate points are left out of the triangles, as are all points
+ *   when they are collinear.
+ *
+ * References
+ *   [1] A. Bowyer. "Computing Dirichlet tessellations". The Computer
+ *         Journal, 24(2), pp. 162-166, 1981.
+ *   [2] N. Amenta, S. Choi, G. Rote. "Incremental constructions con
+ *         BRIO". Proceedings of the 19th Annual Symposium on
+ *         Computational Geometry, pp. 211-219, 2003.
+ *   [3] H. Edelsbrunner, E. P. Mucke. "Simulation of Simplicity". ACM
+ *         Transactions on Graphics, 9(1), pp. 66-104, 1990.
+ *   [4] V. Agafonkin. "Delaunator", https://github.com/mapbox/delaunator
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	// no triangle, or no opposite half edge
+	const unsigned int delaunay_npos = ~0u;
+
+	// triangulates the points 'order' names from the x, y pairs 'coords',
+	//   in that order, leaving global indices in triangles and halfedges
+	class delaunay_builder {
+	// Variables
+	public:
+
+		std::vector<unsigned int>  triangles;
+		std::vector<unsigned int>  halfedges;
+
+	private:
+
+		std::vector<double>        m_xy;        // local, 2 per point
+		std::vector<unsigned int>  m_id;        // global index of each local point
+		std::vector<unsigned int>  m_tri;       // 3 per triangle, ghosts too
+		std::vector<unsigned int>  m_twin;
+		std::vector<unsigned int>  m_stamp;     // per triangle, see insert( )
+		std::vector<unsigned int>  m_link;      // per point, a new triangle
+		std::vector<unsigned int>  m_stack;
+		std::vector<unsigned int>  m_cavity;
+		std::vector<unsigned int>  m_boundary;  // x, y and outside twin of each edge
+		unsigned int               m_inf;       // the vertex at infinity
+		unsigned int               m_last;      // where the next walk starts
+		unsigned int               m_mark;
+		uint32_t                   m_random;
+
+	// Methods
+	public:
+
+		void build( const double* coords, const unsigned int* order, unsigned int count ) {
+			triangles.clear( );
+			halfedges.clear( );
+			m_xy.resize( 2 * std::size_t(count) );
+			m_id.assign( order, order + count );
+			for( unsigned int i = 0; i < count; ++i ) {
+				m_xy[2 * i] = coords[2 * std::size_t(order[i])];
+				m_xy[2 * i + 1] = coords[2 * std::size_t(order[i]) + 1];
+			}
+			m_inf = count;
+			m_mark = 0;
+			m_random = 2463534242u;
+			m_tri.clear( );
+			m_twin.clear( );
+			m_stamp.clear( );
+			m_link.assign( count + 1, 0 );
+			m_tri.reserve( 6 * std::size_t(count) + 12 );
+			m_twin.reserve( 6 * std::size_t(count) + 12 );
+			m_stamp.reserve( 2 * std::size_t(count) + 4 );
+
+			// the first three points not on a line
+			unsigned int a = 0, b = 1, c = delaunay_npos;
+			while( b < count && same( a, b ) ) { ++b; }
+			for( unsigned int i = b + 1; i < count && c == delaunay_npos; ++i ) {
+				if( orient( a, b, i ) != 0.0 ) { c = i; }
+			}
+			if( c == delaunay_npos ) { return; }
+			if( orient( a, b, c ) < 0.0 ) { start( a, c, b ); }
+			else { start( a, b, c ); }
+
+			for( unsigned int i = 0; i < count; ++i ) {
+				if( i != a && i != b && i != c ) { insert( i ); }
+			}
+			finish( );
+		}
+
+	private:
+
+		static unsigned int next( unsigned int e ) { return e % 3 == 2 ? e - 2 : e + 1; }
+
+		bool same( unsigned int a, unsigned int b ) const {
+			return m_xy[2 * a] == m_xy[2 * b] && m_xy[2 * a + 1] == m_xy[2 * b + 1];
+		}
+
+		double orient( unsigned int a, unsigned int b, unsigned int c ) const {
+			return orient2d( m_xy[2 * a], m_xy[2 * a + 1], m_xy[2 * b], m_xy[2 * b + 1],
+			                 m_xy[2 * c], m_xy[2 * c + 1] );
+		}
+
+		// d inside the circle of counterclockwise a, b, c, ties broken by
+		//   lifting each point by a perturbation that is larger for lower
+		//   input indices
+		bool in_circle( unsigned int a, unsigned int b, unsigned int c, unsigned int d ) const {
+			double det = incircle( m_xy[2 * a], m_xy[2 * a + 1], m_xy[2 * b], m_xy[2 * b + 1],
+			                       m_xy[2 * c], m_xy[2 * c + 1], m_xy[2 * d], m_xy[2 * d + 1] );
+			if( det != 0.0 ) { return det > 0.0; }
+			unsigned int p[4] = { a, b, c, d };
+			std::sort( p, p + 4, [this]( unsigned int i, unsigned int j ) { return m_id[i] < m_id[j]; } );
+			for( unsigned int i = 0; i < 4; ++i ) {
+				double term;
+				if( p[i] == a ) { term = orient( b, c, d ); }
+				else if( p[i] == b ) { term = orient( c, a, d ); }
+				else if( p[i] == c ) { term = orient( a, b, d ); }
+				else { term = -orient( a, b, c ); }
+				if( term != 0.0 ) { return term > 0.0; }
+			}
+			return false;
+		}
+
+		// position of the vertex at infinity in t, or 3 for none
+		unsigned int ghost( unsigned int t ) const {
+			for( unsigned int k = 0; k < 3; ++k ) {
+				if( m_tri[3 * t + k] == m_inf ) { return k; }
+			}
+			return 3;
+		}
+
+		bool conflict( unsigned int t, unsigned int p ) const {
+			const unsigned int k = ghost( t );
+			if( k == 3 ) { return in_circle( m_tri[3 * t], m_tri[3 * t + 1], m_tri[3 * t + 2], p ); }
+
+			// beyond the hull edge x, y, or on it between the two
+			const unsigned int x = m_tri[3 * t + ( k + 1 ) % 3], y = m_tri[3 * t + ( k + 2 ) % 3];
+			const double o = orient( x, y, p );
+			if( o != 0.0 ) { return o > 0.0; }
+			const unsigned int axis = m_xy[2 * x] != m_xy[2 * y] ? 0 : 1;
+			const double px = m_xy[2 * p + axis], xx = m_xy[2 * x + axis], yx = m_xy[2 * y + axis];
+			return ( xx < px && px < yx ) || ( yx < px && px < xx );
+		}
+
+		unsigned int add_triangle( unsigned int a, unsigned int b, unsigned int c ) {
+			const unsigned int t = m_stamp.size( );
+			m_tri.push_back( a );
+			m_tri.push_back( b );
+			m_tri.push_back( c );
+			m_twin.resize( m_tri.size( ), delaunay_npos );
+			m_stamp.push_back( 0 );
+			return t;
+		}
+
+		void start( unsigned int a, unsigned int b, unsigned int c ) {
+			add_triangle( a, b, c );
+			const unsigned int v[3] = { a, b, c };
+			for( unsigned int k = 0; k < 3; ++k ) {
+				const unsigned int g = add_triangle( v[( k + 1 ) % 3], v[k], m_inf );
+				m_twin[k] = 3 * g;
+				m_twin[3 * g] = k;
+				m_link[v[( k + 1 ) % 3]] = g;
+			}
+			// ghost x, y, inf: y to inf meets inf to y of the ghost starting at y
+			for( unsigned int g = 1; g <= 3; ++g ) {
+				const unsigned int h = m_link[m_tri[3 * g + 1]];
+				m_twin[3 * g + 1] = 3 * h + 2;
+				m_twin[3 * h + 2] = 3 * g + 1;
+			}
+			m_last = 0;
+		}
+
+		// a triangle in conflict with p, or none if p is already a vertex
+		unsigned int locate( unsigned int p ) {
+			unsigned int t = m_last;
+			const unsigned int k = ghost( t );
+			if( k != 3 ) { t = m_twin[3 * t + ( k + 1 ) % 3] / 3; }
+			for( ;; ) {
+				if( ghost( t ) != 3 ) { return t; }
+				m_random ^= m_random << 13;
+				m_random ^= m_random >> 17;
+				m_random ^= m_random << 5;
+				const unsigned int r = m_random % 3;
+				bool moved = false;
+				for( unsigned int j = 0; j < 3 && !moved; ++j ) {
+					const unsigned int e = 3 * t + ( r + j ) % 3;
+					if( orient( m_tri[e], m_tri[next( e )], p ) < 0.0 ) {
+						t = m_twin[e] / 3;
+						moved = true;
+					}
+				}
+				if( moved ) { continue; }
+				for( unsigned int j = 0; j < 3; ++j ) {
+					if( same( m_tri[3 * t + j], p ) ) { return delaunay_npos; }
+				}
+				return t;
+			}
+		}
+
+		void insert( unsigned int p ) {
+			const unsigned int first = locate( p );
+			if( first == delaunay_npos ) { return; }
+			m_mark += 2;
+			const unsigned int inside = m_mark, outside = m_mark + 1;
+
+			m_cavity.clear( );
+			m_boundary.clear( );
+			m_stack.assign( 1, first );
+			m_stamp[first] = inside;
+			while( !m_stack.empty( ) ) {
+				const unsigned int t = m_stack.back( );
+				m_stack.pop_back( );
+				m_cavity.push_back( t );
+				for( unsigned int e = 3 * t; e < 3 * t + 3; ++e ) {
+					const unsigned int n = m_twin[e] / 3;
+					if( m_stamp[n] != inside && m_stamp[n] != outside ) {
+						if( conflict( n, p ) ) {
+							m_stamp[n] = inside;
+							m_stack.push_back( n );
+							continue;
+						}
+						m_stamp[n] = outside;
+					}
+					if( m_stamp[n] == outside ) {
+						m_boundary.push_back( m_tri[e] );
+						m_boundary.push_back( m_tri[next( e )] );
+						m_boundary.push_back( m_twin[e] );
+					}
+				}
+			}
+
+			// one triangle per boundary edge, reusing the cavity's
+			const unsigned int edges = m_boundary.size( ) / 3;
+			unsigned int last = delaunay_npos;
+			for( unsigned int i = 0; i < edges; ++i ) {
+				const unsigned int x = m_boundary[3 * i], y = m_boundary[3 * i + 1];
+				const unsigned int o = m_boundary[3 * i + 2];
+				unsigned int t;
+				if( i < m_cavity.size( ) ) {
+					t = m_cavity[i];
+					m_tri[3 * t] = x;
+					m_tri[3 * t + 1] = y;
+					m_tri[3 * t + 2] = p;
+				}
+				else {
+					t = add_triangle( x, y, p );
+				}
+				m_twin[3 * t] = o;
+				m_twin[o] = 3 * t;
+				m_link[x] = t;
+				if( x != m_inf && y != m_inf ) { last = t; }
+				m_boundary[3 * i + 2] = t;
+			}
+			for( unsigned int i = 0; i < edges; ++i ) {
+				const unsigned int t = m_boundary[3 * i + 2];
+				const unsigned int h = m_link[m_boundary[3 * i + 1]];
+				m_twin[3 * t + 1] = 3 * h + 2;
+				m_twin[3 * h + 2] = 3 * t + 1;
+			}
+			m_last = last;
+		}
+
+		// finite triangles only, in global indices
+		void finish( ) {
+			const unsigned int total = m_stamp.size( );
+			std::vector<unsigned int> index( total, delaunay_npos );
+			unsigned int count = 0;
+			for( unsigned int t = 0; t < total; ++t ) {
+				if( ghost( t ) == 3 ) { index[t] = count++; }
+			}
+			triangles.resize( 3 * std::size_t(count) );
+			halfedges.resize( 3 * std::size_t(count) );
+			for( unsigned int t = 0; t < total; ++t ) {
+				if( index[t] == delaunay_npos ) { continue; }
+				for( unsigned int k = 0; k < 3; ++k ) {
+					const unsigned int e = 3 * t + k, o = m_twin[e];
+					triangles[3 * index[t] + k] = m_id[m_tri[e]];
+					halfedges[3 * index[t] + k] = index[o / 3] == delaunay_npos ? delaunay_npos : 3 * index[o / 3] + o % 3;
+				}
+			}
+			std::vector<double>( ).swap( m_xy );
+			std::vector<unsigned int>( ).swap( m_tri );
+			std::vector<unsigned int>( ).swap( m_twin );
+			std::vector<unsigned int>( ).swap( m_stamp );
+			std::vector<unsigned int>( ).swap( m_link );
+		}
+	}; // End class delaunay_builder
+
+} // End namespace detail
+
+template<typename T>
+class delaunay {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with floating point types
+	static_assert( !limit_t::is_integer, "delaunay needs a floating point type" );
+
+	// fewest points worth cutting into strips, per strip
+	static const unsigned int strip_points = 32768;
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+
+// Variables
+private:
+
+	std::vector<point2<T>>     m_points;
+	std::vector<unsigned int>  m_triangles;   // 3 per triangle, a point index per half edge
+	std::vector<unsigned int>  m_halfedges;   // opposite half edge, npos on the hull
+
+
+// Constructors
+public:
+
+	delaunay( ) { }
+
+	// 'threads' as for parallel_for( ), 0 for one per core
+	explicit delaunay( const std::vector<point2<T>>& points, unsigned int threads = 0 ) {
+		build( points, threads );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const { return m_triangles.size( ) / 3; }
+	bool empty( ) const        { return m_triangles.empty( ); }
+
+	const std::vector<point2<T>>& points( ) const        { return m_points; }
+	const std::vector<unsigned int>& triangles( ) const  { return m_triangles; }
+	const std::vector<unsigned int>& halfedges( ) const  { return m_halfedges; }
+
+	static unsigned int next_halfedge( unsigned int e ) { return e % 3 == 2 ? e - 2 : e + 1; }
+	static unsigned int prev_halfedge( unsigned int e ) { return e % 3 == 0 ? e + 2 : e - 1; }
+
+	void build( const std::vector<point2<T>>& points, unsigned int threads = 0 ) {
+		m_points = points;
+		m_triangles.clear( );
+		m_halfedges.clear( );
+		const unsigned int n = points.size( );
+		if( n < 3 ) { return; }
+		if( threads == 0 ) { threads = default_threads( ); }
+		#ifdef EUCLIB_NO_THREADS
+			threads = 1;
+		#endif
+
+		std::vector<double> coords( 2 * std::size_t(n) );
+		parallel_for( 0, n, [&]( unsigned int i ) {
+			coords[2 * i] = points[i].x;
+			coords[2 * i + 1] = points[i].y;
+		}, threads, 4096 );
+		std::vector<unsigned int> order;
+		insertion_order( coords, order, threads );
+
+		const unsigned int strips = std::min( threads, n / strip_points );
+		if( strips > 1 && build_strips( coords, order, strips, threads ) ) { return; }
+
+		detail::delaunay_builder builder;
+		builder.build( coords.data( ), order.data( ), n );
+		m_triangles.swap( builder.triangles );
+		m_halfedges.swap( builder.halfedges );
+	}
+
+	// the hull, counterclockwise, as point indices
+	void hull( std::vector<unsigned int>& result ) const {
+		result.clear( );
+		std::vector<std::pair<unsigned int, unsigned int>> edges;
+		for( unsigned int e = 0; e < m_halfedges.size( ); ++e ) {
+			if( m_halfedges[e] == npos ) {
+				edges.push_back( std::make_pair( m_triangles[e], m_triangles[next_halfedge( e )] ) );
+			}
+		}
+		if( edges.empty( ) ) { return; }
+		std::sort( edges.begin( ), edges.end( ) );
+		unsigned int v = edges[0].first;
+		do {
+			result.push_back( v );
+			v = std::lower_bound( edges.begin( ), edges.end( ), std::make_pair( v, 0u ) )->second;
+		} while( v != edges[0].first && result.size( ) <= edges.size( ) );
+	}
+
+private:
+
+	// rounds of doubling size chosen by a hash of the index, each along a
+	//   Hilbert curve through the points' bounding box
+	static void insertion_order( const std::vector<double>& coords, std::vector<unsigned int>& order,
+	                             unsigned int threads ) {
+		const unsigned int n = coords.size( ) / 2;
+		double l = std::numeric_limits<double>::max( ), t = l, r = -l, b = -l;
+		for( unsigned int i = 0; i < n; ++i ) {
+			l = std::min( l, coords[2 * i] );
+			r = std::max( r, coords[2 * i] );
+			t = std::min( t, coords[2 * i + 1] );
+			b = std::max( b, coords[2 * i + 1] );
+		}
+		const double sx = r > l ? 65535.0 / ( r - l ) : 0.0;
+		const double sy = b > t ? 65535.0 / ( b - t ) : 0.0;
+		unsigned int rounds = 1;
+		while( rounds < 32 && ( n >> rounds ) >= 64 ) { ++rounds; }
+
+		std::vector<uint64_t> keys( n );
+		order.resize( n );
+		parallel_for( 0, n, [&]( unsigned int i ) {
+			uint32_t h = i * 2654435761u;
+			h ^= h >> 15;
+			h *= 0x2C1B3C6Du;
+			h ^= h >> 12;
+			unsigned int round = rounds - 1;
+			while( round > 0 && ( h & 1 ) == 0 ) {
+				--round;
+				h >>= 1;
+			}
+			const uint32_t curve = detail::hilbert_index( uint32_t( ( coords[2 * i] - l ) * sx ),
+			                                              uint32_t( ( coords[2 * i + 1] - t ) * sy ) );
+			keys[i] = ( uint64_t(round) << 32 ) | curve;
+			order[i] = i;
+		}, threads, 4096 );
+		radix_sort( keys, order, threads );
+	}
+
+	// strips triangulated in parallel, then the seams. Returns false if
+	//   the pieces do not fit, which exact predicates should never allow,
+	//   leaving the caller to build serially.
+	bool build_strips( const std::vector<double>& coords, const std::vector<unsigned int>& order,
+	                   unsigned int strips, unsigned int threads ) {
+		typedef std::unordered_map<uint64_t, unsigned int> edge_map;
+		const unsigned int n = order.size( );
+
+		// cut at quantiles of x from a sample
+		std::vector<double> sample;
+		for( unsigned int i = 0; i < n; i += std::max( 1u, n / 8192 ) ) { sample.push_back( coords[2 * i] ); }
+		std::sort( sample.begin( ), sample.end( ) );
+		std::vector<double> cuts( strips - 1 );
+		for( unsigned int s = 1; s < strips; ++s ) { cuts[s - 1] = sample[s * sample.size( ) / strips]; }
+
+		std::vector<std::vector<unsigned int>> members( strips );
+		std::vector<double> low( strips, std::numeric_limits<double>::infinity( ) );
+		std::vector<double> high( strips, -std::numeric_limits<double>::infinity( ) );
+		for( unsigned int i = 0; i < n; ++i ) {
+			const unsigned int p = order[i];
+			const double x = coords[2 * p];
+			const unsigned int s = std::upper_bound( cuts.begin( ), cuts.end( ), x ) - cuts.begin( );
+			members[s].push_back( p );
+			low[s] = std::min( low[s], x );
+			high[s] = std::max( high[s], x );
+		}
+
+		// the open slab around each strip holding no other strip's points
+		std::vector<double> slab_low( strips ), slab_high( strips );
+		double edge = -std::numeric_limits<double>::infinity( );
+		for( unsigned int s = 0; s < strips; ++s ) {
+			slab_low[s] = edge;
+			edge = std::max( edge, high[s] );
+		}
+		edge = std::numeric_limits<double>::infinity( );
+		for( unsigned int s = strips; s-- > 0; ) {
+			slab_high[s] = edge;
+			edge = std::min( edge, low[s] );
+		}
+
+		std::vector<detail::delaunay_builder> builders( strips );
+		std::vector<std::vector<unsigned char>> final( strips );
+		std::vector<unsigned char> seam( n, 0 ), used( n, 0 );
+		parallel_for( 0, strips, [&]( unsigned int s ) {
+			builders[s].build( coords.data( ), members[s].data( ), members[s].size( ) );
+			const std::vector<unsigned int>& tri = builders[s].triangles;
+			const std::vector<unsigned int>& twin = builders[s].halfedges;
+			final[s].assign( tri.size( ) / 3, 0 );
+			for( unsigned int t = 0; t < tri.size( ) / 3; ++t ) {
+				final[s][t] = inside_slab( coords, &tri[3 * t], slab_low[s], slab_high[s] );
+				for( unsigned int k = 0; k < 3; ++k ) {
+					used[tri[3 * t + k]] = 1;
+					if( !final[s][t] || twin[3 * t + k] == npos ) { seam[tri[3 * t + k]] = 1; }
+					if( twin[3 * t + k] == npos ) { seam[tri[3 * t + next_halfedge( k )]] = 1; }
+				}
+			}
+		}, threads, 1 );
+
+		// the seam points, in insertion order
+		std::vector<unsigned int> seam_order;
+		for( unsigned int i = 0; i < n; ++i ) {
+			if( seam[order[i]] || !used[order[i]] ) { seam_order.push_back( order[i] ); }
+		}
+		detail::delaunay_builder joint;
+		joint.build( coords.data( ), seam_order.data( ), seam_order.size( ) );
+		const std::vector<unsigned int>& jtri = joint.triangles;
+		const std::vector<unsigned int>& jtwin = joint.halfedges;
+		edge_map jedges;
+		jedges.reserve( jtri.size( ) );
+		for( unsigned int e = 0; e < jtri.size( ); ++e ) {
+			jedges[key( jtri[e], jtri[next_halfedge( e )] )] = e;
+		}
+
+		// kept triangles get the first places, strip by strip
+		std::vector<unsigned int> first( strips + 1, 0 );
+		std::vector<std::vector<unsigned int>> place( strips );
+		for( unsigned int s = 0; s < strips; ++s ) {
+			place[s].assign( final[s].size( ), npos );
+			unsigned int count = first[s];
+			for( unsigned int t = 0; t < final[s].size( ); ++t ) {
+				if( final[s][t] ) { place[s][t] = count++; }
+			}
+			first[s + 1] = count;
+		}
+
+		// edges between kept and not, by the kept side's half edge
+		edge_map border;
+		for( unsigned int s = 0; s < strips; ++s ) {
+			const std::vector<unsigned int>& tri = builders[s].triangles;
+			const std::vector<unsigned int>& twin = builders[s].halfedges;
+			for( unsigned int e = 0; e < tri.size( ); ++e ) {
+				if( !final[s][e / 3] || ( twin[e] != npos && final[s][twin[e] / 3] ) ) { continue; }
+				border[key( tri[e], tri[next_halfedge( e )] )] = 3 * place[s][e / 3] + e % 3;
+			}
+		}
+
+		// the rest is what the seam triangulation has between the borders
+		std::vector<unsigned int> fill( jtri.size( ) / 3, npos );
+		std::vector<unsigned int> stack;
+		unsigned int filled = first[strips];
+		if( first[strips] == 0 ) {
+			for( unsigned int t = 0; t < fill.size( ); ++t ) { fill[t] = filled++; }
+		}
+		for( edge_map::const_iterator itr = border.begin( ); itr != border.end( ); ++itr ) {
+			const unsigned int a = itr->first >> 32, b = itr->first & 0xFFFFFFFF;
+			edge_map::const_iterator other = jedges.find( key( b, a ) );
+			if( other == jedges.end( ) ) {
+				// only a hull edge of everything has no other side
+				edge_map::const_iterator same = jedges.find( itr->first );
+				if( same == jedges.end( ) || jtwin[same->second] != npos ) { return false; }
+				continue;
+			}
+			if( fill[other->second / 3] != npos ) { continue; }
+			fill[other->second / 3] = filled++;
+			stack.assign( 1, other->second / 3 );
+			while( !stack.empty( ) ) {
+				const unsigned int t = stack.back( );
+				stack.pop_back( );
+				for( unsigned int e = 3 * t; e < 3 * t + 3; ++e ) {
+					const unsigned int o = jtwin[e];
+					if( o == npos || fill[o / 3] != npos ||
+					    border.count( key( jtri[next_halfedge( e )], jtri[e] ) ) ) {
+						continue;
+					}
+					fill[o / 3] = filled++;
+					stack.push_back( o / 3 );
+				}
+			}
+		}
+
+		m_triangles.resize( 3 * std::size_t(filled) );
+		m_halfedges.resize( 3 * std::size_t(filled) );
+		bool fits = true;
+		parallel_for( 0, strips, [&]( unsigned int s ) {
+			const std::vector<unsigned int>& tri = builders[s].triangles;
+			const std::vector<unsigned int>& twin = builders[s].halfedges;
+			for( unsigned int e = 0; e < tri.size( ); ++e ) {
+				if( !final[s][e / 3] ) { continue; }
+				const unsigned int to = 3 * place[s][e / 3] + e % 3;
+				m_triangles[to] = tri[e];
+				if( twin[e] != npos && final[s][twin[e] / 3] ) {
+					m_halfedges[to] = 3 * place[s][twin[e] / 3] + twin[e] % 3;
+					continue;
+				}
+				edge_map::const_iterator other = jedges.find( key( tri[next_halfedge( e )], tri[e] ) );
+				if( other == jedges.end( ) ) { m_halfedges[to] = npos; }
+				else if( fill[other->second / 3] == npos ) { fits = false; }
+				else { m_halfedges[to] = 3 * fill[other->second / 3] + other->second % 3; }
+			}
+		}, threads, 1 );
+		for( unsigned int e = 0; e < jtri.size( ); ++e ) {
+			if( fill[e / 3] == npos ) { continue; }
+			const unsigned int to = 3 * fill[e / 3] + e % 3;
+			m_triangles[to] = jtri[e];
+			const unsigned int o = jtwin[e];
+			edge_map::const_iterator kept = border.find( key( jtri[next_halfedge( e )], jtri[e] ) );
+			if( kept != border.end( ) ) { m_halfedges[to] = kept->second; }
+			else if( o == npos ) { m_halfedges[to] = npos; }
+			else if( fill[o / 3] == npos ) { fits = false; }
+			else { m_halfedges[to] = 3 * fill[o / 3] + o % 3; }
+		}
+		if( !fits ) {
+			m_triangles.clear( );
+			m_halfedges.clear( );
+		}
+		return fits;
+	}
+
+	static uint64_t key( unsigned int a, unsigned int b ) {
+		return ( uint64_t(a) << 32 ) | b;
+	}
+
+	// the circumcircle of 'tri' is strictly between 'low' and 'high' in
+	//   x, with room for rounding. Thin triangles are left out, their
+	//   circles being too uncertain.
+	static bool inside_slab( const std::vector<double>& coords, const unsigned int* tri,
+	                         double low, double high ) {
+		const double ax = coords[2 * std::size_t(tri[0])], ay = coords[2 * std::size_t(tri[0]) + 1];
+		const double bx = coords[2 * std::size_t(tri[1])] - ax, by = coords[2 * std::size_t(tri[1]) + 1] - ay;
+		const double cx = coords[2 * std::size_t(tri[2])] - ax, cy = coords[2 * std::size_t(tri[2]) + 1] - ay;
+		const double bl = bx * bx + by * by, cl = cx * cx + cy * cy;
+		const double d = 2.0 * ( bx * cy - by * cx );
+		const double longest = std::max( std::max( bl, cl ), ( bx - cx ) * ( bx - cx ) + ( by - cy ) * ( by - cy ) );
+		if( !( std::fabs( d ) > 1e-3 * longest ) ) { return false; }
+		const double ux = ( cy * bl - by * cl ) / d, uy = ( bx * cl - cx * bl ) / d;
+		const double radius = std::sqrt( ux * ux + uy * uy ), centre = ax + ux;
+		const double room = 1e-9 * ( radius + std::fabs( centre ) );
+		return centre - radius > low + room && centre + radius < high - room;
+	}
+}; // End class delaunay
+
+template<typename T>
+const unsigned int delaunay<T>::npos;
+
+template<typename T>
+const unsigned int delaunay<T>::strip_points;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_DELAUNAY_HPP
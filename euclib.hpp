@@ -17,7 +17,7 @@
  */
 
 #ifndef EUBLIB_HPP
-#define EUCLIB_HPP
+#define EUBLIB_HPP
 
 #include "angle.hpp"
 #include "point.hpp"
@@ -25,4 +25,29 @@
 #include "line.hpp"
 #include "segment.hpp"
 
+// 2D shapes and polygon operations
+#include "rect.hpp"
+#include "polygon.hpp"
+#include "euclib_helper.hpp"
+#include "simple_polygon.hpp"
+#include "polygon_set.hpp"
+#include "clip.hpp"
+#include "boolean.hpp"
+#include "offset.hpp"
+#include "simplify.hpp"
+
+// Spatial indexes and point set structures
+#include "rect_array.hpp"
+#include "uniform_grid.hpp"
+#include "loose_quadtree.hpp"
+#include "sweep_and_prune.hpp"
+#include "packed_rtree.hpp"
+#include "rstar_tree.hpp"
+#include "segment_bvh.hpp"
+#include "kd_tree.hpp"
+#include "rp_forest.hpp"
+#include "delaunay.hpp"
+#include "voronoi.hpp"
+#include "proximity.hpp"
+
 #endif // EUBLIB_HPP
@@ -25,9 +25,12 @@
 #include "segment.hpp"
 #include "rect.hpp"
 #include "polygon.hpp"
+#include "clip.hpp"
+#include "boolean.hpp"
 
 #include <vector>
 #include <complex>
+#include <algorithm>
 // TODO: only for debugging
 #include <iostream>
 using std::cout;
@@ -134,7 +137,7 @@ const float RADIANS = PI / 180.f;
 		// translate 'about' to origin
 		point2<T> tmp = translate( target, -about.x, -about.y );
 
-		point2f rotated = { ( matrix[0]*static_cast<float>(tmp.x) +
+		point2<float> rotated = { ( matrix[0]*static_cast<float>(tmp.x) +
 		                      matrix[1]*static_cast<float>(tmp.y) ),
 		                    ( matrix[2]*static_cast<float>(tmp.x) +
 		                      matrix[3]*static_cast<float>(tmp.y) ) };
@@ -208,7 +211,7 @@ const float RADIANS = PI / 180.f;
 		}
 
 		// calculate new point
-		point2f tmp = { ( matrix[0]*static_cast<float>(t_targ.x) +
+		point2<float> tmp = { ( matrix[0]*static_cast<float>(t_targ.x) +
 		                  matrix[1]*static_cast<float>(t_targ.y) ),
 		                ( matrix[2]*static_cast<float>(t_targ.x) +
 		                  matrix[3]*static_cast<float>(t_targ.y) ) };
@@ -312,10 +315,10 @@ const float RADIANS = PI / 180.f;
 			return point2<T>::null( );
 		}
 		// general case
-		else if( greater_equal( pt.x, rect.l ) &&
-		         less_equal( pt.x, rect.r ) &&
-		         greater_equal( pt.y, rect.t ) &&
-		         less_equal( pt.y, rect.b ) ) {
+		else if( greater_than_eq( pt.x, rect.l ) &&
+		         less_than_eq( pt.x, rect.r ) &&
+		         greater_than_eq( pt.y, rect.t ) &&
+		         less_than_eq( pt.y, rect.b ) ) {
 			return pt;
 		}
 		else {
@@ -477,26 +480,619 @@ const float RADIANS = PI / 180.f;
 	}
 */
 
+	// rectangle with *
+
+	template<typename T>
+	rect2<T> overlap( const rect2<T>& rc1, const rect2<T>& rc2 ) {
+		// check if either is null
+		if( rc1 == rect2<T>::null( ) || rc2 == rect2<T>::null( ) ) {
+			return rect2<T>::null( );
+		}
+
+		// rect2<T> nulls itself if l > r or t > b
+		return rect2<T>{ std::max( rc1.l, rc2.l ), std::min( rc1.r, rc2.r ),
+		                 std::max( rc1.t, rc2.t ), std::min( rc1.b, rc2.b ) };
+	}
+
+
+	// polygon with *
+
+	namespace detail {
+
+		// sign of the turn pt0 -> pt1 -> pt2, 1 is left (counter-clockwise),
+		//   worked in double so integer coordinates cannot overflow
+		template<typename T> inline
+		int orientation( const point2<T>& pt0, const point2<T>& pt1, const point2<T>& pt2 ) {
+			double dir = ( double(pt1.x) - double(pt0.x) ) * ( double(pt2.y) - double(pt0.y) ) -
+			             ( double(pt1.y) - double(pt0.y) ) * ( double(pt2.x) - double(pt0.x) );
+			if( equal( dir, 0.0 ) ) { return 0; }
+			return dir > 0.0 ? 1 : -1;
+		}
+
+		// result of intersecting two segments
+		enum segment_hit {
+			hit_none,    // no intersection
+			hit_proper,  // cross at a single interior point
+			hit_vertex,  // an endpoint of one lies on the other
+			hit_edge     // collinear and overlapping
+		};
+
+		// intersects segments a0->a1 and b0->b1, writing the point of
+		//   intersection to 'hit' for hit_proper and hit_vertex
+		template<typename T>
+		segment_hit intersect_segments( const point2<T>& a0, const point2<T>& a1,
+		                                const point2<T>& b0, const point2<T>& b1,
+		                                point2<T>& hit ) {
+			double denom = double(a0.x) * ( double(b1.y) - double(b0.y) ) +
+			               double(a1.x) * ( double(b0.y) - double(b1.y) ) +
+			               double(b1.x) * ( double(a1.y) - double(a0.y) ) +
+			               double(b0.x) * ( double(a0.y) - double(a1.y) );
+
+			// parallel, only overlapping if collinear
+			if( equal( denom, 0.0 ) ) {
+				if( orientation( a0, a1, b0 ) != 0 ) { return hit_none; }
+				// project on the dominant axis to test overlap
+				bool use_x = std::abs( double(a1.x) - double(a0.x) ) >= std::abs( double(a1.y) - double(a0.y) );
+				T a_lo = use_x ? std::min( a0.x, a1.x ) : std::min( a0.y, a1.y );
+				T a_hi = use_x ? std::max( a0.x, a1.x ) : std::max( a0.y, a1.y );
+				T b_lo = use_x ? std::min( b0.x, b1.x ) : std::min( b0.y, b1.y );
+				T b_hi = use_x ? std::max( b0.x, b1.x ) : std::max( b0.y, b1.y );
+				if( a_hi < b_lo || b_hi < a_lo ) { return hit_none; }
+				return hit_edge;
+			}
+
+			segment_hit code = hit_none;
+			double num = double(a0.x) * ( double(b1.y) - double(b0.y) ) +
+			             double(b0.x) * ( double(a0.y) - double(b1.y) ) +
+			             double(b1.x) * ( double(b0.y) - double(a0.y) );
+			if( equal( num, 0.0 ) || equal( num, denom ) ) { code = hit_vertex; }
+			double s = num / denom;
+
+			num = -( double(a0.x) * ( double(b0.y) - double(a1.y) ) +
+			         double(a1.x) * ( double(a0.y) - double(b0.y) ) +
+			         double(b0.x) * ( double(a1.y) - double(a0.y) ) );
+			if( equal( num, 0.0 ) || equal( num, denom ) ) { code = hit_vertex; }
+			double t = num / denom;
+
+			if( s < 0.0 || s > 1.0 || t < 0.0 || t > 1.0 ) { return hit_none; }
+			if( code != hit_vertex ) { code = hit_proper; }
+
+			hit = point2<T>{ round_to<T>( double(a0.x) + s * ( double(a1.x) - double(a0.x) ) ),
+			                 round_to<T>( double(a0.y) + s * ( double(a1.y) - double(a0.y) ) ) };
+			return code;
+		}
+
+		// appends to a hull, skipping repeated points
+		template<typename T, typename Hull> inline
+		void append_unique( Hull& hull, const point2<T>& pt ) {
+			if( hull.empty( ) || hull.back( ) != pt ) {
+				hull.push_back( pt );
+			}
+		}
+
+	} // End namespace detail
+
+	// friend function
+	//   Convex intersection by chasing edges around both hulls at once, see
+	//   J. O'Rourke, Computational Geometry in C, 2nd ed., sec. 7.6. Runs in
+	//   O(n+m), the hulls from graham_hull( ) are already counter-clockwise.
+	template<typename T>
+	polygon2<T> overlap( const polygon2<T>& poly1, const polygon2<T>& poly2 ) {
+		// check if either is null
+		if( poly1 == polygon2<T>::null( ) || poly2 == polygon2<T>::null( ) ||
+		    poly1.m_hull.size( ) < 3 || poly2.m_hull.size( ) < 3 ) {
+			return polygon2<T>::null( );
+		}
+		// check bounding boxes first
+		if( overlap( poly1.m_bounding_box, poly2.m_bounding_box ) == rect2<T>::null( ) ) {
+			return polygon2<T>::null( );
+		}
+
+		enum inside_flag { in_unknown, in_p, in_q };
+
+		const auto& P = poly1.m_hull;
+		const auto& Q = poly2.m_hull;
+		const unsigned int n = P.size( );
+		const unsigned int m = Q.size( );
+
+		polygon2<T> result;
+		auto& hull = result.m_hull;
+		hull.clear( );
+		hull.reserve( n + m );
+
+		inside_flag inflag = in_unknown;
+		unsigned int a = 0, b = 0;   // current edge heads
+		unsigned int aa = 0, ba = 0; // number of advances on each
+		bool first_point = true;
+		point2<T> hit;
+
+		do {
+			unsigned int a1 = (a + n - 1) % n;
+			unsigned int b1 = (b + m - 1) % m;
+
+			// edge vectors, in double as the differences may not fit T
+			point2<double> A{ double(P[a].x) - double(P[a1].x), double(P[a].y) - double(P[a1].y) };
+			point2<double> B{ double(Q[b].x) - double(Q[b1].x), double(Q[b].y) - double(Q[b1].y) };
+
+			int cross = detail::orientation( point2<double>{ 0.0, 0.0 }, A, B );
+			int a_hb = detail::orientation( Q[b1], Q[b], P[a] );
+			int b_ha = detail::orientation( P[a1], P[a], Q[b] );
+
+			detail::segment_hit code = detail::intersect_segments( P[a1], P[a], Q[b1], Q[b], hit );
+			if( code == detail::hit_proper || code == detail::hit_vertex ) {
+				if( inflag == in_unknown && first_point ) {
+					aa = ba = 0;
+					first_point = false;
+				}
+				detail::append_unique( hull, hit );
+				if( a_hb > 0 ) { inflag = in_p; }
+				else if( b_ha > 0 ) { inflag = in_q; }
+			}
+
+			// overlapping edges pointing in opposite directions,
+			//   the hulls only touch along a shared edge
+			if( code == detail::hit_edge &&
+			    A.x * B.x + A.y * B.y < 0.0 ) {
+				return polygon2<T>::null( );
+			}
+			// parallel and separated
+			if( cross == 0 && a_hb < 0 && b_ha < 0 ) {
+				return polygon2<T>::null( );
+			}
+
+			// advance whichever edge is "behind" the other
+			bool advance_a;
+			if( cross == 0 && a_hb == 0 && b_ha == 0 ) {
+				advance_a = ( inflag != in_p );
+			}
+			else if( cross >= 0 ) {
+				advance_a = ( b_ha > 0 );
+			}
+			else {
+				advance_a = !( a_hb > 0 );
+			}
+
+			if( advance_a ) {
+				if( inflag == in_p ) { detail::append_unique( hull, P[a] ); }
+				++aa;
+				a = (a + 1) % n;
+			}
+			else {
+				if( inflag == in_q ) { detail::append_unique( hull, Q[b] ); }
+				++ba;
+				b = (b + 1) % m;
+			}
+		} while( (aa < n || ba < m) && aa < 2*n && ba < 2*m );
+
+		// the boundaries never crossed, either one contains the
+		//   other or they are disjoint
+		if( inflag == in_unknown ) {
+			if( overlap( P[0], poly2 ) != point2<T>::null( ) ) { return poly1; }
+			if( overlap( Q[0], poly1 ) != point2<T>::null( ) ) { return poly2; }
+			return polygon2<T>::null( );
+		}
+
+		// closing the loop may have repeated the first point
+		while( hull.size( ) > 1 && hull.back( ) == hull.front( ) ) {
+			hull.pop_back( );
+		}
+		if( hull.size( ) < 3 ) {
+			return polygon2<T>::null( );
+		}
+
+		result.calc_bounding_box( );
+		return result;
+	}
+
+	// friend function
+	//   clips the hull with Sutherland-Hodgman, see clip.hpp
+	template<typename T>
+	polygon2<T> overlap( const rect2<T>& rect, const polygon2<T>& poly ) {
+		// check if either is null
+		if( rect == rect2<T>::null( ) || poly == polygon2<T>::null( ) ) {
+			return polygon2<T>::null( );
+		}
+		// check bounding box first
+		if( overlap( rect, poly.m_bounding_box ) == rect2<T>::null( ) ) {
+			return polygon2<T>::null( );
+		}
+
+		// kept for each thread, so clipping stops allocating once they grow
+		static thread_local std::vector<point2<T>> ring;
+		static thread_local clipper<T> clip;
+		if( !clip.clip( poly.m_hull, rect, ring ) ) {
+			return polygon2<T>::null( );
+		}
+
+		polygon2<T> result;
+		result.m_hull.clear( );
+		for( auto itr = ring.begin( ); itr != ring.end( ); ++itr ) {
+			detail::append_unique( result.m_hull, *itr );
+		}
+		while( result.m_hull.size( ) > 1 && result.m_hull.back( ) == result.m_hull.front( ) ) {
+			result.m_hull.pop_back( );
+		}
+		if( result.m_hull.size( ) < 3 ) {
+			return polygon2<T>::null( );
+		}
+
+		result.calc_bounding_box( );
+		return result;
+	}
+
+	template<typename T> inline
+	polygon2<T> overlap( const polygon2<T>& poly, const rect2<T>& rect ) {
+		return overlap( rect, poly );
+	}
+
+/*******************************
+ * Intersection Test Functions *
+ *******************************/
+/** intersects ( shape1, shape2 )
+ *    tests if two shapes touch without building the overlap. Convex
+ *    polygons are tested with the separating axis theorem over the hull
+ *    edge normals, never allocating and exiting on the first separating
+ *    axis found. A separating_axis can be kept between calls to test the
+ *    axis that separated (or nearly separated) the last frame first.
+ */
+
+	// axis cache for intersects( ), valid between calls on the same pair
+	struct separating_axis {
+		separating_axis( ) : poly( 0 ), edge( 0 ), valid( false ) { }
+
+		int          poly;  // 0 for an edge of the first polygon, 1 the second
+		unsigned int edge;  // edge starting at hull[edge]
+		bool         valid;
+	};
+
+	// minimum translation to separate two overlapping polygons
+	struct penetration {
+		penetration( ) : depth( 0.f ), normal{ 0.f, 0.f } { }
+
+		float         depth;   // distance to move the second polygon
+		point2<float> normal;  // unit direction from the first to the second
+	};
+
+	namespace detail {
+
+		// signed distance of the closest vertex of 'other' in front of
+		//   edge 'i' of the counter-clockwise hull 'hull'. Differences are
+		//   taken in double, they would wrap for unsigned coordinates.
+		template<typename Hull>
+		float edge_separation( const Hull& hull, unsigned int i, const Hull& other ) {
+			const auto& pt0 = hull[i];
+			const auto& pt1 = hull[i + 1 == hull.size( ) ? 0 : i + 1];
+			// outward normal of a counter-clockwise edge
+			double nx = double(pt1.y) - double(pt0.y);
+			double ny = double(pt0.x) - double(pt1.x);
+
+			double best = std::numeric_limits<double>::max( );
+			for( unsigned int j = 0; j < other.size( ); ++j ) {
+				double d = nx * ( double(other[j].x) - double(pt0.x) ) +
+				           ny * ( double(other[j].y) - double(pt0.y) );
+				if( d < best ) { best = d; }
+			}
+
+			// a repeated hull point can never separate
+			double len = std::sqrt( nx*nx + ny*ny );
+			if( equal( len, 0.0 ) ) { return -std::numeric_limits<float>::max( ); }
+			return static_cast<float>( best / len );
+		}
+
+		// largest separation over the edges of 'hull', stops early
+		//   at the first separating edge when 'early_exit' is set
+		template<typename Hull>
+		float max_separation( const Hull& hull, const Hull& other,
+		                      unsigned int& edge, bool early_exit ) {
+			float best = -std::numeric_limits<float>::max( );
+			for( unsigned int i = 0; i < hull.size( ); ++i ) {
+				float sep = edge_separation( hull, i, other );
+				if( sep > best ) {
+					best = sep;
+					edge = i;
+					if( early_exit && sep > 0.f ) { break; }
+				}
+			}
+			return best;
+		}
+
+		// shared by both intersects( ) variants, returns the largest
+		//   separation and leaves its axis in 'axis'
+		template<typename Hull>
+		float sat_separation( const Hull& hull1, const Hull& hull2,
+		                      separating_axis& axis, bool early_exit ) {
+			// warm start, last frame's axis is most likely to still separate
+			if( axis.valid ) {
+				const auto& h1 = ( axis.poly == 0 ? hull1 : hull2 );
+				const auto& h2 = ( axis.poly == 0 ? hull2 : hull1 );
+				if( axis.edge < h1.size( ) ) {
+					float sep = edge_separation( h1, axis.edge, h2 );
+					if( early_exit && sep > 0.f ) { return sep; }
+				}
+			}
+
+			unsigned int edge1 = 0, edge2 = 0;
+			float sep1 = max_separation( hull1, hull2, edge1, early_exit );
+			if( early_exit && sep1 > 0.f ) {
+				axis.poly = 0;
+				axis.edge = edge1;
+				axis.valid = true;
+				return sep1;
+			}
+			float sep2 = max_separation( hull2, hull1, edge2, early_exit );
+
+			axis.valid = true;
+			if( sep2 > sep1 ) {
+				axis.poly = 1;
+				axis.edge = edge2;
+				return sep2;
+			}
+			axis.poly = 0;
+			axis.edge = edge1;
+			return sep1;
+		}
+
+	} // End namespace detail
+
+	// friend function
+	template<typename T>
+	bool intersects( const polygon2<T>& poly1, const polygon2<T>& poly2,
+	                 separating_axis& axis ) {
+		// check if either is null
+		if( poly1 == polygon2<T>::null( ) || poly2 == polygon2<T>::null( ) ) {
+			return false;
+		}
+		// check bounding boxes first
+		const rect2<T>& box1 = poly1.m_bounding_box;
+		const rect2<T>& box2 = poly2.m_bounding_box;
+		if( box1.r < box2.l || box2.r < box1.l || box1.b < box2.t || box2.b < box1.t ) {
+			return false;
+		}
+
+		return !( detail::sat_separation( poly1.m_hull, poly2.m_hull, axis, true ) > 0.f );
+	}
+
+	template<typename T> inline
+	bool intersects( const polygon2<T>& poly1, const polygon2<T>& poly2 ) {
+		separating_axis axis;
+		return intersects( poly1, poly2, axis );
+	}
+
+	// friend function
+	//   fills 'result' with the minimum translation of poly2 that
+	//   separates the pair, only meaningful when returning true
+	template<typename T>
+	bool intersects( const polygon2<T>& poly1, const polygon2<T>& poly2,
+	                 separating_axis& axis, penetration& result ) {
+		// check if either is null
+		if( poly1 == polygon2<T>::null( ) || poly2 == polygon2<T>::null( ) ) {
+			return false;
+		}
+		// check bounding boxes first
+		const rect2<T>& box1 = poly1.m_bounding_box;
+		const rect2<T>& box2 = poly2.m_bounding_box;
+		if( box1.r < box2.l || box2.r < box1.l || box1.b < box2.t || box2.b < box1.t ) {
+			return false;
+		}
+
+		float sep = detail::sat_separation( poly1.m_hull, poly2.m_hull, axis, false );
+		if( sep > 0.f ) { return false; }
+
+		// the axis of least penetration is the edge normal found above,
+		//   flipped if it belongs to the second polygon
+		const auto& hull = ( axis.poly == 0 ? poly1.m_hull : poly2.m_hull );
+		const auto& pt0 = hull[axis.edge];
+		const auto& pt1 = hull[axis.edge + 1 == hull.size( ) ? 0 : axis.edge + 1];
+		double nx = double(pt1.y) - double(pt0.y);
+		double ny = double(pt0.x) - double(pt1.x);
+		double len = std::sqrt( nx*nx + ny*ny );
+		if( axis.poly != 0 ) { len = -len; }
+
+		result.depth = -sep;
+		result.normal = point2<float>{ static_cast<float>( nx / len ), static_cast<float>( ny / len ) };
+		return true;
+	}
+
+	template<typename T> inline
+	bool intersects( const polygon2<T>& poly1, const polygon2<T>& poly2,
+	                 penetration& result ) {
+		separating_axis axis;
+		return intersects( poly1, poly2, axis, result );
+	}
+
+/***********************
+ * Minkowski Functions *
+ ***********************/
+/** minkowski_sum ( shape1, shape2 )
+ *    the set of every point of shape1 added to every point of shape2. For
+ *    convex polygons the edges of both counter-clockwise hulls are merged
+ *    by angle in O(n+m) rather than hulling all n*m vertex sums. To grow
+ *    an obstacle into configuration space, sum it with the robot mirrored
+ *    through its reference point.
+ */
+
+	namespace detail {
+
+		// index of the bottom-left vertex, where graham_hull( ) starts
+		template<typename Hull>
+		unsigned int lowest_vertex( const Hull& hull ) {
+			unsigned int best = 0;
+			for( unsigned int i = 1; i < hull.size( ); ++i ) {
+				if( hull[i].y < hull[best].y ||
+				    ( hull[i].y == hull[best].y && hull[i].x < hull[best].x ) ) {
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		// merges the edges of two counter-clockwise hulls by angle starting
+		//   from their lowest vertices, collinear vertices are dropped
+		template<typename Hull>
+		void minkowski_merge( const Hull& P, unsigned int p0,
+		                      const Hull& Q, unsigned int q0, Hull& hull ) {
+			typedef typename Hull::value_type point_t;
+			const unsigned int n = P.size( ), m = Q.size( );
+			hull.clear( );
+			hull.reserve( n + m );
+
+			unsigned int i = 0, j = 0;
+			while( i < n || j < m ) {
+				const point_t& a = P[( p0 + i ) % n];
+				const point_t& b = Q[( q0 + j ) % m];
+				point_t pt( a.x + b.x, a.y + b.y );
+				// drop the middle of three collinear points
+				while( hull.size( ) >= 2 &&
+				       orientation( hull[hull.size( ) - 2], hull.back( ), pt ) == 0 ) {
+					hull.pop_back( );
+				}
+				append_unique( hull, pt );
+
+				if( i == n ) { ++j; continue; }
+				if( j == m ) { ++i; continue; }
+				const point_t& a1 = P[( p0 + i + 1 ) % n];
+				const point_t& b1 = Q[( q0 + j + 1 ) % m];
+				double turn = double( a1.x - a.x ) * double( b1.y - b.y ) -
+				              double( a1.y - a.y ) * double( b1.x - b.x );
+				if( turn > 0.0 ) { ++i; }
+				else if( turn < 0.0 ) { ++j; }
+				else { ++i; ++j; }
+			}
+			// the last vertex may be collinear with the first
+			while( hull.size( ) >= 3 &&
+			       orientation( hull[hull.size( ) - 2], hull.back( ), hull[0] ) == 0 ) {
+				hull.pop_back( );
+			}
+		}
+
+	} // End namespace detail
+
+	// friend function
+	template<typename T>
+	polygon2<T> minkowski_sum( const polygon2<T>& poly1, const polygon2<T>& poly2 ) {
+		if( poly1 == polygon2<T>::null( ) || poly2 == polygon2<T>::null( ) ) {
+			return polygon2<T>::null( );
+		}
+
+		polygon2<T> result;
+		detail::minkowski_merge( poly1.m_hull, detail::lowest_vertex( poly1.m_hull ),
+		                         poly2.m_hull, detail::lowest_vertex( poly2.m_hull ),
+		                         result.m_hull );
+		if( result.m_hull.size( ) < 3 ) { return polygon2<T>::null( ); }
+		result.calc_bounding_box( );
+		return result;
+	}
+
+	// friend function
+	//   Sums one shape with each of 'others', result[i] pairs with
+	//   others[i]. The shape's start vertex is found once and the result
+	//   hulls are filled in place, reusing their storage between calls.
+	template<typename T>
+	void minkowski_sum( const polygon2<T>& poly, const std::vector<polygon2<T>>& others,
+	                    std::vector<polygon2<T>>& result ) {
+		result.resize( others.size( ) );
+		if( poly == polygon2<T>::null( ) ) {
+			std::fill( result.begin( ), result.end( ), polygon2<T>::null( ) );
+			return;
+		}
+
+		unsigned int p0 = detail::lowest_vertex( poly.m_hull );
+		for( unsigned int k = 0; k < others.size( ); ++k ) {
+			const polygon2<T>& other = others[k];
+			polygon2<T>& sum = result[k];
+			if( other == polygon2<T>::null( ) ) {
+				sum = polygon2<T>::null( );
+				continue;
+			}
+			detail::minkowski_merge( poly.m_hull, p0, other.m_hull,
+			                         detail::lowest_vertex( other.m_hull ), sum.m_hull );
+			if( sum.m_hull.size( ) < 3 ) { sum = polygon2<T>::null( ); }
+			else { sum.calc_bounding_box( ); }
+		}
+	}
+
 /*************************
  * Combination Functions *
  *************************/
-/** combine ( shape1, shape2 )
- *    combines the two shapes into one shape. result will be a complex polygon.
+/** combine ( shape1, shape2, op )
+ *    combines the two shapes into one shape with op_union, op_intersection,
+ *    op_difference or op_xor. result will be a complex polygon, written
+ *    as rings with each exterior ring counter-clockwise followed by its
+ *    holes clockwise (see boolean.hpp). A vector of complex polygons can
+ *    be unioned in one call.
     +===========+===========+===========+
     | Shape One | Shape Two |  Result   |
     +===========+===========+===========+
-    | Point     | Polygon   | Polygon   |
+    | Rectangle | Rectangle | Rings     |
+    |           | Polygon   | Rings     |
     +-----------+-----------+-----------+
-    | Line      | Polygon   | Polygon   |
+    | Polygon   | Rectangle | Rings     |
+    |           | Polygon   | Rings     |
     +-----------+-----------+-----------+
-    | Rectangle | Rectangle | Polygon   |
-    |           | Polygon   | Polygon   |
-    +-----------+-----------+-----------+
-    | Polygon   | Polygon   | Polygon   |
+    | Rings     | Rings     | Rings     |
     +-----------+-----------+-----------+
  */
 
-//	template<typename T>
+	namespace detail {
+
+		template<typename T>
+		std::vector<std::vector<point2<T>>> as_rings( const rect2<T>& rect ) {
+			std::vector<std::vector<point2<T>>> rings;
+			if( rect == rect2<T>::null( ) ) { return rings; }
+			rings.resize( 1 );
+			rings[0].reserve( 4 );
+			rings[0].push_back( point2<T>( rect.l, rect.t ) );
+			rings[0].push_back( point2<T>( rect.r, rect.t ) );
+			rings[0].push_back( point2<T>( rect.r, rect.b ) );
+			rings[0].push_back( point2<T>( rect.l, rect.b ) );
+			return rings;
+		}
+
+		template<typename T>
+		std::vector<std::vector<point2<T>>> as_rings( const polygon2<T>& poly ) {
+			std::vector<std::vector<point2<T>>> rings;
+			if( poly == polygon2<T>::null( ) || poly.size( ) < 3 ) { return rings; }
+			rings.resize( 1 );
+			rings[0].reserve( poly.size( ) );
+			for( unsigned int i = 0; i < poly.size( ); ++i ) { rings[0].push_back( poly[i] ); }
+			return rings;
+		}
+
+	} // End namespace detail
+
+	template<typename T>
+	void combine( const rect2<T>& rc1, const rect2<T>& rc2, boolean_op op,
+	              std::vector<std::vector<point2<T>>>& result ) {
+		combine( detail::as_rings( rc1 ), detail::as_rings( rc2 ), op, result );
+	}
+
+	template<typename T>
+	void combine( const rect2<T>& rect, const polygon2<T>& poly, boolean_op op,
+	              std::vector<std::vector<point2<T>>>& result ) {
+		combine( detail::as_rings( rect ), detail::as_rings( poly ), op, result );
+	}
+
+	template<typename T>
+	void combine( const polygon2<T>& poly, const rect2<T>& rect, boolean_op op,
+	              std::vector<std::vector<point2<T>>>& result ) {
+		combine( detail::as_rings( poly ), detail::as_rings( rect ), op, result );
+	}
+
+	template<typename T>
+	void combine( const polygon2<T>& poly1, const polygon2<T>& poly2, boolean_op op,
+	              std::vector<std::vector<point2<T>>>& result ) {
+		combine( detail::as_rings( poly1 ), detail::as_rings( poly2 ), op, result );
+	}
+
+	// union of every polygon
+	template<typename T>
+	void combine( const std::vector<polygon2<T>>& polys,
+	              std::vector<std::vector<point2<T>>>& result, unsigned int threads = 0 ) {
+		std::vector<std::vector<std::vector<point2<T>>>> rings;
+		rings.reserve( polys.size( ) );
+		for( unsigned int i = 0; i < polys.size( ); ++i ) { rings.push_back( detail::as_rings( polys[i] ) ); }
+		combine( rings, result, threads );
+	}
 
 
 } // End namespace euclib
@@ -212,6 +212,13 @@ void round_nearest( float& value ) {
 	}
 }
 
+// converts a computed coordinate to T, to the nearest if T is an integer type
+template<typename T>
+inline T round_to( double value ) {
+	if( std::numeric_limits<T>::is_integer ) { return static_cast<T>( std::floor( value + 0.5 ) ); }
+	return static_cast<T>( value );
+}
+
 } // End namespace euclib
 
 #endif // EUCLIB_MATH_HPP
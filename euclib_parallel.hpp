@@ -0,0 +1,98 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_PARALLEL_HPP
+#define EUBLIB_PARALLEL_HPP
+
+/*
+ * Small threading helpers for the batch entry points. Define
+ * EUCLIB_NO_THREADS to run everything on the calling thread, linking
+ * std::thread may need -pthread otherwise.
+ */
+
+#include <algorithm>
+#ifndef EUCLIB_NO_THREADS
+	#include <atomic>
+	#include <exception>
+	#include <thread>
+	#include <vector>
+#endif
+
+namespace euclib {
+
+// number of workers to use when 0 is asked for
+inline unsigned int default_threads( ) {
+	#ifdef EUCLIB_NO_THREADS
+		return 1;
+	#else
+		unsigned int n = std::thread::hardware_concurrency( );
+		return n == 0 ? 1 : n;
+	#endif
+}
+
+// calls fn( i ) for every i in [begin, end) on up to 'threads' threads,
+//   0 meaning default_threads( ). Indices are handed out 'grain' at a time
+//   from a shared counter so uneven work still balances. The first
+//   exception thrown by fn is rethrown once every worker has stopped.
+template<typename Function>
+void parallel_for( unsigned int begin, unsigned int end, Function fn,
+                   unsigned int threads = 0, unsigned int grain = 64 ) {
+	if( begin >= end ) { return; }
+	if( threads == 0 ) { threads = default_threads( ); }
+	if( grain == 0 ) { grain = 1; }
+	threads = std::min( threads, ( end - begin + grain - 1 ) / grain );
+
+	#ifndef EUCLIB_NO_THREADS
+	if( threads > 1 ) {
+		std::atomic<unsigned int> next( begin );
+		std::atomic<bool>         failed( false );
+		std::exception_ptr        error;
+
+		auto work = [&]( ) {
+			try {
+				for( ;; ) {
+					if( failed.load( ) ) { return; }
+					unsigned int first = next.fetch_add( grain );
+					if( first >= end ) { return; }
+					unsigned int last = std::min( end, first + grain );
+					for( unsigned int i = first; i < last; ++i ) { fn( i ); }
+				}
+			}
+			catch( ... ) {
+				if( !failed.exchange( true ) ) { error = std::current_exception( ); }
+			}
+		};
+
+		// the calling thread works too
+		std::vector<std::thread> pool;
+		pool.reserve( threads - 1 );
+		for( unsigned int t = 1; t < threads; ++t ) { pool.push_back( std::thread( work ) ); }
+		work( );
+		for( unsigned int t = 0; t < pool.size( ); ++t ) { pool[t].join( ); }
+
+		if( error ) { std::rethrow_exception( error ); }
+		return;
+	}
+	#endif
+
+	for( unsigned int i = begin; i < end; ++i ) { fn( i ); }
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_PARALLEL_HPP
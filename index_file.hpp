@@ -0,0 +1,438 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_INDEX_FILE_HPP
+#define EUBLIB_INDEX_FILE_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <limits>
+#include <utility>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#if !defined(EUCLIB_NO_MMAP) && ( defined(__unix__) || defined(__APPLE__) )
+#define EUCLIB_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * Index files, mapped and searched in place
+ *
+ *   The static indexes keep everything in a few flat arrays, so a file is
+ *   just those arrays one after the other. Opening one maps it into memory
+ *   and points the index at the arrays where they lie: nothing is read or
+ *   copied, and pages are only loaded as searches touch them.
+ *
+ *   Layout, in the byte order of the machine that wrote it:
+ *
+ *     header      64 bytes: magic "EUCLIBIX", format version, index kind,
+ *                 scalar type, byte order mark, 4 index parameters,
+ *                 section count, file size, checksum of header and table
+ *     table       32 bytes per section: offset, bytes, checksum
+ *     sections    each starting on a multiple of 64 bytes
+ *
+ *   The header and table are always checked on open. Checking the
+ *   sections reads the whole file, so it is asked for separately; a file
+ *   that was never checked is trusted to be the one that was written.
+ *   Checksums are 64 bit, four lanes of xxHash rounds [1].
+ *
+ *   Mapping uses POSIX mmap( ). Elsewhere, or with EUCLIB_NO_MMAP defined,
+ *   opening reads the whole file into memory instead and searches it there.
+ *
+ * References
+ *   [1] Y. Collet. "xxHash", https://github.com/Cyan4973/xxHash
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	static const char          index_magic[8]      = { 'E', 'U', 'C', 'L', 'I', 'B', 'I', 'X' };
+	static const uint32_t      index_version       = 1;
+	static const uint32_t      index_byte_order    = 0x01020304;
+	static const std::size_t   index_alignment     = 64;
+
+	enum index_kind { packed_rtree_index = 1, kd_tree_index = 2 };
+
+	struct index_header {
+		char      magic[8];
+		uint32_t  version;
+		uint32_t  kind;
+		uint32_t  scalar;       // size, integer and signed flags of T
+		uint32_t  byte_order;
+		uint32_t  params[4];
+		uint32_t  sections;
+		uint32_t  reserved;
+		uint64_t  file_size;
+		uint64_t  checksum;     // header and table, taken with this field 0
+	};
+
+	struct index_section {
+		uint64_t  offset;
+		uint64_t  bytes;
+		uint64_t  checksum;
+		uint64_t  reserved;
+	};
+
+	static_assert( sizeof(index_header) == 64, "index header must be 64 bytes" );
+	static_assert( sizeof(index_section) == 32, "index section must be 32 bytes" );
+
+	template<typename T>
+	uint32_t scalar_code( ) {
+		typedef std::numeric_limits<T> limit_t;
+		return uint32_t(sizeof(T)) | ( limit_t::is_integer ? 0x100u : 0u ) |
+		       ( limit_t::is_signed ? 0x200u : 0u );
+	}
+
+	inline uint64_t rotl64( uint64_t x, unsigned int r ) {
+		return ( x << r ) | ( x >> ( 64 - r ) );
+	}
+
+	inline uint64_t read64( const unsigned char* p ) {
+		uint64_t v;
+		std::memcpy( &v, p, 8 );
+		return v;
+	}
+
+	inline uint64_t checksum( const void* data, std::size_t bytes, uint64_t seed = 0 ) {
+		const uint64_t p1 = 0x9E3779B185EBCA87ull, p2 = 0xC2B2AE3D27D4EB4Full;
+		const uint64_t p3 = 0x165667B19E3779F9ull, p4 = 0x85EBCA77C2B2AE63ull;
+		const unsigned char* p = static_cast<const unsigned char*>( data );
+		const unsigned char* end = p + bytes;
+		uint64_t h;
+
+		if( bytes >= 32 ) {
+			uint64_t v[4] = { seed + p1 + p2, seed + p2, seed, seed - p1 };
+			for( ; p + 32 <= end; p += 32 ) {
+				for( unsigned int i = 0; i < 4; ++i ) {
+					v[i] = rotl64( v[i] + read64( p + 8 * i ) * p2, 31 ) * p1;
+				}
+			}
+			h = rotl64( v[0], 1 ) + rotl64( v[1], 7 ) + rotl64( v[2], 12 ) + rotl64( v[3], 18 );
+			for( unsigned int i = 0; i < 4; ++i ) {
+				h = ( h ^ ( rotl64( v[i] * p2, 31 ) * p1 ) ) * p1 + p4;
+			}
+		}
+		else {
+			h = seed + p3 + 0x27D4EB2F165667C5ull;
+		}
+		h += bytes;
+		for( ; p + 8 <= end; p += 8 ) {
+			h ^= rotl64( read64( p ) * p2, 31 ) * p1;
+			h = rotl64( h, 27 ) * p1 + p4;
+		}
+		for( ; p < end; ++p ) {
+			h ^= *p * 0x27D4EB2F165667C5ull;
+			h = rotl64( h, 11 ) * p1;
+		}
+		h ^= h >> 33;
+		h *= p2;
+		h ^= h >> 29;
+		h *= p3;
+		h ^= h >> 32;
+		return h;
+	}
+
+	inline uint64_t aligned_offset( uint64_t offset ) {
+		return ( offset + index_alignment - 1 ) / index_alignment * index_alignment;
+	}
+
+	// a read only mapping of a whole file, unmapped when destroyed. Without
+	//   mmap( ) the file is read into a buffer of its own.
+	class mapped_file {
+	// Variables
+	private:
+
+		const unsigned char*  m_data;
+		std::size_t           m_size;
+
+	// Constructors
+	public:
+
+	#ifdef EUCLIB_MMAP
+		explicit mapped_file( const std::string& path ) : m_data( 0 ), m_size( 0 ) {
+			int fd = ::open( path.c_str( ), O_RDONLY );
+			if( fd < 0 ) { return; }
+			struct stat st;
+			if( ::fstat( fd, &st ) == 0 && st.st_size > 0 ) {
+				void* p = ::mmap( 0, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+				if( p != MAP_FAILED ) {
+					m_data = static_cast<const unsigned char*>( p );
+					m_size = st.st_size;
+				}
+			}
+			::close( fd );
+		}
+
+		~mapped_file( ) {
+			if( m_data ) { ::munmap( const_cast<unsigned char*>( m_data ), m_size ); }
+		}
+	#else
+		explicit mapped_file( const std::string& path ) : m_data( 0 ), m_size( 0 ) {
+			std::FILE* file = std::fopen( path.c_str( ), "rb" );
+			if( !file ) { return; }
+			long size = -1;
+			if( std::fseek( file, 0, SEEK_END ) == 0 ) { size = std::ftell( file ); }
+			if( size > 0 && std::fseek( file, 0, SEEK_SET ) == 0 ) {
+				// new[] storage is aligned for any scalar the sections hold
+				unsigned char* buffer = new unsigned char[size];
+				if( std::fread( buffer, 1, size, file ) == std::size_t(size) ) {
+					m_data = buffer;
+					m_size = size;
+				} else {
+					delete [] buffer;
+				}
+			}
+			std::fclose( file );
+		}
+
+		~mapped_file( ) {
+			delete [] m_data;
+		}
+	#endif
+
+	private:
+
+		mapped_file( const mapped_file& );
+		mapped_file& operator = ( const mapped_file& );
+
+	// Methods
+	public:
+
+		const unsigned char* data( ) const { return m_data; }
+		std::size_t size( ) const          { return m_size; }
+	}; // End class mapped_file
+
+	// one array of an index as it goes into a file
+	struct index_array {
+		const void*  data;
+		uint64_t     bytes;
+	};
+
+	// writes the header, table and arrays of an index to 'path'
+	inline bool write_index( const std::string& path, index_kind kind, uint32_t scalar,
+	                         const uint32_t ( &params )[4], const std::vector<index_array>& arrays ) {
+		index_header header;
+		std::memset( &header, 0, sizeof(header) );
+		std::memcpy( header.magic, index_magic, 8 );
+		header.version = index_version;
+		header.kind = kind;
+		header.scalar = scalar;
+		header.byte_order = index_byte_order;
+		for( unsigned int i = 0; i < 4; ++i ) { header.params[i] = params[i]; }
+		header.sections = arrays.size( );
+
+		std::vector<index_section> table( arrays.size( ) );
+		uint64_t offset = aligned_offset( sizeof(header) + table.size( ) * sizeof(index_section) );
+		for( unsigned int i = 0; i < arrays.size( ); ++i ) {
+			std::memset( &table[i], 0, sizeof(index_section) );
+			table[i].offset = offset;
+			table[i].bytes = arrays[i].bytes;
+			table[i].checksum = checksum( arrays[i].data, arrays[i].bytes );
+			offset = aligned_offset( offset + arrays[i].bytes );
+		}
+		header.file_size = offset;
+		header.checksum = checksum( table.data( ), table.size( ) * sizeof(index_section),
+		                            checksum( &header, sizeof(header) ) );
+
+		std::FILE* file = std::fopen( path.c_str( ), "wb" );
+		if( !file ) { return false; }
+		static const char zeros[index_alignment] = { 0 };
+		bool ok = std::fwrite( &header, sizeof(header), 1, file ) == 1;
+		if( ok && !table.empty( ) ) {
+			ok = std::fwrite( table.data( ), sizeof(index_section), table.size( ), file ) == table.size( );
+		}
+		uint64_t at = sizeof(header) + table.size( ) * sizeof(index_section);
+		for( unsigned int i = 0; ok && i < arrays.size( ); ++i ) {
+			ok = std::fwrite( zeros, 1, table[i].offset - at, file ) == table[i].offset - at;
+			ok = ok && ( arrays[i].bytes == 0 ||
+			             std::fwrite( arrays[i].data, 1, arrays[i].bytes, file ) == arrays[i].bytes );
+			at = table[i].offset + arrays[i].bytes;
+		}
+		ok = ok && std::fwrite( zeros, 1, offset - at, file ) == offset - at;
+		ok = ( std::fclose( file ) == 0 ) && ok;
+		if( !ok ) { std::remove( path.c_str( ) ); }
+		return ok;
+	}
+
+	// maps 'path' and checks it holds an index of 'kind' and 'scalar' with
+	//   'sections' arrays. Returns the mapping, or nothing if it does not.
+	inline std::shared_ptr<const mapped_file> open_index( const std::string& path, index_kind kind,
+	                                                      uint32_t scalar, unsigned int sections,
+	                                                      bool verify ) {
+		std::shared_ptr<const mapped_file> file( new mapped_file( path ) );
+		const unsigned char* data = file->data( );
+		const uint64_t size = file->size( );
+		const uint64_t table_end = sizeof(index_header) + uint64_t(sections) * sizeof(index_section);
+		if( !data || size < table_end ) { return std::shared_ptr<const mapped_file>( ); }
+
+		index_header header;
+		std::memcpy( &header, data, sizeof(header) );
+		if( std::memcmp( header.magic, index_magic, 8 ) != 0 || header.version != index_version ||
+		    header.byte_order != index_byte_order || header.kind != uint32_t(kind) ||
+		    header.scalar != scalar || header.sections != sections || header.file_size != size ) {
+			return std::shared_ptr<const mapped_file>( );
+		}
+		const uint64_t stored = header.checksum;
+		header.checksum = 0;
+		if( checksum( data + sizeof(header), sections * sizeof(index_section),
+		              checksum( &header, sizeof(header) ) ) != stored ) {
+			return std::shared_ptr<const mapped_file>( );
+		}
+
+		const index_section* table = reinterpret_cast<const index_section*>( data + sizeof(header) );
+		for( unsigned int i = 0; i < sections; ++i ) {
+			if( table[i].offset % index_alignment != 0 || table[i].offset < table_end ||
+			    table[i].offset > size || table[i].bytes > size - table[i].offset ) {
+				return std::shared_ptr<const mapped_file>( );
+			}
+			if( verify && checksum( data + table[i].offset, table[i].bytes ) != table[i].checksum ) {
+				return std::shared_ptr<const mapped_file>( );
+			}
+		}
+		return file;
+	}
+
+	inline const index_header& header_of( const mapped_file& file ) {
+		return *reinterpret_cast<const index_header*>( file.data( ) );
+	}
+
+	inline const index_section& section_of( const mapped_file& file, unsigned int i ) {
+		return reinterpret_cast<const index_section*>( file.data( ) + sizeof(index_header) )[i];
+	}
+
+	// an array either owned or lying in a mapped file. Writing through it
+	//   is only for building, after resize( ) or assign( ) have made it owned.
+	template<typename T>
+	class flat_array {
+	// Variables
+	private:
+
+		std::vector<T>               m_own;
+		const T*                     m_data;
+		std::size_t                  m_size;
+		std::shared_ptr<const void>  m_keep;   // the mapping, while in use
+
+	// Constructors
+	public:
+
+		flat_array( ) : m_data( 0 ), m_size( 0 ) { }
+
+		flat_array( const flat_array& other ) :
+			m_own( other.m_own ),
+			m_size( other.m_size ),
+			m_keep( other.m_keep )
+		{
+			m_data = m_keep ? other.m_data : m_own.data( );
+		}
+
+		flat_array( flat_array&& other ) :
+			m_own( std::move( other.m_own ) ),
+			m_data( other.m_data ),
+			m_size( other.m_size ),
+			m_keep( std::move( other.m_keep ) )
+		{
+			other.m_data = 0;
+			other.m_size = 0;
+		}
+
+	// Operators
+	public:
+
+		flat_array& operator = ( flat_array other ) {
+			m_own.swap( other.m_own );
+			std::swap( m_data, other.m_data );
+			std::swap( m_size, other.m_size );
+			m_keep.swap( other.m_keep );
+			return *this;
+		}
+
+		const T& operator [] ( std::size_t i ) const { return m_data[i]; }
+		T& operator [] ( std::size_t i )             { return m_own[i]; }
+
+	// Methods
+	public:
+
+		std::size_t size( ) const { return m_size; }
+		bool empty( ) const       { return m_size == 0; }
+		const T* data( ) const    { return m_data; }
+		bool mapped( ) const      { return bool(m_keep); }
+
+		void clear( ) {
+			m_keep.reset( );
+			m_own.clear( );
+			sync( );
+		}
+
+		void resize( std::size_t n ) {
+			own( );
+			m_own.resize( n );
+			sync( );
+		}
+
+		void assign( std::size_t n, const T& value ) {
+			m_keep.reset( );
+			m_own.assign( n, value );
+			sync( );
+		}
+
+		// points at 'n' values at 'data', kept alive by 'keep'
+		void map( const T* data, std::size_t n, const std::shared_ptr<const void>& keep ) {
+			std::vector<T>( ).swap( m_own );
+			m_data = data;
+			m_size = n;
+			m_keep = keep;
+		}
+
+	private:
+
+		void own( ) {
+			if( m_keep ) {
+				m_own.assign( m_data, m_data + m_size );
+				m_keep.reset( );
+			}
+		}
+
+		void sync( ) {
+			m_data = m_own.data( );
+			m_size = m_own.size( );
+		}
+	}; // End class flat_array
+
+	// points 'array' at section 'i' of 'file', if it holds exactly 'n' values
+	template<typename T>
+	bool map_section( flat_array<T>& array, const std::shared_ptr<const mapped_file>& file,
+	                  unsigned int i, std::size_t n ) {
+		const index_section& section = section_of( *file, i );
+		if( section.bytes != uint64_t(n) * sizeof(T) ) { return false; }
+		array.map( reinterpret_cast<const T*>( file->data( ) + section.offset ), n, file );
+		return true;
+	}
+
+} // End namespace detail
+
+}  // End namespace euclib
+
+#endif // EUBLIB_INDEX_FILE_HPP
@@ -0,0 +1,439 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_KD_TREE_HPP
+#define EUBLIB_KD_TREE_HPP
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include "point.hpp"
+#include "euclib_parallel.hpp"
+#include "index_file.hpp"
+
+/*
+ * Static k-d tree over point<T,D>
+ *
+ *   Each node splits its points at the median of the axis they are most
+ *   spread along [1], found with nth_element, until at most bucket_size( )
+ *   points are left. As the halves always differ by at most one point the
+ *   tree is complete: node i has children 2i+1 and 2i+2, every leaf is at
+ *   depth( ), and the points are stored in leaf order in one flat array,
+ *   so only the split of each inner node needs storing. The nodes of a
+ *   level are independent and are split in parallel.
+ *
+ *   Searches prune with the incremental distance to the far cell [2].
+ *   Results are the indices the points had in the vector given to the
+ *   constructor and go into buffers owned by the caller, so a reused
+ *   buffer makes searching allocation free. A built tree can be saved
+ *   to a file and later mapped back with open( ), searching it in place
+ *   without reading it in, see index_file.hpp.
+ *
+ * References
+ *   [1] J. H. Friedman, J. L. Bentley, R. A. Finkel. "An Algorithm for
+ *         Finding Best Matches in Logarithmic Expected Time". ACM
+ *         Transactions on Mathematical Software, 3(3), pp. 209-226, 1977.
+ *   [2] S. Arya, D. M. Mount. "Algorithms for fast vector quantization".
+ *         Proceedings of the Data Compression Conference, pp. 381-390, 1993.
+ */
+
+namespace euclib {
+
+template<typename T, std::size_t D>
+class kd_tree {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+	static_assert( D < 256, "axes are stored in a byte" );
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+	// (distance squared, index) pairs, closest first
+	typedef std::vector<std::pair<T, unsigned int>> neighbours_t;
+
+
+// Variables
+private:
+
+	unsigned int                       m_bucket_size;
+	unsigned int                       m_count;
+	unsigned int                       m_depth;    // levels of inner nodes
+	detail::flat_array<T>              m_coords;   // D per point, in leaf order
+	detail::flat_array<unsigned int>   m_indices;  // input index of each point
+	detail::flat_array<T>              m_split;    // split value of each inner node
+	detail::flat_array<unsigned char>  m_axis;     // split axis of each inner node
+
+
+// Constructors
+public:
+
+	kd_tree( ) : m_bucket_size( 8 ), m_count( 0 ), m_depth( 0 ) { }
+
+	// maps a tree saved to 'path', empty if it cannot, see open( )
+	explicit kd_tree( const std::string& path, bool verify = false ) :
+		m_bucket_size( 8 ),
+		m_count( 0 ),
+		m_depth( 0 )
+	{
+		open( path, verify );
+	}
+
+	// 'threads' as for parallel_for( ), 0 for one per core
+	kd_tree( const std::vector<point<T,D>>& points, unsigned int bucket_size = 8,
+	         unsigned int threads = 0 ) {
+		build( points, bucket_size, threads );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const        { return m_count; }
+	bool empty( ) const               { return m_count == 0; }
+	unsigned int bucket_size( ) const { return m_bucket_size; }
+	unsigned int depth( ) const       { return m_depth; }
+	bool mapped( ) const              { return m_coords.mapped( ); }
+
+	void build( const std::vector<point<T,D>>& points, unsigned int bucket_size = 8,
+	            unsigned int threads = 0 ) {
+		typedef std::pair<std::array<T,D>, unsigned int> work_t;
+
+		m_bucket_size = std::max( bucket_size, 1u );
+		m_count = points.size( );
+		m_depth = depth_for( m_count, m_bucket_size );
+		const unsigned int inner = ( 1u << m_depth ) - 1;
+		m_split.assign( inner, T( ) );
+		m_axis.assign( inner, 0 );
+
+		std::vector<work_t> work( m_count );
+		parallel_for( 0, m_count, [&]( unsigned int i ) {
+			for( std::size_t a = 0; a < D; ++a ) { work[i].first[a] = points[i][a]; }
+			work[i].second = i;
+		}, threads, 4096 );
+
+		for( unsigned int level = 0; level < m_depth; ++level ) {
+			const unsigned int first = ( 1u << level ) - 1;
+			parallel_for( 0, 1u << level, [&]( unsigned int i ) {
+				unsigned int begin, end;
+				range( level, i, begin, end );
+
+				// widest axis
+				std::array<T,D> lo = work[begin].first, hi = lo;
+				for( unsigned int p = begin + 1; p < end; ++p ) {
+					for( std::size_t a = 0; a < D; ++a ) {
+						lo[a] = std::min( lo[a], work[p].first[a] );
+						hi[a] = std::max( hi[a], work[p].first[a] );
+					}
+				}
+				std::size_t axis = 0;
+				for( std::size_t a = 1; a < D; ++a ) {
+					if( hi[a] - lo[a] > hi[axis] - lo[axis] ) { axis = a; }
+				}
+
+				const unsigned int mid = begin + ( end - begin ) / 2;
+				std::nth_element( work.begin( ) + begin, work.begin( ) + mid, work.begin( ) + end,
+				                  [axis]( const work_t& p1, const work_t& p2 ) {
+				                      return p1.first[axis] < p2.first[axis]; } );
+				m_split[first + i] = work[mid].first[axis];
+				m_axis[first + i] = axis;
+			}, threads, 1 );
+		}
+
+		m_coords.resize( std::size_t(m_count) * D );
+		m_indices.resize( m_count );
+		parallel_for( 0, m_count, [&]( unsigned int i ) {
+			std::copy( work[i].first.begin( ), work[i].first.end( ), &m_coords[std::size_t(i) * D] );
+			m_indices[i] = work[i].second;
+		}, threads, 4096 );
+	}
+
+	// the k (at most) points nearest 'pt' within 'max_distance', closest
+	//   first, as (distance squared, index) pairs
+	void nearest( const point<T,D>& pt, unsigned int k, neighbours_t& result,
+	              T max_distance = limit_t::max( ) ) const {
+		result.clear( );
+		if( k == 0 || m_count == 0 ) { return; }
+		T q[D], off[D];
+		for( std::size_t a = 0; a < D; ++a ) {
+			q[a] = pt[a];
+			off[a] = T( );
+		}
+		T bound = max_distance < std::sqrt( limit_t::max( ) ) ? max_distance * max_distance : limit_t::max( );
+		nearest( 0, 0, 0, m_count, q, off, T( ), k, bound, result );
+		std::sort_heap( result.begin( ), result.end( ) );
+	}
+
+	// index of the point nearest 'pt', npos when empty
+	unsigned int nearest( const point<T,D>& pt ) const {
+		neighbours_t result;
+		result.reserve( 1 );
+		nearest( pt, 1, result );
+		return result.empty( ) ? npos : result[0].second;
+	}
+
+	// calls visit( index ) for every point within 'distance' of 'pt',
+	//   stopping early if visit returns false
+	template<typename Visitor>
+	void radius( const point<T,D>& pt, T distance, Visitor visit ) const {
+		if( m_count == 0 || distance < T( ) ) { return; }
+		T q[D], off[D];
+		for( std::size_t a = 0; a < D; ++a ) {
+			q[a] = pt[a];
+			off[a] = T( );
+		}
+		within( 0, 0, 0, m_count, q, off, T( ), distance * distance, visit );
+	}
+
+	// appends the indices of the points within 'distance' of 'pt'
+	void radius( const point<T,D>& pt, T distance, std::vector<unsigned int>& result ) const {
+		radius( pt, distance, [&]( unsigned int index ) {
+			result.push_back( index );
+			return true;
+		} );
+	}
+
+	// calls visit( index ) for every point with lo[a] <= pt[a] <= hi[a] on
+	//   every axis, stopping early if visit returns false
+	template<typename Visitor>
+	void search( const point<T,D>& lo, const point<T,D>& hi, Visitor visit ) const {
+		if( m_count == 0 ) { return; }
+		T l[D], h[D];
+		for( std::size_t a = 0; a < D; ++a ) {
+			l[a] = lo[a];
+			h[a] = hi[a];
+		}
+		search( 0, 0, 0, m_count, l, h, visit );
+	}
+
+	// appends the indices of the points in the box from 'lo' to 'hi'
+	void search( const point<T,D>& lo, const point<T,D>& hi, std::vector<unsigned int>& result ) const {
+		search( lo, hi, [&]( unsigned int index ) {
+			result.push_back( index );
+			return true;
+		} );
+	}
+
+	// writes the tree to 'path' in the format of index_file.hpp
+	bool save( const std::string& path ) const {
+		const uint32_t params[4] = { m_bucket_size, m_count, m_depth, uint32_t(D) };
+		std::vector<detail::index_array> arrays( 4 );
+		arrays[0].data = m_coords.data( );
+		arrays[0].bytes = uint64_t(m_coords.size( )) * sizeof(T);
+		arrays[1].data = m_indices.data( );
+		arrays[1].bytes = uint64_t(m_indices.size( )) * sizeof(unsigned int);
+		arrays[2].data = m_split.data( );
+		arrays[2].bytes = uint64_t(m_split.size( )) * sizeof(T);
+		arrays[3].data = m_axis.data( );
+		arrays[3].bytes = m_axis.size( );
+		return detail::write_index( path, detail::kd_tree_index, detail::scalar_code<T>( ),
+		                            params, arrays );
+	}
+
+	// maps a tree written by save( ) and searches it where it lies in the
+	//   file, which must not change while mapped. 'verify' also checks the
+	//   arrays against their checksums, reading the whole file. Returns
+	//   false, leaving the tree as it was, if the file is not such a tree.
+	bool open( const std::string& path, bool verify = false ) {
+		static_assert( sizeof(unsigned int) == 4, "indices are stored as 32 bits" );
+		std::shared_ptr<const detail::mapped_file> file =
+			detail::open_index( path, detail::kd_tree_index, detail::scalar_code<T>( ), 4, verify );
+		if( !file ) { return false; }
+
+		const detail::index_header& header = detail::header_of( *file );
+		kd_tree tree;
+		tree.m_bucket_size = header.params[0];
+		tree.m_count = header.params[1];
+		tree.m_depth = header.params[2];
+		if( header.params[3] != D || tree.m_bucket_size == 0 ||
+		    tree.m_depth != depth_for( tree.m_count, tree.m_bucket_size ) ) {
+			return false;
+		}
+		const std::size_t inner = ( std::size_t(1) << tree.m_depth ) - 1;
+		if( !detail::map_section( tree.m_coords, file, 0, std::size_t(tree.m_count) * D ) ||
+		    !detail::map_section( tree.m_indices, file, 1, tree.m_count ) ||
+		    !detail::map_section( tree.m_split, file, 2, inner ) ||
+		    !detail::map_section( tree.m_axis, file, 3, inner ) ) {
+			return false;
+		}
+		*this = std::move( tree );
+		return true;
+	}
+
+private:
+
+	// levels of inner nodes so no leaf holds more than 'bucket_size' points
+	static unsigned int depth_for( unsigned int count, unsigned int bucket_size ) {
+		unsigned int depth = 0;
+		while( ( ( uint64_t(count) + ( uint64_t(1) << depth ) - 1 ) >> depth ) > bucket_size ) {
+			++depth;
+		}
+		return depth;
+	}
+
+	// points [begin, end) of node 'i' of 'level'
+	void range( unsigned int level, unsigned int i, unsigned int& begin, unsigned int& end ) const {
+		begin = 0;
+		end = m_count;
+		for( unsigned int bit = level; bit-- > 0; ) {
+			unsigned int mid = begin + ( end - begin ) / 2;
+			if( ( i >> bit ) & 1 ) { begin = mid; }
+			else { end = mid; }
+		}
+	}
+
+	static T distance_sq( const T* q, const T* p ) {
+		T d = T( );
+		for( std::size_t a = 0; a < D; ++a ) {
+			T diff = q[a] - p[a];
+			d += diff * diff;
+		}
+		return d;
+	}
+
+	// 'off' is the offset from 'q' to the node's cell on each axis and
+	//   'rd' the distance squared it adds up to
+	void nearest( unsigned int node, unsigned int level, unsigned int begin, unsigned int end,
+	              const T* q, T* off, T rd, unsigned int k, T bound, neighbours_t& result ) const {
+		if( level == m_depth ) {
+			for( unsigned int i = begin; i < end; ++i ) {
+				T d = distance_sq( q, &m_coords[std::size_t(i) * D] );
+				if( result.size( ) < k ) {
+					if( d <= bound ) {
+						result.push_back( std::make_pair( d, m_indices[i] ) );
+						std::push_heap( result.begin( ), result.end( ) );
+					}
+				}
+				else if( d < result.front( ).first ) {
+					std::pop_heap( result.begin( ), result.end( ) );
+					result.back( ) = std::make_pair( d, m_indices[i] );
+					std::push_heap( result.begin( ), result.end( ) );
+				}
+			}
+			return;
+		}
+
+		const unsigned int axis = m_axis[node];
+		const unsigned int mid = begin + ( end - begin ) / 2;
+		const T diff = q[axis] - m_split[node];
+		if( diff < T( ) ) {
+			nearest( 2 * node + 1, level + 1, begin, mid, q, off, rd, k, bound, result );
+		}
+		else {
+			nearest( 2 * node + 2, level + 1, mid, end, q, off, rd, k, bound, result );
+		}
+
+		const T old = off[axis];
+		const T far_rd = rd - old * old + diff * diff;
+		if( far_rd <= ( result.size( ) < k ? bound : result.front( ).first ) ) {
+			off[axis] = diff;
+			if( diff < T( ) ) {
+				nearest( 2 * node + 2, level + 1, mid, end, q, off, far_rd, k, bound, result );
+			}
+			else {
+				nearest( 2 * node + 1, level + 1, begin, mid, q, off, far_rd, k, bound, result );
+			}
+			off[axis] = old;
+		}
+	}
+
+	template<typename Visitor>
+	bool within( unsigned int node, unsigned int level, unsigned int begin, unsigned int end,
+	             const T* q, T* off, T rd, T bound, Visitor& visit ) const {
+		if( level == m_depth ) {
+			for( unsigned int i = begin; i < end; ++i ) {
+				if( distance_sq( q, &m_coords[std::size_t(i) * D] ) <= bound ) {
+					if( !visit( m_indices[i] ) ) { return false; }
+				}
+			}
+			return true;
+		}
+
+		const unsigned int axis = m_axis[node];
+		const unsigned int mid = begin + ( end - begin ) / 2;
+		const T diff = q[axis] - m_split[node];
+		const T old = off[axis];
+		const T far_rd = rd - old * old + diff * diff;
+		bool go_on;
+		if( diff < T( ) ) {
+			go_on = within( 2 * node + 1, level + 1, begin, mid, q, off, rd, bound, visit );
+		}
+		else {
+			go_on = within( 2 * node + 2, level + 1, mid, end, q, off, rd, bound, visit );
+		}
+		if( go_on && far_rd <= bound ) {
+			off[axis] = diff;
+			if( diff < T( ) ) {
+				go_on = within( 2 * node + 2, level + 1, mid, end, q, off, far_rd, bound, visit );
+			}
+			else {
+				go_on = within( 2 * node + 1, level + 1, begin, mid, q, off, far_rd, bound, visit );
+			}
+			off[axis] = old;
+		}
+		return go_on;
+	}
+
+	template<typename Visitor>
+	bool search( unsigned int node, unsigned int level, unsigned int begin, unsigned int end,
+	             const T* lo, const T* hi, Visitor& visit ) const {
+		if( level == m_depth ) {
+			for( unsigned int i = begin; i < end; ++i ) {
+				const T* p = &m_coords[std::size_t(i) * D];
+				bool inside = true;
+				for( std::size_t a = 0; a < D && inside; ++a ) {
+					inside = lo[a] <= p[a] && p[a] <= hi[a];
+				}
+				if( inside && !visit( m_indices[i] ) ) { return false; }
+			}
+			return true;
+		}
+
+		// left holds values <= the split, right values >= it
+		const unsigned int axis = m_axis[node];
+		const unsigned int mid = begin + ( end - begin ) / 2;
+		if( lo[axis] <= m_split[node] &&
+		    !search( 2 * node + 1, level + 1, begin, mid, lo, hi, visit ) ) {
+			return false;
+		}
+		if( hi[axis] >= m_split[node] &&
+		    !search( 2 * node + 2, level + 1, mid, end, lo, hi, visit ) ) {
+			return false;
+		}
+		return true;
+	}
+}; // End class kd_tree
+
+template<typename T, std::size_t D>
+const unsigned int kd_tree<T,D>::npos;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_KD_TREE_HPP
@@ -209,6 +209,83 @@ public:
 }; // End class line<T,2>
 
 
+// An infinite 2D line through two points, usable with any scalar type.
+//   Slope and intercept are float so vertical lines can report infinity
+//   even for integral T.
+template<typename T>
+class line2 {
+// Variables
+public:
+
+	point2<T> pt1, pt2;
+
+
+// Constructors
+public:
+
+	line2( ) { }
+	line2( const point2<T>& pt1_, const point2<T>& pt2_ ) : pt1( pt1_ ), pt2( pt2_ ) { }
+
+
+// Methods
+public:
+
+	// Returns a null line, defined by two null points
+	static line2<T> null( ) {
+		return line2<T>( point2<T>::null( ), point2<T>::null( ) );
+	}
+
+	const point2<T>& start_pt( ) const { return pt1; }
+	const point2<T>& end_pt( )   const { return pt2; }
+
+	float length( ) const {
+		float dx = static_cast<float>( pt2.x ) - static_cast<float>( pt1.x );
+		float dy = static_cast<float>( pt2.y ) - static_cast<float>( pt1.y );
+		return std::sqrt( dx*dx + dy*dy );
+	}
+
+	float slope( ) const {
+		float dx = static_cast<float>( pt2.x ) - static_cast<float>( pt1.x );
+		// vertical line
+		if( equal( dx, 0.f ) ) {
+			return std::numeric_limits<float>::infinity( );
+		}
+		return ( static_cast<float>( pt2.y ) - static_cast<float>( pt1.y ) ) / dx;
+	}
+
+	float intercept( ) const {
+		float m = slope( );
+		// vertical line
+		if( m == std::numeric_limits<float>::infinity( ) ) {
+			return m;
+		}
+		return static_cast<float>( pt1.y ) - m * static_cast<float>( pt1.x );
+	}
+
+	T at_x( T x ) const {
+		float m = slope( );
+		// vertical line
+		if( m == std::numeric_limits<float>::infinity( ) ) {
+			return pt1.y;
+		}
+		return static_cast<T>( intercept( ) + m * static_cast<float>( x ) );
+	}
+
+
+// Operators
+public:
+
+	bool operator == ( const line2<T>& line ) const {
+		return pt1 == line.pt1 && pt2 == line.pt2;
+	}
+
+	bool operator != ( const line2<T>& line ) const {
+		return !(*this == line);
+	}
+
+}; // End class line2<T>
+
+
 // Various typedefs to make usage easier
 typedef line<float,2>         line2f;
 typedef line<double,2>        line2d;
@@ -0,0 +1,407 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_LOOSE_QUADTREE_HPP
+#define EUBLIB_LOOSE_QUADTREE_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "point.hpp"
+#include "rect.hpp"
+
+/*
+ * Loose quadtree over rect2
+ *
+ *   The world square is split into quadrants down to max_depth( ). Each
+ *   node's loose bounds are its cell grown by half a cell on every side
+ *   [1], and a box is stored in the deepest node whose cell holds its
+ *   centre and whose loose bounds hold all of it, which is found from the
+ *   box's size without searching. Boxes of any size sit at one depth,
+ *   never split between nodes.
+ *
+ *   Boxes get a handle on insert. update( ) to a box still inside the
+ *   loose bounds of its node is O(1), anything else takes one walk from
+ *   the root. A box is not pushed deeper when it shrinks until it leaves
+ *   its node. Nodes come from a pool, are made when first needed and go
+ *   back once empty with no children. Boxes whose centre is outside the
+ *   world stay in the root.
+ *
+ * References
+ *   [1] T. Ulrich. "Loose Octrees". Game Programming Gems, pp. 444-453,
+ *         Charles River Media, 2000.
+ */
+
+namespace euclib {
+
+template<typename T>
+class loose_quadtree {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+	static const unsigned int depth_limit = 32;
+
+	struct node {
+		double        cx, cy, half;  // cell centre and half its side
+		unsigned int  parent;
+		unsigned int  child[4];      // by ( x >= cx ) + 2 * ( y >= cy )
+		unsigned int  children;
+		unsigned int  first;         // head of the list of boxes
+		unsigned int  objects;
+		unsigned int  depth;
+	};
+
+	struct item {
+		T             l, r, t, b;
+		unsigned int  node;          // npos while the handle is free
+		unsigned int  prev, next;
+	};
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+	// totals for one depth, see stats( )
+	struct level_stats {
+		unsigned int  nodes;
+		unsigned int  objects;
+		unsigned int  max_objects;  // most held by one node
+		unsigned int  empty;        // nodes holding only children
+	};
+
+
+// Variables
+private:
+
+	std::vector<node>          m_nodes;
+	std::vector<unsigned int>  m_free_nodes;
+	std::vector<item>          m_items;
+	std::vector<unsigned int>  m_free_items;
+	unsigned int               m_root;
+	unsigned int               m_max_depth;
+	unsigned int               m_size;
+	rect2<T>                   m_world;
+
+
+// Constructors
+public:
+
+	// 'world' is made square around its centre, max_depth at most 31
+	explicit loose_quadtree( const rect2<T>& world, unsigned int max_depth = 8 ) :
+		m_max_depth( std::min( max_depth, depth_limit - 1 ) ),
+		m_world( world ) {
+		clear( );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const      { return m_size; }
+	bool empty( ) const             { return m_size == 0; }
+	unsigned int max_depth( ) const { return m_max_depth; }
+	rect2<T> world( ) const         { return m_world; }
+
+	// nodes currently in use
+	unsigned int nodes( ) const { return m_nodes.size( ) - m_free_nodes.size( ); }
+
+	void clear( ) {
+		m_nodes.clear( );
+		m_free_nodes.clear( );
+		m_items.clear( );
+		m_free_items.clear( );
+		m_size = 0;
+		double half = std::max( double(m_world.r) - double(m_world.l),
+		                        double(m_world.b) - double(m_world.t) ) / 2.0;
+		m_root = alloc_node( ( double(m_world.l) + double(m_world.r) ) / 2.0,
+		                     ( double(m_world.t) + double(m_world.b) ) / 2.0,
+		                     half > 0.0 ? half : 1.0, npos, 0 );
+	}
+
+	// room for 'count' boxes without the pools growing
+	void reserve( unsigned int count ) {
+		m_items.reserve( count );
+	}
+
+	rect2<T> box( unsigned int handle ) const {
+		const item& it = m_items[handle];
+		return rect2<T>( it.l, it.r, it.t, it.b );
+	}
+
+	bool contains( unsigned int handle ) const {
+		return handle < m_items.size( ) && m_items[handle].node != npos;
+	}
+
+	// depth of the node holding 'handle'
+	unsigned int depth( unsigned int handle ) const {
+		return m_nodes[m_items[handle].node].depth;
+	}
+
+	// adds 'rect', returning its handle, or npos for a null rect
+	unsigned int insert( const rect2<T>& rect ) {
+		if( rect == rect2<T>::null( ) ) { return npos; }
+		unsigned int handle;
+		if( !m_free_items.empty( ) ) {
+			handle = m_free_items.back( );
+			m_free_items.pop_back( );
+		}
+		else {
+			handle = m_items.size( );
+			m_items.push_back( item( ) );
+		}
+		set_box( handle, rect );
+		place( handle );
+		++m_size;
+		return handle;
+	}
+
+	bool remove( unsigned int handle ) {
+		if( !contains( handle ) ) { return false; }
+		unsigned int n = m_items[handle].node;
+		unlink( handle );
+		prune( n );
+		m_items[handle].node = npos;
+		m_free_items.push_back( handle );
+		--m_size;
+		return true;
+	}
+
+	// moves the box of 'handle' to 'rect'
+	bool update( unsigned int handle, const rect2<T>& rect ) {
+		if( !contains( handle ) || rect == rect2<T>::null( ) ) { return false; }
+		const unsigned int n = m_items[handle].node;
+		set_box( handle, rect );
+		if( n == m_root || inside_loose( m_nodes[n], m_items[handle] ) ) { return true; }
+
+		unlink( handle );
+		place( handle );
+		prune( n );
+		return true;
+	}
+
+	// calls visit( handle ) for every box overlapping 'window', stopping
+	//   early if visit returns false. Touching counts as overlapping.
+	template<typename Visitor>
+	void search( const rect2<T>& window, Visitor visit ) const {
+		if( m_size == 0 || window == rect2<T>::null( ) ) { return; }
+		search( window.l, window.r, window.t, window.b, visit );
+	}
+
+	void search( const rect2<T>& window, std::vector<unsigned int>& result ) const {
+		search( window, [&]( unsigned int handle ) {
+			result.push_back( handle );
+			return true;
+		} );
+	}
+
+	// calls visit( handle ) for every box containing 'pt'
+	template<typename Visitor>
+	void search( const point2<T>& pt, Visitor visit ) const {
+		if( m_size == 0 || pt == point2<T>::null( ) ) { return; }
+		search( pt.x, pt.x, pt.y, pt.y, visit );
+	}
+
+	void search( const point2<T>& pt, std::vector<unsigned int>& result ) const {
+		search( pt, [&]( unsigned int handle ) {
+			result.push_back( handle );
+			return true;
+		} );
+	}
+
+	// calls visit( depth, loose bounds, boxes held, children ) for every
+	//   node in use, parents before children
+	template<typename Visitor>
+	void visit_nodes( Visitor visit ) const {
+		unsigned int stack[3 * depth_limit + 1];
+		unsigned int top = 0;
+		stack[top++] = m_root;
+		while( top > 0 ) {
+			const node& n = m_nodes[stack[--top]];
+			visit( n.depth, loose_bounds( n ), n.objects, n.children );
+			for( int q = 0; q < 4; ++q ) {
+				if( n.child[q] != npos ) { stack[top++] = n.child[q]; }
+			}
+		}
+	}
+
+	// per depth totals, stats[d] for depth d, to see where boxes settle
+	//   and whether max_depth( ) is too small or large
+	void stats( std::vector<level_stats>& stats ) const {
+		level_stats zero = { 0, 0, 0, 0 };
+		stats.assign( m_max_depth + 1, zero );
+		visit_nodes( [&]( unsigned int depth, const rect2<T>&, unsigned int objects, unsigned int ) {
+			level_stats& s = stats[depth];
+			++s.nodes;
+			s.objects += objects;
+			s.max_objects = std::max( s.max_objects, objects );
+			if( objects == 0 ) { ++s.empty; }
+		} );
+	}
+
+private:
+
+	unsigned int alloc_node( double cx, double cy, double half, unsigned int parent, unsigned int depth ) {
+		unsigned int id;
+		if( !m_free_nodes.empty( ) ) {
+			id = m_free_nodes.back( );
+			m_free_nodes.pop_back( );
+		}
+		else {
+			id = m_nodes.size( );
+			m_nodes.push_back( node( ) );
+		}
+		node& n = m_nodes[id];
+		n.cx = cx;
+		n.cy = cy;
+		n.half = half;
+		n.parent = parent;
+		n.child[0] = n.child[1] = n.child[2] = n.child[3] = npos;
+		n.children = 0;
+		n.first = npos;
+		n.objects = 0;
+		n.depth = depth;
+		return id;
+	}
+
+	void set_box( unsigned int handle, const rect2<T>& rect ) {
+		item& it = m_items[handle];
+		it.l = rect.l;
+		it.r = rect.r;
+		it.t = rect.t;
+		it.b = rect.b;
+	}
+
+	static bool inside_loose( const node& n, const item& it ) {
+		const double reach = 2.0 * n.half;
+		return double(it.l) >= n.cx - reach && double(it.r) <= n.cx + reach &&
+		       double(it.t) >= n.cy - reach && double(it.b) <= n.cy + reach;
+	}
+
+	static rect2<T> loose_bounds( const node& n ) {
+		const double reach = 2.0 * n.half;
+		return rect2<T>( T(n.cx - reach), T(n.cx + reach), T(n.cy - reach), T(n.cy + reach) );
+	}
+
+	// files 'handle' in the deepest node it fits, making nodes on the way
+	void place( unsigned int handle ) {
+		const item& it = m_items[handle];
+		const double cx = ( double(it.l) + double(it.r) ) / 2.0;
+		const double cy = ( double(it.t) + double(it.b) ) / 2.0;
+		const double extent = std::max( double(it.r) - double(it.l), double(it.b) - double(it.t) ) / 2.0;
+
+		unsigned int id = m_root;
+		{
+			const node& root = m_nodes[m_root];
+			if( !( std::abs( cx - root.cx ) <= root.half && std::abs( cy - root.cy ) <= root.half ) ) {
+				link( handle, id );
+				return;
+			}
+		}
+		while( m_nodes[id].depth < m_max_depth ) {
+			const node& n = m_nodes[id];
+			const double half = n.half / 2.0;
+			if( extent > half ) { break; }
+			const unsigned int q = ( cx >= n.cx ? 1 : 0 ) + ( cy >= n.cy ? 2 : 0 );
+			unsigned int next = n.child[q];
+			if( next == npos ) {
+				next = alloc_node( n.cx + ( q & 1 ? half : -half ), n.cy + ( q & 2 ? half : -half ),
+				                   half, id, n.depth + 1 );
+				m_nodes[id].child[q] = next;
+				++m_nodes[id].children;
+			}
+			id = next;
+		}
+		link( handle, id );
+	}
+
+	void link( unsigned int handle, unsigned int id ) {
+		item& it = m_items[handle];
+		node& n = m_nodes[id];
+		it.node = id;
+		it.prev = npos;
+		it.next = n.first;
+		if( n.first != npos ) { m_items[n.first].prev = handle; }
+		n.first = handle;
+		++n.objects;
+	}
+
+	void unlink( unsigned int handle ) {
+		item& it = m_items[handle];
+		node& n = m_nodes[it.node];
+		if( it.prev != npos ) { m_items[it.prev].next = it.next; }
+		else { n.first = it.next; }
+		if( it.next != npos ) { m_items[it.next].prev = it.prev; }
+		--n.objects;
+	}
+
+	// hands empty leaves back to the pool, walking up
+	void prune( unsigned int id ) {
+		while( id != m_root && m_nodes[id].objects == 0 && m_nodes[id].children == 0 ) {
+			node& parent = m_nodes[m_nodes[id].parent];
+			for( int q = 0; q < 4; ++q ) {
+				if( parent.child[q] == id ) { parent.child[q] = npos; }
+			}
+			--parent.children;
+			m_free_nodes.push_back( id );
+			id = m_nodes[id].parent;
+		}
+	}
+
+	template<typename Visitor>
+	void search( T ql, T qr, T qt, T qb, Visitor& visit ) const {
+		const double l = ql, r = qr, t = qt, b = qb;
+		unsigned int stack[3 * depth_limit + 1];
+		unsigned int top = 0;
+		stack[top++] = m_root;
+		while( top > 0 ) {
+			const node& n = m_nodes[stack[--top]];
+			for( unsigned int h = n.first; h != npos; h = m_items[h].next ) {
+				const item& it = m_items[h];
+				if( it.l <= qr && ql <= it.r && it.t <= qb && qt <= it.b ) {
+					if( !visit( h ) ) { return; }
+				}
+			}
+			for( int q = 0; q < 4; ++q ) {
+				if( n.child[q] == npos ) { continue; }
+				const node& c = m_nodes[n.child[q]];
+				const double reach = 2.0 * c.half;
+				if( c.cx - reach <= r && l <= c.cx + reach && c.cy - reach <= b && t <= c.cy + reach ) {
+					stack[top++] = n.child[q];
+				}
+			}
+		}
+	}
+}; // End class loose_quadtree
+
+template<typename T>
+const unsigned int loose_quadtree<T>::npos;
+
+template<typename T>
+const unsigned int loose_quadtree<T>::depth_limit;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_LOOSE_QUADTREE_HPP
@@ -0,0 +1,365 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_OFFSET_HPP
+#define EUBLIB_OFFSET_HPP
+
+#include <vector>
+#include <deque>
+#include <limits>
+#include <cmath>
+#include "euclib_math.hpp"
+#include "polygon.hpp"
+#include "simple_polygon.hpp"
+#include "euclib_helper.hpp"
+#include "boolean.hpp"
+#include "euclib_parallel.hpp"
+
+/*
+ * Polygon offsetting (buffering)
+ *
+ *   offset( poly, delta ) moves every edge 'delta' along its outward
+ *   normal, positive to inflate and negative to deflate. Where the moved
+ *   edges leave a gap the corner is filled by the join style:
+ *
+ *     join_round  - an arc whose chords stay within 'arc_tolerance' of
+ *                   the true circle. The tolerance is a distance in the
+ *                   polygon's own units, clamped to between delta/10000
+ *                   and delta
+ *     join_miter  - the edges are extended until they meet, unless that
+ *                   point is more than 'miter_limit' times delta away in
+ *                   which case the corner is squared
+ *     join_square - the corner is cut square at distance delta
+ *
+ *   Deflating a convex polygon2 intersects the moved edges' half planes,
+ *   so the result is exact and may be null. Other polygons get the raw
+ *   offset curve, which runs back through each vertex where the moved
+ *   edges cross and so loops over itself wherever delta is larger than
+ *   a local feature. The curve winds once around the true offset and
+ *   zero or fewer times around the loops, so one sweep of it keeping
+ *   positive winding, see boolean.hpp, leaves simple rings only:
+ *   several where deflating pinches the polygon apart, with holes where
+ *   inflating closes a gap.
+ *
+ * References
+ *   [1] W. Tiller, E.G. Hanson. "Offsets of two-dimensional profiles".
+ *         IEEE Computer Graphics and Applications, vol. 4, no. 9,
+ *         pp. 36-46, 1984.
+ *   [2] F.P. Preparata, M.I. Shamos. "Computational Geometry: An
+ *         Introduction". Springer, 1985. sec. 7.2 (half-plane intersection)
+ */
+
+namespace euclib {
+
+	enum join_type : int {
+		join_round,
+		join_miter,
+		join_square
+	};
+
+	namespace detail {
+
+		// the raw offset curve of 'ring', moved 'delta' along its outward
+		//   normals and counter-clockwise, see the notes above
+		template<typename Ring>
+		void offset_ring( const Ring& ring, double delta, join_type join,
+		                  double miter_limit, double arc_tolerance,
+		                  std::vector<point2<double>>& out ) {
+			out.clear( );
+
+			// drop repeated points, the edges need a direction
+			std::vector<point2<double>> pts;
+			pts.reserve( ring.size( ) );
+			for( unsigned int i = 0; i < ring.size( ); ++i ) {
+				point2<double> pt( double(ring[i].x), double(ring[i].y) );
+				if( pts.empty( ) || pts.back( ) != pt ) { pts.push_back( pt ); }
+			}
+			while( pts.size( ) > 1 && pts.back( ) == pts.front( ) ) { pts.pop_back( ); }
+			const unsigned int n = pts.size( );
+			if( n < 3 ) { return; }
+
+			// walk counter-clockwise so outward is on the right
+			double area = 0.0;
+			for( unsigned int i = 0, j = n - 1; i < n; j = i++ ) {
+				area += pts[j].x * pts[i].y - pts[i].x * pts[j].y;
+			}
+			if( area < 0.0 ) { std::reverse( pts.begin( ), pts.end( ) ); }
+
+			// unit edge directions
+			std::vector<point2<double>> dir( n );
+			for( unsigned int i = 0; i < n; ++i ) {
+				const point2<double>& a = pts[i];
+				const point2<double>& b = pts[i + 1 == n ? 0 : i + 1];
+				double len = std::sqrt( ( b.x - a.x ) * ( b.x - a.x ) + ( b.y - a.y ) * ( b.y - a.y ) );
+				dir[i] = point2<double>( ( b.x - a.x ) / len, ( b.y - a.y ) / len );
+			}
+
+			const double k = std::abs( delta );
+			const double sgn = delta < 0.0 ? -1.0 : 1.0;
+			// chord angle that keeps an arc of radius k within tolerance
+			double tol = std::max( std::min( arc_tolerance, k ), k * 1e-4 );
+			double step = 2.0 * std::acos( 1.0 - tol / k );
+			double limit_sq = miter_limit * miter_limit;
+
+			out.reserve( 2 * n );
+			for( unsigned int i = 0; i < n; ++i ) {
+				const point2<double>& p = pts[i];
+				const point2<double>& e1 = dir[i == 0 ? n - 1 : i - 1];
+				const point2<double>& e2 = dir[i];
+				// offset directions of the incoming and outgoing edges
+				point2<double> n1( sgn * e1.y, -sgn * e1.x );
+				point2<double> n2( sgn * e2.y, -sgn * e2.x );
+				double sin_a = e1.x * e2.y - e1.y * e2.x;
+				double cos_a = e1.x * e2.x + e1.y * e2.y;
+
+				// straight through
+				if( std::abs( sin_a ) < 1e-12 && cos_a > 0.0 ) {
+					out.push_back( point2<double>( p.x + k * n1.x, p.y + k * n1.y ) );
+					continue;
+				}
+
+				// the moved edges cross, run through the vertex so the
+				//   ring keeps its winding, this is where loops come from
+				if( sgn * sin_a < 0.0 ) {
+					out.push_back( point2<double>( p.x + k * n1.x, p.y + k * n1.y ) );
+					out.push_back( p );
+					out.push_back( point2<double>( p.x + k * n2.x, p.y + k * n2.y ) );
+					continue;
+				}
+
+				double dot_n = n1.x * n2.x + n1.y * n2.y;
+				join_type style = join;
+				if( style == join_miter && 2.0 / ( 1.0 + dot_n ) > limit_sq ) { style = join_square; }
+
+				if( style == join_miter ) {
+					double r = k / ( 1.0 + dot_n );
+					out.push_back( point2<double>( p.x + r * ( n1.x + n2.x ), p.y + r * ( n1.y + n2.y ) ) );
+				}
+				else if( style == join_square ) {
+					// cut perpendicular to the bisector at distance k
+					point2<double> b( n1.x + n2.x, n1.y + n2.y );
+					double len = std::sqrt( b.x * b.x + b.y * b.y );
+					if( len < 1e-12 ) { b = e1; }
+					else { b = point2<double>( b.x / len, b.y / len ); }
+					double t1 = k * ( 1.0 - ( n1.x * b.x + n1.y * b.y ) ) / ( e1.x * b.x + e1.y * b.y );
+					double t2 = k * ( 1.0 - ( n2.x * b.x + n2.y * b.y ) ) / -( e2.x * b.x + e2.y * b.y );
+					out.push_back( point2<double>( p.x + k * n1.x + t1 * e1.x, p.y + k * n1.y + t1 * e1.y ) );
+					out.push_back( point2<double>( p.x + k * n2.x - t2 * e2.x, p.y + k * n2.y - t2 * e2.y ) );
+				}
+				else {
+					double angle = std::atan2( n1.x * n2.y - n1.y * n2.x, dot_n );
+					unsigned int steps = std::max( 1u, static_cast<unsigned int>( std::ceil( std::abs( angle ) / step ) ) );
+					double c = std::cos( angle / steps ), s = std::sin( angle / steps );
+					point2<double> r = n1;
+					for( unsigned int j = 0; j <= steps; ++j ) {
+						out.push_back( point2<double>( p.x + k * r.x, p.y + k * r.y ) );
+						r = point2<double>( r.x * c - r.y * s, r.x * s + r.y * c );
+					}
+				}
+			}
+		}
+
+		// a directed line, the half plane kept is on its left
+		struct half_plane {
+			double px, py, dx, dy;
+
+			bool contains( double x, double y ) const {
+				return dx * ( y - py ) - dy * ( x - px ) >= -1e-9 * ( std::abs( dx ) + std::abs( dy ) );
+			}
+		};
+
+		// false for (anti)parallel lines
+		inline bool meet( const half_plane& a, const half_plane& b, double& x, double& y ) {
+			double den = a.dx * b.dy - a.dy * b.dx;
+			if( std::abs( den ) < 1e-12 ) { return false; }
+			double t = ( ( b.px - a.px ) * b.dy - ( b.py - a.py ) * b.dx ) / den;
+			x = a.px + t * a.dx;
+			y = a.py + t * a.dy;
+			return true;
+		}
+
+		// intersection of half planes already sorted by angle, a convex
+		//   counter-clockwise ring or nothing if it is empty or flat
+		template<typename T>
+		void intersect_half_planes( const std::vector<half_plane>& planes,
+		                            std::vector<point2<T>>& out ) {
+			out.clear( );
+			std::deque<half_plane> dq;
+			double x, y;
+			for( unsigned int i = 0; i < planes.size( ); ++i ) {
+				const half_plane& hp = planes[i];
+				while( dq.size( ) >= 2 && meet( dq[dq.size( ) - 2], dq.back( ), x, y ) &&
+				       !hp.contains( x, y ) ) {
+					dq.pop_back( );
+				}
+				while( dq.size( ) >= 2 && meet( dq[0], dq[1], x, y ) && !hp.contains( x, y ) ) {
+					dq.pop_front( );
+				}
+				dq.push_back( hp );
+			}
+			while( dq.size( ) >= 3 && meet( dq[dq.size( ) - 2], dq.back( ), x, y ) &&
+			       !dq.front( ).contains( x, y ) ) {
+				dq.pop_back( );
+			}
+			while( dq.size( ) >= 3 && meet( dq[0], dq[1], x, y ) && !dq.back( ).contains( x, y ) ) {
+				dq.pop_front( );
+			}
+			if( dq.size( ) < 3 ) { return; }
+
+			// an empty intersection leaves corners outside some plane
+			std::vector<point2<double>> corners( dq.size( ) );
+			double area = 0.0;
+			for( unsigned int i = 0; i < dq.size( ); ++i ) {
+				if( !meet( dq[i], dq[i + 1 == dq.size( ) ? 0 : i + 1], x, y ) ) { return; }
+				corners[i] = point2<double>( x, y );
+			}
+			for( unsigned int i = 0, j = corners.size( ) - 1; i < corners.size( ); j = i++ ) {
+				area += corners[j].x * corners[i].y - corners[i].x * corners[j].y;
+				for( unsigned int p = 0; p < dq.size( ); ++p ) {
+					if( !dq[p].contains( corners[i].x, corners[i].y ) ) { return; }
+				}
+			}
+			if( area <= 0.0 ) { return; }
+
+			for( unsigned int i = 0; i < corners.size( ); ++i ) {
+				point2<T> pt( round_to<T>( corners[i].x ), round_to<T>( corners[i].y ) );
+				if( out.empty( ) || out.back( ) != pt ) { out.push_back( pt ); }
+			}
+			while( out.size( ) > 1 && out.back( ) == out.front( ) ) { out.pop_back( ); }
+		}
+
+	} // End namespace detail
+
+
+	// friend function
+	template<typename T>
+	polygon2<T> offset( const polygon2<T>& poly, double delta, join_type join,
+	                    double miter_limit, double arc_tolerance ) {
+		if( poly == polygon2<T>::null( ) || delta == 0.0 ) { return poly; }
+
+		std::vector<point2<T>> ring;
+		if( delta > 0.0 ) {
+			// a convex ring's offset curve has no loops
+			std::vector<point2<double>> raw;
+			detail::offset_ring( poly.m_hull, delta, join, miter_limit, arc_tolerance, raw );
+			for( unsigned int i = 0; i < raw.size( ); ++i ) {
+				point2<T> pt( round_to<T>( raw[i].x ), round_to<T>( raw[i].y ) );
+				if( ring.empty( ) || ring.back( ) != pt ) { ring.push_back( pt ); }
+			}
+		}
+		else {
+			// the hull starts at its lowest vertex so its edges are
+			//   already in angle order
+			const unsigned int n = poly.m_hull.size( );
+			unsigned int start = detail::lowest_vertex( poly.m_hull );
+			std::vector<detail::half_plane> planes;
+			planes.reserve( n );
+			for( unsigned int i = 0; i < n; ++i ) {
+				const point2<T>& a = poly.m_hull[( start + i ) % n];
+				const point2<T>& b = poly.m_hull[( start + i + 1 ) % n];
+				double dx = double(b.x) - double(a.x), dy = double(b.y) - double(a.y);
+				double len = std::sqrt( dx * dx + dy * dy );
+				if( len == 0.0 ) { continue; }
+				// move the edge along its outward normal
+				detail::half_plane hp = { double(a.x) + delta * dy / len,
+				                          double(a.y) - delta * dx / len, dx, dy };
+				planes.push_back( hp );
+			}
+			detail::intersect_half_planes( planes, ring );
+		}
+
+		// keep the convex ring free of collinear points
+		polygon2<T> result;
+		for( unsigned int i = 0; i < ring.size( ); ++i ) {
+			while( result.m_hull.size( ) >= 2 &&
+			       detail::orientation( result.m_hull[result.m_hull.size( ) - 2],
+			                            result.m_hull.back( ), ring[i] ) <= 0 ) {
+				result.m_hull.pop_back( );
+			}
+			result.m_hull.push_back( ring[i] );
+		}
+		while( result.m_hull.size( ) >= 3 &&
+		       detail::orientation( result.m_hull[result.m_hull.size( ) - 2],
+		                            result.m_hull.back( ), result.m_hull[0] ) <= 0 ) {
+			result.m_hull.pop_back( );
+		}
+		if( result.m_hull.size( ) < 3 ) { return polygon2<T>::null( ); }
+
+		// start where graham_hull( ) would
+		std::rotate( result.m_hull.begin( ),
+		             result.m_hull.begin( ) + detail::lowest_vertex( result.m_hull ),
+		             result.m_hull.end( ) );
+		result.calc_bounding_box( );
+		return result;
+	}
+
+	template<typename T> inline
+	polygon2<T> offset( const polygon2<T>& poly, double delta, join_type join = join_round ) {
+		return offset( poly, delta, join, 2.0, 0.25 );
+	}
+
+	// the offset of a simple polygon, see the notes above, as exterior
+	//   rings counter-clockwise each followed by its holes clockwise
+	template<typename T>
+	void offset( const simple_polygon2<T>& poly, double delta,
+	             std::vector<std::vector<point2<T>>>& rings, join_type join = join_round,
+	             double miter_limit = 2.0, double arc_tolerance = 0.25 ) {
+		rings.clear( );
+		if( poly == simple_polygon2<T>::null( ) ) { return; }
+		if( delta == 0.0 ) {
+			rings.push_back( poly.points( ) );
+			return;
+		}
+
+		// the points the raw curve winds around are the offset
+		detail::martinez::rings_t raw( 1 ), none, result;
+		detail::offset_ring( poly.points( ), delta, join, miter_limit, arc_tolerance, raw[0] );
+		detail::martinez sweep;
+		sweep.run( raw, none, op_union, result, fill_positive );
+		detail::from_double( result, rings );
+	}
+
+
+	// batch versions, the shapes are shared out over 'threads' threads
+	//   (0 for one per core), result[i] is the offset of polys[i]
+
+	template<typename T>
+	void offset( const std::vector<polygon2<T>>& polys, double delta,
+	             std::vector<polygon2<T>>& result, join_type join = join_round,
+	             double miter_limit = 2.0, double arc_tolerance = 0.25,
+	             unsigned int threads = 0 ) {
+		result.resize( polys.size( ) );
+		parallel_for( 0, polys.size( ), [&]( unsigned int i ) {
+			result[i] = offset( polys[i], delta, join, miter_limit, arc_tolerance );
+		}, threads );
+	}
+
+	template<typename T>
+	void offset( const std::vector<simple_polygon2<T>>& polys, double delta,
+	             std::vector<std::vector<std::vector<point2<T>>>>& result,
+	             join_type join = join_round, double miter_limit = 2.0,
+	             double arc_tolerance = 0.25, unsigned int threads = 0 ) {
+		result.resize( polys.size( ) );
+		parallel_for( 0, polys.size( ), [&]( unsigned int i ) {
+			offset( polys[i], delta, result[i], join, miter_limit, arc_tolerance );
+		}, threads );
+	}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_OFFSET_HPP
@@ -0,0 +1,462 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_PACKED_RTREE_HPP
+#define EUBLIB_PACKED_RTREE_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include "point.hpp"
+#include "rect.hpp"
+#include "euclib_parallel.hpp"
+#include "curve.hpp"
+#include "index_file.hpp"
+
+/*
+ * Static R-tree packed into flat arrays
+ *
+ *   The boxes are sorted along a Hilbert curve through their centres and
+ *   cut into nodes of node_size( ) boxes, then the node boxes are cut the
+ *   same way until one root is left [1]. Every level is stored one after
+ *   the other in a single array, leaves first, so a node's children are
+ *   found by arithmetic and there are no pointers to chase.
+ *
+ *   str_packing instead sorts every level Sort-Tile-Recursive [3]: by x
+ *   into vertical slabs of about sqrt( nodes ) nodes, then by y within
+ *   each slab. Its leaves are tighter, but boxes near each other can be
+ *   a slab apart in memory, so which searches faster depends on the data.
+ *   Both sorts are one parallel radix_sort( ) over the whole level, the
+ *   slab going in the high bits of the second key, so the extra memory is
+ *   a key and an index per box.
+ *
+ *   Built once, it cannot be changed. Null boxes are left out, searches
+ *   report the index each box had in the vector given to the constructor.
+ *   A built tree can be saved to a file and later mapped back with open( ),
+ *   searching it in place without reading it in, see index_file.hpp.
+ *
+ * References
+ *   [1] I. Kamel, C. Faloutsos. "On Packing R-trees". Proceedings of the
+ *         2nd International Conference on Information and Knowledge
+ *         Management, pp. 490-499, 1993.
+ *   [2] V. Agafonkin. "Flatbush", https://github.com/mourner/flatbush
+ *   [3] S. T. Leutenegger, M. A. Lopez, J. Edgington. "STR: A Simple and
+ *         Efficient Algorithm for R-Tree Packing". Proceedings of the 13th
+ *         International Conference on Data Engineering, pp. 497-506, 1997.
+ */
+
+namespace euclib {
+
+enum rtree_packing { hilbert_packing, str_packing };
+
+template<typename T>
+class packed_rtree {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+	// deepest tree possible with 2^32 boxes and nodes of 2
+	static const unsigned int max_levels = 33;
+
+public:
+
+	// (distance squared, position) pairs, kept between nearest( ) calls to
+	//   reuse the memory
+	typedef std::vector<std::pair<double, unsigned int>> nearest_queue;
+
+
+// Variables
+private:
+
+	unsigned int                      m_node_size;
+	unsigned int                      m_count;      // boxes stored, the leaves
+	detail::flat_array<T>             m_boxes;      // l, r, t, b of every node, leaves first
+	detail::flat_array<unsigned int>  m_indices;    // leaf: input index, other: first child
+	std::vector<unsigned int>         m_level_end;  // one past the last node of each level
+
+
+// Constructors
+public:
+
+	packed_rtree( ) : m_node_size( 16 ), m_count( 0 ) { }
+
+	// maps a tree saved to 'path', empty if it cannot, see open( )
+	explicit packed_rtree( const std::string& path, bool verify = false ) :
+		m_node_size( 16 ),
+		m_count( 0 )
+	{
+		open( path, verify );
+	}
+
+	// 'threads' as for parallel_for( ), 0 for one per core
+	packed_rtree( const std::vector<rect2<T>>& boxes, unsigned int node_size = 16,
+	              unsigned int threads = 0, rtree_packing packing = hilbert_packing ) {
+		build( boxes, node_size, threads, packing );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const      { return m_count; }
+	bool empty( ) const             { return m_count == 0; }
+	unsigned int node_size( ) const { return m_node_size; }
+	unsigned int levels( ) const    { return m_level_end.size( ); }
+	bool mapped( ) const            { return m_boxes.mapped( ); }
+
+	rect2<T> bounding_box( ) const {
+		if( m_count == 0 ) { return rect2<T>::null( ); }
+		return box( m_boxes.size( ) / 4 - 1 );
+	}
+
+	void build( const std::vector<rect2<T>>& boxes, unsigned int node_size = 16,
+	            unsigned int threads = 0, rtree_packing packing = hilbert_packing ) {
+		m_node_size = std::max( node_size, 2u );
+		m_boxes.clear( );
+		m_indices.clear( );
+		m_level_end.clear( );
+
+		std::vector<uint32_t> order;
+		order.reserve( boxes.size( ) );
+		double l = std::numeric_limits<double>::max( ), t = l;
+		double r = -l, b = -l;
+		for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+			if( boxes[i] == rect2<T>::null( ) ) { continue; }
+			order.push_back( i );
+			l = std::min( l, double(boxes[i].l) );
+			r = std::max( r, double(boxes[i].r) );
+			t = std::min( t, double(boxes[i].t) );
+			b = std::max( b, double(boxes[i].b) );
+		}
+		m_count = order.size( );
+		if( m_count == 0 ) { return; }
+
+		// level sizes, so every array is allocated once
+		const unsigned int total = count_levels( );
+		m_boxes.resize( 4 * total );
+		m_indices.resize( total );
+
+		if( packing == str_packing ) {
+			str_order( order, [&]( uint32_t i, double& x, double& y ) {
+				x = ( double(boxes[i].l) + double(boxes[i].r) ) / 2.0;
+				y = ( double(boxes[i].t) + double(boxes[i].b) ) / 2.0;
+			}, l, r, t, b, threads );
+		}
+		else {
+			// centres along the curve, which only needs to be 16 bits a side
+			std::vector<uint32_t> keys( m_count );
+			const double sx = r > l ? 65535.0 / ( r - l ) : 0.0;
+			const double sy = b > t ? 65535.0 / ( b - t ) : 0.0;
+			parallel_for( 0, m_count, [&]( unsigned int i ) {
+				const rect2<T>& rc = boxes[order[i]];
+				double cx = ( double(rc.l) + double(rc.r) ) / 2.0;
+				double cy = ( double(rc.t) + double(rc.b) ) / 2.0;
+				keys[i] = detail::hilbert_index( uint32_t( ( cx - l ) * sx ), uint32_t( ( cy - t ) * sy ) );
+			}, threads, 4096 );
+			radix_sort( keys, order, threads );
+		}
+
+		parallel_for( 0, m_count, [&]( unsigned int i ) {
+			const rect2<T>& rc = boxes[order[i]];
+			T* out = &m_boxes[4 * i];
+			out[0] = rc.l;
+			out[1] = rc.r;
+			out[2] = rc.t;
+			out[3] = rc.b;
+			m_indices[i] = order[i];
+		}, threads, 4096 );
+
+		// each parent covers the next node_size( ) nodes of the level below
+		for( unsigned int level = 1; level < m_level_end.size( ); ++level ) {
+			const unsigned int child_begin = level_begin( level - 1 );
+			const unsigned int child_end = m_level_end[level - 1];
+			const unsigned int begin = level_begin( level );
+			if( packing == str_packing && level > 1 ) { str_level( level - 1, l, r, t, b, threads ); }
+			parallel_for( begin, m_level_end[level], [&]( unsigned int node ) {
+				unsigned int first = child_begin + ( node - begin ) * m_node_size;
+				unsigned int last = std::min( first + m_node_size, child_end );
+				T* out = &m_boxes[4 * node];
+				const T* in = &m_boxes[4 * first];
+				out[0] = in[0]; out[1] = in[1]; out[2] = in[2]; out[3] = in[3];
+				for( unsigned int c = first + 1; c < last; ++c ) {
+					in = &m_boxes[4 * c];
+					out[0] = std::min( out[0], in[0] );
+					out[1] = std::max( out[1], in[1] );
+					out[2] = std::min( out[2], in[2] );
+					out[3] = std::max( out[3], in[3] );
+				}
+				m_indices[node] = first;
+			}, threads, 1024 );
+		}
+	}
+
+	// calls visit( index ) for every box overlapping 'window', stopping
+	//   early if visit returns false. Touching counts as overlapping. No
+	//   memory is allocated.
+	template<typename Visitor>
+	void search( const rect2<T>& window, Visitor visit ) const {
+		if( m_count == 0 || window == rect2<T>::null( ) ) { return; }
+		search( window.l, window.r, window.t, window.b, visit );
+	}
+
+	// appends every box overlapping 'window' to 'result'
+	void search( const rect2<T>& window, std::vector<unsigned int>& result ) const {
+		search( window, [&]( unsigned int index ) {
+			result.push_back( index );
+			return true;
+		} );
+	}
+
+	// calls visit( index ) for every box containing 'pt'
+	template<typename Visitor>
+	void search( const point2<T>& pt, Visitor visit ) const {
+		if( m_count == 0 || pt == point2<T>::null( ) ) { return; }
+		search( pt.x, pt.x, pt.y, pt.y, visit );
+	}
+
+	void search( const point2<T>& pt, std::vector<unsigned int>& result ) const {
+		search( pt, [&]( unsigned int index ) {
+			result.push_back( index );
+			return true;
+		} );
+	}
+
+	// calls visit( index, distance ) for boxes in order of distance from
+	//   'pt', 0 for boxes containing it, until visit returns false or
+	//   every box within 'max_distance' has been seen. 'queue' is scratch
+	//   space that can be kept between calls.
+	template<typename Visitor>
+	void nearest( const point2<T>& pt, Visitor visit, nearest_queue& queue,
+	              double max_distance = std::numeric_limits<double>::infinity( ) ) const {
+		queue.clear( );
+		if( m_count == 0 ) { return; }
+		typedef std::greater<std::pair<double, unsigned int>> later;
+		const double max_sq = max_distance * max_distance;
+		const double x = pt.x, y = pt.y;
+
+		queue.push_back( std::make_pair( distance_sq( m_boxes.size( ) / 4 - 1, x, y ), m_boxes.size( ) / 4 - 1 ) );
+		while( !queue.empty( ) ) {
+			std::pop_heap( queue.begin( ), queue.end( ), later( ) );
+			std::pair<double, unsigned int> top = queue.back( );
+			queue.pop_back( );
+			if( top.first > max_sq ) { break; }
+
+			// a leaf, nothing left in the queue can be closer
+			if( top.second < m_count ) {
+				if( !visit( m_indices[top.second], std::sqrt( top.first ) ) ) { return; }
+				continue;
+			}
+			unsigned int level = level_of( top.second );
+			unsigned int first = m_indices[top.second];
+			unsigned int last = std::min( first + m_node_size, m_level_end[level - 1] );
+			for( unsigned int c = first; c < last; ++c ) {
+				double d = distance_sq( c, x, y );
+				if( d <= max_sq ) {
+					queue.push_back( std::make_pair( d, c ) );
+					std::push_heap( queue.begin( ), queue.end( ), later( ) );
+				}
+			}
+		}
+	}
+
+	// the (at most) k boxes nearest 'pt', closest first
+	void nearest( const point2<T>& pt, unsigned int k, std::vector<unsigned int>& result,
+	              double max_distance = std::numeric_limits<double>::infinity( ) ) const {
+		result.clear( );
+		if( k == 0 ) { return; }
+		nearest_queue queue;
+		nearest( pt, [&]( unsigned int index, double ) {
+			result.push_back( index );
+			return result.size( ) < k;
+		}, queue, max_distance );
+	}
+
+	// writes the tree to 'path' in the format of index_file.hpp
+	bool save( const std::string& path ) const {
+		const uint32_t params[4] = { m_node_size, m_count, uint32_t(m_level_end.size( )), 0 };
+		std::vector<detail::index_array> arrays( 2 );
+		arrays[0].data = m_boxes.data( );
+		arrays[0].bytes = uint64_t(m_boxes.size( )) * sizeof(T);
+		arrays[1].data = m_indices.data( );
+		arrays[1].bytes = uint64_t(m_indices.size( )) * sizeof(unsigned int);
+		return detail::write_index( path, detail::packed_rtree_index, detail::scalar_code<T>( ),
+		                            params, arrays );
+	}
+
+	// maps a tree written by save( ) and searches it where it lies in the
+	//   file, which must not change while mapped. 'verify' also checks the
+	//   arrays against their checksums, reading the whole file. Returns
+	//   false, leaving the tree as it was, if the file is not such a tree.
+	bool open( const std::string& path, bool verify = false ) {
+		static_assert( sizeof(unsigned int) == 4, "indices are stored as 32 bits" );
+		std::shared_ptr<const detail::mapped_file> file =
+			detail::open_index( path, detail::packed_rtree_index, detail::scalar_code<T>( ), 2, verify );
+		if( !file ) { return false; }
+
+		const detail::index_header& header = detail::header_of( *file );
+		packed_rtree tree;
+		tree.m_node_size = header.params[0];
+		tree.m_count = header.params[1];
+		if( tree.m_node_size < 2 ) { return false; }
+		const unsigned int total = tree.m_count == 0 ? 0 : tree.count_levels( );
+		if( tree.m_level_end.size( ) != header.params[2] ||
+		    !detail::map_section( tree.m_boxes, file, 0, 4 * std::size_t(total) ) ||
+		    !detail::map_section( tree.m_indices, file, 1, total ) ) {
+			return false;
+		}
+		*this = std::move( tree );
+		return true;
+	}
+
+private:
+
+	// sorts 'order' by x into slabs, then each slab by y. centre( i, x, y )
+	//   gives the centre of item i, inside the box from ( l, t ) to ( r, b ).
+	template<typename Centre>
+	void str_order( std::vector<uint32_t>& order, Centre centre, double l, double r,
+	                double t, double b, unsigned int threads ) const {
+		const unsigned int n = order.size( );
+		const unsigned int nodes = ( n + m_node_size - 1 ) / m_node_size;
+		const unsigned int slabs = std::ceil( std::sqrt( double(nodes) ) );
+		const unsigned int slab_size = slabs * m_node_size;
+		unsigned int slab_bits = 0;
+		while( ( 1u << slab_bits ) < slabs ) { ++slab_bits; }
+
+		// positions scaled to 32 bit keys, less the bits of the slab for y
+		const double top = 4294967295.0;
+		const double sx = r > l ? top / ( r - l ) : 0.0;
+		const double sy = b > t ? double( 0xFFFFFFFFu >> slab_bits ) / ( b - t ) : 0.0;
+
+		std::vector<uint32_t> keys( n );
+		parallel_for( 0, n, [&]( unsigned int i ) {
+			double x, y;
+			centre( order[i], x, y );
+			keys[i] = uint32_t( std::min( ( x - l ) * sx, top ) );
+		}, threads, 4096 );
+		radix_sort( keys, order, threads );
+
+		parallel_for( 0, n, [&]( unsigned int i ) {
+			double x, y;
+			centre( order[i], x, y );
+			uint32_t slab = slab_bits == 0 ? 0 : ( i / slab_size ) << ( 32 - slab_bits );
+			keys[i] = slab | uint32_t( std::min( ( y - t ) * sy, top ) );
+		}, threads, 4096 );
+		radix_sort( keys, order, threads );
+	}
+
+	// reorders the nodes of 'level' by str_order( ), children following
+	void str_level( unsigned int level, double l, double r, double t, double b,
+	                unsigned int threads ) {
+		const unsigned int begin = level_begin( level );
+		const unsigned int n = m_level_end[level] - begin;
+		std::vector<uint32_t> order( n );
+		for( unsigned int i = 0; i < n; ++i ) { order[i] = i; }
+		str_order( order, [&]( uint32_t i, double& x, double& y ) {
+			const T* in = &m_boxes[4 * ( begin + i )];
+			x = ( double(in[0]) + double(in[1]) ) / 2.0;
+			y = ( double(in[2]) + double(in[3]) ) / 2.0;
+		}, l, r, t, b, threads );
+
+		std::vector<T> boxes( 4 * std::size_t(n) );
+		std::vector<unsigned int> indices( n );
+		parallel_for( 0, n, [&]( unsigned int i ) {
+			const T* in = &m_boxes[4 * ( begin + order[i] )];
+			std::copy( in, in + 4, &boxes[4 * std::size_t(i)] );
+			indices[i] = m_indices[begin + order[i]];
+		}, threads, 4096 );
+		parallel_for( 0, n, [&]( unsigned int i ) {
+			std::copy( &boxes[4 * std::size_t(i)], &boxes[4 * std::size_t(i)] + 4, &m_boxes[4 * ( begin + i )] );
+			m_indices[begin + i] = indices[i];
+		}, threads, 4096 );
+	}
+
+	// fills m_level_end for m_count boxes, returning the number of nodes
+	unsigned int count_levels( ) {
+		m_level_end.clear( );
+		unsigned int total = 0;
+		for( unsigned int n = m_count; ; n = ( n + m_node_size - 1 ) / m_node_size ) {
+			total += n;
+			m_level_end.push_back( total );
+			if( n == 1 ) { break; }
+		}
+		return total;
+	}
+
+	unsigned int level_begin( unsigned int level ) const {
+		return level == 0 ? 0 : m_level_end[level - 1];
+	}
+
+	unsigned int level_of( unsigned int node ) const {
+		unsigned int level = 0;
+		while( node >= m_level_end[level] ) { ++level; }
+		return level;
+	}
+
+	rect2<T> box( unsigned int node ) const {
+		const T* in = &m_boxes[4 * node];
+		return rect2<T>( in[0], in[1], in[2], in[3] );
+	}
+
+	double distance_sq( unsigned int node, double x, double y ) const {
+		const T* in = &m_boxes[4 * node];
+		double dx = std::max( std::max( double(in[0]) - x, x - double(in[1]) ), 0.0 );
+		double dy = std::max( std::max( double(in[2]) - y, y - double(in[3]) ), 0.0 );
+		return dx * dx + dy * dy;
+	}
+
+	// depth first, one cursor per level in place of a stack
+	template<typename Visitor>
+	void search( T ql, T qr, T qt, T qb, Visitor& visit ) const {
+		unsigned int cursor[max_levels], last[max_levels];
+		int level = m_level_end.size( ) - 1;
+		cursor[level] = m_level_end[level] - 1;
+		last[level] = m_level_end[level];
+
+		while( level < int(m_level_end.size( )) ) {
+			if( cursor[level] == last[level] ) {
+				++level;
+				continue;
+			}
+			unsigned int node = cursor[level]++;
+			const T* in = &m_boxes[4 * node];
+			if( in[0] > qr || ql > in[1] || in[2] > qb || qt > in[3] ) { continue; }
+			if( level == 0 ) {
+				if( !visit( m_indices[node] ) ) { return; }
+				continue;
+			}
+			--level;
+			cursor[level] = m_indices[node];
+			last[level] = std::min( m_indices[node] + m_node_size, m_level_end[level] );
+		}
+	}
+}; // End class packed_rtree
+
+}  // End namespace euclib
+
+#endif // EUBLIB_PACKED_RTREE_HPP
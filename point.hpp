@@ -20,6 +20,8 @@
 #define EUBLIB_POINT_HPP
 
 #include <array>
+#include <limits>
+#include <ostream>
 
 #include "type_traits.hpp"
 #include "euclib_math.hpp"
@@ -305,6 +307,77 @@ public:
 }; // End class point<T,4>
 
 
+// A plain 2D point with public coordinates, usable with any scalar type.
+//   The 2D shapes (rect2, polygon2) and the spatial indexes are written
+//   against it, where point<T,2> would limit them to floating point.
+template<typename T>
+class point2 {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+// Variables
+public:
+
+	T x, y;
+
+private:
+
+	static T invalid; // holds either limit_t::infinity or limit_t::max
+
+
+// Constructors
+public:
+
+	point2( ) : x( 0 ), y( 0 ) { }
+	point2( T x_, T y_ ) : x( x_ ), y( y_ ) { }
+
+
+// Methods
+public:
+
+	// Returns a null point, defined as inf/max for both
+	static point2<T> null( ) {
+		return point2<T>( invalid, invalid );
+	}
+
+
+// Operators
+public:
+
+	bool operator == ( const point2<T>& pt ) const {
+		return x == pt.x && y == pt.y;
+	}
+
+	bool operator != ( const point2<T>& pt ) const {
+		return !(*this == pt);
+	}
+
+	friend std::ostream& operator << ( std::ostream& stream, const point2<T>& pt ) {
+		#ifdef GNUPLOT
+			return stream << pt.x << " " << pt.y << "\n";
+		#else
+			return stream << "(" << pt.x << "," << pt.y << ")";
+		#endif
+	}
+
+}; // End class point2<T>
+
+// Initialize invalid with either infinity or max
+template<typename T>
+T point2<T>::invalid = ( point2<T>::limit_t::has_infinity ?
+                             point2<T>::limit_t::infinity( )
+                         : // else
+                             point2<T>::limit_t::max( )
+                       );
+
+
 // Various typedefs to make usage easier
 typedef point<float,2>         point2f;
 typedef point<float,3>         point3f;
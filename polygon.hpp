@@ -19,7 +19,7 @@
 #ifndef EUBLIB_POLYGON_HPP
 #define EUBLIB_POLYGON_HPP
 
-#include <ostream>
+#include <iostream>
 #include <limits>
 #include <complex>
 #include <vector>
@@ -28,9 +28,21 @@
 #include "point.hpp"
 #include "rect.hpp"
 #include "segment.hpp"
+#include "small_vector.hpp"
+
+// hulls of up to this many vertices are stored without allocating
+#ifndef EUCLIB_POLYGON_INLINE_SIZE
+	#define EUCLIB_POLYGON_INLINE_SIZE 8
+#endif
 
 namespace euclib {
 
+// defined in euclib_helper.hpp
+struct separating_axis;
+struct penetration;
+// defined in offset.hpp
+enum join_type : int;
+
 template<typename T>
 class polygon2 {
 // Typedefs
@@ -43,25 +55,42 @@ protected:
 	static_assert( limit_t::is_specialized,
 	               "type not compatible with std::numeric_limits" );
 
+	typedef small_vector<point2<T>, EUCLIB_POLYGON_INLINE_SIZE> hull_t;
+
 // Friend functions
 public:
 	// defined in euclib_helper.hpp
 	template<typename T_Ex> friend
 	polygon2<T_Ex> translate( const polygon2<T_Ex>& poly, T_Ex x, T_Ex y );
 	template<typename T_Ex> friend
-	polygon2<T_Ex> rotate( const polygon2<T_Ex>& target, const point2<T_Ex>& about, float angle, bool clockwise = true );
+	polygon2<T_Ex> rotate( const polygon2<T_Ex>& target, const point2<T_Ex>& about, float angle, bool clockwise );
 	template<typename T_Ex> friend
 	polygon2<T_Ex> mirror( const polygon2<T_Ex>& target, const line2<T_Ex>& over );
 	template<typename T_Ex> friend
 	point2<T_Ex> overlap( const point2<T_Ex>& pt, const polygon2<T_Ex>& poly );
 	template<typename T_Ex> friend
 	line2<T_Ex> overlap( const line2<T_Ex>& line, const polygon2<T_Ex>& poly );
+	template<typename T_Ex> friend
+	polygon2<T_Ex> overlap( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2 );
+	template<typename T_Ex> friend
+	polygon2<T_Ex> overlap( const rect2<T_Ex>& rect, const polygon2<T_Ex>& poly );
+	template<typename T_Ex> friend
+	bool intersects( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2, separating_axis& axis );
+	template<typename T_Ex> friend
+	bool intersects( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2, separating_axis& axis, penetration& result );
+	template<typename T_Ex> friend
+	polygon2<T_Ex> minkowski_sum( const polygon2<T_Ex>& poly1, const polygon2<T_Ex>& poly2 );
+	template<typename T_Ex> friend
+	void minkowski_sum( const polygon2<T_Ex>& poly, const std::vector<polygon2<T_Ex>>& others, std::vector<polygon2<T_Ex>>& result );
+	// defined in offset.hpp
+	template<typename T_Ex> friend
+	polygon2<T_Ex> offset( const polygon2<T_Ex>& poly, double delta, join_type join, double miter_limit, double arc_tolerance );
 
 // Variables
 private:
 
-	std::vector<point2<T>>  m_hull;
-	rect2<T>                m_bounding_box;
+	hull_t    m_hull;
+	rect2<T>  m_bounding_box;
 
 	static T invalid; // holds either limit_t::infinity or limit_t::max
 
@@ -70,7 +99,6 @@ private:
 public:
 
 	polygon2( ) {
-		m_hull.reserve( 3 ); // 3 is minimum to make polygon
 		set_null( );
 	}
 	polygon2( const polygon2<T>& poly ) { *this = poly; }
@@ -168,8 +196,9 @@ private:
 		calc_bounding_box( );
 	}
 
-	T direction( const point2<T>& pt0, const point2<T>& pt1, const point2<T>& pt2 ) const {
-		return ( (pt1.x-pt0.x)*(pt2.y-pt0.y) - (pt1.y-pt0.y)*(pt2.x-pt0.x) );
+	double direction( const point2<T>& pt0, const point2<T>& pt1, const point2<T>& pt2 ) const {
+		return ( double(pt1.x) - double(pt0.x) ) * ( double(pt2.y) - double(pt0.y) ) -
+		       ( double(pt1.y) - double(pt0.y) ) * ( double(pt2.x) - double(pt0.x) );
 	}
 
 	// TODO: can probably implement the algorithm a little better
@@ -179,7 +208,7 @@ private:
 		if( m_hull.size( ) < 3 ) { return; }
 
 		// holds the points of the convex hull
-		std::vector<point2<T>> stack;
+		hull_t stack;
 		stack.reserve( m_hull.size( ) );
 
 		// find the right/bottommost point
@@ -229,12 +258,12 @@ private:
 			if( stack.size( ) < 2 ) { stack.push_back( *itr ); }
 			else {
 				// left turn
-				T dir = direction( *(stack.rbegin()+1), *stack.rbegin(), *itr );
-				if( greater_than( dir, T(0) ) ) {
+				double dir = direction( *(stack.rbegin()+1), *stack.rbegin(), *itr );
+				if( greater_than( dir, 0.0 ) ) {
 					stack.push_back( *itr );
 				}
 				// straight
-				else if( equal( dir, T(0) ) ) {
+				else if( equal( dir, 0.0 ) ) {
 					float d1 = segment2<T>( *(stack.rbegin( )+1), *itr ).length( );
 					float d2 = segment2<T>( *(stack.rbegin( )+1), *stack.rbegin( ) ).length( );
 					if( equal( d1, d2 ) ) {
@@ -250,7 +279,7 @@ private:
 			}
 		}
 
-		m_hull = stack;
+		m_hull.swap( stack );
 	}
 
 	void calc_bounding_box( ) {
@@ -333,7 +362,7 @@ public:
 
 	polygon2<T>& operator = ( polygon2<T>&& poly ) {
 		std::swap( m_bounding_box, poly.m_bounding_box );
-		std::swap( m_hull, poly.m_hull );
+		m_hull.swap( poly.m_hull );
 		return *this;
 	}
 
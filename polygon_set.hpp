@@ -0,0 +1,391 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_POLYGON_SET_HPP
+#define EUBLIB_POLYGON_SET_HPP
+
+#include <ostream>
+#include <limits>
+#include <vector>
+#include <iterator>
+#include <cmath>
+#include "point.hpp"
+#include "rect.hpp"
+#include "line.hpp"
+#include "polygon.hpp"
+#include "simple_polygon.hpp"
+#include "euclib_helper.hpp"
+
+/*
+ * Many polygons in three flat arrays
+ *
+ *   Polygon i owns the vertices points( )[offsets( )[i]] up to (not
+ *   including) points( )[offsets( )[i+1]], and its box is
+ *   bounding_boxes( )[i]. Vertices are kept in the order they were added,
+ *   so a polygon2 goes in as its counter-clockwise hull.
+ *
+ *   Indexing the set gives a polygon_view, a cheap read-only handle that
+ *   answers the same questions a polygon2 does. The batch methods walk the
+ *   flat arrays front to back instead of one object at a time.
+ */
+
+namespace euclib {
+
+template<typename T>
+class polygon_set;
+
+template<typename T>
+class polygon_view {
+// Typedefs
+public:
+
+	typedef const point2<T>*  const_iterator;
+	typedef const point2<T>*  iterator;
+
+
+// Variables
+private:
+
+	const point2<T>*  m_first;
+	unsigned int      m_size;
+	const rect2<T>*   m_bounding_box;
+
+
+// Constructors
+public:
+
+	polygon_view( const point2<T>* first, unsigned int size, const rect2<T>* box ) :
+		m_first( first ),
+		m_size( size ),
+		m_bounding_box( box )
+	{ }
+
+
+// Methods
+public:
+
+	T width( ) const  { return m_bounding_box->width( ); }
+	T height( ) const { return m_bounding_box->height( ); }
+
+	// shoelace formula, positive when counter-clockwise
+	float signed_area( ) const {
+		if( m_size < 3 ) { return 0.f; }
+		double sum = 0.0;
+		for( unsigned int i = 0, j = m_size - 1; i < m_size; j = i++ ) {
+			sum += double(m_first[j].x) * double(m_first[i].y) -
+			       double(m_first[i].x) * double(m_first[j].y);
+		}
+		return static_cast<float>( sum / 2.0 );
+	}
+	float area( ) const { return std::abs( signed_area( ) ); }
+
+	float perimeter( ) const {
+		if( m_size < 2 ) { return 0.f; }
+		double perim = 0.0;
+		for( unsigned int i = 0, j = m_size - 1; i < m_size; j = i++ ) {
+			double dx = double(m_first[i].x) - double(m_first[j].x);
+			double dy = double(m_first[i].y) - double(m_first[j].y);
+			perim += std::sqrt( dx*dx + dy*dy );
+		}
+		return static_cast<float>( perim );
+	}
+
+	const rect2<T>& bounding_box( ) const { return *m_bounding_box; }
+	unsigned int size( ) const { return m_size; }
+
+	const_iterator begin( ) const { return m_first; }
+	const_iterator end( ) const   { return m_first + m_size; }
+
+	// copies out as a polygon2, which hulls the vertices
+	polygon2<T> to_polygon( ) const {
+		return polygon2<T>( std::vector<point2<T>>( begin( ), end( ) ) );
+	}
+
+
+// Operators
+public:
+
+	const point2<T>& operator [] ( unsigned int index ) const {
+		return m_first[index];
+	}
+
+	friend std::ostream& operator << ( std::ostream& stream, const polygon_view<T>& poly ) {
+		#ifdef GNUPLOT
+			for( unsigned int i = 0; i < poly.m_size; ++i ) {
+				stream << poly.m_first[i];
+			}
+			if( poly.m_size > 0 ) { stream << poly.m_first[0]; }
+			return stream << "e\n";
+		#else
+			stream << "Polygon: size = " << poly.m_size << "\n  ";
+			for( unsigned int i = 0; i < poly.m_size; ++i ) {
+				stream << ( i != 0 ? "->" : "" ) << poly.m_first[i];
+			}
+			return stream;
+		#endif
+	}
+}; // End class polygon_view
+
+
+template<typename T>
+class polygon_set {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+public:
+
+	typedef polygon_view<T> view_type;
+
+	// walks the polygons, yielding a view for each
+	class const_iterator {
+	public:
+		typedef std::random_access_iterator_tag  iterator_category;
+		typedef polygon_view<T>                  value_type;
+		typedef int                              difference_type;
+		typedef const polygon_view<T>*           pointer;
+		typedef polygon_view<T>                  reference;
+
+		const_iterator( ) : m_set( 0 ), m_index( 0 ) { }
+		const_iterator( const polygon_set<T>* set, unsigned int index ) :
+			m_set( set ),
+			m_index( index )
+		{ }
+
+		polygon_view<T> operator * ( ) const { return (*m_set)[m_index]; }
+		polygon_view<T> operator [] ( int n ) const { return (*m_set)[m_index + n]; }
+
+		const_iterator& operator ++ ( ) { ++m_index; return *this; }
+		const_iterator& operator -- ( ) { --m_index; return *this; }
+		const_iterator operator ++ ( int ) { const_iterator itr( *this ); ++m_index; return itr; }
+		const_iterator operator -- ( int ) { const_iterator itr( *this ); --m_index; return itr; }
+		const_iterator& operator += ( int n ) { m_index += n; return *this; }
+		const_iterator& operator -= ( int n ) { m_index -= n; return *this; }
+		const_iterator operator + ( int n ) const { return const_iterator( m_set, m_index + n ); }
+		const_iterator operator - ( int n ) const { return const_iterator( m_set, m_index - n ); }
+		int operator - ( const const_iterator& itr ) const { return int(m_index) - int(itr.m_index); }
+
+		bool operator == ( const const_iterator& itr ) const { return m_index == itr.m_index; }
+		bool operator != ( const const_iterator& itr ) const { return m_index != itr.m_index; }
+		bool operator < ( const const_iterator& itr ) const  { return m_index < itr.m_index; }
+
+	private:
+		const polygon_set<T>*  m_set;
+		unsigned int           m_index;
+	};
+
+
+// Variables
+private:
+
+	std::vector<point2<T>>     m_points;   // every vertex, polygon after polygon
+	std::vector<unsigned int>  m_offsets;  // size( ) + 1 entries into m_points
+	std::vector<rect2<T>>      m_boxes;    // one per polygon
+
+
+// Constructors
+public:
+
+	polygon_set( ) : m_offsets( 1, 0 ) { }
+
+	polygon_set( const std::vector<polygon2<T>>& polys ) : m_offsets( 1, 0 ) {
+		unsigned int count = 0;
+		for( unsigned int i = 0; i < polys.size( ); ++i ) { count += polys[i].size( ); }
+		reserve( polys.size( ), count );
+		for( unsigned int i = 0; i < polys.size( ); ++i ) { add( polys[i] ); }
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const { return m_boxes.size( ); }
+	bool empty( ) const        { return m_boxes.empty( ); }
+	unsigned int vertex_count( ) const { return m_points.size( ); }
+
+	// the flat arrays, for streaming over every polygon at once
+	const std::vector<point2<T>>& points( ) const           { return m_points; }
+	const std::vector<unsigned int>& offsets( ) const       { return m_offsets; }
+	const std::vector<rect2<T>>& bounding_boxes( ) const    { return m_boxes; }
+
+	const_iterator begin( ) const { return const_iterator( this, 0 ); }
+	const_iterator end( ) const   { return const_iterator( this, size( ) ); }
+
+	void reserve( unsigned int polygons, unsigned int vertices ) {
+		m_points.reserve( vertices );
+		m_offsets.reserve( polygons + 1 );
+		m_boxes.reserve( polygons );
+	}
+
+	void clear( ) {
+		m_points.clear( );
+		m_offsets.assign( 1, 0 );
+		m_boxes.clear( );
+	}
+
+	// appends the vertices in [first, last) as one polygon
+	template<typename Iterator>
+	void add( Iterator first, Iterator last ) {
+		for( ; first != last; ++first ) { m_points.push_back( *first ); }
+		m_offsets.push_back( m_points.size( ) );
+		m_boxes.push_back( calc_bounding_box( m_offsets[m_offsets.size( ) - 2], m_points.size( ) ) );
+	}
+
+	void add( const std::vector<point2<T>>& points ) {
+		add( points.begin( ), points.end( ) );
+	}
+
+	void add( const polygon2<T>& poly ) {
+		for( unsigned int i = 0; i < poly.size( ); ++i ) { m_points.push_back( poly[i] ); }
+		m_offsets.push_back( m_points.size( ) );
+		m_boxes.push_back( poly.size( ) == 0 ? rect2<T>::null( ) : poly.bounding_box( ) );
+	}
+
+	void add( const simple_polygon2<T>& poly ) {
+		add( poly.points( ).begin( ), poly.points( ).end( ) );
+	}
+
+	void add( const polygon_view<T>& poly ) {
+		add( poly.begin( ), poly.end( ) );
+	}
+
+	// 'result' gets the area of every polygon
+	void areas( std::vector<float>& result ) const {
+		result.resize( size( ) );
+		for( unsigned int p = 0; p < size( ); ++p ) {
+			result[p] = std::abs( signed_area( m_offsets[p], m_offsets[p+1] ) );
+		}
+	}
+
+	// 'result' gets the signed area of every polygon, positive when
+	//   counter-clockwise
+	void signed_areas( std::vector<float>& result ) const {
+		result.resize( size( ) );
+		for( unsigned int p = 0; p < size( ); ++p ) {
+			result[p] = signed_area( m_offsets[p], m_offsets[p+1] );
+		}
+	}
+
+	// sum of every polygon's area
+	double area( ) const {
+		double total = 0.0;
+		for( unsigned int p = 0; p < size( ); ++p ) {
+			total += std::abs( signed_area( m_offsets[p], m_offsets[p+1] ) );
+		}
+		return total;
+	}
+
+	// box around every polygon
+	rect2<T> bounding_box( ) const {
+		if( m_points.empty( ) ) { return rect2<T>::null( ); }
+		return calc_bounding_box( 0, m_points.size( ) );
+	}
+
+	void translate( T x, T y ) {
+		for( unsigned int i = 0; i < m_points.size( ); ++i ) {
+			m_points[i].x += x;
+			m_points[i].y += y;
+		}
+		for( unsigned int p = 0; p < m_boxes.size( ); ++p ) {
+			if( m_offsets[p] == m_offsets[p+1] ) { continue; }
+			rect2<T>& box = m_boxes[p];
+			box = rect2<T>( box.l + x, box.r + x, box.t + y, box.b + y );
+		}
+	}
+
+	void scale( const point2<T>& about, double factor ) {
+		transform( [&]( const point2<T>& pt ) {
+			return point2<T>( static_cast<T>( about.x + ( pt.x - about.x ) * factor ),
+			                  static_cast<T>( about.y + ( pt.y - about.y ) * factor ) );
+		} );
+	}
+
+	void rotate( const point2<T>& about, float angle, bool clockwise = true ) {
+		transform( [&]( const point2<T>& pt ) {
+			return euclib::rotate( pt, about, angle, clockwise );
+		} );
+	}
+
+	void mirror( const line2<T>& over ) {
+		transform( [&]( const point2<T>& pt ) {
+			return euclib::mirror( pt, over );
+		} );
+	}
+
+	// replaces every vertex with fn( vertex ) and refits the boxes
+	template<typename Function>
+	void transform( Function fn ) {
+		for( unsigned int i = 0; i < m_points.size( ); ++i ) {
+			m_points[i] = fn( m_points[i] );
+		}
+		for( unsigned int p = 0; p < m_boxes.size( ); ++p ) {
+			m_boxes[p] = calc_bounding_box( m_offsets[p], m_offsets[p+1] );
+		}
+	}
+
+private:
+
+	float signed_area( unsigned int first, unsigned int last ) const {
+		if( last - first < 3 ) { return 0.f; }
+		double sum = 0.0;
+		for( unsigned int i = first, j = last - 1; i < last; j = i++ ) {
+			sum += double(m_points[j].x) * double(m_points[i].y) -
+			       double(m_points[i].x) * double(m_points[j].y);
+		}
+		return static_cast<float>( sum / 2.0 );
+	}
+
+	rect2<T> calc_bounding_box( unsigned int first, unsigned int last ) const {
+		if( first == last ) { return rect2<T>::null( ); }
+		T l = m_points[first].x, r = l;
+		T t = m_points[first].y, b = t;
+		for( unsigned int i = first + 1; i < last; ++i ) {
+			if( m_points[i].x < l ) { l = m_points[i].x; }
+			else if( m_points[i].x > r ) { r = m_points[i].x; }
+			if( m_points[i].y < t ) { t = m_points[i].y; }
+			else if( m_points[i].y > b ) { b = m_points[i].y; }
+		}
+		return rect2<T>( l, r, t, b );
+	}
+
+
+// Operators
+public:
+
+	polygon_view<T> operator [] ( unsigned int index ) const {
+		return polygon_view<T>( m_points.data( ) + m_offsets[index],
+		                        m_offsets[index+1] - m_offsets[index], &m_boxes[index] );
+	}
+
+	friend std::ostream& operator << ( std::ostream& stream, const polygon_set<T>& set ) {
+		for( unsigned int p = 0; p < set.size( ); ++p ) {
+			stream << set[p] << '\n';
+		}
+		return stream;
+	}
+}; // End class polygon_set
+
+}  // End namespace euclib
+
+#endif // EUBLIB_POLYGON_SET_HPP
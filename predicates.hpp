@@ -0,0 +1,253 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_PREDICATES_HPP
+#define EUBLIB_PREDICATES_HPP
+
+#include <cmath>
+
+/*
+ * Robust geometric predicates on doubles
+ *
+ *   orient2d( ) and incircle( ) give the sign of their determinant
+ *   exactly for any doubles whose products neither overflow nor
+ *   underflow. The determinant is first evaluated in floating point and
+ *   returned when it is larger than its error bound, which is almost
+ *   always; otherwise it is recomputed exactly with floating point
+ *   expansions [1]. The exact path needs no allocation.
+ *
+ *   The value returned has the correct sign, but is only approximate in
+ *   magnitude.
+ *
+ * References
+ *   [1] J. R. Shewchuk. "Adaptive Precision Floating-Point Arithmetic and
+ *         Fast Robust Geometric Predicates". Discrete & Computational
+ *         Geometry, 18(3), pp. 305-363, 1997.
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	// 2^-53, half the distance from 1 to the next double
+	static const double epsilon = 1.1102230246251565e-16;
+	static const double splitter = 134217729.0;   // 2^27 + 1
+
+	inline void fast_two_sum( double a, double b, double& x, double& y ) {
+		x = a + b;
+		y = b - ( x - a );
+	}
+
+	inline void two_sum( double a, double b, double& x, double& y ) {
+		x = a + b;
+		double bv = x - a;
+		double av = x - bv;
+		y = ( a - av ) + ( b - bv );
+	}
+
+	inline void two_diff( double a, double b, double& x, double& y ) {
+		x = a - b;
+		double bv = a - x;
+		double av = x + bv;
+		y = ( a - av ) + ( bv - b );
+	}
+
+	inline void split( double a, double& hi, double& lo ) {
+		double c = splitter * a;
+		hi = c - ( c - a );
+		lo = a - hi;
+	}
+
+	inline void two_product( double a, double b, double& x, double& y ) {
+		x = a * b;
+		double ahi, alo, bhi, blo;
+		split( a, ahi, alo );
+		split( b, bhi, blo );
+		y = alo * blo - ( ( ( x - ahi * bhi ) - alo * bhi ) - ahi * blo );
+	}
+
+	// h = e + f, components in increasing magnitude with zeros left out.
+	//   h must hold elen + flen values. Returns the length of h.
+	inline int expansion_sum( int elen, const double* e, int flen, const double* f, double* h ) {
+		int ei = 0, fi = 0, hi = 0;
+		double q, qnew, hh;
+		if( ( f[0] > e[0] ) == ( f[0] > -e[0] ) ) { q = e[ei++]; }
+		else { q = f[fi++]; }
+		if( ei < elen && fi < flen ) {
+			if( ( f[fi] > e[ei] ) == ( f[fi] > -e[ei] ) ) { fast_two_sum( e[ei++], q, qnew, hh ); }
+			else { fast_two_sum( f[fi++], q, qnew, hh ); }
+			q = qnew;
+			if( hh != 0.0 ) { h[hi++] = hh; }
+			while( ei < elen && fi < flen ) {
+				if( ( f[fi] > e[ei] ) == ( f[fi] > -e[ei] ) ) { two_sum( q, e[ei++], qnew, hh ); }
+				else { two_sum( q, f[fi++], qnew, hh ); }
+				q = qnew;
+				if( hh != 0.0 ) { h[hi++] = hh; }
+			}
+		}
+		while( ei < elen ) {
+			two_sum( q, e[ei++], qnew, hh );
+			q = qnew;
+			if( hh != 0.0 ) { h[hi++] = hh; }
+		}
+		while( fi < flen ) {
+			two_sum( q, f[fi++], qnew, hh );
+			q = qnew;
+			if( hh != 0.0 ) { h[hi++] = hh; }
+		}
+		if( q != 0.0 || hi == 0 ) { h[hi++] = q; }
+		return hi;
+	}
+
+	// h = e * b, h must hold 2 * elen values
+	inline int scale_expansion( int elen, const double* e, double b, double* h ) {
+		double bhi, blo, q, hh, p1, p0, sum, ehi, elo;
+		split( b, bhi, blo );
+		int hi = 0;
+		q = e[0] * b;
+		split( e[0], ehi, elo );
+		hh = elo * blo - ( ( ( q - ehi * bhi ) - elo * bhi ) - ehi * blo );
+		if( hh != 0.0 ) { h[hi++] = hh; }
+		for( int i = 1; i < elen; ++i ) {
+			p1 = e[i] * b;
+			split( e[i], ehi, elo );
+			p0 = elo * blo - ( ( ( p1 - ehi * bhi ) - elo * bhi ) - ehi * blo );
+			two_sum( q, p0, sum, hh );
+			if( hh != 0.0 ) { h[hi++] = hh; }
+			fast_two_sum( p1, sum, q, hh );
+			if( hh != 0.0 ) { h[hi++] = hh; }
+		}
+		if( q != 0.0 || hi == 0 ) { h[hi++] = q; }
+		return hi;
+	}
+
+	// h = e * f, using 'scratch' of 2 * elen * flen values. h must hold
+	//   2 * elen * flen values.
+	inline int expansion_product( int elen, const double* e, int flen, const double* f,
+	                              double* h, double* scratch ) {
+		double part[64];
+		int hlen = scale_expansion( elen, e, f[0], h );
+		for( int i = 1; i < flen; ++i ) {
+			int plen = scale_expansion( elen, e, f[i], part );
+			int slen = expansion_sum( hlen, h, plen, part, scratch );
+			for( int j = 0; j < slen; ++j ) { h[j] = scratch[j]; }
+			hlen = slen;
+		}
+		return hlen;
+	}
+
+	inline void negate( int len, double* e ) {
+		for( int i = 0; i < len; ++i ) { e[i] = -e[i]; }
+	}
+
+	// (a * b - c * d) for two-term a, b, c, d, into h of 16
+	inline int cross_exact( const double* a, const double* b, const double* c, const double* d, double* h ) {
+		double ab[8], cd[8], scratch[8];
+		int ablen = expansion_product( 2, a, 2, b, ab, scratch );
+		int cdlen = expansion_product( 2, c, 2, d, cd, scratch );
+		negate( cdlen, cd );
+		return expansion_sum( ablen, ab, cdlen, cd, h );
+	}
+
+	inline double orient2d_exact( double ax, double ay, double bx, double by, double cx, double cy ) {
+		double acx[2], acy[2], bcx[2], bcy[2], det[16];
+		two_diff( ax, cx, acx[1], acx[0] );
+		two_diff( ay, cy, acy[1], acy[0] );
+		two_diff( bx, cx, bcx[1], bcx[0] );
+		two_diff( by, cy, bcy[1], bcy[0] );
+		int len = cross_exact( acx, bcy, acy, bcx, det );
+		return det[len - 1];
+	}
+
+	// lift * det, added onto 'sum'
+	inline int incircle_term( const double* dx, const double* dy, const double* det, int detlen,
+	                          double* sum, int sumlen ) {
+		double xx[8], yy[8], lift[16], term[512], scratch[512], total[1536];
+		int xxlen = expansion_product( 2, dx, 2, dx, xx, scratch );
+		int yylen = expansion_product( 2, dy, 2, dy, yy, scratch );
+		int liftlen = expansion_sum( xxlen, xx, yylen, yy, lift );
+		int termlen = expansion_product( liftlen, lift, detlen, det, term, scratch );
+		int totallen = expansion_sum( sumlen, sum, termlen, term, total );
+		for( int i = 0; i < totallen; ++i ) { sum[i] = total[i]; }
+		return totallen;
+	}
+
+	inline double incircle_exact( double ax, double ay, double bx, double by, double cx, double cy,
+	                              double dx, double dy ) {
+		double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+		two_diff( ax, dx, adx[1], adx[0] );
+		two_diff( ay, dy, ady[1], ady[0] );
+		two_diff( bx, dx, bdx[1], bdx[0] );
+		two_diff( by, dy, bdy[1], bdy[0] );
+		two_diff( cx, dx, cdx[1], cdx[0] );
+		two_diff( cy, dy, cdy[1], cdy[0] );
+
+		double bc[16], ca[16], ab[16], sum[1536];
+		int bclen = cross_exact( bdx, cdy, cdx, bdy, bc );
+		int calen = cross_exact( cdx, ady, adx, cdy, ca );
+		int ablen = cross_exact( adx, bdy, bdx, ady, ab );
+		sum[0] = 0.0;
+		int len = 1;
+		len = incircle_term( adx, ady, bc, bclen, sum, len );
+		len = incircle_term( bdx, bdy, ca, calen, sum, len );
+		len = incircle_term( cdx, cdy, ab, ablen, sum, len );
+		return sum[len - 1];
+	}
+
+} // End namespace detail
+
+// positive if a, b, c turn counterclockwise, negative if clockwise, zero
+//   if collinear
+inline double orient2d( double ax, double ay, double bx, double by, double cx, double cy ) {
+	const double left = ( ax - cx ) * ( by - cy );
+	const double right = ( ay - cy ) * ( bx - cx );
+	const double det = left - right;
+	const double bound = ( 3.0 + 16.0 * detail::epsilon ) * detail::epsilon *
+	                     ( std::fabs( left ) + std::fabs( right ) );
+	if( det > bound || -det > bound ) { return det; }
+	return detail::orient2d_exact( ax, ay, bx, by, cx, cy );
+}
+
+// positive if d lies inside the circle through a, b, c, taken
+//   counterclockwise, negative if outside, zero if on it
+inline double incircle( double ax, double ay, double bx, double by, double cx, double cy,
+                        double dx, double dy ) {
+	const double adx = ax - dx, ady = ay - dy;
+	const double bdx = bx - dx, bdy = by - dy;
+	const double cdx = cx - dx, cdy = cy - dy;
+
+	const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	const double cdxady = cdx * ady, adxcdy = adx * cdy;
+	const double adxbdy = adx * bdy, bdxady = bdx * ady;
+	const double alift = adx * adx + ady * ady;
+	const double blift = bdx * bdx + bdy * bdy;
+	const double clift = cdx * cdx + cdy * cdy;
+
+	const double det = alift * ( bdxcdy - cdxbdy ) + blift * ( cdxady - adxcdy ) +
+	                   clift * ( adxbdy - bdxady );
+	const double permanent = ( std::fabs( bdxcdy ) + std::fabs( cdxbdy ) ) * alift +
+	                         ( std::fabs( cdxady ) + std::fabs( adxcdy ) ) * blift +
+	                         ( std::fabs( adxbdy ) + std::fabs( bdxady ) ) * clift;
+	const double bound = ( 10.0 + 96.0 * detail::epsilon ) * detail::epsilon * permanent;
+	if( det > bound || -det > bound ) { return det; }
+	return detail::incircle_exact( ax, ay, bx, by, cx, cy, dx, dy );
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_PREDICATES_HPP
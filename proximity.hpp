@@ -0,0 +1,325 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_PROXIMITY_HPP
+#define EUBLIB_PROXIMITY_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include "point.hpp"
+#include "euclib_parallel.hpp"
+#include "curve.hpp"
+
+/*
+ * Closest pair and all nearest neighbours of point2 sets
+ *
+ *   closest_pair( ) is the divide and conquer of [1]: the points are
+ *   sorted on x once, each half is solved alone, and the pairs across the
+ *   cut only need looking at within the strip as wide as the best
+ *   distance so far, taken in y order, which the recursion keeps by
+ *   merging. It is O(n log n) whatever the input. The halves of the top
+ *   few levels are solved in parallel.
+ *
+ *   all_nearest( ) builds an implicit k-d tree [2], the points permuted
+ *   so every node is a range split at its middle on its wider axis, and
+ *   answers each point from the leaf holding it outward. Points are
+ *   answered in tree order, in parallel, with no memory per point beyond
+ *   the recursion. Clustered input stays balanced, unlike a grid.
+ *
+ *   Both take a pointer and count, so any contiguous run of point2
+ *   values will do, and give point indices into it. Distances are
+ *   compared squared, in double. Duplicate points are each other's
+ *   nearest, at distance 0.
+ *
+ * References
+ *   [1] M. I. Shamos, D. Hoey. "Closest-point problems". Proceedings of
+ *         the 16th Annual Symposium on Foundations of Computer Science,
+ *         pp. 151-162, 1975.
+ *   [2] J. L. Bentley. "Multidimensional binary search trees used for
+ *         associative searching". Communications of the ACM, 18(9),
+ *         pp. 509-517, 1975.
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	// a point copied next to its index, so passes over a permutation of
+	//   them read memory in order
+	struct point_entry {
+		double        xy[2];
+		unsigned int  index;
+	};
+
+	inline double distance_sq( const point_entry& a, const point_entry& b ) {
+		const double dx = a.xy[0] - b.xy[0], dy = a.xy[1] - b.xy[1];
+		return dx * dx + dy * dy;
+	}
+
+	// a key that sorts as 'value' does
+	inline uint64_t order_key( double value ) {
+		uint64_t bits;
+		std::memcpy( &bits, &value, sizeof(bits) );
+		return ( bits >> 63 ) ? ~bits : bits | ( uint64_t(1) << 63 );
+	}
+
+	struct closest_found {
+		double        distance;
+		unsigned int  a, b;
+
+		closest_found( ) : distance( std::numeric_limits<double>::infinity( ) ), a( ~0u ), b( ~0u ) { }
+
+		void offer( double d, unsigned int i, unsigned int j ) {
+			if( i > j ) { std::swap( i, j ); }
+			if( d < distance ) {
+				distance = d;
+				a = i;
+				b = j;
+			}
+		}
+	};
+
+	// the closest pair in items[lo, hi), sorted on x, leaving that range
+	//   sorted on y. 'scratch' is as long as 'items'. The halves are run
+	//   in parallel for 'split' more levels.
+	inline closest_found closest_pair( point_entry* items, point_entry* scratch,
+	                                   unsigned int lo, unsigned int hi, unsigned int split ) {
+		closest_found best;
+		if( hi - lo <= 3 ) {
+			for( unsigned int i = lo; i < hi; ++i ) {
+				for( unsigned int j = i + 1; j < hi; ++j ) {
+					best.offer( distance_sq( items[i], items[j] ), items[i].index, items[j].index );
+				}
+			}
+			for( unsigned int i = lo + 1; i < hi; ++i ) {
+				const point_entry v = items[i];
+				unsigned int j = i;
+				for( ; j > lo && items[j - 1].xy[1] > v.xy[1]; --j ) { items[j] = items[j - 1]; }
+				items[j] = v;
+			}
+			return best;
+		}
+
+		const unsigned int mid = lo + ( hi - lo ) / 2;
+		const double cut = items[mid].xy[0];
+		if( split > 0 ) {
+			closest_found half[2];
+			parallel_for( 0, 2, [&]( unsigned int k ) {
+				half[k] = k == 0 ? closest_pair( items, scratch, lo, mid, split - 1 ) :
+				                   closest_pair( items, scratch, mid, hi, split - 1 );
+			}, 2, 1 );
+			best = half[0];
+			best.offer( half[1].distance, half[1].a, half[1].b );
+		}
+		else {
+			best = closest_pair( items, scratch, lo, mid, 0 );
+			const closest_found right = closest_pair( items, scratch, mid, hi, 0 );
+			best.offer( right.distance, right.a, right.b );
+		}
+
+		std::merge( items + lo, items + mid, items + mid, items + hi, scratch + lo,
+		            []( const point_entry& e, const point_entry& f ) { return e.xy[1] < f.xy[1]; } );
+		std::copy( scratch + lo, scratch + hi, items + lo );
+
+		// the strip about the cut, in y order, each against those just above
+		unsigned int strip = lo;
+		for( unsigned int i = lo; i < hi; ++i ) {
+			const double dx = items[i].xy[0] - cut;
+			if( dx * dx < best.distance ) { scratch[strip++] = items[i]; }
+		}
+		for( unsigned int i = lo; i < strip; ++i ) {
+			for( unsigned int j = i + 1; j < strip; ++j ) {
+				const double dy = scratch[j].xy[1] - scratch[i].xy[1];
+				if( dy * dy >= best.distance ) { break; }
+				best.offer( distance_sq( scratch[i], scratch[j] ), scratch[i].index, scratch[j].index );
+			}
+		}
+		return best;
+	}
+
+	// points copied and permuted so node k of a heap ordered tree is a
+	//   range, split at its middle, k's children being 2k + 1 and 2k + 2
+	template<typename T>
+	class nearest_tree {
+	// Variables
+	public:
+
+		static const unsigned int bucket = 8;
+
+		std::vector<point_entry>   entries;
+		std::vector<double>        cuts;    // per inner node
+		std::vector<unsigned char> axes;
+
+	// Methods
+	public:
+
+		nearest_tree( const point2<T>* points, unsigned int count, unsigned int threads ) :
+			entries( count ) {
+			unsigned int depth = 0;
+			for( unsigned int size = count; size > bucket; size = ( size + 1 ) / 2 ) { ++depth; }
+			cuts.resize( ( std::size_t(1) << depth ) - 1 );
+			axes.resize( cuts.size( ) );
+			parallel_for( 0, count, [&]( unsigned int i ) {
+				entries[i].xy[0] = points[i].x;
+				entries[i].xy[1] = points[i].y;
+				entries[i].index = i;
+			}, threads, 4096 );
+			unsigned int split = 0;
+			while( split < 8 && ( 1u << split ) < threads ) { ++split; }
+			build( 0, 0, count, split );
+		}
+
+		// the index of the nearest point to entries[at] but itself
+		unsigned int nearest( unsigned int at ) const {
+			double best = std::numeric_limits<double>::infinity( );
+			unsigned int found = ~0u;
+			search( 0, 0, entries.size( ), at, best, found );
+			return found;
+		}
+
+	private:
+
+		void build( unsigned int k, unsigned int lo, unsigned int hi, unsigned int split ) {
+			if( hi - lo <= bucket ) { return; }
+			double l = std::numeric_limits<double>::max( ), t = l, r = -l, b = -l;
+			for( unsigned int i = lo; i < hi; ++i ) {
+				l = std::min( l, entries[i].xy[0] );
+				r = std::max( r, entries[i].xy[0] );
+				t = std::min( t, entries[i].xy[1] );
+				b = std::max( b, entries[i].xy[1] );
+			}
+			const unsigned int mid = lo + ( hi - lo ) / 2;
+			const unsigned int axis = r - l >= b - t ? 0 : 1;
+			std::nth_element( &entries[lo], &entries[mid], &entries[0] + hi,
+			                  [axis]( const point_entry& e, const point_entry& f ) { return e.xy[axis] < f.xy[axis]; } );
+			cuts[k] = entries[mid].xy[axis];
+			axes[k] = axis;
+			if( split > 0 ) {
+				parallel_for( 0, 2, [&]( unsigned int c ) {
+					if( c == 0 ) { build( 2 * k + 1, lo, mid, split - 1 ); }
+					else { build( 2 * k + 2, mid, hi, split - 1 ); }
+				}, 2, 1 );
+			}
+			else {
+				build( 2 * k + 1, lo, mid, 0 );
+				build( 2 * k + 2, mid, hi, 0 );
+			}
+		}
+
+		// the side holding the point first, the side holding 'at' on a
+		//   tie, so its own leaf is searched first and gives a close bound
+		void search( unsigned int k, unsigned int lo, unsigned int hi, unsigned int at,
+		             double& best, unsigned int& found ) const {
+			const point_entry& q = entries[at];
+			if( hi - lo <= bucket ) {
+				for( unsigned int j = lo; j < hi; ++j ) {
+					const double d = distance_sq( entries[j], q );
+					if( d < best && j != at ) {
+						best = d;
+						found = entries[j].index;
+					}
+				}
+				return;
+			}
+			const unsigned int mid = lo + ( hi - lo ) / 2;
+			const double gap = q.xy[axes[k]] - cuts[k];
+			if( gap < 0.0 || ( gap == 0.0 && at < mid ) ) {
+				search( 2 * k + 1, lo, mid, at, best, found );
+				if( gap * gap < best ) { search( 2 * k + 2, mid, hi, at, best, found ); }
+			}
+			else {
+				search( 2 * k + 2, mid, hi, at, best, found );
+				if( gap * gap < best ) { search( 2 * k + 1, lo, mid, at, best, found ); }
+			}
+		}
+	}; // End class nearest_tree
+
+	template<typename T>
+	const unsigned int nearest_tree<T>::bucket;
+
+} // End namespace detail
+
+// the indices of the two closest of 'count' points, the lower first, or
+//   ( ~0u, ~0u ) for fewer than two. 'threads' as for parallel_for( ).
+template<typename T>
+std::pair<unsigned int, unsigned int> closest_pair( const point2<T>* points, unsigned int count,
+                                                    unsigned int threads = 0 ) {
+	if( count < 2 ) { return std::make_pair( ~0u, ~0u ); }
+	if( threads == 0 ) { threads = default_threads( ); }
+	#ifdef EUCLIB_NO_THREADS
+		threads = 1;
+	#endif
+
+	std::vector<uint64_t> keys( count );
+	std::vector<unsigned int> order( count );
+	parallel_for( 0, count, [&]( unsigned int i ) {
+		keys[i] = detail::order_key( double(points[i].x) );
+		order[i] = i;
+	}, threads, 4096 );
+	radix_sort( keys, order, threads );
+	std::vector<uint64_t>( ).swap( keys );
+	std::vector<detail::point_entry> items( count ), scratch( count );
+	parallel_for( 0, count, [&]( unsigned int i ) {
+		items[i].xy[0] = points[order[i]].x;
+		items[i].xy[1] = points[order[i]].y;
+		items[i].index = order[i];
+	}, threads, 4096 );
+
+	unsigned int split = 0;
+	while( split < 8 && ( 1u << split ) < threads && ( count >> split ) > 65536 ) { ++split; }
+	const detail::closest_found best = detail::closest_pair( &items[0], &scratch[0], 0, count, split );
+	return std::make_pair( best.a, best.b );
+}
+
+template<typename T>
+std::pair<unsigned int, unsigned int> closest_pair( const std::vector<point2<T>>& points,
+                                                    unsigned int threads = 0 ) {
+	return points.empty( ) ? std::make_pair( ~0u, ~0u ) : closest_pair( &points[0], points.size( ), threads );
+}
+
+// result[i] = the index of the point nearest points[i], itself aside,
+//   or ~0u if there is no other point. 'result' holds 'count' values.
+template<typename T>
+void all_nearest( const point2<T>* points, unsigned int count, unsigned int* result,
+                  unsigned int threads = 0 ) {
+	if( count == 0 ) { return; }
+	if( threads == 0 ) { threads = default_threads( ); }
+	#ifdef EUCLIB_NO_THREADS
+		threads = 1;
+	#endif
+
+	const detail::nearest_tree<T> tree( points, count, threads );
+	parallel_for( 0, count, [&]( unsigned int at ) {
+		result[tree.entries[at].index] = tree.nearest( at );
+	}, threads, 1024 );
+}
+
+template<typename T>
+void all_nearest( const std::vector<point2<T>>& points, std::vector<unsigned int>& result,
+                  unsigned int threads = 0 ) {
+	result.resize( points.size( ) );
+	if( !points.empty( ) ) { all_nearest( &points[0], points.size( ), &result[0], threads ); }
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_PROXIMITY_HPP
@@ -0,0 +1,335 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_RECT_ARRAY_HPP
+#define EUBLIB_RECT_ARRAY_HPP
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include "point.hpp"
+#include "rect.hpp"
+
+#ifndef EUCLIB_NO_SIMD
+	#if defined(__AVX__)
+		#include <immintrin.h>
+	#elif defined(__SSE2__)
+		#include <emmintrin.h>
+	#endif
+#endif
+
+/*
+ * Many rect2 stored as four arrays (all l, all r, all t, all b) so one
+ *   query can be tested against several boxes per instruction. Tests use
+ *   closed intervals like overlap( ), boxes that only touch do overlap.
+ *
+ *   Results come either as a bitmask, bit i of word i/64 set when box i
+ *   passes, or compacted into a list of indices. float and double use
+ *   SSE2 or AVX when the compiler targets them, define EUCLIB_NO_SIMD to
+ *   always use the plain loops (which the compiler may still vectorize).
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	// bit k set when box k, for k in [first, count), overlaps the query
+	//   [ql, qr] x [qt, qb]
+	template<typename T> inline
+	uint64_t box_bits( const T* l, const T* r, const T* t, const T* b,
+	                   unsigned int first, unsigned int count, T ql, T qr, T qt, T qb ) {
+		uint64_t bits = 0;
+		for( unsigned int k = first; k < count; ++k ) {
+			bits |= uint64_t( ( l[k] <= qr ) & ( ql <= r[k] ) &
+			                  ( t[k] <= qb ) & ( qt <= b[k] ) ) << k;
+		}
+		return bits;
+	}
+
+	// the same for all 'count' (at most 64) boxes, vectorized where the
+	//   type and target allow
+	template<typename T>
+	struct box_kernel {
+		static uint64_t mask( const T* l, const T* r, const T* t, const T* b,
+		                      unsigned int count, T ql, T qr, T qt, T qb ) {
+			return box_bits( l, r, t, b, 0, count, ql, qr, qt, qb );
+		}
+	};
+
+#ifndef EUCLIB_NO_SIMD
+#if defined(__AVX__)
+
+	template<>
+	struct box_kernel<float> {
+		static uint64_t mask( const float* l, const float* r, const float* t, const float* b,
+		                      unsigned int count, float ql, float qr, float qt, float qb ) {
+			const __m256 QL = _mm256_set1_ps( ql ), QR = _mm256_set1_ps( qr );
+			const __m256 QT = _mm256_set1_ps( qt ), QB = _mm256_set1_ps( qb );
+			uint64_t bits = 0;
+			unsigned int k = 0;
+			for( ; k + 8 <= count; k += 8 ) {
+				__m256 in = _mm256_and_ps(
+					_mm256_and_ps( _mm256_cmp_ps( _mm256_loadu_ps( l + k ), QR, _CMP_LE_OQ ),
+					               _mm256_cmp_ps( QL, _mm256_loadu_ps( r + k ), _CMP_LE_OQ ) ),
+					_mm256_and_ps( _mm256_cmp_ps( _mm256_loadu_ps( t + k ), QB, _CMP_LE_OQ ),
+					               _mm256_cmp_ps( QT, _mm256_loadu_ps( b + k ), _CMP_LE_OQ ) ) );
+				bits |= uint64_t( _mm256_movemask_ps( in ) ) << k;
+			}
+			return bits | box_bits( l, r, t, b, k, count, ql, qr, qt, qb );
+		}
+	};
+
+	template<>
+	struct box_kernel<double> {
+		static uint64_t mask( const double* l, const double* r, const double* t, const double* b,
+		                      unsigned int count, double ql, double qr, double qt, double qb ) {
+			const __m256d QL = _mm256_set1_pd( ql ), QR = _mm256_set1_pd( qr );
+			const __m256d QT = _mm256_set1_pd( qt ), QB = _mm256_set1_pd( qb );
+			uint64_t bits = 0;
+			unsigned int k = 0;
+			for( ; k + 4 <= count; k += 4 ) {
+				__m256d in = _mm256_and_pd(
+					_mm256_and_pd( _mm256_cmp_pd( _mm256_loadu_pd( l + k ), QR, _CMP_LE_OQ ),
+					               _mm256_cmp_pd( QL, _mm256_loadu_pd( r + k ), _CMP_LE_OQ ) ),
+					_mm256_and_pd( _mm256_cmp_pd( _mm256_loadu_pd( t + k ), QB, _CMP_LE_OQ ),
+					               _mm256_cmp_pd( QT, _mm256_loadu_pd( b + k ), _CMP_LE_OQ ) ) );
+				bits |= uint64_t( _mm256_movemask_pd( in ) ) << k;
+			}
+			return bits | box_bits( l, r, t, b, k, count, ql, qr, qt, qb );
+		}
+	};
+
+#elif defined(__SSE2__)
+
+	template<>
+	struct box_kernel<float> {
+		static uint64_t mask( const float* l, const float* r, const float* t, const float* b,
+		                      unsigned int count, float ql, float qr, float qt, float qb ) {
+			const __m128 QL = _mm_set1_ps( ql ), QR = _mm_set1_ps( qr );
+			const __m128 QT = _mm_set1_ps( qt ), QB = _mm_set1_ps( qb );
+			uint64_t bits = 0;
+			unsigned int k = 0;
+			for( ; k + 4 <= count; k += 4 ) {
+				__m128 in = _mm_and_ps(
+					_mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( l + k ), QR ),
+					            _mm_cmple_ps( QL, _mm_loadu_ps( r + k ) ) ),
+					_mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( t + k ), QB ),
+					            _mm_cmple_ps( QT, _mm_loadu_ps( b + k ) ) ) );
+				bits |= uint64_t( _mm_movemask_ps( in ) ) << k;
+			}
+			return bits | box_bits( l, r, t, b, k, count, ql, qr, qt, qb );
+		}
+	};
+
+	template<>
+	struct box_kernel<double> {
+		static uint64_t mask( const double* l, const double* r, const double* t, const double* b,
+		                      unsigned int count, double ql, double qr, double qt, double qb ) {
+			const __m128d QL = _mm_set1_pd( ql ), QR = _mm_set1_pd( qr );
+			const __m128d QT = _mm_set1_pd( qt ), QB = _mm_set1_pd( qb );
+			uint64_t bits = 0;
+			unsigned int k = 0;
+			for( ; k + 2 <= count; k += 2 ) {
+				__m128d in = _mm_and_pd(
+					_mm_and_pd( _mm_cmple_pd( _mm_loadu_pd( l + k ), QR ),
+					            _mm_cmple_pd( QL, _mm_loadu_pd( r + k ) ) ),
+					_mm_and_pd( _mm_cmple_pd( _mm_loadu_pd( t + k ), QB ),
+					            _mm_cmple_pd( QT, _mm_loadu_pd( b + k ) ) ) );
+				bits |= uint64_t( _mm_movemask_pd( in ) ) << k;
+			}
+			return bits | box_bits( l, r, t, b, k, count, ql, qr, qt, qb );
+		}
+	};
+
+#endif
+#endif
+
+	inline unsigned int lowest_bit( uint64_t bits ) {
+		#ifdef __GNUC__
+			return __builtin_ctzll( bits );
+		#else
+			unsigned int n = 0;
+			while( !( bits & 1 ) ) { bits >>= 1; ++n; }
+			return n;
+		#endif
+	}
+
+	// appends the index of every set bit
+	inline void append_indices( const std::vector<uint64_t>& mask, std::vector<unsigned int>& indices ) {
+		for( unsigned int w = 0; w < mask.size( ); ++w ) {
+			for( uint64_t bits = mask[w]; bits != 0; bits &= bits - 1 ) {
+				indices.push_back( w * 64 + lowest_bit( bits ) );
+			}
+		}
+	}
+
+} // End namespace detail
+
+
+template<typename T>
+class rect_array {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+
+// Variables
+private:
+
+	std::vector<T>  m_l, m_r, m_t, m_b;
+
+
+// Constructors
+public:
+
+	rect_array( ) { }
+	rect_array( const std::vector<rect2<T>>& rects ) {
+		reserve( rects.size( ) );
+		for( unsigned int i = 0; i < rects.size( ); ++i ) { push_back( rects[i] ); }
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const { return m_l.size( ); }
+	bool empty( ) const        { return m_l.empty( ); }
+
+	// the four columns
+	const T* l( ) const { return m_l.data( ); }
+	const T* r( ) const { return m_r.data( ); }
+	const T* t( ) const { return m_t.data( ); }
+	const T* b( ) const { return m_b.data( ); }
+
+	void reserve( unsigned int count ) {
+		m_l.reserve( count );
+		m_r.reserve( count );
+		m_t.reserve( count );
+		m_b.reserve( count );
+	}
+
+	void clear( ) {
+		m_l.clear( );
+		m_r.clear( );
+		m_t.clear( );
+		m_b.clear( );
+	}
+
+	void push_back( const rect2<T>& rect ) {
+		m_l.push_back( rect.l );
+		m_r.push_back( rect.r );
+		m_t.push_back( rect.t );
+		m_b.push_back( rect.b );
+	}
+
+	void set( unsigned int index, const rect2<T>& rect ) {
+		m_l[index] = rect.l;
+		m_r[index] = rect.r;
+		m_t[index] = rect.t;
+		m_b[index] = rect.b;
+	}
+
+	// 'mask' gets a bit for every box overlapping 'query'
+	void overlaps( const rect2<T>& query, std::vector<uint64_t>& mask ) const {
+		mask.assign( ( size( ) + 63 ) / 64, 0 );
+		if( query == rect2<T>::null( ) ) { return; }
+		test( query.l, query.r, query.t, query.b, mask );
+	}
+
+	// 'indices' gets every box overlapping 'query', in order
+	void overlaps( const rect2<T>& query, std::vector<unsigned int>& indices ) const {
+		std::vector<uint64_t> mask;
+		overlaps( query, mask );
+		indices.clear( );
+		detail::append_indices( mask, indices );
+	}
+
+	// 'mask' gets a bit for every box containing 'pt'
+	void contains( const point2<T>& pt, std::vector<uint64_t>& mask ) const {
+		mask.assign( ( size( ) + 63 ) / 64, 0 );
+		if( pt == point2<T>::null( ) ) { return; }
+		test( pt.x, pt.x, pt.y, pt.y, mask );
+	}
+
+	void contains( const point2<T>& pt, std::vector<unsigned int>& indices ) const {
+		std::vector<uint64_t> mask;
+		contains( pt, mask );
+		indices.clear( );
+		detail::append_indices( mask, indices );
+	}
+
+	// 'mask' gets bit i set when box i here overlaps box i of 'rects',
+	//   for i below the smaller size
+	void overlaps( const rect_array<T>& rects, std::vector<uint64_t>& mask ) const {
+		const unsigned int n = std::min( size( ), rects.size( ) );
+		mask.assign( ( n + 63 ) / 64, 0 );
+		for( unsigned int i = 0; i < n; ++i ) {
+			if( ( m_l[i] <= rects.m_r[i] ) & ( rects.m_l[i] <= m_r[i] ) &
+			    ( m_t[i] <= rects.m_b[i] ) & ( rects.m_t[i] <= m_b[i] ) ) {
+				mask[i / 64] |= uint64_t( 1 ) << ( i % 64 );
+			}
+		}
+	}
+
+	// 'pairs' gets every (i, j) where box i here overlaps box j of 'rects'
+	void overlaps( const rect_array<T>& rects,
+	               std::vector<std::pair<unsigned int, unsigned int>>& pairs ) const {
+		pairs.clear( );
+		std::vector<uint64_t> mask( ( size( ) + 63 ) / 64 );
+		for( unsigned int j = 0; j < rects.size( ); ++j ) {
+			std::fill( mask.begin( ), mask.end( ), 0 );
+			test( rects.m_l[j], rects.m_r[j], rects.m_t[j], rects.m_b[j], mask );
+			for( unsigned int w = 0; w < mask.size( ); ++w ) {
+				for( uint64_t bits = mask[w]; bits != 0; bits &= bits - 1 ) {
+					pairs.push_back( std::make_pair( w * 64 + detail::lowest_bit( bits ), j ) );
+				}
+			}
+		}
+	}
+
+private:
+
+	void test( T ql, T qr, T qt, T qb, std::vector<uint64_t>& mask ) const {
+		const unsigned int n = size( );
+		for( unsigned int first = 0, w = 0; first < n; first += 64, ++w ) {
+			unsigned int count = std::min( 64u, n - first );
+			mask[w] = detail::box_kernel<T>::mask( &m_l[first], &m_r[first], &m_t[first], &m_b[first],
+			                                       count, ql, qr, qt, qb );
+		}
+	}
+
+
+// Operators
+public:
+
+	rect2<T> operator [] ( unsigned int index ) const {
+		return rect2<T>( m_l[index], m_r[index], m_t[index], m_b[index] );
+	}
+}; // End class rect_array
+
+}  // End namespace euclib
+
+#endif // EUBLIB_RECT_ARRAY_HPP
@@ -0,0 +1,536 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_RP_FOREST_HPP
+#define EUBLIB_RP_FOREST_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <random>
+#include <cstdint>
+#include <cmath>
+#include "point.hpp"
+#include "euclib_parallel.hpp"
+
+#if defined(__AVX__) || defined(__SSE2__)
+	#include <immintrin.h>
+#endif
+
+/*
+ * Approximate nearest neighbours over point<T,D>
+ *
+ *   A forest of random projection trees [1]. Each tree splits its points
+ *   at the median of their projections onto the line through two random
+ *   points of the node, down to leaf_size( ) points, so close points
+ *   usually share a leaf and each tree misses different ones. A search
+ *   walks every tree best first by the distance to the splitting planes
+ *   on its path [2], gathering leaves until it has 'search_k' distinct
+ *   candidates, then ranks them exactly. More trees or a larger search_k give higher
+ *   recall for more time; recall( ) measures it against brute force on a
+ *   sample of queries.
+ *
+ *   Points are stored padded with zeros to a multiple of 32 bytes, and
+ *   distances and projections use AVX or SSE2 when the compiler targets
+ *   them. The trees are built in parallel, batches of queries are
+ *   answered in parallel, and a kept query_buffer makes single searches
+ *   allocation free.
+ *
+ * References
+ *   [1] S. Dasgupta, Y. Freund. "Random projection trees and low
+ *         dimensional manifolds". Proceedings of the 40th Annual ACM
+ *         Symposium on Theory of Computing, pp. 537-546, 2008.
+ *   [2] E. Bernhardsson. "Annoy", https://github.com/spotify/annoy
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	// sums over 'n' values, a multiple of 32 bytes
+	template<typename T> inline
+	T distance_sq( const T* a, const T* b, std::size_t n ) {
+		T s[4] = { 0, 0, 0, 0 };
+		for( std::size_t i = 0; i < n; i += 4 ) {
+			for( std::size_t j = 0; j < 4 && i + j < n; ++j ) {
+				T d = a[i + j] - b[i + j];
+				s[j] += d * d;
+			}
+		}
+		return ( s[0] + s[1] ) + ( s[2] + s[3] );
+	}
+
+	template<typename T> inline
+	T dot( const T* a, const T* b, std::size_t n ) {
+		T s[4] = { 0, 0, 0, 0 };
+		for( std::size_t i = 0; i < n; i += 4 ) {
+			for( std::size_t j = 0; j < 4 && i + j < n; ++j ) {
+				s[j] += a[i + j] * b[i + j];
+			}
+		}
+		return ( s[0] + s[1] ) + ( s[2] + s[3] );
+	}
+
+#if defined(__AVX__)
+	inline float sum8( __m256 v ) {
+		__m128 s = _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+		s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+		return _mm_cvtss_f32( _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) ) );
+	}
+
+	inline double sum4( __m256d v ) {
+		__m128d s = _mm_add_pd( _mm256_castpd256_pd128( v ), _mm256_extractf128_pd( v, 1 ) );
+		return _mm_cvtsd_f64( _mm_add_sd( s, _mm_unpackhi_pd( s, s ) ) );
+	}
+
+	template<> inline
+	float distance_sq<float>( const float* a, const float* b, std::size_t n ) {
+		__m256 s = _mm256_setzero_ps( );
+		for( std::size_t i = 0; i < n; i += 8 ) {
+			__m256 d = _mm256_sub_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ) );
+			s = _mm256_add_ps( s, _mm256_mul_ps( d, d ) );
+		}
+		return sum8( s );
+	}
+
+	template<> inline
+	float dot<float>( const float* a, const float* b, std::size_t n ) {
+		__m256 s = _mm256_setzero_ps( );
+		for( std::size_t i = 0; i < n; i += 8 ) {
+			s = _mm256_add_ps( s, _mm256_mul_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ) ) );
+		}
+		return sum8( s );
+	}
+
+	template<> inline
+	double distance_sq<double>( const double* a, const double* b, std::size_t n ) {
+		__m256d s = _mm256_setzero_pd( );
+		for( std::size_t i = 0; i < n; i += 4 ) {
+			__m256d d = _mm256_sub_pd( _mm256_loadu_pd( a + i ), _mm256_loadu_pd( b + i ) );
+			s = _mm256_add_pd( s, _mm256_mul_pd( d, d ) );
+		}
+		return sum4( s );
+	}
+
+	template<> inline
+	double dot<double>( const double* a, const double* b, std::size_t n ) {
+		__m256d s = _mm256_setzero_pd( );
+		for( std::size_t i = 0; i < n; i += 4 ) {
+			s = _mm256_add_pd( s, _mm256_mul_pd( _mm256_loadu_pd( a + i ), _mm256_loadu_pd( b + i ) ) );
+		}
+		return sum4( s );
+	}
+#elif defined(__SSE2__)
+	inline float sum4( __m128 s ) {
+		s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+		return _mm_cvtss_f32( _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) ) );
+	}
+
+	inline double sum2( __m128d s ) {
+		return _mm_cvtsd_f64( _mm_add_sd( s, _mm_unpackhi_pd( s, s ) ) );
+	}
+
+	template<> inline
+	float distance_sq<float>( const float* a, const float* b, std::size_t n ) {
+		__m128 s0 = _mm_setzero_ps( ), s1 = _mm_setzero_ps( );
+		for( std::size_t i = 0; i < n; i += 8 ) {
+			__m128 d0 = _mm_sub_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) );
+			__m128 d1 = _mm_sub_ps( _mm_loadu_ps( a + i + 4 ), _mm_loadu_ps( b + i + 4 ) );
+			s0 = _mm_add_ps( s0, _mm_mul_ps( d0, d0 ) );
+			s1 = _mm_add_ps( s1, _mm_mul_ps( d1, d1 ) );
+		}
+		return sum4( _mm_add_ps( s0, s1 ) );
+	}
+
+	template<> inline
+	float dot<float>( const float* a, const float* b, std::size_t n ) {
+		__m128 s0 = _mm_setzero_ps( ), s1 = _mm_setzero_ps( );
+		for( std::size_t i = 0; i < n; i += 8 ) {
+			s0 = _mm_add_ps( s0, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+			s1 = _mm_add_ps( s1, _mm_mul_ps( _mm_loadu_ps( a + i + 4 ), _mm_loadu_ps( b + i + 4 ) ) );
+		}
+		return sum4( _mm_add_ps( s0, s1 ) );
+	}
+
+	template<> inline
+	double distance_sq<double>( const double* a, const double* b, std::size_t n ) {
+		__m128d s0 = _mm_setzero_pd( ), s1 = _mm_setzero_pd( );
+		for( std::size_t i = 0; i < n; i += 4 ) {
+			__m128d d0 = _mm_sub_pd( _mm_loadu_pd( a + i ), _mm_loadu_pd( b + i ) );
+			__m128d d1 = _mm_sub_pd( _mm_loadu_pd( a + i + 2 ), _mm_loadu_pd( b + i + 2 ) );
+			s0 = _mm_add_pd( s0, _mm_mul_pd( d0, d0 ) );
+			s1 = _mm_add_pd( s1, _mm_mul_pd( d1, d1 ) );
+		}
+		return sum2( _mm_add_pd( s0, s1 ) );
+	}
+
+	template<> inline
+	double dot<double>( const double* a, const double* b, std::size_t n ) {
+		__m128d s0 = _mm_setzero_pd( ), s1 = _mm_setzero_pd( );
+		for( std::size_t i = 0; i < n; i += 4 ) {
+			s0 = _mm_add_pd( s0, _mm_mul_pd( _mm_loadu_pd( a + i ), _mm_loadu_pd( b + i ) ) );
+			s1 = _mm_add_pd( s1, _mm_mul_pd( _mm_loadu_pd( a + i + 2 ), _mm_loadu_pd( b + i + 2 ) ) );
+		}
+		return sum2( _mm_add_pd( s0, s1 ) );
+	}
+#endif
+
+	// starts loading 'bytes' at 'p' into cache
+	inline void prefetch( const void* p, std::size_t bytes ) {
+	#if defined(__SSE2__)
+		for( std::size_t i = 0; i < bytes; i += 64 ) {
+			_mm_prefetch( static_cast<const char*>( p ) + i, _MM_HINT_T0 );
+		}
+	#else
+		(void)p;
+		(void)bytes;
+	#endif
+	}
+
+} // End namespace detail
+
+template<typename T, std::size_t D>
+class rp_forest {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with floating point types
+	static_assert( !limit_t::is_integer, "rp_forest needs a floating point type" );
+
+	// a leaf has normal npos and holds positions [left, right) of m_order
+	struct node {
+		T             split;
+		unsigned int  normal;   // offset in m_normals
+		unsigned int  left, right;
+	};
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+	// values per stored point, D padded to 32 bytes
+	static const std::size_t stride = ( D * sizeof(T) + 31 ) / 32 * 32 / sizeof(T);
+
+	// (distance squared, index) pairs, closest first
+	typedef std::vector<std::pair<T, unsigned int>> neighbours_t;
+
+	// scratch space for nearest( ), kept between calls to reuse the memory
+	struct query_buffer {
+		std::vector<std::pair<T, unsigned int>>  queue;
+		std::vector<unsigned int>                candidates;
+		std::vector<unsigned int>                seen;    // hash set of candidates
+		std::vector<T>                           query;
+	};
+
+
+// Variables
+private:
+
+	unsigned int               m_count;
+	unsigned int               m_leaf_size;
+	std::vector<T>             m_coords;    // stride per point, in input order
+	std::vector<node>          m_nodes;     // every tree, each root first
+	std::vector<T>             m_normals;   // stride per inner node, unit length
+	std::vector<unsigned int>  m_order;     // leaf points, m_count per tree
+	std::vector<unsigned int>  m_roots;
+
+
+// Constructors
+public:
+
+	rp_forest( ) : m_count( 0 ), m_leaf_size( 32 ) { }
+
+	// 'threads' as for parallel_for( ), 0 for one per core
+	rp_forest( const std::vector<point<T,D>>& points, unsigned int trees = 8,
+	           unsigned int leaf_size = 32, unsigned int threads = 0, unsigned int seed = 1 ) {
+		build( points, trees, leaf_size, threads, seed );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const      { return m_count; }
+	bool empty( ) const             { return m_count == 0; }
+	unsigned int trees( ) const     { return m_roots.size( ); }
+	unsigned int leaf_size( ) const { return m_leaf_size; }
+
+	// the same seed gives the same forest whatever the thread count
+	void build( const std::vector<point<T,D>>& points, unsigned int trees = 8,
+	            unsigned int leaf_size = 32, unsigned int threads = 0, unsigned int seed = 1 ) {
+		m_count = points.size( );
+		m_leaf_size = std::max( leaf_size, 1u );
+		m_nodes.clear( );
+		m_normals.clear( );
+		m_roots.clear( );
+		m_order.assign( std::size_t(m_count) * trees, 0 );
+		m_coords.assign( std::size_t(m_count) * stride, T( 0 ) );
+		parallel_for( 0, m_count, [&]( unsigned int i ) {
+			for( std::size_t a = 0; a < D; ++a ) { m_coords[i * stride + a] = points[i][a]; }
+		}, threads, 4096 );
+		if( m_count == 0 || trees == 0 ) { return; }
+
+		std::vector<std::vector<node>> nodes( trees );
+		std::vector<std::vector<T>> normals( trees );
+		parallel_for( 0, trees, [&]( unsigned int t ) {
+			build_tree( t, seed, nodes[t], normals[t] );
+		}, threads, 1 );
+
+		// one array for all, moving the offsets along
+		for( unsigned int t = 0; t < trees; ++t ) {
+			const unsigned int base = m_nodes.size( ), normal_base = m_normals.size( );
+			for( unsigned int i = 0; i < nodes[t].size( ); ++i ) {
+				node n = nodes[t][i];
+				if( n.normal == npos ) {
+					n.left += t * m_count;
+					n.right += t * m_count;
+				}
+				else {
+					n.normal += normal_base;
+					n.left += base;
+					n.right += base;
+				}
+				m_nodes.push_back( n );
+			}
+			m_normals.insert( m_normals.end( ), normals[t].begin( ), normals[t].end( ) );
+			m_roots.push_back( base );
+			std::vector<node>( ).swap( nodes[t] );
+			std::vector<T>( ).swap( normals[t] );
+		}
+	}
+
+	// the k (at most) approximate nearest points to 'pt', closest first,
+	//   as (distance squared, index) pairs. 'search_k' candidates are
+	//   ranked, 0 for k or leaf_size( ), whichever is more, per tree.
+	void nearest( const point<T,D>& pt, unsigned int k, neighbours_t& result,
+	              query_buffer& buffer, unsigned int search_k = 0 ) const {
+		result.clear( );
+		if( k == 0 || m_count == 0 || m_roots.empty( ) ) { return; }
+		buffer.query.assign( stride, T( 0 ) );
+		for( std::size_t a = 0; a < D; ++a ) { buffer.query[a] = pt[a]; }
+		search( &buffer.query[0], k, search_k, buffer, result );
+	}
+
+	void nearest( const point<T,D>& pt, unsigned int k, neighbours_t& result,
+	              unsigned int search_k = 0 ) const {
+		query_buffer buffer;
+		nearest( pt, k, result, buffer, search_k );
+	}
+
+	// nearest( ) for every query in parallel. The neighbours of query q
+	//   are result[q * k] to result[q * k + k - 1], padded with
+	//   ( limit_t::max( ), npos ) when fewer than k were found.
+	void nearest( const std::vector<point<T,D>>& queries, unsigned int k, neighbours_t& result,
+	              unsigned int search_k = 0, unsigned int threads = 0 ) const {
+		result.assign( std::size_t(queries.size( )) * k, std::make_pair( limit_t::max( ), npos ) );
+		if( k == 0 || m_count == 0 || m_roots.empty( ) ) { return; }
+		const unsigned int block = 64;
+		const unsigned int blocks = ( queries.size( ) + block - 1 ) / block;
+		parallel_for( 0, blocks, [&]( unsigned int b ) {
+			query_buffer buffer;
+			neighbours_t found;
+			for( unsigned int q = b * block, e = std::min<unsigned int>( q + block, queries.size( ) ); q < e; ++q ) {
+				nearest( queries[q], k, found, buffer, search_k );
+				std::copy( found.begin( ), found.end( ), result.begin( ) + std::size_t(q) * k );
+			}
+		}, threads, 1 );
+	}
+
+	// the share of the true k nearest neighbours of 'queries' that
+	//   nearest( ) finds, checked by brute force
+	double recall( const std::vector<point<T,D>>& queries, unsigned int k,
+	               unsigned int search_k = 0, unsigned int threads = 0 ) const {
+		if( queries.empty( ) || k == 0 || m_count == 0 ) { return 1.0; }
+		neighbours_t found;
+		nearest( queries, k, found, search_k, threads );
+		std::vector<unsigned int> hits( queries.size( ), 0 );
+		parallel_for( 0, queries.size( ), [&]( unsigned int q ) {
+			std::vector<T> query( stride, T( 0 ) );
+			for( std::size_t a = 0; a < D; ++a ) { query[a] = queries[q][a]; }
+			neighbours_t exact;
+			rank_all( &query[0], k, exact );
+			// ties with the k-th distance count as found
+			const T bound = exact.back( ).first;
+			for( unsigned int j = 0; j < k; ++j ) {
+				const std::pair<T, unsigned int>& f = found[std::size_t(q) * k + j];
+				if( f.second != npos && f.first <= bound ) { ++hits[q]; }
+			}
+		}, threads, 1 );
+		std::size_t total = 0;
+		for( unsigned int q = 0; q < hits.size( ); ++q ) { total += hits[q]; }
+		return double(total) / ( double(queries.size( )) * std::min( k, m_count ) );
+	}
+
+private:
+
+	const T* coords( unsigned int i ) const { return &m_coords[std::size_t(i) * stride]; }
+
+	// fills this tree's part of m_order, which no other tree touches
+	void build_tree( unsigned int tree, unsigned int seed, std::vector<node>& nodes,
+	                 std::vector<T>& normals ) {
+		std::mt19937 random( seed * 2654435761u + tree );
+		std::normal_distribution<double> gauss;
+		unsigned int* order = &m_order[std::size_t(tree) * m_count];
+		for( unsigned int i = 0; i < m_count; ++i ) { order[i] = i; }
+
+		std::vector<std::pair<T, unsigned int>> projected;
+		std::vector<T> normal( stride );
+		std::vector<unsigned int> todo( 1, 0 );
+		nodes.push_back( node( ) );
+		nodes[0].left = 0;
+		nodes[0].right = m_count;
+
+		while( !todo.empty( ) ) {
+			const unsigned int n = todo.back( );
+			todo.pop_back( );
+			const unsigned int begin = nodes[n].left, end = nodes[n].right;
+			nodes[n].normal = npos;
+			if( end - begin <= m_leaf_size ) { continue; }
+
+			// the line through two random points, or a random line if they
+			//   are the same
+			double length = 0.0;
+			for( unsigned int attempt = 0; attempt < 3 && length == 0.0; ++attempt ) {
+				const T* p1 = coords( order[begin + random( ) % ( end - begin )] );
+				const T* p2 = coords( order[begin + random( ) % ( end - begin )] );
+				for( std::size_t a = 0; a < D; ++a ) { normal[a] = p1[a] - p2[a]; }
+				length = std::sqrt( double(detail::dot( &normal[0], &normal[0], stride )) );
+			}
+			if( length == 0.0 ) {
+				for( std::size_t a = 0; a < D; ++a ) { normal[a] = T( gauss( random ) ); }
+				length = std::sqrt( double(detail::dot( &normal[0], &normal[0], stride )) );
+			}
+			for( std::size_t a = 0; a < D; ++a ) { normal[a] = T( normal[a] / length ); }
+
+			projected.resize( end - begin );
+			for( unsigned int i = begin; i < end; ++i ) {
+				projected[i - begin] = std::make_pair( detail::dot( &normal[0], coords( order[i] ), stride ), order[i] );
+			}
+			const unsigned int mid = ( end - begin ) / 2;
+			std::nth_element( projected.begin( ), projected.begin( ) + mid, projected.end( ) );
+			for( unsigned int i = begin; i < end; ++i ) { order[i] = projected[i - begin].second; }
+
+			nodes[n].split = projected[mid].first;
+			nodes[n].normal = normals.size( );
+			normals.insert( normals.end( ), normal.begin( ), normal.end( ) );
+			const unsigned int left = nodes.size( );
+			nodes[n].left = left;
+			nodes[n].right = left + 1;
+			node child;
+			child.split = T( 0 );
+			child.normal = npos;
+			child.left = begin;
+			child.right = begin + mid;
+			nodes.push_back( child );
+			child.left = begin + mid;
+			child.right = end;
+			nodes.push_back( child );
+			todo.push_back( left );
+			todo.push_back( left + 1 );
+		}
+	}
+
+	// best first through every tree, the priority of a node being the
+	//   furthest it lies past any plane on its path
+	void search( const T* q, unsigned int k, unsigned int search_k, query_buffer& buffer,
+	             neighbours_t& result ) const {
+		typedef std::greater<std::pair<T, unsigned int>> later;
+		if( search_k == 0 ) { search_k = std::max( k, m_leaf_size ) * m_roots.size( ); }
+		search_k = std::min( search_k, m_count );
+		std::vector<std::pair<T, unsigned int>>& queue = buffer.queue;
+		std::vector<unsigned int>& candidates = buffer.candidates;
+		std::vector<unsigned int>& seen = buffer.seen;
+		unsigned int slots = 64;
+		while( slots < 2 * ( search_k + m_leaf_size ) ) { slots *= 2; }
+		queue.clear( );
+		candidates.clear( );
+		seen.assign( slots, npos );
+		for( unsigned int t = 0; t < m_roots.size( ); ++t ) {
+			queue.push_back( std::make_pair( T( 0 ), m_roots[t] ) );
+		}
+
+		while( !queue.empty( ) && candidates.size( ) < search_k ) {
+			std::pop_heap( queue.begin( ), queue.end( ), later( ) );
+			const std::pair<T, unsigned int> top = queue.back( );
+			queue.pop_back( );
+			const node& n = m_nodes[top.second];
+			if( n.normal == npos ) {
+				// trees share points, keep the first sighting
+				for( unsigned int i = n.left; i < n.right; ++i ) {
+					const unsigned int id = m_order[i];
+					unsigned int h = ( id * 2654435761u ) & ( slots - 1 );
+					while( seen[h] != npos && seen[h] != id ) { h = ( h + 1 ) & ( slots - 1 ); }
+					if( seen[h] == npos ) {
+						seen[h] = id;
+						candidates.push_back( id );
+					}
+				}
+				continue;
+			}
+			const T margin = detail::dot( q, &m_normals[n.normal], stride ) - n.split;
+			queue.push_back( std::make_pair( top.first, margin < 0 ? n.left : n.right ) );
+			std::push_heap( queue.begin( ), queue.end( ), later( ) );
+			queue.push_back( std::make_pair( std::max( top.first, T( std::abs( margin ) ) ),
+			                                 margin < 0 ? n.right : n.left ) );
+			std::push_heap( queue.begin( ), queue.end( ), later( ) );
+		}
+
+		rank( q, k, candidates.data( ), candidates.data( ) + candidates.size( ), result );
+	}
+
+	// the k nearest of 'first' to 'last' into 'result', closest first
+	void rank( const T* q, unsigned int k, const unsigned int* first, const unsigned int* last,
+	           neighbours_t& result ) const {
+		const unsigned int ahead = 8;
+		result.clear( );
+		for( ; first != last; ++first ) {
+			if( last - first > ahead ) { detail::prefetch( coords( first[ahead] ), stride * sizeof(T) ); }
+			const T d = detail::distance_sq( q, coords( *first ), stride );
+			if( result.size( ) < k ) {
+				result.push_back( std::make_pair( d, *first ) );
+				std::push_heap( result.begin( ), result.end( ) );
+			}
+			else if( std::make_pair( d, *first ) < result.front( ) ) {
+				std::pop_heap( result.begin( ), result.end( ) );
+				result.back( ) = std::make_pair( d, *first );
+				std::push_heap( result.begin( ), result.end( ) );
+			}
+		}
+		std::sort_heap( result.begin( ), result.end( ) );
+	}
+
+	void rank_all( const T* q, unsigned int k, neighbours_t& result ) const {
+		std::vector<unsigned int> all( m_count );
+		for( unsigned int i = 0; i < m_count; ++i ) { all[i] = i; }
+		rank( q, k, all.data( ), all.data( ) + all.size( ), result );
+	}
+}; // End class rp_forest
+
+template<typename T, std::size_t D>
+const unsigned int rp_forest<T,D>::npos;
+
+template<typename T, std::size_t D>
+const std::size_t rp_forest<T,D>::stride;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_RP_FOREST_HPP
@@ -0,0 +1,693 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_RSTAR_TREE_HPP
+#define EUBLIB_RSTAR_TREE_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <cmath>
+#include "point.hpp"
+#include "rect.hpp"
+
+/*
+ * Dynamic R*-tree over rect2
+ *
+ *   Every box inserted gets a handle, which stays valid until the box is
+ *   removed and is what searches report. Nodes hold up to M entries and
+ *   live in one array, freed nodes being reused before it grows.
+ *
+ *   Insertion follows the R*-tree [1]: the subtree needing the least
+ *   overlap enlargement (just above the leaves) or area enlargement
+ *   (higher up) is chosen, and the first node to overflow on each level
+ *   gives up its 30% outermost entries to be inserted again before any
+ *   node is split. Splits pick the axis with the least margin, then the
+ *   cut with the least overlap.
+ *
+ *   update( ) of a box that stays inside its leaf only rewrites the entry
+ *   and refits the boxes above it, anything else is a remove and insert.
+ *
+ * References
+ *   [1] N. Beckmann, H.-P. Kriegel, R. Schneider, B. Seeger. "The R*-tree:
+ *         an efficient and robust access method for points and
+ *         rectangles". Proceedings of ACM SIGMOD, pp. 322-331, 1990.
+ *   [2] A. Guttman. "R-trees: a dynamic index structure for spatial
+ *         searching". Proceedings of ACM SIGMOD, pp. 47-57, 1984.
+ */
+
+namespace euclib {
+
+template<typename T, unsigned int M = 16>
+class rstar_tree {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+	static_assert( M >= 4, "nodes need room for at least 4 entries" );
+
+	static const unsigned int min_entries = M * 2 / 5 < 2 ? 2 : M * 2 / 5;
+	static const unsigned int reinsert_count = M * 3 / 10 < 1 ? 1 : M * 3 / 10;
+	static const unsigned int max_depth = 32;
+
+	struct entry {
+		T             l, r, t, b;
+		unsigned int  id;  // a handle in a leaf, a node above
+	};
+
+	struct node {
+		unsigned int  parent;
+		unsigned int  level;  // 0 for leaves
+		unsigned int  count;
+		entry         entries[M + 1];  // one spare while overflowing
+	};
+
+	struct item {
+		unsigned int  node;  // npos while the handle is free
+		unsigned int  slot;
+	};
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+	// (distance squared, node or handle) pairs for nearest( ), kept
+	//   between calls to reuse the memory
+	typedef std::vector<std::pair<double, std::pair<unsigned int, bool>>> nearest_queue;
+
+
+// Variables
+private:
+
+	std::vector<node>          m_nodes;
+	std::vector<unsigned int>  m_free_nodes;
+	std::vector<item>          m_items;
+	std::vector<unsigned int>  m_free_items;
+	unsigned int               m_root;
+	unsigned int               m_size;
+
+	// entries of dropped nodes, kept to reuse the memory
+	std::vector<std::pair<entry, unsigned int>>  m_orphans;
+
+
+// Constructors
+public:
+
+	rstar_tree( ) { clear( ); }
+
+
+// Methods
+public:
+
+	unsigned int size( ) const { return m_size; }
+	bool empty( ) const        { return m_size == 0; }
+	unsigned int height( ) const { return m_nodes[m_root].level + 1; }
+
+	void clear( ) {
+		m_nodes.clear( );
+		m_free_nodes.clear( );
+		m_items.clear( );
+		m_free_items.clear( );
+		m_size = 0;
+		m_root = alloc_node( 0 );
+		m_nodes[m_root].parent = npos;
+	}
+
+	// room for 'count' boxes without the arrays growing
+	void reserve( unsigned int count ) {
+		m_items.reserve( count );
+		m_nodes.reserve( 2 * count / ( min_entries + 1 ) + 1 );
+	}
+
+	rect2<T> bounding_box( ) const {
+		if( m_size == 0 ) { return rect2<T>::null( ); }
+		entry e = node_box( m_root );
+		return rect2<T>( e.l, e.r, e.t, e.b );
+	}
+
+	// the box stored for 'handle'
+	rect2<T> box( unsigned int handle ) const {
+		const item& it = m_items[handle];
+		const entry& e = m_nodes[it.node].entries[it.slot];
+		return rect2<T>( e.l, e.r, e.t, e.b );
+	}
+
+	bool contains( unsigned int handle ) const {
+		return handle < m_items.size( ) && m_items[handle].node != npos;
+	}
+
+	// adds 'rect', returning its handle, or npos for a null rect
+	unsigned int insert( const rect2<T>& rect ) {
+		if( rect == rect2<T>::null( ) ) { return npos; }
+		unsigned int handle;
+		if( !m_free_items.empty( ) ) {
+			handle = m_free_items.back( );
+			m_free_items.pop_back( );
+		}
+		else {
+			handle = m_items.size( );
+			m_items.push_back( item( ) );
+		}
+		entry e = { rect.l, rect.r, rect.t, rect.b, handle };
+		unsigned int reinserted = 0;
+		insert_entry( e, 0, reinserted );
+		++m_size;
+		return handle;
+	}
+
+	bool remove( unsigned int handle ) {
+		if( !contains( handle ) ) { return false; }
+		remove_entry( handle );
+		m_items[handle].node = npos;
+		m_free_items.push_back( handle );
+		--m_size;
+		return true;
+	}
+
+	// moves the box of 'handle' to 'rect'
+	bool update( unsigned int handle, const rect2<T>& rect ) {
+		if( !contains( handle ) || rect == rect2<T>::null( ) ) { return false; }
+		const item it = m_items[handle];
+		entry e = { rect.l, rect.r, rect.t, rect.b, handle };
+
+		// still inside its leaf, so only the boxes above need refitting
+		const unsigned int leaf = it.node;
+		if( leaf == m_root || encloses( parent_entry( leaf ), e ) ) {
+			m_nodes[leaf].entries[it.slot] = e;
+			refit_up( leaf );
+			return true;
+		}
+
+		remove_entry( handle );
+		unsigned int reinserted = 0;
+		insert_entry( e, 0, reinserted );
+		return true;
+	}
+
+	// calls visit( handle ) for every box overlapping 'window', stopping
+	//   early if visit returns false. Touching counts as overlapping.
+	template<typename Visitor>
+	void search( const rect2<T>& window, Visitor visit ) const {
+		if( m_size == 0 || window == rect2<T>::null( ) ) { return; }
+		search( window.l, window.r, window.t, window.b, visit );
+	}
+
+	void search( const rect2<T>& window, std::vector<unsigned int>& result ) const {
+		search( window, [&]( unsigned int handle ) {
+			result.push_back( handle );
+			return true;
+		} );
+	}
+
+	// calls visit( handle ) for every box containing 'pt'
+	template<typename Visitor>
+	void search( const point2<T>& pt, Visitor visit ) const {
+		if( m_size == 0 || pt == point2<T>::null( ) ) { return; }
+		search( pt.x, pt.x, pt.y, pt.y, visit );
+	}
+
+	void search( const point2<T>& pt, std::vector<unsigned int>& result ) const {
+		search( pt, [&]( unsigned int handle ) {
+			result.push_back( handle );
+			return true;
+		} );
+	}
+
+	// calls visit( handle, distance ) for boxes in order of distance from
+	//   'pt' until visit returns false or every box within 'max_distance'
+	//   has been seen. 'queue' is scratch space kept between calls.
+	template<typename Visitor>
+	void nearest( const point2<T>& pt, Visitor visit, nearest_queue& queue,
+	              double max_distance = std::numeric_limits<double>::infinity( ) ) const {
+		typedef typename nearest_queue::value_type queued;
+		typedef std::greater<queued> later;
+		queue.clear( );
+		if( m_size == 0 ) { return; }
+		const double max_sq = max_distance * max_distance;
+		const double x = pt.x, y = pt.y;
+
+		queue.push_back( queued( 0.0, std::make_pair( m_root, false ) ) );
+		while( !queue.empty( ) ) {
+			std::pop_heap( queue.begin( ), queue.end( ), later( ) );
+			queued top = queue.back( );
+			queue.pop_back( );
+			if( top.first > max_sq ) { break; }
+			if( top.second.second ) {
+				if( !visit( top.second.first, std::sqrt( top.first ) ) ) { return; }
+				continue;
+			}
+			const node& n = m_nodes[top.second.first];
+			for( unsigned int i = 0; i < n.count; ++i ) {
+				double d = distance_sq( n.entries[i], x, y );
+				if( d <= max_sq ) {
+					queue.push_back( queued( d, std::make_pair( n.entries[i].id, n.level == 0 ) ) );
+					std::push_heap( queue.begin( ), queue.end( ), later( ) );
+				}
+			}
+		}
+	}
+
+	// the (at most) k boxes nearest 'pt', closest first
+	void nearest( const point2<T>& pt, unsigned int k, std::vector<unsigned int>& result,
+	              double max_distance = std::numeric_limits<double>::infinity( ) ) const {
+		result.clear( );
+		if( k == 0 ) { return; }
+		nearest_queue queue;
+		nearest( pt, [&]( unsigned int handle, double ) {
+			result.push_back( handle );
+			return result.size( ) < k;
+		}, queue, max_distance );
+	}
+
+private:
+
+	// entry helpers
+
+	static double area( const entry& e ) {
+		return ( double(e.r) - double(e.l) ) * ( double(e.b) - double(e.t) );
+	}
+
+	static double margin( const entry& e ) {
+		return ( double(e.r) - double(e.l) ) + ( double(e.b) - double(e.t) );
+	}
+
+	static void extend( entry& e, const entry& by ) {
+		e.l = std::min( e.l, by.l );
+		e.r = std::max( e.r, by.r );
+		e.t = std::min( e.t, by.t );
+		e.b = std::max( e.b, by.b );
+	}
+
+	static double enlarged_area( const entry& e, const entry& by ) {
+		return ( double(std::max( e.r, by.r )) - double(std::min( e.l, by.l )) ) *
+		       ( double(std::max( e.b, by.b )) - double(std::min( e.t, by.t )) );
+	}
+
+	static double overlap( const entry& e1, const entry& e2 ) {
+		double w = double(std::min( e1.r, e2.r )) - double(std::max( e1.l, e2.l ));
+		double h = double(std::min( e1.b, e2.b )) - double(std::max( e1.t, e2.t ));
+		return ( w > 0.0 && h > 0.0 ) ? w * h : 0.0;
+	}
+
+	static bool encloses( const entry& outer, const entry& inner ) {
+		return outer.l <= inner.l && inner.r <= outer.r &&
+		       outer.t <= inner.t && inner.b <= outer.b;
+	}
+
+	static bool same_box( const entry& e1, const entry& e2 ) {
+		return e1.l == e2.l && e1.r == e2.r && e1.t == e2.t && e1.b == e2.b;
+	}
+
+	static double distance_sq( const entry& e, double x, double y ) {
+		double dx = std::max( std::max( double(e.l) - x, x - double(e.r) ), 0.0 );
+		double dy = std::max( std::max( double(e.t) - y, y - double(e.b) ), 0.0 );
+		return dx * dx + dy * dy;
+	}
+
+	// node helpers
+
+	unsigned int alloc_node( unsigned int level ) {
+		unsigned int id;
+		if( !m_free_nodes.empty( ) ) {
+			id = m_free_nodes.back( );
+			m_free_nodes.pop_back( );
+		}
+		else {
+			id = m_nodes.size( );
+			m_nodes.push_back( node( ) );
+		}
+		m_nodes[id].level = level;
+		m_nodes[id].count = 0;
+		m_nodes[id].parent = npos;
+		return id;
+	}
+
+	void free_node( unsigned int id ) {
+		m_free_nodes.push_back( id );
+	}
+
+	entry node_box( unsigned int id ) const {
+		const node& n = m_nodes[id];
+		entry e = n.entries[0];
+		for( unsigned int i = 1; i < n.count; ++i ) { extend( e, n.entries[i] ); }
+		e.id = id;
+		return e;
+	}
+
+	unsigned int slot_in_parent( unsigned int id ) const {
+		const node& p = m_nodes[m_nodes[id].parent];
+		unsigned int slot = 0;
+		while( p.entries[slot].id != id ) { ++slot; }
+		return slot;
+	}
+
+	const entry& parent_entry( unsigned int id ) const {
+		return m_nodes[m_nodes[id].parent].entries[slot_in_parent( id )];
+	}
+
+	// points whatever entry 'slot' of node 'id' refers to back at it
+	void link( unsigned int id, unsigned int slot ) {
+		node& n = m_nodes[id];
+		if( n.level == 0 ) {
+			m_items[n.entries[slot].id].node = id;
+			m_items[n.entries[slot].id].slot = slot;
+		}
+		else {
+			m_nodes[n.entries[slot].id].parent = id;
+		}
+	}
+
+	void add_entry( unsigned int id, const entry& e ) {
+		node& n = m_nodes[id];
+		n.entries[n.count] = e;
+		link( id, n.count++ );
+	}
+
+	void remove_slot( unsigned int id, unsigned int slot ) {
+		node& n = m_nodes[id];
+		--n.count;
+		if( slot != n.count ) {
+			n.entries[slot] = n.entries[n.count];
+			link( id, slot );
+		}
+	}
+
+	// makes the boxes above 'id' fit again, stopping once one is unchanged
+	void refit_up( unsigned int id ) {
+		while( id != m_root ) {
+			unsigned int parent = m_nodes[id].parent;
+			entry& e = m_nodes[parent].entries[slot_in_parent( id )];
+			entry fit = node_box( id );
+			if( same_box( e, fit ) ) { return; }
+			e = fit;
+			id = parent;
+		}
+	}
+
+	// insertion
+
+	unsigned int choose_subtree( const entry& e, unsigned int level ) const {
+		unsigned int id = m_root;
+		while( m_nodes[id].level > level ) {
+			const node& n = m_nodes[id];
+			unsigned int best = 0;
+			if( n.level == 1 ) {
+				// least overlap enlargement, then area enlargement, then area
+				double best_overlap = 0.0, best_enlarge = 0.0, best_area = 0.0;
+				bool enclosed = false;
+				for( unsigned int i = 0; i < n.count; ++i ) {
+					// a child already holding 'e' adds no overlap, take the smallest
+					if( encloses( n.entries[i], e ) ) {
+						double a = area( n.entries[i] );
+						if( !enclosed || a < best_area ) {
+							best = i;
+							best_area = a;
+						}
+						enclosed = true;
+					}
+				}
+				for( unsigned int i = 0; i < n.count && !enclosed; ++i ) {
+					entry grown = n.entries[i];
+					extend( grown, e );
+					double before = 0.0, after = 0.0;
+					for( unsigned int j = 0; j < n.count; ++j ) {
+						if( j == i ) { continue; }
+						before += overlap( n.entries[i], n.entries[j] );
+						after += overlap( grown, n.entries[j] );
+					}
+					double enlarge_overlap = after - before;
+					double a = area( n.entries[i] );
+					double enlarge = area( grown ) - a;
+					if( i == 0 || enlarge_overlap < best_overlap ||
+					    ( enlarge_overlap == best_overlap &&
+					      ( enlarge < best_enlarge || ( enlarge == best_enlarge && a < best_area ) ) ) ) {
+						best = i;
+						best_overlap = enlarge_overlap;
+						best_enlarge = enlarge;
+						best_area = a;
+					}
+				}
+			}
+			else {
+				// least area enlargement, then area
+				double best_enlarge = 0.0, best_area = 0.0;
+				for( unsigned int i = 0; i < n.count; ++i ) {
+					double a = area( n.entries[i] );
+					double enlarge = enlarged_area( n.entries[i], e ) - a;
+					if( i == 0 || enlarge < best_enlarge || ( enlarge == best_enlarge && a < best_area ) ) {
+						best = i;
+						best_enlarge = enlarge;
+						best_area = a;
+					}
+				}
+			}
+			id = n.entries[best].id;
+		}
+		return id;
+	}
+
+	// 'reinserted' has bit k set once level k has reinserted during this
+	//   insertion, so each level does it at most once
+	void insert_entry( const entry& e, unsigned int level, unsigned int& reinserted ) {
+		unsigned int id = choose_subtree( e, level );
+		add_entry( id, e );
+		if( m_nodes[id].count > M ) { overflow( id, reinserted ); }
+		else { refit_up( id ); }
+	}
+
+	void overflow( unsigned int id, unsigned int& reinserted ) {
+		unsigned int bit = 1u << m_nodes[id].level;
+		if( id != m_root && !( reinserted & bit ) ) {
+			reinserted |= bit;
+			reinsert( id, reinserted );
+		}
+		else {
+			split( id, reinserted );
+		}
+	}
+
+	// takes out the entries furthest from the node's centre and inserts
+	//   them again, closest first
+	void reinsert( unsigned int id, unsigned int& reinserted ) {
+		node& n = m_nodes[id];
+		entry box = node_box( id );
+		double cx = ( double(box.l) + double(box.r) ) / 2.0;
+		double cy = ( double(box.t) + double(box.b) ) / 2.0;
+
+		std::pair<double, unsigned int> order[M + 1];
+		for( unsigned int i = 0; i < n.count; ++i ) {
+			double dx = ( double(n.entries[i].l) + double(n.entries[i].r) ) / 2.0 - cx;
+			double dy = ( double(n.entries[i].t) + double(n.entries[i].b) ) / 2.0 - cy;
+			order[i] = std::make_pair( dx * dx + dy * dy, i );
+		}
+		std::sort( order, order + n.count );
+
+		const unsigned int level = n.level;
+		const unsigned int keep = n.count - reinsert_count;
+		entry kept[M + 1], removed[reinsert_count];
+		for( unsigned int i = 0; i < keep; ++i ) { kept[i] = n.entries[order[i].second]; }
+		for( unsigned int i = keep; i < n.count; ++i ) { removed[i - keep] = n.entries[order[i].second]; }
+		n.count = 0;
+		for( unsigned int i = 0; i < keep; ++i ) { add_entry( id, kept[i] ); }
+		refit_up( id );
+
+		for( unsigned int i = 0; i < reinsert_count; ++i ) {
+			insert_entry( removed[i], level, reinserted );
+		}
+	}
+
+	void split( unsigned int id, unsigned int& reinserted ) {
+		entry all[M + 1];
+		const unsigned int total = m_nodes[id].count;
+		std::copy( m_nodes[id].entries, m_nodes[id].entries + total, all );
+
+		const unsigned int cut = choose_split( all, total );
+
+		const unsigned int level = m_nodes[id].level;
+		unsigned int sibling = alloc_node( level );
+		m_nodes[id].count = 0;
+		for( unsigned int i = 0; i < cut; ++i ) { add_entry( id, all[i] ); }
+		for( unsigned int i = cut; i < total; ++i ) { add_entry( sibling, all[i] ); }
+
+		if( id == m_root ) {
+			unsigned int root = alloc_node( level + 1 );
+			add_entry( root, node_box( id ) );
+			add_entry( root, node_box( sibling ) );
+			m_root = root;
+			return;
+		}
+
+		unsigned int parent = m_nodes[id].parent;
+		m_nodes[parent].entries[slot_in_parent( id )] = node_box( id );
+		add_entry( parent, node_box( sibling ) );
+		if( m_nodes[parent].count > M ) { overflow( parent, reinserted ); }
+		else { refit_up( parent ); }
+	}
+
+	// sorts 'all' and returns the cut making the R* split: the axis with
+	//   the least total margin, then the cut with the least overlap and
+	//   then least area
+	unsigned int choose_split( entry* all, unsigned int total ) {
+		const unsigned int first_cut = min_entries, last_cut = total - min_entries;
+		entry best_order[M + 1];
+		unsigned int best_cut = first_cut;
+		double best_margin = 0.0;
+		bool have = false;
+
+		for( int axis = 0; axis < 2; ++axis ) {
+			entry sorted[2][M + 1];
+			std::copy( all, all + total, sorted[0] );
+			std::copy( all, all + total, sorted[1] );
+			if( axis == 0 ) {
+				std::sort( sorted[0], sorted[0] + total, []( const entry& a, const entry& b ) {
+					return a.l < b.l || ( a.l == b.l && a.r < b.r ); } );
+				std::sort( sorted[1], sorted[1] + total, []( const entry& a, const entry& b ) {
+					return a.r < b.r || ( a.r == b.r && a.l < b.l ); } );
+			}
+			else {
+				std::sort( sorted[0], sorted[0] + total, []( const entry& a, const entry& b ) {
+					return a.t < b.t || ( a.t == b.t && a.b < b.b ); } );
+				std::sort( sorted[1], sorted[1] + total, []( const entry& a, const entry& b ) {
+					return a.b < b.b || ( a.b == b.b && a.t < b.t ); } );
+			}
+
+			double margin_sum = 0.0;
+			double axis_overlap = 0.0, axis_area = 0.0;
+			unsigned int axis_sort = 0, axis_cut = first_cut;
+			bool axis_have = false;
+			for( int s = 0; s < 2; ++s ) {
+				// boxes of every prefix and suffix
+				entry prefix[M + 1], suffix[M + 1];
+				prefix[0] = sorted[s][0];
+				for( unsigned int i = 1; i < total; ++i ) {
+					prefix[i] = prefix[i - 1];
+					extend( prefix[i], sorted[s][i] );
+				}
+				suffix[total - 1] = sorted[s][total - 1];
+				for( unsigned int i = total - 1; i-- > 0; ) {
+					suffix[i] = suffix[i + 1];
+					extend( suffix[i], sorted[s][i] );
+				}
+				for( unsigned int cut = first_cut; cut <= last_cut; ++cut ) {
+					const entry& a = prefix[cut - 1];
+					const entry& b = suffix[cut];
+					margin_sum += margin( a ) + margin( b );
+					double o = overlap( a, b );
+					double ar = area( a ) + area( b );
+					if( !axis_have || o < axis_overlap || ( o == axis_overlap && ar < axis_area ) ) {
+						axis_have = true;
+						axis_overlap = o;
+						axis_area = ar;
+						axis_sort = s;
+						axis_cut = cut;
+					}
+				}
+			}
+
+			if( !have || margin_sum < best_margin ) {
+				have = true;
+				best_margin = margin_sum;
+				best_cut = axis_cut;
+				std::copy( sorted[axis_sort], sorted[axis_sort] + total, best_order );
+			}
+		}
+		std::copy( best_order, best_order + total, all );
+		return best_cut;
+	}
+
+	// removal
+
+	// takes the entry of 'handle' out, leaving the handle allocated
+	void remove_entry( unsigned int handle ) {
+		unsigned int id = m_items[handle].node;
+		remove_slot( id, m_items[handle].slot );
+		condense( id );
+	}
+
+	// drops underfull nodes on the way to the root, putting their
+	//   entries back in at the same level
+	void condense( unsigned int id ) {
+		std::vector<std::pair<entry, unsigned int>>& orphans = m_orphans;
+		orphans.clear( );
+		while( id != m_root ) {
+			unsigned int parent = m_nodes[id].parent;
+			if( m_nodes[id].count < min_entries ) {
+				remove_slot( parent, slot_in_parent( id ) );
+				const node& n = m_nodes[id];
+				for( unsigned int i = 0; i < n.count; ++i ) {
+					orphans.push_back( std::make_pair( n.entries[i], n.level ) );
+				}
+				free_node( id );
+			}
+			else {
+				m_nodes[parent].entries[slot_in_parent( id )] = node_box( id );
+			}
+			id = parent;
+		}
+
+		for( unsigned int i = 0; i < orphans.size( ); ++i ) {
+			unsigned int reinserted = 0;
+			insert_entry( orphans[i].first, orphans[i].second, reinserted );
+		}
+
+		// a root with one child is not needed
+		while( m_nodes[m_root].level > 0 && m_nodes[m_root].count == 1 ) {
+			unsigned int old = m_root;
+			m_root = m_nodes[old].entries[0].id;
+			m_nodes[m_root].parent = npos;
+			free_node( old );
+		}
+	}
+
+	// searching
+
+	template<typename Visitor>
+	void search( T ql, T qr, T qt, T qb, Visitor& visit ) const {
+		unsigned int stack[max_depth * M];
+		unsigned int top = 0;
+		stack[top++] = m_root;
+		while( top > 0 ) {
+			const node& n = m_nodes[stack[--top]];
+			for( unsigned int i = 0; i < n.count; ++i ) {
+				const entry& e = n.entries[i];
+				if( e.l > qr || ql > e.r || e.t > qb || qt > e.b ) { continue; }
+				if( n.level == 0 ) {
+					if( !visit( e.id ) ) { return; }
+				}
+				else {
+					stack[top++] = e.id;
+				}
+			}
+		}
+	}
+
+}; // End class rstar_tree
+
+template<typename T, unsigned int M>
+const unsigned int rstar_tree<T,M>::npos;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_RSTAR_TREE_HPP
@@ -165,6 +165,52 @@ public:
 }; // End class segment<T,2>
 
 
+// A 2D segment between two points, usable with any scalar type.
+template<typename T>
+class segment2 {
+// Variables
+public:
+
+	point2<T> pt1, pt2;
+
+
+// Constructors
+public:
+
+	segment2( ) { }
+	segment2( const point2<T>& pt1_, const point2<T>& pt2_ ) : pt1( pt1_ ), pt2( pt2_ ) { }
+	segment2( T x1, T y1, T x2, T y2 ) : pt1( x1, y1 ), pt2( x2, y2 ) { }
+
+
+// Methods
+public:
+
+	// Returns a null segment, defined by two null points
+	static segment2<T> null( ) {
+		return segment2<T>( point2<T>::null( ), point2<T>::null( ) );
+	}
+
+	float length( ) const {
+		float dx = static_cast<float>( pt2.x ) - static_cast<float>( pt1.x );
+		float dy = static_cast<float>( pt2.y ) - static_cast<float>( pt1.y );
+		return std::sqrt( dx*dx + dy*dy );
+	}
+
+
+// Operators
+public:
+
+	bool operator == ( const segment2<T>& seg ) const {
+		return pt1 == seg.pt1 && pt2 == seg.pt2;
+	}
+
+	bool operator != ( const segment2<T>& seg ) const {
+		return !(*this == seg);
+	}
+
+}; // End class segment2<T>
+
+
 typedef segment<float,2>         segment2f;
 typedef segment<double,2>        segment2d;
 
@@ -0,0 +1,635 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SEGMENT_BVH_HPP
+#define EUBLIB_SEGMENT_BVH_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include "point.hpp"
+#include "vector.hpp"
+#include "segment.hpp"
+#include "euclib_parallel.hpp"
+
+/*
+ * Bounding volume hierarchy over 2D segments for ray casting
+ *
+ *   Nodes are split with the binned surface area heuristic [1], in 2D the
+ *   half perimeter of the boxes, into up to leaf_size( ) segments a leaf.
+ *   The nodes sit depth first in one array: an inner node's left child is
+ *   the next node and it stores where the right one is, so a traversal
+ *   needs only a short fixed stack. Below the top of the tree subtrees
+ *   are built in parallel and spliced in after. Past a depth of 32 splits
+ *   fall back to halving, which bounds the depth at 64.
+ *
+ *   A ray is origin + t * direction for t in [0, max_t], so a segment
+ *   from p to q is the ray from p along q - p with max_t 1. Queries can
+ *   stop at the first hit along the ray, at any hit (for visibility), or
+ *   report every hit. Segments collinear with a ray hit it where they
+ *   first overlap. Results are the index of the segment in the input.
+ *   Segments and rays may also be given as segment2 and point2, T still
+ *   being floating point.
+ *
+ *   first_hits( ) casts rays in packets of packet_size rays that walk
+ *   the tree together, a node being entered when any ray of the packet
+ *   crosses it. Neighbouring rays in the input should be close in space
+ *   and direction for this to pay off.
+ *
+ * References
+ *   [1] I. Wald. "On fast Construction of SAH-based Bounding Volume
+ *         Hierarchies". IEEE Symposium on Interactive Ray Tracing,
+ *         pp. 33-40, 2007.
+ */
+
+namespace euclib {
+
+template<typename T>
+class segment_bvh {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with floating point types
+	static_assert( std::is_floating_point<T>::value,
+	               "T must be floating point" );
+
+	static const unsigned int bins = 16;
+	static const unsigned int sah_depth = 32;
+	static const unsigned int stack_size = 96;
+
+	// count: 0 for an inner node whose right child is 'first', else the
+	//   leaf's segments start at 'first'
+	struct node {
+		T             l, r, t, b;
+		unsigned int  first;
+		unsigned int  count;
+	};
+
+	struct build_item {
+		T             l, r, t, b;
+		T             cx, cy;
+		unsigned int  index;
+	};
+
+public:
+
+	static const unsigned int npos = ~0u;
+	static const unsigned int packet_size = 8;
+
+	struct ray {
+		point<T,2>   origin;
+		vector<T,2>  direction;
+		T            max_t;
+	};
+
+	// index npos when nothing was hit
+	struct ray_hit {
+		unsigned int  index;
+		T             t;
+	};
+
+
+// Variables
+private:
+
+	unsigned int               m_leaf_size;
+	std::vector<node>          m_nodes;
+	std::vector<T>             m_coords;   // x0, y0, x1, y1 in leaf order
+	std::vector<unsigned int>  m_indices;  // input index, in leaf order
+
+
+// Constructors
+public:
+
+	segment_bvh( ) : m_leaf_size( 4 ) { }
+
+	// 'threads' as for parallel_for( ), 0 for one per core
+	segment_bvh( const std::vector<segment<T,2>>& segments, unsigned int leaf_size = 4,
+	             unsigned int threads = 0 ) {
+		build( segments, leaf_size, threads );
+	}
+
+	segment_bvh( const std::vector<segment2<T>>& segments, unsigned int leaf_size = 4,
+	             unsigned int threads = 0 ) {
+		build( segments, leaf_size, threads );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const      { return m_indices.size( ); }
+	bool empty( ) const             { return m_indices.empty( ); }
+	unsigned int nodes( ) const     { return m_nodes.size( ); }
+	unsigned int leaf_size( ) const { return m_leaf_size; }
+
+	void build( const std::vector<segment<T,2>>& segments, unsigned int leaf_size = 4,
+	            unsigned int threads = 0 ) {
+		build( segments.size( ), [&]( unsigned int i, T& x0, T& y0, T& x1, T& y1 ) {
+			const point<T,2>& p = segments[i].base_point( );
+			const vector<T,2>& v = segments[i].base_vector( );
+			x0 = p[0];
+			y0 = p[1];
+			x1 = p[0] + v[0];
+			y1 = p[1] + v[1];
+		}, leaf_size, threads );
+	}
+
+	void build( const std::vector<segment2<T>>& segments, unsigned int leaf_size = 4,
+	            unsigned int threads = 0 ) {
+		build( segments.size( ), [&]( unsigned int i, T& x0, T& y0, T& x1, T& y1 ) {
+			x0 = segments[i].pt1.x;
+			y0 = segments[i].pt1.y;
+			x1 = segments[i].pt2.x;
+			y1 = segments[i].pt2.y;
+		}, leaf_size, threads );
+	}
+
+	// any other set of segments, endpoints( i, x0, y0, x1, y1 ) giving
+	//   segment i of 'count'
+	template<typename Endpoints>
+	void build( unsigned int count, Endpoints endpoints, unsigned int leaf_size = 4,
+	            unsigned int threads = 0 ) {
+		if( threads == 0 ) { threads = default_threads( ); }
+		m_leaf_size = std::max( leaf_size, 1u );
+		m_nodes.clear( );
+		m_coords.resize( 4 * std::size_t(count) );
+		m_indices.resize( count );
+		if( count == 0 ) { return; }
+
+		std::vector<build_item> items( count );
+		parallel_for( 0, count, [&]( unsigned int i ) {
+			T x0, y0, x1, y1;
+			endpoints( i, x0, y0, x1, y1 );
+			build_item& it = items[i];
+			it.l = std::min( x0, x1 );
+			it.r = std::max( x0, x1 );
+			it.t = std::min( y0, y1 );
+			it.b = std::max( y0, y1 );
+			it.cx = ( it.l + it.r ) / 2;
+			it.cy = ( it.t + it.b ) / 2;
+			it.index = i;
+			T* out = &m_coords[4 * std::size_t(i)];
+			out[0] = x0; out[1] = y0; out[2] = x1; out[3] = y1;
+		}, threads, 4096 );
+
+		// the top of the tree, leaving ranges below 'task_size' as tasks
+		std::vector<std::pair<unsigned int, unsigned int>> tasks;
+		const unsigned int task_size = threads > 1 ?
+		    std::max( count / ( 8 * threads ), 4096u ) : count + 1;
+		std::vector<node> top;
+		subdivide( top, items, 0, count, 0, task_size, &tasks );
+
+		std::vector<std::vector<node>> subtrees( tasks.size( ) );
+		parallel_for( 0, tasks.size( ), [&]( unsigned int k ) {
+			subdivide( subtrees[k], items, tasks[k].first, tasks[k].second,
+			           task_depth( top, k ), count + 1, 0 );
+		}, threads, 1 );
+
+		m_nodes.reserve( top.size( ) + [&]( ) {
+			std::size_t n = 0;
+			for( unsigned int k = 0; k < subtrees.size( ); ++k ) { n += subtrees[k].size( ); }
+			return n;
+		}( ) );
+		splice( top, 0, subtrees );
+
+		// segments in leaf order
+		std::vector<T> coords( m_coords.size( ) );
+		parallel_for( 0, count, [&]( unsigned int i ) {
+			std::copy( &m_coords[4 * std::size_t(items[i].index)],
+			           &m_coords[4 * std::size_t(items[i].index)] + 4, &coords[4 * std::size_t(i)] );
+			m_indices[i] = items[i].index;
+		}, threads, 4096 );
+		m_coords.swap( coords );
+	}
+
+	// the closest hit along the ray, if any
+	bool first_hit( const point<T,2>& origin, const vector<T,2>& direction, T max_t,
+	                ray_hit& hit ) const {
+		hit.index = npos;
+		hit.t = max_t;
+		if( m_nodes.empty( ) ) { return false; }
+		const T ox = origin[0], oy = origin[1], dx = direction[0], dy = direction[1];
+		const T ix = T(1) / dx, iy = T(1) / dy;
+
+		unsigned int stack[stack_size];
+		unsigned int top = 0;
+		stack[top++] = 0;
+		while( top > 0 ) {
+			const unsigned int id = stack[--top];
+			const node& n = m_nodes[id];
+			T enter;
+			if( !cross_box( n, ox, oy, dx, dy, ix, iy, hit.t, enter ) ) { continue; }
+			if( n.count > 0 ) {
+				for( unsigned int s = n.first; s < n.first + n.count; ++s ) {
+					T t;
+					if( cross_segment( s, ox, oy, dx, dy, hit.t, t ) &&
+					    ( t < hit.t || hit.index == npos ) ) {
+						hit.t = t;
+						hit.index = m_indices[s];
+					}
+				}
+				continue;
+			}
+			// nearer child on top
+			T enter_left = 0, enter_right = 0;
+			bool left = cross_box( m_nodes[id + 1], ox, oy, dx, dy, ix, iy, hit.t, enter_left );
+			bool right = cross_box( m_nodes[n.first], ox, oy, dx, dy, ix, iy, hit.t, enter_right );
+			if( left && right ) {
+				if( enter_left <= enter_right ) {
+					stack[top++] = n.first;
+					stack[top++] = id + 1;
+				}
+				else {
+					stack[top++] = id + 1;
+					stack[top++] = n.first;
+				}
+			}
+			else if( left )  { stack[top++] = id + 1; }
+			else if( right ) { stack[top++] = n.first; }
+		}
+		return hit.index != npos;
+	}
+
+	// the same with the direction as a point2, the offset from the origin
+	//   at t = 1
+	bool first_hit( const point2<T>& origin, const point2<T>& direction, T max_t,
+	                ray_hit& hit ) const {
+		return first_hit( point<T,2>( origin.x, origin.y ), vector<T,2>( direction.x, direction.y ), max_t, hit );
+	}
+
+	// true when anything crosses the ray, for line of sight
+	bool any_hit( const point<T,2>& origin, const vector<T,2>& direction, T max_t ) const {
+		bool found = false;
+		all_hits( origin, direction, max_t, [&]( unsigned int, T ) {
+			found = true;
+			return false;
+		} );
+		return found;
+	}
+
+	bool any_hit( const point2<T>& origin, const point2<T>& direction, T max_t ) const {
+		return any_hit( point<T,2>( origin.x, origin.y ), vector<T,2>( direction.x, direction.y ), max_t );
+	}
+
+	// nothing lies between 'from' and 'to'
+	bool visible( const point<T,2>& from, const point<T,2>& to ) const {
+		return !any_hit( from, vector<T,2>( to[0] - from[0], to[1] - from[1] ), T(1) );
+	}
+
+	bool visible( const point2<T>& from, const point2<T>& to ) const {
+		return visible( point<T,2>( from.x, from.y ), point<T,2>( to.x, to.y ) );
+	}
+
+	// calls visit( index, t ) for every segment crossing the ray, in no
+	//   particular order, stopping early if visit returns false
+	template<typename Visitor>
+	void all_hits( const point<T,2>& origin, const vector<T,2>& direction, T max_t,
+	               Visitor visit ) const {
+		if( m_nodes.empty( ) ) { return; }
+		const T ox = origin[0], oy = origin[1], dx = direction[0], dy = direction[1];
+		const T ix = T(1) / dx, iy = T(1) / dy;
+
+		unsigned int stack[stack_size];
+		unsigned int top = 0;
+		stack[top++] = 0;
+		while( top > 0 ) {
+			const unsigned int id = stack[--top];
+			const node& n = m_nodes[id];
+			T enter;
+			if( !cross_box( n, ox, oy, dx, dy, ix, iy, max_t, enter ) ) { continue; }
+			if( n.count > 0 ) {
+				for( unsigned int s = n.first; s < n.first + n.count; ++s ) {
+					T t;
+					if( cross_segment( s, ox, oy, dx, dy, max_t, t ) && !visit( m_indices[s], t ) ) {
+						return;
+					}
+				}
+				continue;
+			}
+			stack[top++] = n.first;
+			stack[top++] = id + 1;
+		}
+	}
+
+	// every hit along the ray, nearest first
+	void all_hits( const point<T,2>& origin, const vector<T,2>& direction, T max_t,
+	               std::vector<ray_hit>& result ) const {
+		result.clear( );
+		all_hits( origin, direction, max_t, [&]( unsigned int index, T t ) {
+			ray_hit hit = { index, t };
+			result.push_back( hit );
+			return true;
+		} );
+		std::sort( result.begin( ), result.end( ), []( const ray_hit& h1, const ray_hit& h2 ) {
+			return h1.t < h2.t || ( h1.t == h2.t && h1.index < h2.index ); } );
+	}
+
+	template<typename Visitor>
+	void all_hits( const point2<T>& origin, const point2<T>& direction, T max_t,
+	               Visitor visit ) const {
+		all_hits( point<T,2>( origin.x, origin.y ), vector<T,2>( direction.x, direction.y ), max_t, visit );
+	}
+
+	void all_hits( const point2<T>& origin, const point2<T>& direction, T max_t,
+	               std::vector<ray_hit>& result ) const {
+		all_hits( point<T,2>( origin.x, origin.y ), vector<T,2>( direction.x, direction.y ), max_t, result );
+	}
+
+	// first hit of every ray, cast packet_size at a time
+	void first_hits( const std::vector<ray>& rays, std::vector<ray_hit>& hits,
+	                 unsigned int threads = 0 ) const {
+		hits.resize( rays.size( ) );
+		const unsigned int packets = ( rays.size( ) + packet_size - 1 ) / packet_size;
+		parallel_for( 0, packets, [&]( unsigned int p ) {
+			unsigned int first = p * packet_size;
+			unsigned int count = std::min<unsigned int>( packet_size, rays.size( ) - first );
+			cast_packet( &rays[first], count, &hits[first] );
+		}, threads, 16 );
+	}
+
+private:
+
+	// slab test, 'enter' is where the ray gets in
+	static bool cross_box( const node& n, T ox, T oy, T dx, T dy, T ix, T iy, T max_t, T& enter ) {
+		T t0 = 0, t1 = max_t;
+		if( dx != 0 ) {
+			T a = ( n.l - ox ) * ix, b = ( n.r - ox ) * ix;
+			if( a > b ) { std::swap( a, b ); }
+			t0 = std::max( t0, a );
+			t1 = std::min( t1, b );
+		}
+		else if( ox < n.l || ox > n.r ) { return false; }
+		if( dy != 0 ) {
+			T a = ( n.t - oy ) * iy, b = ( n.b - oy ) * iy;
+			if( a > b ) { std::swap( a, b ); }
+			t0 = std::max( t0, a );
+			t1 = std::min( t1, b );
+		}
+		else if( oy < n.t || oy > n.b ) { return false; }
+		enter = t0;
+		return t0 <= t1;
+	}
+
+	// ray against stored segment 's', 't' the parameter along the ray
+	bool cross_segment( unsigned int s, T ox, T oy, T dx, T dy, T max_t, T& t ) const {
+		const T* c = &m_coords[4 * std::size_t(s)];
+		const T ex = c[2] - c[0], ey = c[3] - c[1];
+		const T ax = c[0] - ox, ay = c[1] - oy;
+		const T denom = dx * ey - dy * ex;
+		const T along = ax * dy - ay * dx;
+		if( denom == 0 ) {
+			// parallel, a hit only when collinear
+			if( along != 0 ) { return false; }
+			const T dd = dx * dx + dy * dy;
+			if( dd == 0 ) { return false; }
+			T ta = ( ax * dx + ay * dy ) / dd;
+			T tb = ( ( c[2] - ox ) * dx + ( c[3] - oy ) * dy ) / dd;
+			if( ta > tb ) { std::swap( ta, tb ); }
+			if( tb < 0 || ta > max_t ) { return false; }
+			t = std::max( ta, T(0) );
+			return true;
+		}
+		t = ( ax * ey - ay * ex ) / denom;
+		const T u = along / denom;
+		return t >= 0 && t <= max_t && u >= 0 && u <= 1;
+	}
+
+	void cast_packet( const ray* rays, unsigned int count, ray_hit* hits ) const {
+		T ox[packet_size], oy[packet_size], dx[packet_size], dy[packet_size];
+		T ix[packet_size], iy[packet_size];
+		for( unsigned int k = 0; k < count; ++k ) {
+			ox[k] = rays[k].origin[0];
+			oy[k] = rays[k].origin[1];
+			dx[k] = rays[k].direction[0];
+			dy[k] = rays[k].direction[1];
+			ix[k] = T(1) / dx[k];
+			iy[k] = T(1) / dy[k];
+			hits[k].index = npos;
+			hits[k].t = rays[k].max_t;
+		}
+		if( m_nodes.empty( ) ) { return; }
+
+		unsigned int stack[stack_size];
+		unsigned int top = 0;
+		stack[top++] = 0;
+		while( top > 0 ) {
+			const unsigned int id = stack[--top];
+			const node& n = m_nodes[id];
+			unsigned int active = 0;
+			for( unsigned int k = 0; k < count; ++k ) {
+				T enter;
+				if( cross_box( n, ox[k], oy[k], dx[k], dy[k], ix[k], iy[k], hits[k].t, enter ) ) {
+					active |= 1u << k;
+				}
+			}
+			if( active == 0 ) { continue; }
+			if( n.count == 0 ) {
+				stack[top++] = n.first;
+				stack[top++] = id + 1;
+				continue;
+			}
+			for( unsigned int k = 0; k < count; ++k ) {
+				if( !( active & ( 1u << k ) ) ) { continue; }
+				for( unsigned int s = n.first; s < n.first + n.count; ++s ) {
+					T t;
+					if( cross_segment( s, ox[k], oy[k], dx[k], dy[k], hits[k].t, t ) &&
+					    ( t < hits[k].t || hits[k].index == npos ) ) {
+						hits[k].t = t;
+						hits[k].index = m_indices[s];
+					}
+				}
+			}
+		}
+	}
+
+	// building
+
+	static T half_perimeter( T l, T r, T t, T b ) {
+		return ( r - l ) + ( b - t );
+	}
+
+	// depth in 'top' of the placeholder for task 'k'
+	static unsigned int task_depth( const std::vector<node>& top, unsigned int k ) {
+		unsigned int depth = 0;
+		std::vector<std::pair<unsigned int, unsigned int>> stack( 1, std::make_pair( 0u, 0u ) );
+		while( !stack.empty( ) ) {
+			std::pair<unsigned int, unsigned int> at = stack.back( );
+			stack.pop_back( );
+			const node& n = top[at.first];
+			if( n.count == npos ) {
+				if( n.first == k ) { depth = at.second; break; }
+			}
+			else if( n.count == 0 ) {
+				stack.push_back( std::make_pair( n.first, at.second + 1 ) );
+				stack.push_back( std::make_pair( at.first + 1, at.second + 1 ) );
+			}
+		}
+		return depth;
+	}
+
+	// builds [begin, end) of 'items' depth first into 'out'. Ranges smaller
+	//   than 'task_size' become placeholders (count npos, first the task
+	//   number) listed in 'tasks'.
+	void subdivide( std::vector<node>& out, std::vector<build_item>& items,
+	                unsigned int begin, unsigned int end, unsigned int depth,
+	                unsigned int task_size, std::vector<std::pair<unsigned int, unsigned int>>* tasks ) const {
+		const unsigned int at = out.size( );
+		out.push_back( node( ) );
+		if( tasks && end - begin < task_size ) {
+			out[at].count = npos;
+			out[at].first = tasks->size( );
+			tasks->push_back( std::make_pair( begin, end ) );
+			return;
+		}
+
+		node n;
+		n.l = n.t = limit_t::max( );
+		n.r = n.b = -limit_t::max( );
+		T cl = limit_t::max( ), ct = cl, cr = -cl, cb = -cl;
+		for( unsigned int i = begin; i < end; ++i ) {
+			const build_item& it = items[i];
+			n.l = std::min( n.l, it.l ); n.r = std::max( n.r, it.r );
+			n.t = std::min( n.t, it.t ); n.b = std::max( n.b, it.b );
+			cl = std::min( cl, it.cx ); cr = std::max( cr, it.cx );
+			ct = std::min( ct, it.cy ); cb = std::max( cb, it.cy );
+		}
+		const unsigned int count = end - begin;
+		n.first = begin;
+		n.count = count;
+		out[at] = n;
+		if( count <= 1 ) { return; }
+
+		const int axis = ( cr - cl ) >= ( cb - ct ) ? 0 : 1;
+		const T lo = axis == 0 ? cl : ct;
+		const T extent = axis == 0 ? cr - cl : cb - ct;
+		unsigned int mid = begin;
+
+		if( extent > 0 && depth < sah_depth ) {
+			// binned SAH
+			struct bin {
+				T             l, r, t, b;
+				unsigned int  count;
+			};
+			bin bin_of[bins];
+			for( unsigned int k = 0; k < bins; ++k ) {
+				bin_of[k].l = bin_of[k].t = limit_t::max( );
+				bin_of[k].r = bin_of[k].b = -limit_t::max( );
+				bin_of[k].count = 0;
+			}
+			const T scale = T(bins) * ( 1 - limit_t::epsilon( ) ) / extent;
+			for( unsigned int i = begin; i < end; ++i ) {
+				const build_item& it = items[i];
+				unsigned int k = std::min( bins - 1, (unsigned int)( ( ( axis == 0 ? it.cx : it.cy ) - lo ) * scale ) );
+				bin& b = bin_of[k];
+				b.l = std::min( b.l, it.l ); b.r = std::max( b.r, it.r );
+				b.t = std::min( b.t, it.t ); b.b = std::max( b.b, it.b );
+				++b.count;
+			}
+
+			// cost of the left side of every cut, then sweep from the right
+			T left_cost[bins];
+			bin acc = bin_of[0];
+			left_cost[0] = half_perimeter( acc.l, acc.r, acc.t, acc.b ) * acc.count;
+			for( unsigned int k = 1; k + 1 < bins; ++k ) {
+				const bin& b = bin_of[k];
+				acc.l = std::min( acc.l, b.l ); acc.r = std::max( acc.r, b.r );
+				acc.t = std::min( acc.t, b.t ); acc.b = std::max( acc.b, b.b );
+				acc.count += b.count;
+				left_cost[k] = acc.count ? half_perimeter( acc.l, acc.r, acc.t, acc.b ) * acc.count : T(0);
+			}
+			T best = limit_t::max( );
+			unsigned int best_cut = 0;
+			acc = bin_of[bins - 1];
+			for( unsigned int k = bins - 1; k > 0; --k ) {
+				if( k < bins - 1 ) {
+					const bin& b = bin_of[k];
+					acc.l = std::min( acc.l, b.l ); acc.r = std::max( acc.r, b.r );
+					acc.t = std::min( acc.t, b.t ); acc.b = std::max( acc.b, b.b );
+					acc.count += b.count;
+				}
+				T cost = left_cost[k - 1] +
+				         ( acc.count ? half_perimeter( acc.l, acc.r, acc.t, acc.b ) * acc.count : T(0) );
+				if( cost < best ) {
+					best = cost;
+					best_cut = k;
+				}
+			}
+
+			// a leaf is cheaper, traversing a node costing about one test
+			const T leaf_cost = half_perimeter( n.l, n.r, n.t, n.b ) * count;
+			if( count <= m_leaf_size && leaf_cost <= best + half_perimeter( n.l, n.r, n.t, n.b ) ) {
+				return;
+			}
+
+			build_item* split = std::partition( &items[0] + begin, &items[0] + end,
+			    [&]( const build_item& it ) {
+			        unsigned int k = std::min( bins - 1, (unsigned int)( ( ( axis == 0 ? it.cx : it.cy ) - lo ) * scale ) );
+			        return k < best_cut;
+			    } );
+			mid = split - &items[0];
+		}
+		else if( count <= m_leaf_size ) {
+			return;
+		}
+
+		// no useful cut, halve
+		if( mid == begin || mid == end ) {
+			mid = begin + count / 2;
+			std::nth_element( &items[0] + begin, &items[0] + mid, &items[0] + end,
+			    [axis]( const build_item& i1, const build_item& i2 ) {
+			        return axis == 0 ? i1.cx < i2.cx : i1.cy < i2.cy; } );
+		}
+
+		out[at].count = 0;
+		subdivide( out, items, begin, mid, depth + 1, task_size, tasks );
+		out[at].first = out.size( );
+		subdivide( out, items, mid, end, depth + 1, task_size, tasks );
+	}
+
+	// copies 'src' from node 'i' into m_nodes, replacing placeholders with
+	//   their subtree
+	void splice( const std::vector<node>& src, unsigned int i,
+	             const std::vector<std::vector<node>>& subtrees ) {
+		const node& n = src[i];
+		if( n.count == npos ) {
+			splice( subtrees[n.first], 0, subtrees );
+			return;
+		}
+		const unsigned int at = m_nodes.size( );
+		m_nodes.push_back( n );
+		if( n.count == 0 ) {
+			splice( src, i + 1, subtrees );
+			m_nodes[at].first = m_nodes.size( );
+			splice( src, n.first, subtrees );
+		}
+	}
+}; // End class segment_bvh
+
+template<typename T>
+const unsigned int segment_bvh<T>::npos;
+
+template<typename T>
+const unsigned int segment_bvh<T>::packet_size;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SEGMENT_BVH_HPP
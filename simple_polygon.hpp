@@ -0,0 +1,668 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SIMPLE_POLYGON_HPP
+#define EUBLIB_SIMPLE_POLYGON_HPP
+
+#include <ostream>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <set>
+#include <utility>
+#include "euclib_math.hpp"
+#include "point.hpp"
+#include "rect.hpp"
+
+namespace euclib {
+
+namespace detail {
+
+/*
+ * Sweep line triangulation through monotone pieces
+ *
+ *   A top to bottom sweep classifies every vertex (start, end, split, merge
+ *   or regular) and adds diagonals that remove the split and merge vertices,
+ *   leaving y-monotone pieces.  Each piece is then triangulated in linear
+ *   time with a stack, for O(n log n) overall.  Ties in y are broken by x so
+ *   horizontal edges need no special casing.  The input must be simple,
+ *   consecutive duplicate points are skipped.
+ *
+ * References
+ *   [1] M. de Berg, O. Cheong, M. van Kreveld, M. Overmars. Computational
+ *         Geometry: Algorithms and Applications, 3rd ed. Berlin: Springer,
+ *         2008, pp. 45-61.
+ */
+
+class monotone_triangulator {
+// Typedefs
+private:
+
+	enum vertex_type { start_vertex, end_vertex, split_vertex, merge_vertex, regular_vertex };
+
+	struct vertex {
+		double       x, y;
+		unsigned int index;  // index in the input ring
+	};
+
+	// orders edges in the sweep status by their x at the sweep line
+	struct edge_less {
+		const monotone_triangulator* self;
+
+		edge_less( const monotone_triangulator* owner ) : self( owner ) { }
+
+		bool operator () ( unsigned int a, unsigned int b ) const {
+			if( a == b ) { return false; }
+			double xa = ( a == self->probe( ) ? self->m_sweep_x : self->x_at( a ) );
+			double xb = ( b == self->probe( ) ? self->m_sweep_x : self->x_at( b ) );
+			if( xa != xb ) { return xa < xb; }
+			if( a == self->probe( ) || b == self->probe( ) ) { return false; }
+			// sharing a point on the sweep line, compare just below it
+			double c = self->cross_down( a, b );
+			if( c != 0.0 ) { return c > 0.0; }
+			return a < b;
+		}
+	};
+
+	typedef std::set<unsigned int, edge_less> status_t;
+
+
+// Constructors
+public:
+
+	monotone_triangulator( ) : m_status( edge_less( this ) ), m_sweep_x( 0 ), m_sweep_y( 0 ) { }
+
+private:
+
+	// the status comparator points back at this object
+	monotone_triangulator( const monotone_triangulator& );
+	monotone_triangulator& operator = ( const monotone_triangulator& );
+
+
+// Methods
+public:
+
+	// appends index triples (counter-clockwise) for the ring to 'triangles'
+	template<typename Ring>
+	void triangulate( const Ring& ring, std::vector<unsigned int>& triangles ) {
+		load( ring );
+		const unsigned int n = m_verts.size( );
+		if( n < 3 ) { return; }
+		triangles.reserve( triangles.size( ) + 3 * ( n - 2 ) );
+		if( n == 3 ) {
+			emit( 0, 1, 2, triangles );
+			return;
+		}
+
+		make_monotone( );
+		split_faces( triangles );
+	}
+
+
+private:
+
+	// copies the ring counter-clockwise without repeated points
+	template<typename Ring>
+	void load( const Ring& ring ) {
+		m_verts.clear( );
+		for( unsigned int k = 0; k < ring.size( ); ++k ) {
+			vertex v = { double(ring[k].x), double(ring[k].y), k };
+			if( m_verts.empty( ) || m_verts.back( ).x != v.x || m_verts.back( ).y != v.y ) {
+				m_verts.push_back( v );
+			}
+		}
+		while( m_verts.size( ) > 1 && m_verts.front( ).x == m_verts.back( ).x &&
+		       m_verts.front( ).y == m_verts.back( ).y ) {
+			m_verts.pop_back( );
+		}
+
+		double sum = 0.0;
+		for( unsigned int k = 0, j = m_verts.size( ) - 1; k < m_verts.size( ); j = k++ ) {
+			sum += m_verts[j].x * m_verts[k].y - m_verts[k].x * m_verts[j].y;
+		}
+		if( sum < 0.0 ) { std::reverse( m_verts.begin( ), m_verts.end( ) ); }
+	}
+
+	unsigned int next( unsigned int i ) const { return i + 1 == m_verts.size( ) ? 0 : i + 1; }
+	unsigned int prev( unsigned int i ) const { return i == 0 ? m_verts.size( ) - 1 : i - 1; }
+
+	// sweep order, top to bottom then left to right
+	bool above( unsigned int a, unsigned int b ) const {
+		return m_verts[a].y > m_verts[b].y ||
+		       ( m_verts[a].y == m_verts[b].y && m_verts[a].x < m_verts[b].x );
+	}
+
+	static double cross( const vertex& o, const vertex& a, const vertex& b ) {
+		return ( a.x - o.x ) * ( b.y - o.y ) - ( a.y - o.y ) * ( b.x - o.x );
+	}
+
+	vertex_type classify( unsigned int i ) const {
+		unsigned int p = prev( i ), n = next( i );
+		bool convex = cross( m_verts[p], m_verts[i], m_verts[n] ) > 0.0;
+		if( above( i, p ) && above( i, n ) ) {
+			return convex ? start_vertex : split_vertex;
+		}
+		if( above( p, i ) && above( n, i ) ) {
+			return convex ? end_vertex : merge_vertex;
+		}
+		return regular_vertex;
+	}
+
+	// x of edge e (from vertex e to its successor) on the sweep line
+	double x_at( unsigned int e ) const {
+		const vertex& a = m_verts[e];
+		const vertex& b = m_verts[next( e )];
+		if( a.y == b.y ) { return m_sweep_x; }
+		return a.x + ( m_sweep_y - a.y ) * ( b.x - a.x ) / ( b.y - a.y );
+	}
+
+	// positive when edge a runs left of edge b below the sweep line
+	double cross_down( unsigned int a, unsigned int b ) const {
+		const vertex* a0 = &m_verts[a];
+		const vertex* a1 = &m_verts[next( a )];
+		const vertex* b0 = &m_verts[b];
+		const vertex* b1 = &m_verts[next( b )];
+		if( above( next( a ), a ) ) { std::swap( a0, a1 ); }
+		if( above( next( b ), b ) ) { std::swap( b0, b1 ); }
+		double ax = a1->x - a0->x, ay = a1->y - a0->y;
+		double bx = b1->x - b0->x, by = b1->y - b0->y;
+		return ax * by - ay * bx;
+	}
+
+	// edge of the status directly left of vertex v, searched with a
+	//   probe id that the comparator reads as the sweep point itself
+	unsigned int left_of( unsigned int v ) {
+		(void)v;
+		status_t::iterator itr = m_status.upper_bound( probe( ) );
+		if( itr == m_status.begin( ) ) { return none; }
+		return *(--itr);
+	}
+
+	unsigned int probe( ) const { return m_verts.size( ); }
+
+	void make_monotone( ) {
+		const unsigned int n = m_verts.size( );
+
+		m_order.resize( n );
+		for( unsigned int k = 0; k < n; ++k ) { m_order[k] = k; }
+		std::sort( m_order.begin( ), m_order.end( ),
+			[this]( unsigned int a, unsigned int b ) { return above( a, b ); } );
+
+		m_status.clear( );
+		m_where.assign( n, m_status.end( ) );
+		m_helper.assign( n, static_cast<unsigned int>( none ) );
+		m_type.resize( n );
+		for( unsigned int k = 0; k < n; ++k ) { m_type[k] = classify( k ); }
+		m_diagonals.clear( );
+
+		for( unsigned int k = 0; k < n; ++k ) {
+			unsigned int v = m_order[k];
+			unsigned int p = prev( v );
+			m_sweep_x = m_verts[v].x;
+			m_sweep_y = m_verts[v].y;
+
+			switch( m_type[v] ) {
+				case start_vertex:
+					insert_edge( v );
+					break;
+
+				case end_vertex:
+					fix_up( v, p );
+					erase_edge( p );
+					break;
+
+				case split_vertex: {
+					unsigned int e = left_of( v );
+					if( e != none ) {
+						m_diagonals.push_back( std::make_pair( v, m_helper[e] ) );
+						m_helper[e] = v;
+					}
+					insert_edge( v );
+					break;
+				}
+
+				case merge_vertex: {
+					fix_up( v, p );
+					erase_edge( p );
+					unsigned int e = left_of( v );
+					if( e != none ) {
+						fix_up( v, e );
+						m_helper[e] = v;
+					}
+					break;
+				}
+
+				case regular_vertex:
+					// interior to the right, the boundary is heading down
+					if( above( p, v ) ) {
+						fix_up( v, p );
+						erase_edge( p );
+						insert_edge( v );
+					}
+					else {
+						unsigned int e = left_of( v );
+						if( e != none ) {
+							fix_up( v, e );
+							m_helper[e] = v;
+						}
+					}
+					break;
+			}
+		}
+	}
+
+	// connects v to the helper of e if that helper was a merge vertex
+	void fix_up( unsigned int v, unsigned int e ) {
+		unsigned int h = m_helper[e];
+		if( h != none && m_type[h] == merge_vertex ) {
+			m_diagonals.push_back( std::make_pair( v, h ) );
+		}
+	}
+
+	void insert_edge( unsigned int e ) {
+		m_where[e] = m_status.insert( e ).first;
+		m_helper[e] = e;
+	}
+
+	void erase_edge( unsigned int e ) {
+		if( m_where[e] != m_status.end( ) ) {
+			m_status.erase( m_where[e] );
+			m_where[e] = m_status.end( );
+		}
+	}
+
+	// walks the faces left by the diagonals, each one is monotone
+	void split_faces( std::vector<unsigned int>& triangles ) {
+		const unsigned int n = m_verts.size( );
+
+		// adjacency of every vertex, sorted counter-clockwise by angle
+		m_adj_start.assign( n + 1, 0 );
+		for( unsigned int k = 0; k < n; ++k ) { m_adj_start[k + 1] += 2; }
+		for( unsigned int d = 0; d < m_diagonals.size( ); ++d ) {
+			++m_adj_start[m_diagonals[d].first + 1];
+			++m_adj_start[m_diagonals[d].second + 1];
+		}
+		for( unsigned int k = 0; k < n; ++k ) { m_adj_start[k + 1] += m_adj_start[k]; }
+
+		m_adj.resize( m_adj_start[n] );
+		m_fill.assign( m_adj_start.begin( ), m_adj_start.end( ) - 1 );
+		for( unsigned int k = 0; k < n; ++k ) {
+			m_adj[m_fill[k]++] = next( k );
+			m_adj[m_fill[k]++] = prev( k );
+		}
+		for( unsigned int d = 0; d < m_diagonals.size( ); ++d ) {
+			unsigned int a = m_diagonals[d].first, b = m_diagonals[d].second;
+			m_adj[m_fill[a]++] = b;
+			m_adj[m_fill[b]++] = a;
+		}
+		for( unsigned int k = 0; k < n; ++k ) {
+			const vertex& o = m_verts[k];
+			const std::vector<vertex>& verts = m_verts;
+			std::sort( m_adj.begin( ) + m_adj_start[k], m_adj.begin( ) + m_adj_start[k + 1],
+				[&o, &verts]( unsigned int a, unsigned int b ) {
+					return std::atan2( verts[a].y - o.y, verts[a].x - o.x ) <
+					       std::atan2( verts[b].y - o.y, verts[b].x - o.x );
+				} );
+		}
+
+		// the half edge from k to m_adj[s] is used once s is set, the
+		//   reversed boundary edges belong to the outside
+		m_used.assign( m_adj.size( ), false );
+		for( unsigned int k = 0; k < n; ++k ) {
+			for( unsigned int s = m_adj_start[k]; s < m_adj_start[k + 1]; ++s ) {
+				if( m_adj[s] == prev( k ) && m_adj[s] != next( k ) ) { m_used[s] = true; }
+			}
+		}
+
+		for( unsigned int k = 0; k < n; ++k ) {
+			for( unsigned int s = m_adj_start[k]; s < m_adj_start[k + 1]; ++s ) {
+				if( m_used[s] ) { continue; }
+
+				// trace one face keeping it on the left
+				m_face.clear( );
+				unsigned int from = k, slot = s;
+				do {
+					m_used[slot] = true;
+					m_face.push_back( from );
+					unsigned int to = m_adj[slot];
+					// at 'to', take the edge just clockwise of the way back
+					unsigned int first = m_adj_start[to], last = m_adj_start[to + 1];
+					unsigned int back = first;
+					while( m_adj[back] != from ) { ++back; }
+					slot = ( back == first ? last : back ) - 1;
+					from = to;
+				} while( !m_used[slot] );
+
+				triangulate_monotone( triangles );
+			}
+		}
+	}
+
+	// stack based triangulation of the y-monotone face in m_face
+	void triangulate_monotone( std::vector<unsigned int>& triangles ) {
+		const unsigned int k = m_face.size( );
+		if( k < 3 ) { return; }
+		if( k == 3 ) {
+			emit( m_face[0], m_face[1], m_face[2], triangles );
+			return;
+		}
+
+		// the face is counter-clockwise, from the top the left chain
+		//   runs forward and the right chain backward to the bottom
+		unsigned int top = 0, bottom = 0;
+		for( unsigned int j = 1; j < k; ++j ) {
+			if( above( m_face[j], m_face[top] ) ) { top = j; }
+			if( above( m_face[bottom], m_face[j] ) ) { bottom = j; }
+		}
+
+		m_sorted.clear( );
+		m_sorted.push_back( std::make_pair( m_face[top], true ) );
+		unsigned int l = ( top + 1 ) % k, r = ( top + k - 1 ) % k;
+		while( l != bottom || r != bottom ) {
+			if( r == bottom || ( l != bottom && above( m_face[l], m_face[r] ) ) ) {
+				m_sorted.push_back( std::make_pair( m_face[l], true ) );
+				l = ( l + 1 ) % k;
+			}
+			else {
+				m_sorted.push_back( std::make_pair( m_face[r], false ) );
+				r = ( r + k - 1 ) % k;
+			}
+		}
+		m_sorted.push_back( std::make_pair( m_face[bottom], false ) );
+
+		m_stack.clear( );
+		m_stack.push_back( m_sorted[0] );
+		m_stack.push_back( m_sorted[1] );
+		for( unsigned int j = 2; j + 1 < m_sorted.size( ); ++j ) {
+			const std::pair<unsigned int, bool>& u = m_sorted[j];
+			if( u.second != m_stack.back( ).second ) {
+				// opposite chains, fan to everything on the stack
+				for( unsigned int s = m_stack.size( ) - 1; s > 0; --s ) {
+					emit( u.first, m_stack[s].first, m_stack[s - 1].first, triangles );
+				}
+				std::pair<unsigned int, bool> last = m_stack.back( );
+				m_stack.clear( );
+				m_stack.push_back( last );
+				m_stack.push_back( u );
+			}
+			else {
+				// same chain, cut off while the diagonal stays inside
+				std::pair<unsigned int, bool> last = m_stack.back( );
+				m_stack.pop_back( );
+				while( !m_stack.empty( ) ) {
+					double c = cross( m_verts[m_stack.back( ).first], m_verts[last.first],
+					                  m_verts[u.first] );
+					bool inside = u.second ? c > 0.0 : c < 0.0;
+					if( !inside ) { break; }
+					emit( u.first, last.first, m_stack.back( ).first, triangles );
+					last = m_stack.back( );
+					m_stack.pop_back( );
+				}
+				m_stack.push_back( last );
+				m_stack.push_back( u );
+			}
+		}
+
+		// the bottom vertex sees the rest of the stack
+		unsigned int u = m_sorted.back( ).first;
+		for( unsigned int s = m_stack.size( ) - 1; s > 0; --s ) {
+			emit( u, m_stack[s].first, m_stack[s - 1].first, triangles );
+		}
+	}
+
+	// writes a triangle counter-clockwise in input indices
+	void emit( unsigned int a, unsigned int b, unsigned int c, std::vector<unsigned int>& triangles ) const {
+		if( cross( m_verts[a], m_verts[b], m_verts[c] ) < 0.0 ) { std::swap( b, c ); }
+		triangles.push_back( m_verts[a].index );
+		triangles.push_back( m_verts[b].index );
+		triangles.push_back( m_verts[c].index );
+	}
+
+
+// Variables
+private:
+
+	static const unsigned int none = static_cast<unsigned int>( -1 );
+
+	std::vector<vertex>        m_verts;
+	std::vector<unsigned int>  m_order;      // sweep order
+	std::vector<vertex_type>   m_type;
+	std::vector<unsigned int>  m_helper;     // helper of each status edge
+
+	status_t                                  m_status;
+	std::vector<status_t::iterator>           m_where;      // status slot of each edge
+	std::vector<std::pair<unsigned int, unsigned int>>  m_diagonals;
+	double                                    m_sweep_x;
+	double                                    m_sweep_y;
+
+	std::vector<unsigned int>  m_adj_start;  // face walk adjacency
+	std::vector<unsigned int>  m_adj;
+	std::vector<unsigned int>  m_fill;
+	std::vector<bool>          m_used;
+	std::vector<unsigned int>  m_face;
+
+	std::vector<std::pair<unsigned int, bool>>  m_sorted;  // (vertex, on left chain)
+	std::vector<std::pair<unsigned int, bool>>  m_stack;
+
+}; // End class monotone_triangulator
+
+} // End namespace detail
+
+
+template<typename T>
+class simple_polygon2 {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+// Variables
+private:
+
+	std::vector<point2<T>>  m_points;  // boundary in the order given
+	rect2<T>                m_bounding_box;
+
+
+// Constructors
+public:
+
+	simple_polygon2( ) { set_null( ); }
+	simple_polygon2( const simple_polygon2<T>& poly ) { *this = poly; }
+	simple_polygon2( simple_polygon2<T>&& poly ) { *this = std::move( poly ); }
+	simple_polygon2( const std::vector<point2<T>>& points ) {
+		m_points.reserve( points.size( ) );
+		for( auto itr = points.begin( ); itr != points.end( ); ++itr ) {
+			if( *itr != point2<T>::null( ) ) {
+				m_points.push_back( *itr );
+			}
+		}
+		check_valid( );
+	}
+
+	template<typename... Points>
+	simple_polygon2( const point2<T>& point, const Points&... points ) {
+		m_points.reserve( sizeof...(points) + 1 );
+		add_points( point, points... );
+	}
+
+
+// Methods
+public:
+
+	// Returns a null polygon, defined as having a null bounding box
+	static simple_polygon2<T> null( ) {
+		static simple_polygon2<T> null = simple_polygon2<T>( );
+		return null;
+	}
+
+	T width( ) const  { return m_bounding_box.width( ); }
+	T height( ) const { return m_bounding_box.height( ); }
+
+	// shoelace formula, positive when counter-clockwise
+	float signed_area( ) const {
+		double sum = 0.0;
+		for( unsigned int i = 0, j = m_points.size( ) - 1; i < m_points.size( ); j = i++ ) {
+			sum += double(m_points[j].x) * double(m_points[i].y) -
+			       double(m_points[i].x) * double(m_points[j].y);
+		}
+		return static_cast<float>( sum / 2.0 );
+	}
+	float area( ) const { return std::abs( signed_area( ) ); }
+
+	float perimeter( ) const {
+		double perim = 0.0;
+		for( unsigned int i = 0, j = m_points.size( ) - 1; i < m_points.size( ); j = i++ ) {
+			double dx = double(m_points[i].x) - double(m_points[j].x);
+			double dy = double(m_points[i].y) - double(m_points[j].y);
+			perim += std::sqrt( dx*dx + dy*dy );
+		}
+		return static_cast<float>( perim );
+	}
+
+	rect2<T> bounding_box( ) const { return m_bounding_box; }
+	unsigned int size( ) const { return m_points.size( ); }
+	const std::vector<point2<T>>& points( ) const { return m_points; }
+
+	// appends index triples into this polygon, counter-clockwise
+	//   regardless of the winding of the input, n-2 triangles for n
+	//   points of a simple polygon
+	void triangulate( std::vector<unsigned int>& triangles ) const {
+		detail::monotone_triangulator sweep;
+		sweep.triangulate( m_points, triangles );
+	}
+
+	// reuses 'sweep' to avoid reallocating between polygons
+	void triangulate( std::vector<unsigned int>& triangles,
+	                  detail::monotone_triangulator& sweep ) const {
+		sweep.triangulate( m_points, triangles );
+	}
+
+	template<typename... Points>
+	void add_points( const point2<T>& point, const Points&... points ) {
+		if( point != point2<T>::null( ) ) {
+			m_points.push_back( point );
+		}
+		add_points( points... );
+	}
+
+	point2<T> operator [] ( int index ) const {
+		return m_points.at( index );
+	}
+
+private:
+
+	void add_points( ) {
+		check_valid( );
+	}
+
+	void calc_bounding_box( ) {
+		auto itr = m_points.begin( );
+		T l = itr->x;
+		T r = itr->x;
+		T t = itr->y;
+		T b = itr->y;
+		for( ++itr; itr != m_points.end( ); ++itr ) {
+			l = std::min( l, itr->x );
+			r = std::max( r, itr->x );
+			t = std::min( t, itr->y );
+			b = std::max( b, itr->y );
+		}
+
+		m_bounding_box = rect2<T>( l, r, t, b );
+	}
+
+	void check_valid( ) {
+		// drop the closing point if the ring was given closed
+		if( m_points.size( ) > 1 && m_points.front( ) == m_points.back( ) ) {
+			m_points.pop_back( );
+		}
+		if( m_points.size( ) < 3 ) {
+			set_null( );
+		}
+		else {
+			calc_bounding_box( );
+		}
+	}
+
+	void set_null( ) {
+		m_bounding_box = rect2<T>::null( );
+	}
+
+
+// Operators
+public:
+
+	bool operator == ( const simple_polygon2<T>& poly ) const {
+		if( m_bounding_box != poly.m_bounding_box ) { return false; }
+		else if( m_bounding_box == rect2<T>::null( ) ) { return true; }
+		else if( m_points.size( ) != poly.m_points.size( ) ) { return false; }
+		// order matters, the same ring started elsewhere is not equal
+		for( unsigned int i = 0; i < m_points.size( ); ++i ) {
+			if( m_points[i] != poly.m_points[i] ) { return false; }
+		}
+		return true;
+	}
+
+	bool operator != ( const simple_polygon2<T>& poly ) const {
+		return !(*this == poly);
+	}
+
+	simple_polygon2<T>& operator = ( const simple_polygon2<T>& poly ) {
+		m_bounding_box = poly.m_bounding_box;
+		m_points = poly.m_points;
+		return *this;
+	}
+
+	simple_polygon2<T>& operator = ( simple_polygon2<T>&& poly ) {
+		std::swap( m_bounding_box, poly.m_bounding_box );
+		std::swap( m_points, poly.m_points );
+		return *this;
+	}
+
+	friend std::ostream& operator << ( std::ostream& stream, const simple_polygon2<T>& poly ) {
+		#ifdef GNUPLOT
+			for( unsigned int i = 0; i < poly.m_points.size( ); ++i ) {
+				stream << poly.m_points[i];
+			}
+			stream << poly.m_points[0];
+			return stream << "e\n";
+		#else
+			stream << "Simple Polygon: size = " << poly.m_points.size( ) << "\n  ";
+			for( unsigned int i = 0; i < poly.m_points.size( ); ++i ) {
+				stream << ( i != 0 ? "->" : "" ) << poly.m_points[i];
+			}
+			return stream;
+		#endif
+	}
+
+}; // End class simple_polygon2<T>
+
+typedef simple_polygon2<int>     simple_polygon2i;
+typedef simple_polygon2<float>   simple_polygon2f;
+typedef simple_polygon2<double>  simple_polygon2d;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SIMPLE_POLYGON_HPP
@@ -0,0 +1,707 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SIMPLIFY_HPP
+#define EUBLIB_SIMPLIFY_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include "euclib_math.hpp"
+#include "point.hpp"
+#include "polygon.hpp"
+#include "simple_polygon.hpp"
+
+/*
+ * Polyline and polygon simplification
+ *
+ *   douglas_peucker( ) keeps the vertex farthest from each chord while it is
+ *   more than 'tolerance' away, using an explicit stack so million point
+ *   lines do not recurse.  visvalingam( ) repeatedly drops the vertex whose
+ *   triangle with its neighbours has the smallest area, driven by a heap,
+ *   until every triangle left is at least 'min_area'.
+ *
+ *   Both write the indices of the kept vertices in order.  With
+ *   'preserve_topology' set the result does not introduce self
+ *   intersections: Douglas-Peucker re-splits any chord that crosses another
+ *   until none do, unless the stretches of line the two chords replace
+ *   already touch, and Visvalingam refuses to drop a vertex while another
+ *   vertex lies inside its triangle.  Either check only adds work when it
+ *   has something to fix, crossings already in the input are kept as they
+ *   are.
+ *
+ * References
+ *   [1] D.H. Douglas, T.K. Peucker. "Algorithms for the reduction of the
+ *         number of points required to represent a digitized line or its
+ *         caricature". Cartographica, vol. 10, no. 2, pp. 112-122, 1973.
+ *   [2] M. Visvalingam, J.D. Whyatt. "Line generalisation by repeated
+ *         elimination of points". The Cartographic Journal, vol. 30, no. 1,
+ *         pp. 46-51, 1993.
+ */
+
+namespace euclib {
+
+namespace detail {
+
+	// squared distance from pt to the segment pt0 -> pt1
+	template<typename T> inline
+	double segment_dist_sq( const point2<T>& pt, const point2<T>& pt0, const point2<T>& pt1 ) {
+		double dx = double(pt1.x) - double(pt0.x);
+		double dy = double(pt1.y) - double(pt0.y);
+		double px = double(pt.x) - double(pt0.x);
+		double py = double(pt.y) - double(pt0.y);
+		double len_sq = dx*dx + dy*dy;
+		if( len_sq > 0.0 ) {
+			double t = ( px*dx + py*dy ) / len_sq;
+			if( t > 1.0 ) {
+				px -= dx;
+				py -= dy;
+			}
+			else if( t > 0.0 ) {
+				px -= t * dx;
+				py -= t * dy;
+			}
+		}
+		return px*px + py*py;
+	}
+
+	template<typename T> inline
+	double turn( const point2<T>& pt0, const point2<T>& pt1, const point2<T>& pt2 ) {
+		return ( double(pt1.x) - double(pt0.x) ) * ( double(pt2.y) - double(pt0.y) ) -
+		       ( double(pt1.y) - double(pt0.y) ) * ( double(pt2.x) - double(pt0.x) );
+	}
+
+	// do the closed segments a0-a1 and b0-b1 share any point
+	template<typename T>
+	bool segments_touch( const point2<T>& a0, const point2<T>& a1,
+	                     const point2<T>& b0, const point2<T>& b1 ) {
+		double d1 = turn( b0, b1, a0 ), d2 = turn( b0, b1, a1 );
+		double d3 = turn( a0, a1, b0 ), d4 = turn( a0, a1, b1 );
+		if( ( ( d1 > 0.0 && d2 < 0.0 ) || ( d1 < 0.0 && d2 > 0.0 ) ) &&
+		    ( ( d3 > 0.0 && d4 < 0.0 ) || ( d3 < 0.0 && d4 > 0.0 ) ) ) {
+			return true;
+		}
+		// collinear touching cases
+		struct within {
+			static bool test( const point2<T>& p, const point2<T>& q, const point2<T>& r ) {
+				return std::min( p.x, q.x ) <= r.x && r.x <= std::max( p.x, q.x ) &&
+				       std::min( p.y, q.y ) <= r.y && r.y <= std::max( p.y, q.y );
+			}
+		};
+		return ( d1 == 0.0 && within::test( b0, b1, a0 ) ) ||
+		       ( d2 == 0.0 && within::test( b0, b1, a1 ) ) ||
+		       ( d3 == 0.0 && within::test( a0, a1, b0 ) ) ||
+		       ( d4 == 0.0 && within::test( a0, a1, b1 ) );
+	}
+
+	// do segments [i0, i1) and [j0, j1) of 'line' touch, segment k runs
+	//   from vertex k to the next one around
+	template<typename T>
+	bool spans_touch( const std::vector<point2<T>>& line, unsigned int i0, unsigned int i1,
+	                  unsigned int j0, unsigned int j1 ) {
+		const unsigned int n = line.size( );
+		std::vector<std::pair<double, unsigned int>> order;
+		order.reserve( ( i1 - i0 ) + ( j1 - j0 ) );
+		for( unsigned int k = i0; k < i1; ++k ) {
+			order.push_back( std::make_pair( double( std::min( line[k].x, line[k + 1 == n ? 0 : k + 1].x ) ), k ) );
+		}
+		for( unsigned int k = j0; k < j1; ++k ) {
+			order.push_back( std::make_pair( double( std::min( line[k].x, line[k + 1 == n ? 0 : k + 1].x ) ), k ) );
+		}
+		std::sort( order.begin( ), order.end( ) );
+
+		for( unsigned int i = 0; i < order.size( ); ++i ) {
+			const unsigned int a = order[i].second;
+			const point2<T>& a0 = line[a];
+			const point2<T>& a1 = line[a + 1 == n ? 0 : a + 1];
+			const bool first = a < i1 && a >= i0;
+			double right = double( std::max( a0.x, a1.x ) );
+			for( unsigned int j = i + 1; j < order.size( ) && order[j].first <= right; ++j ) {
+				const unsigned int b = order[j].second;
+				if( ( b < i1 && b >= i0 ) == first ) { continue; }
+				if( segments_touch( a0, a1, line[b], line[b + 1 == n ? 0 : b + 1] ) ) { return true; }
+			}
+		}
+		return false;
+	}
+
+	// marks every chord in 'kept' (consecutive kept vertices, wrapping when
+	//   'closed') that touches a non-adjacent chord where the parts of the
+	//   line the two stand for do not, returns the count
+	template<typename T>
+	unsigned int find_crossings( const std::vector<point2<T>>& line,
+	                             const std::vector<unsigned int>& kept, bool closed,
+	                             std::vector<char>& crossing ) {
+		const unsigned int m = kept.size( );
+		const unsigned int segs = closed ? m : m - 1;
+		crossing.assign( segs, 0 );
+		if( segs < 3 ) { return 0; }
+
+		// sweep the chords ordered by their left end
+		std::vector<std::pair<double, unsigned int>> order( segs );
+		for( unsigned int s = 0; s < segs; ++s ) {
+			const point2<T>& a = line[kept[s]];
+			const point2<T>& b = line[kept[s + 1 == m ? 0 : s + 1]];
+			order[s] = std::make_pair( double( std::min( a.x, b.x ) ), s );
+		}
+		std::sort( order.begin( ), order.end( ) );
+
+		unsigned int count = 0;
+		for( unsigned int i = 0; i < segs; ++i ) {
+			unsigned int s = order[i].second;
+			const point2<T>& a0 = line[kept[s]];
+			const point2<T>& a1 = line[kept[s + 1 == m ? 0 : s + 1]];
+			double right = double( std::max( a0.x, a1.x ) );
+			for( unsigned int j = i + 1; j < segs && order[j].first <= right; ++j ) {
+				unsigned int t = order[j].second;
+				// neighbouring chords share an end point
+				unsigned int lo = std::min( s, t ), hi = std::max( s, t );
+				if( hi - lo == 1 || ( closed && lo == 0 && hi == segs - 1 ) ) { continue; }
+				const point2<T>& b0 = line[kept[t]];
+				const point2<T>& b1 = line[kept[t + 1 == m ? 0 : t + 1]];
+				if( crossing[s] && crossing[t] ) { continue; }
+				if( !segments_touch( a0, a1, b0, b1 ) ) { continue; }
+				// the line crossed itself there already
+				if( spans_touch( line, kept[s], s + 1 == m ? line.size( ) : kept[s + 1],
+				                 kept[t], t + 1 == m ? line.size( ) : kept[t + 1] ) ) {
+					continue;
+				}
+				count += !crossing[s] + !crossing[t];
+				crossing[s] = crossing[t] = 1;
+			}
+		}
+		return count;
+	}
+
+	// binary min heap of vertex ids ordered by an outside area array, the
+	//   position of each id is tracked so a changed area is fixed in place,
+	//   areas are copied into the nodes to keep the sifts in cache
+	class area_heap {
+	public:
+		// Constructors
+		area_heap( const std::vector<double>& key )
+			: m_key( key ), m_pos( key.size( ), absent( ) ) { }
+
+		// Methods
+		bool empty( ) const { return m_heap.empty( ); }
+		unsigned int top( ) const { return m_heap[0].id; }
+
+		// loads the ids and heapifies in linear time
+		void build( const std::vector<unsigned int>& ids ) {
+			m_heap.resize( ids.size( ) );
+			for( unsigned int i = 0; i < ids.size( ); ++i ) {
+				m_heap[i].area = m_key[ids[i]];
+				m_heap[i].id = ids[i];
+				m_pos[ids[i]] = i;
+			}
+			for( unsigned int i = m_heap.size( ) / 2; i-- > 0; ) {
+				node item = m_heap[i];
+				sift_down( i, item );
+			}
+		}
+
+		void pop( ) {
+			m_pos[m_heap[0].id] = absent( );
+			node last = m_heap.back( );
+			m_heap.pop_back( );
+			if( !m_heap.empty( ) ) { sift_down( 0, last ); }
+		}
+
+		// call after the area of 'id' changed, inserts it if missing
+		void update( unsigned int id ) {
+			node item = { m_key[id], id };
+			unsigned int i = m_pos[id];
+			if( i == absent( ) ) {
+				i = m_heap.size( );
+				m_heap.push_back( item );
+			}
+			sift_down( sift_up( i, item ), item );
+		}
+
+	private:
+		struct node {
+			double       area;
+			unsigned int id;
+		};
+
+		static unsigned int absent( ) { return static_cast<unsigned int>( -1 ); }
+
+		void place( unsigned int i, const node& item ) {
+			m_heap[i] = item;
+			m_pos[item.id] = i;
+		}
+
+		unsigned int sift_up( unsigned int i, const node& item ) {
+			while( i > 0 ) {
+				unsigned int parent = ( i - 1 ) / 2;
+				if( !( item.area < m_heap[parent].area ) ) { break; }
+				place( i, m_heap[parent] );
+				i = parent;
+			}
+			place( i, item );
+			return i;
+		}
+
+		void sift_down( unsigned int i, const node& item ) {
+			const unsigned int size = m_heap.size( );
+			for( ;; ) {
+				unsigned int child = 2 * i + 1;
+				if( child >= size ) { break; }
+				if( child + 1 < size && m_heap[child + 1].area < m_heap[child].area ) { ++child; }
+				if( !( m_heap[child].area < item.area ) ) { break; }
+				place( i, m_heap[child] );
+				i = child;
+			}
+			place( i, item );
+		}
+
+		// Variables
+		const std::vector<double>& m_key;
+		std::vector<node>          m_heap;
+		std::vector<unsigned int>  m_pos;
+	};
+
+	// hashed grid over the live vertices of a line, used to find vertices
+	//   inside a candidate triangle, cells are sized to the current
+	//   segments and rebuilt as the line thins out
+	template<typename T>
+	class vertex_grid {
+	public:
+		// Methods
+		void build( const std::vector<point2<T>>& line, const std::vector<char>& removed,
+		            const std::vector<unsigned int>& next, unsigned int live ) {
+			const unsigned int n = line.size( );
+			m_built = live;
+			m_min_x = m_min_y = std::numeric_limits<double>::infinity( );
+			double max_x = -m_min_x, max_y = -m_min_y, length = 0.0;
+			unsigned int segs = 0;
+			for( unsigned int i = 0; i < n; ++i ) {
+				if( removed[i] ) { continue; }
+				m_min_x = std::min( m_min_x, double(line[i].x) );
+				m_min_y = std::min( m_min_y, double(line[i].y) );
+				max_x = std::max( max_x, double(line[i].x) );
+				max_y = std::max( max_y, double(line[i].y) );
+				if( next[i] < n ) {
+					length += std::sqrt( segment_dist_sq( line[i], line[next[i]], line[next[i]] ) );
+					++segs;
+				}
+			}
+
+			// cells about twice a segment long, hashed so empty space
+			//   costs nothing
+			double extent = std::max( max_x - m_min_x, max_y - m_min_y );
+			double cell = std::max( segs ? 2.0 * length / segs : 0.0, extent / ( 1 << 20 ) );
+			m_inv_cell = cell > 0.0 ? 1.0 / cell : 0.0;
+			m_mask = 1;
+			while( m_mask < live ) { m_mask <<= 1; }
+			--m_mask;
+
+			// counting sort of the live vertices into their buckets
+			m_start.assign( m_mask + 2, 0 );
+			m_bucket.assign( n, 0 );
+			for( unsigned int i = 0; i < n; ++i ) {
+				if( removed[i] ) { continue; }
+				m_bucket[i] = bucket( coord( double(line[i].x) - m_min_x ), coord( double(line[i].y) - m_min_y ) );
+				++m_start[m_bucket[i] + 1];
+			}
+			for( unsigned int c = 0; c + 1 < m_start.size( ); ++c ) { m_start[c + 1] += m_start[c]; }
+			m_end.assign( m_start.begin( ), m_start.end( ) - 1 );
+			m_items.resize( live );
+			m_slot.assign( n, 0 );
+			for( unsigned int i = 0; i < n; ++i ) {
+				if( removed[i] ) { continue; }
+				item& it = m_items[m_slot[i] = m_end[m_bucket[i]]++];
+				it.x = double(line[i].x);
+				it.y = double(line[i].y);
+				it.id = i;
+			}
+		}
+
+		unsigned int built_size( ) const { return m_built; }
+
+		// swaps the vertex with the last one in its bucket
+		void erase( unsigned int id ) {
+			const item& last = m_items[--m_end[m_bucket[id]]];
+			m_slot[last.id] = m_slot[id];
+			m_items[m_slot[id]] = last;
+		}
+
+		// is any live vertex other than the corners inside triangle a, p, b
+		bool blocked( const std::vector<point2<T>>& line, unsigned int a, unsigned int p,
+		              unsigned int b ) const {
+			triangle tri;
+			tri.a = a;
+			tri.p = p;
+			tri.b = b;
+			tri.x[0] = double(line[a].x);  tri.y[0] = double(line[a].y);
+			tri.x[1] = double(line[p].x);  tri.y[1] = double(line[p].y);
+			tri.x[2] = double(line[b].x);  tri.y[2] = double(line[b].y);
+			tri.l = std::min( tri.x[0], std::min( tri.x[1], tri.x[2] ) );
+			tri.r = std::max( tri.x[0], std::max( tri.x[1], tri.x[2] ) );
+			tri.t = std::min( tri.y[0], std::min( tri.y[1], tri.y[2] ) );
+			tri.bt = std::max( tri.y[0], std::max( tri.y[1], tri.y[2] ) );
+			tri.orient = cross( tri, 0, 1, tri.x[2], tri.y[2] );
+
+			unsigned int cx0 = coord( tri.l - m_min_x ), cx1 = coord( tri.r - m_min_x );
+			unsigned int cy0 = coord( tri.t - m_min_y ), cy1 = coord( tri.bt - m_min_y );
+			// a triangle spanning more cells than buckets reads each bucket once
+			if( double( cx1 - cx0 + 1 ) * double( cy1 - cy0 + 1 ) > double( m_mask ) ) {
+				for( unsigned int c = 0; c <= m_mask; ++c ) {
+					if( blocked_in( c, tri ) ) { return true; }
+				}
+				return false;
+			}
+			for( unsigned int cy = cy0; cy <= cy1; ++cy ) {
+				for( unsigned int cx = cx0; cx <= cx1; ++cx ) {
+					if( blocked_in( bucket( cx, cy ), tri ) ) { return true; }
+				}
+			}
+			return false;
+		}
+
+	private:
+		struct triangle {
+			unsigned int a, p, b;
+			double x[3], y[3];
+			double l, r, t, bt, orient;
+		};
+
+		static double cross( const triangle& tri, int i, int j, double x, double y ) {
+			return ( tri.x[j] - tri.x[i] ) * ( y - tri.y[i] ) - ( tri.y[j] - tri.y[i] ) * ( x - tri.x[i] );
+		}
+
+		bool blocked_in( unsigned int c, const triangle& tri ) const {
+			for( unsigned int k = m_start[c]; k < m_end[c]; ++k ) {
+				const item& it = m_items[k];
+				if( it.x < tri.l || it.x > tri.r || it.y < tri.t || it.y > tri.bt ||
+				    it.id == tri.a || it.id == tri.p || it.id == tri.b ) {
+					continue;
+				}
+				double d0 = cross( tri, 0, 1, it.x, it.y );
+				double d1 = cross( tri, 1, 2, it.x, it.y );
+				double d2 = cross( tri, 2, 0, it.x, it.y );
+				if( tri.orient >= 0.0 ? ( d0 >= 0.0 && d1 >= 0.0 && d2 >= 0.0 )
+				                      : ( d0 <= 0.0 && d1 <= 0.0 && d2 <= 0.0 ) ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		unsigned int coord( double offset ) const {
+			double c = offset * m_inv_cell;
+			return c <= 0.0 ? 0 : static_cast<unsigned int>( c );
+		}
+
+		unsigned int bucket( unsigned int cx, unsigned int cy ) const {
+			return ( cx * 73856093u ^ cy * 19349663u ) & m_mask;
+		}
+
+		// coordinates are copied in so a query stays in the bucket
+		struct item {
+			double       x, y;
+			unsigned int id;
+		};
+
+		// Variables
+		double m_min_x, m_min_y, m_inv_cell;
+		unsigned int m_mask, m_built;
+		std::vector<unsigned int> m_start, m_end;   // live items of bucket c in [start, end)
+		std::vector<item>         m_items;
+		std::vector<unsigned int> m_bucket, m_slot;
+	};
+
+	// standard Douglas-Peucker between first and last, marking 'keep'
+	template<typename T>
+	void douglas_peucker_range( const std::vector<point2<T>>& line, unsigned int first,
+	                            unsigned int last, double tol_sq, std::vector<char>& keep,
+	                            std::vector<std::pair<unsigned int, unsigned int>>& stack ) {
+		stack.clear( );
+		stack.push_back( std::make_pair( first, last ) );
+		while( !stack.empty( ) ) {
+			unsigned int i = stack.back( ).first;
+			unsigned int j = stack.back( ).second;
+			stack.pop_back( );
+			if( j <= i + 1 ) { continue; }
+
+			double best = -1.0;
+			unsigned int best_k = i;
+			for( unsigned int k = i + 1; k < j; ++k ) {
+				double d = segment_dist_sq( line[k], line[i], line[j] );
+				if( d > best ) {
+					best = d;
+					best_k = k;
+				}
+			}
+			if( best > tol_sq ) {
+				keep[best_k] = 1;
+				stack.push_back( std::make_pair( i, best_k ) );
+				stack.push_back( std::make_pair( best_k, j ) );
+			}
+		}
+	}
+
+} // End namespace detail
+
+
+// writes the indices of the vertices of 'line' to keep, a 'closed' line
+//   is a ring whose last vertex connects back to the first
+template<typename T>
+void douglas_peucker( const std::vector<point2<T>>& line, double tolerance,
+                      std::vector<unsigned int>& kept, bool preserve_topology = false,
+                      bool closed = false ) {
+	kept.clear( );
+	const unsigned int n = line.size( );
+	if( n < ( closed ? 4u : 3u ) ) {
+		for( unsigned int i = 0; i < n; ++i ) { kept.push_back( i ); }
+		return;
+	}
+
+	double tol_sq = tolerance * tolerance;
+	std::vector<char> keep( n, 0 );
+	std::vector<std::pair<unsigned int, unsigned int>> stack;
+	stack.reserve( 64 );
+
+	keep[0] = 1;
+	unsigned int last = n - 1;
+	if( closed ) {
+		// anchor the ring on the vertex farthest from the first
+		double best = -1.0;
+		for( unsigned int k = 1; k < n; ++k ) {
+			double dx = double(line[k].x) - double(line[0].x);
+			double dy = double(line[k].y) - double(line[0].y);
+			if( dx*dx + dy*dy > best ) {
+				best = dx*dx + dy*dy;
+				last = k;
+			}
+		}
+		keep[last] = 1;
+		detail::douglas_peucker_range( line, 0, last, tol_sq, keep, stack );
+		// the far side runs from 'last' around to 0, done on a copy
+		//   rotated so the range is contiguous
+		std::vector<point2<T>> back( line.begin( ) + last, line.end( ) );
+		back.push_back( line[0] );
+		std::vector<char> back_keep( back.size( ), 0 );
+		detail::douglas_peucker_range( back, 0, back.size( ) - 1, tol_sq, back_keep, stack );
+		for( unsigned int k = 1; k + 1 < back.size( ); ++k ) {
+			if( back_keep[k] ) { keep[last + k] = 1; }
+		}
+	}
+	else {
+		keep[last] = 1;
+		detail::douglas_peucker_range( line, 0, last, tol_sq, keep, stack );
+	}
+
+	for( unsigned int i = 0; i < n; ++i ) {
+		if( keep[i] ) { kept.push_back( i ); }
+	}
+
+	if( !preserve_topology ) { return; }
+
+	// split crossing chords at their farthest vertex until none cross,
+	//   this ends at worst with the original line
+	std::vector<char> crossing;
+	while( detail::find_crossings( line, kept, closed, crossing ) != 0 ) {
+		bool changed = false;
+		const unsigned int m = kept.size( );
+		for( unsigned int s = 0; s < crossing.size( ); ++s ) {
+			if( !crossing[s] ) { continue; }
+			unsigned int i = kept[s];
+			unsigned int j = ( s + 1 == m ? n : kept[s + 1] );
+			double best = -1.0;
+			unsigned int best_k = i;
+			for( unsigned int k = i + 1; k < j; ++k ) {
+				double d = detail::segment_dist_sq( line[k], line[i], line[j == n ? 0 : j] );
+				if( d > best ) {
+					best = d;
+					best_k = k;
+				}
+			}
+			if( best_k != i ) {
+				keep[best_k] = 1;
+				changed = true;
+			}
+		}
+		if( !changed ) { break; }
+
+		kept.clear( );
+		for( unsigned int i = 0; i < n; ++i ) {
+			if( keep[i] ) { kept.push_back( i ); }
+		}
+	}
+}
+
+
+// writes the indices of the vertices of 'line' to keep, dropping vertices
+//   whose effective area is below 'min_area'
+template<typename T>
+void visvalingam( const std::vector<point2<T>>& line, double min_area,
+                  std::vector<unsigned int>& kept, bool preserve_topology = false,
+                  bool closed = false ) {
+	kept.clear( );
+	const unsigned int n = line.size( );
+	const unsigned int min_keep = closed ? 3 : 2;
+	if( n <= min_keep ) {
+		for( unsigned int i = 0; i < n; ++i ) { kept.push_back( i ); }
+		return;
+	}
+
+	const unsigned int none = static_cast<unsigned int>( -1 );
+	std::vector<unsigned int> prev( n ), next( n );
+	std::vector<double>       area( n, std::numeric_limits<double>::infinity( ) );
+	std::vector<char>         removed( n, 0 );
+	for( unsigned int i = 0; i < n; ++i ) {
+		prev[i] = ( i == 0 ? ( closed ? n - 1 : none ) : i - 1 );
+		next[i] = ( i + 1 == n ? ( closed ? 0 : none ) : i + 1 );
+	}
+
+	// only vertices under the threshold can ever be dropped, the rest
+	//   enter the heap if a neighbour's removal brings them under it
+	detail::area_heap heap( area );
+	std::vector<unsigned int> candidates;
+	for( unsigned int i = 0; i < n; ++i ) {
+		if( prev[i] == none || next[i] == none ) { continue; }
+		area[i] = std::abs( detail::turn( line[prev[i]], line[i], line[next[i]] ) ) / 2.0;
+		if( area[i] < min_area ) { candidates.push_back( i ); }
+	}
+	heap.build( candidates );
+
+	// refuses a removal while another vertex is inside its triangle
+	detail::vertex_grid<T> grid;
+	if( preserve_topology ) { grid.build( line, removed, next, n ); }
+
+	unsigned int remaining = n;
+	double max_removed = 0.0;
+	while( !heap.empty( ) && remaining > min_keep ) {
+		unsigned int i = heap.top( );
+		if( area[i] >= min_area ) { break; }
+		heap.pop( );
+
+		unsigned int a = prev[i], b = next[i];
+		if( preserve_topology && grid.blocked( line, a, i, b ) ) {
+			// stays out until a neighbour changes and it is pushed again
+			continue;
+		}
+
+		removed[i] = 1;
+		--remaining;
+		if( preserve_topology ) {
+			grid.erase( i );
+			if( remaining < grid.built_size( ) / 4 ) { grid.build( line, removed, next, remaining ); }
+		}
+		// effective areas never decrease so the order stays meaningful
+		max_removed = std::max( max_removed, area[i] );
+		next[a] = b;
+		prev[b] = a;
+
+		unsigned int update[2] = { a, b };
+		for( int u = 0; u < 2; ++u ) {
+			unsigned int v = update[u];
+			if( prev[v] == none || next[v] == none ) { continue; }
+			area[v] = std::max( max_removed,
+			                    std::abs( detail::turn( line[prev[v]], line[v], line[next[v]] ) ) / 2.0 );
+			heap.update( v );
+		}
+	}
+
+	for( unsigned int i = 0; i < n; ++i ) {
+		if( !removed[i] ) { kept.push_back( i ); }
+	}
+}
+
+
+// point returning versions
+
+template<typename T>
+std::vector<point2<T>> douglas_peucker( const std::vector<point2<T>>& line, double tolerance,
+                                        bool preserve_topology = false ) {
+	std::vector<unsigned int> kept;
+	douglas_peucker( line, tolerance, kept, preserve_topology );
+	std::vector<point2<T>> result;
+	result.reserve( kept.size( ) );
+	for( unsigned int i = 0; i < kept.size( ); ++i ) { result.push_back( line[kept[i]] ); }
+	return result;
+}
+
+template<typename T>
+std::vector<point2<T>> visvalingam( const std::vector<point2<T>>& line, double min_area,
+                                    bool preserve_topology = false ) {
+	std::vector<unsigned int> kept;
+	visvalingam( line, min_area, kept, preserve_topology );
+	std::vector<point2<T>> result;
+	result.reserve( kept.size( ) );
+	for( unsigned int i = 0; i < kept.size( ); ++i ) { result.push_back( line[kept[i]] ); }
+	return result;
+}
+
+
+// polygon versions, the boundary is treated as a closed ring
+
+template<typename T>
+simple_polygon2<T> douglas_peucker( const simple_polygon2<T>& poly, double tolerance,
+                                    bool preserve_topology = false ) {
+	if( poly == simple_polygon2<T>::null( ) ) { return poly; }
+	std::vector<unsigned int> kept;
+	douglas_peucker( poly.points( ), tolerance, kept, preserve_topology, true );
+	std::vector<point2<T>> result;
+	for( unsigned int i = 0; i < kept.size( ); ++i ) { result.push_back( poly[kept[i]] ); }
+	return simple_polygon2<T>( result );
+}
+
+template<typename T>
+simple_polygon2<T> visvalingam( const simple_polygon2<T>& poly, double min_area,
+                                bool preserve_topology = false ) {
+	if( poly == simple_polygon2<T>::null( ) ) { return poly; }
+	std::vector<unsigned int> kept;
+	visvalingam( poly.points( ), min_area, kept, preserve_topology, true );
+	std::vector<point2<T>> result;
+	for( unsigned int i = 0; i < kept.size( ); ++i ) { result.push_back( poly[kept[i]] ); }
+	return simple_polygon2<T>( result );
+}
+
+// a subset of a convex hull is still convex, so no topology option
+template<typename T>
+polygon2<T> douglas_peucker( const polygon2<T>& poly, double tolerance ) {
+	if( poly == polygon2<T>::null( ) ) { return poly; }
+	std::vector<point2<T>> hull;
+	for( unsigned int i = 0; i < poly.size( ); ++i ) { hull.push_back( poly[i] ); }
+	std::vector<unsigned int> kept;
+	douglas_peucker( hull, tolerance, kept, false, true );
+	if( kept.size( ) < 3 ) { return polygon2<T>::null( ); }
+	std::vector<point2<T>> result;
+	for( unsigned int i = 0; i < kept.size( ); ++i ) { result.push_back( hull[kept[i]] ); }
+	return polygon2<T>( result );
+}
+
+template<typename T>
+polygon2<T> visvalingam( const polygon2<T>& poly, double min_area ) {
+	if( poly == polygon2<T>::null( ) ) { return poly; }
+	std::vector<point2<T>> hull;
+	for( unsigned int i = 0; i < poly.size( ); ++i ) { hull.push_back( poly[i] ); }
+	std::vector<unsigned int> kept;
+	visvalingam( hull, min_area, kept, false, true );
+	std::vector<point2<T>> result;
+	for( unsigned int i = 0; i < kept.size( ); ++i ) { result.push_back( hull[kept[i]] ); }
+	return polygon2<T>( result );
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SIMPLIFY_HPP
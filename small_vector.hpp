@@ -0,0 +1,333 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SMALL_VECTOR_HPP
+#define EUBLIB_SMALL_VECTOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+ * A vector holding up to N elements inside the object itself, only going
+ *   to the heap once it grows past N. Meant for the many small polygons
+ *   that would otherwise cost an allocation each. Iterators are plain
+ *   pointers and, like std::vector, are invalidated by growth; unlike
+ *   std::vector they are also invalidated by moving or swapping while the
+ *   elements are inline.
+ */
+
+namespace euclib {
+
+template<typename T, unsigned int N>
+class small_vector {
+// Typedefs
+public:
+
+	typedef T                                      value_type;
+	typedef T&                                     reference;
+	typedef const T&                               const_reference;
+	typedef T*                                     pointer;
+	typedef const T*                               const_pointer;
+	typedef T*                                     iterator;
+	typedef const T*                               const_iterator;
+	typedef std::reverse_iterator<iterator>        reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>  const_reverse_iterator;
+	typedef std::size_t                            size_type;
+	typedef std::ptrdiff_t                         difference_type;
+
+	static const unsigned int inline_capacity = N;
+
+	static_assert( N > 0, "small_vector needs room for at least one element" );
+
+private:
+
+	typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage_t;
+
+
+// Variables
+private:
+
+	T*         m_data;
+	size_type  m_size;
+	size_type  m_capacity;
+	storage_t  m_inline[N];
+
+
+// Constructors
+public:
+
+	small_vector( ) :
+		m_data( inline_data( ) ),
+		m_size( 0 ),
+		m_capacity( N )
+	{ }
+
+	explicit small_vector( size_type count, const T& value = T( ) ) :
+		m_data( inline_data( ) ),
+		m_size( 0 ),
+		m_capacity( N ) {
+		assign( count, value );
+	}
+
+	template<typename Iterator>
+	small_vector( Iterator first, Iterator last,
+	              typename std::enable_if<!std::is_integral<Iterator>::value>::type* = 0 ) :
+		m_data( inline_data( ) ),
+		m_size( 0 ),
+		m_capacity( N ) {
+		assign( first, last );
+	}
+
+	small_vector( const small_vector<T,N>& vec ) :
+		m_data( inline_data( ) ),
+		m_size( 0 ),
+		m_capacity( N ) {
+		assign( vec.begin( ), vec.end( ) );
+	}
+
+	small_vector( small_vector<T,N>&& vec ) :
+		m_data( inline_data( ) ),
+		m_size( 0 ),
+		m_capacity( N ) {
+		steal( vec );
+	}
+
+	~small_vector( ) {
+		clear( );
+		release( );
+	}
+
+
+// Methods
+public:
+
+	size_type size( ) const     { return m_size; }
+	size_type capacity( ) const { return m_capacity; }
+	bool empty( ) const         { return m_size == 0; }
+
+	// true while the elements live inside the object
+	bool is_inline( ) const { return m_data == inline_data( ); }
+
+	T* data( )             { return m_data; }
+	const T* data( ) const { return m_data; }
+
+	iterator begin( )             { return m_data; }
+	const_iterator begin( ) const { return m_data; }
+	iterator end( )               { return m_data + m_size; }
+	const_iterator end( ) const   { return m_data + m_size; }
+
+	reverse_iterator rbegin( )             { return reverse_iterator( end( ) ); }
+	const_reverse_iterator rbegin( ) const { return const_reverse_iterator( end( ) ); }
+	reverse_iterator rend( )               { return reverse_iterator( begin( ) ); }
+	const_reverse_iterator rend( ) const   { return const_reverse_iterator( begin( ) ); }
+
+	T& front( )             { return m_data[0]; }
+	const T& front( ) const { return m_data[0]; }
+	T& back( )              { return m_data[m_size - 1]; }
+	const T& back( ) const  { return m_data[m_size - 1]; }
+
+	T& at( size_type index ) {
+		if( index >= m_size ) { throw std::out_of_range( "small_vector::at" ); }
+		return m_data[index];
+	}
+	const T& at( size_type index ) const {
+		if( index >= m_size ) { throw std::out_of_range( "small_vector::at" ); }
+		return m_data[index];
+	}
+
+	void reserve( size_type count ) {
+		if( count > m_capacity ) { reallocate( count ); }
+	}
+
+	void push_back( const T& value ) {
+		if( m_size == m_capacity ) {
+			// value may be one of ours
+			T copy( value );
+			grow( m_size + 1 );
+			::new( static_cast<void*>( m_data + m_size ) ) T( std::move( copy ) );
+		}
+		else {
+			::new( static_cast<void*>( m_data + m_size ) ) T( value );
+		}
+		++m_size;
+	}
+
+	void push_back( T&& value ) {
+		if( m_size == m_capacity ) {
+			T copy( std::move( value ) );
+			grow( m_size + 1 );
+			::new( static_cast<void*>( m_data + m_size ) ) T( std::move( copy ) );
+		}
+		else {
+			::new( static_cast<void*>( m_data + m_size ) ) T( std::move( value ) );
+		}
+		++m_size;
+	}
+
+	template<typename... Args>
+	void emplace_back( Args&&... args ) {
+		push_back( T( std::forward<Args>( args )... ) );
+	}
+
+	void pop_back( ) {
+		--m_size;
+		m_data[m_size].~T( );
+	}
+
+	void resize( size_type count, const T& value = T( ) ) {
+		while( m_size > count ) { pop_back( ); }
+		reserve( count );
+		while( m_size < count ) { push_back( value ); }
+	}
+
+	void clear( ) {
+		while( m_size > 0 ) { pop_back( ); }
+	}
+
+	void assign( size_type count, const T& value ) {
+		clear( );
+		reserve( count );
+		for( size_type i = 0; i < count; ++i ) { push_back( value ); }
+	}
+
+	template<typename Iterator>
+	typename std::enable_if<!std::is_integral<Iterator>::value>::type
+	assign( Iterator first, Iterator last ) {
+		clear( );
+		reserve( std::distance( first, last ) );
+		for( ; first != last; ++first ) { push_back( *first ); }
+	}
+
+	iterator erase( iterator pos ) {
+		return erase( pos, pos + 1 );
+	}
+
+	iterator erase( iterator first, iterator last ) {
+		if( first == last ) { return first; }
+		iterator out = first;
+		for( iterator itr = last; itr != end( ); ++itr, ++out ) { *out = std::move( *itr ); }
+		while( end( ) != out ) { pop_back( ); }
+		return first;
+	}
+
+	void swap( small_vector<T,N>& vec ) {
+		if( this == &vec ) { return; }
+		// two heap buffers just trade pointers
+		if( !is_inline( ) && !vec.is_inline( ) ) {
+			std::swap( m_data, vec.m_data );
+			std::swap( m_size, vec.m_size );
+			std::swap( m_capacity, vec.m_capacity );
+			return;
+		}
+		small_vector<T,N> tmp( std::move( vec ) );
+		vec = std::move( *this );
+		*this = std::move( tmp );
+	}
+
+private:
+
+	T* inline_data( ) { return reinterpret_cast<T*>( m_inline ); }
+	const T* inline_data( ) const { return reinterpret_cast<const T*>( m_inline ); }
+
+	void grow( size_type count ) {
+		size_type cap = m_capacity * 2;
+		reallocate( cap < count ? count : cap );
+	}
+
+	// moves the elements to a heap buffer of 'count' elements
+	void reallocate( size_type count ) {
+		T* data = static_cast<T*>( ::operator new( count * sizeof(T) ) );
+		for( size_type i = 0; i < m_size; ++i ) {
+			::new( static_cast<void*>( data + i ) ) T( std::move( m_data[i] ) );
+			m_data[i].~T( );
+		}
+		release( );
+		m_data = data;
+		m_capacity = count;
+	}
+
+	void release( ) {
+		if( !is_inline( ) ) { ::operator delete( m_data ); }
+		m_data = inline_data( );
+		m_capacity = N;
+	}
+
+	// takes the elements of vec, which is left empty
+	void steal( small_vector<T,N>& vec ) {
+		clear( );
+		if( vec.is_inline( ) ) {
+			reserve( vec.m_size );
+			for( size_type i = 0; i < vec.m_size; ++i ) { push_back( std::move( vec.m_data[i] ) ); }
+			vec.clear( );
+		}
+		else {
+			release( );
+			m_data = vec.m_data;
+			m_size = vec.m_size;
+			m_capacity = vec.m_capacity;
+			vec.m_data = vec.inline_data( );
+			vec.m_size = 0;
+			vec.m_capacity = N;
+		}
+	}
+
+
+// Operators
+public:
+
+	T& operator [] ( size_type index )             { return m_data[index]; }
+	const T& operator [] ( size_type index ) const { return m_data[index]; }
+
+	small_vector<T,N>& operator = ( const small_vector<T,N>& vec ) {
+		if( this != &vec ) { assign( vec.begin( ), vec.end( ) ); }
+		return *this;
+	}
+
+	small_vector<T,N>& operator = ( small_vector<T,N>&& vec ) {
+		if( this != &vec ) { steal( vec ); }
+		return *this;
+	}
+
+	bool operator == ( const small_vector<T,N>& vec ) const {
+		if( m_size != vec.m_size ) { return false; }
+		for( size_type i = 0; i < m_size; ++i ) {
+			if( !( m_data[i] == vec.m_data[i] ) ) { return false; }
+		}
+		return true;
+	}
+
+	bool operator != ( const small_vector<T,N>& vec ) const {
+		return !( *this == vec );
+	}
+}; // End class small_vector
+
+template<typename T, unsigned int N>
+const unsigned int small_vector<T,N>::inline_capacity;
+
+template<typename T, unsigned int N> inline
+void swap( small_vector<T,N>& vec1, small_vector<T,N>& vec2 ) {
+	vec1.swap( vec2 );
+}
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SMALL_VECTOR_HPP
@@ -0,0 +1,417 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_SWEEP_AND_PRUNE_HPP
+#define EUBLIB_SWEEP_AND_PRUNE_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <unordered_set>
+#include <cstdint>
+#include "rect.hpp"
+
+/*
+ * Sweep and prune broad phase over rect2
+ *
+ *   The ends of every box are kept sorted along x, and along y too unless
+ *   built for one axis [1]. Boxes are moved with update( ) and step( )
+ *   then re-sorts the lists with insertion sort, cheap when boxes move a
+ *   little each frame. Two ends of different boxes trading places are the
+ *   only way an overlap can begin or end, so step( ) reports just the
+ *   pairs that started or stopped overlapping since the last step.
+ *
+ *   With both axes a pair is tested when its ends cross on either axis.
+ *   With x only, pairs overlapping on x are tracked and checked on y every
+ *   step, which is better when boxes are spread along x and bunched on y.
+ *
+ *   Boxes touching count as overlapping. Inserts and removals take effect
+ *   at the next step( ); a big batch of inserts re-sorts from scratch
+ *   instead of bubbling each box in.
+ *
+ * References
+ *   [1] J. D. Cohen, M. C. Lin, D. Manocha, M. Ponamgi. "I-COLLIDE: An
+ *         Interactive and Exact Collision Detection System for Large-Scale
+ *         Environments". Proceedings of the ACM Symposium on Interactive
+ *         3D Graphics, pp. 189-196, 1995.
+ */
+
+namespace euclib {
+
+template<typename T>
+class sweep_and_prune {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+	enum item_state { state_free, state_live, state_added, state_removed };
+
+	struct item {
+		T           l, r, t, b;
+		item_state  state;
+	};
+
+	// 'id' is handle * 2, plus 1 for the high end
+	struct endpoint {
+		T             value;
+		unsigned int  id;
+	};
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+	// handles, the smaller first
+	typedef std::pair<unsigned int, unsigned int> pair_t;
+
+
+// Variables
+private:
+
+	bool                          m_both_axes;
+	std::vector<item>             m_items;
+	std::vector<unsigned int>     m_free_items;
+	std::vector<unsigned int>     m_released;   // free after the next step
+	std::vector<endpoint>         m_ends[2];    // x, y
+	std::unordered_set<uint64_t>  m_pairs;      // overlapping now
+	std::unordered_set<uint64_t>  m_candidates; // x only: overlapping on x
+	unsigned int                  m_size;
+	unsigned int                  m_added;      // inserts waiting for step( )
+	bool                          m_removed;    // removals waiting for step( )
+
+
+// Constructors
+public:
+
+	explicit sweep_and_prune( bool both_axes = true ) :
+		m_both_axes( both_axes ),
+		m_size( 0 ),
+		m_added( 0 ),
+		m_removed( false )
+	{ }
+
+
+// Methods
+public:
+
+	unsigned int size( ) const { return m_size; }
+	bool empty( ) const        { return m_size == 0; }
+	bool both_axes( ) const    { return m_both_axes; }
+
+	rect2<T> box( unsigned int handle ) const {
+		const item& it = m_items[handle];
+		return rect2<T>( it.l, it.r, it.t, it.b );
+	}
+
+	bool contains( unsigned int handle ) const {
+		return handle < m_items.size( ) &&
+		       ( m_items[handle].state == state_live || m_items[handle].state == state_added );
+	}
+
+	// adds 'rect', returning its handle, or npos for a null rect
+	unsigned int insert( const rect2<T>& rect ) {
+		if( rect == rect2<T>::null( ) ) { return npos; }
+		unsigned int handle;
+		if( !m_free_items.empty( ) ) {
+			handle = m_free_items.back( );
+			m_free_items.pop_back( );
+		}
+		else {
+			handle = m_items.size( );
+			m_items.push_back( item( ) );
+		}
+		set_box( handle, rect );
+		m_items[handle].state = state_added;
+		++m_added;
+		++m_size;
+		return handle;
+	}
+
+	// the handle stays reserved until the next step( ) has reported its
+	//   pairs as removed
+	bool remove( unsigned int handle ) {
+		if( !contains( handle ) ) { return false; }
+		if( m_items[handle].state == state_added ) {
+			--m_added;
+			m_items[handle].state = state_free;
+			m_free_items.push_back( handle );
+		}
+		else {
+			m_items[handle].state = state_removed;
+			m_removed = true;
+		}
+		--m_size;
+		return true;
+	}
+
+	bool update( unsigned int handle, const rect2<T>& rect ) {
+		if( !contains( handle ) || rect == rect2<T>::null( ) ) { return false; }
+		set_box( handle, rect );
+		return true;
+	}
+
+	// brings the sweep up to date with every change since the last step,
+	//   appending the pairs that began and stopped overlapping
+	void step( std::vector<pair_t>& added, std::vector<pair_t>& removed ) {
+		if( m_removed ) { purge( removed ); }
+
+		const unsigned int axes = m_both_axes ? 2 : 1;
+		const unsigned int live = m_ends[0].size( ) / 2;
+		if( m_added > 0 && m_added * 8 >= live ) {
+			rebuild( added, removed );
+		}
+		else {
+			for( unsigned int a = 0; a < axes; ++a ) {
+				refresh( a );
+				append_added( a );
+				sort( a, added, removed );
+			}
+			if( !m_both_axes ) { check_candidates( added, removed ); }
+		}
+
+		for( unsigned int i = 0; i < m_items.size( ); ++i ) {
+			if( m_items[i].state == state_added ) { m_items[i].state = state_live; }
+		}
+		m_added = 0;
+		m_free_items.insert( m_free_items.end( ), m_released.begin( ), m_released.end( ) );
+		m_released.clear( );
+	}
+
+	// every pair overlapping as of the last step( )
+	void pairs( std::vector<pair_t>& result ) const {
+		result.clear( );
+		result.reserve( m_pairs.size( ) );
+		for( typename std::unordered_set<uint64_t>::const_iterator itr = m_pairs.begin( );
+		     itr != m_pairs.end( ); ++itr ) {
+			result.push_back( unkey( *itr ) );
+		}
+	}
+
+	unsigned int pair_count( ) const { return m_pairs.size( ); }
+
+private:
+
+	void set_box( unsigned int handle, const rect2<T>& rect ) {
+		item& it = m_items[handle];
+		it.l = rect.l;
+		it.r = rect.r;
+		it.t = rect.t;
+		it.b = rect.b;
+	}
+
+	static uint64_t key( unsigned int h1, unsigned int h2 ) {
+		if( h1 > h2 ) { std::swap( h1, h2 ); }
+		return ( uint64_t(h1) << 32 ) | h2;
+	}
+
+	static pair_t unkey( uint64_t k ) {
+		return pair_t( unsigned( k >> 32 ), unsigned( k & 0xFFFFFFFF ) );
+	}
+
+	T value( unsigned int axis, unsigned int id ) const {
+		const item& it = m_items[id >> 1];
+		return axis == 0 ? ( id & 1 ? it.r : it.l ) : ( id & 1 ? it.b : it.t );
+	}
+
+	// order along an axis, low ends first on ties so touching overlaps
+	static bool before( const endpoint& e1, const endpoint& e2 ) {
+		return e1.value < e2.value || ( e1.value == e2.value && ( e1.id & 1 ) < ( e2.id & 1 ) );
+	}
+
+	bool overlap_x( unsigned int h1, unsigned int h2 ) const {
+		return m_items[h1].l <= m_items[h2].r && m_items[h2].l <= m_items[h1].r;
+	}
+
+	bool overlap_y( unsigned int h1, unsigned int h2 ) const {
+		return m_items[h1].t <= m_items[h2].b && m_items[h2].t <= m_items[h1].b;
+	}
+
+	// drops removed boxes from the lists and their pairs from the set
+	void purge( std::vector<pair_t>& removed ) {
+		for( unsigned int a = 0; a < 2; ++a ) {
+			std::vector<endpoint>& ends = m_ends[a];
+			ends.erase( std::remove_if( ends.begin( ), ends.end( ), [&]( const endpoint& e ) {
+				return m_items[e.id >> 1].state == state_removed;
+			} ), ends.end( ) );
+		}
+		for( typename std::unordered_set<uint64_t>::iterator itr = m_pairs.begin( ); itr != m_pairs.end( ); ) {
+			pair_t p = unkey( *itr );
+			if( m_items[p.first].state == state_removed || m_items[p.second].state == state_removed ) {
+				removed.push_back( p );
+				itr = m_pairs.erase( itr );
+			}
+			else { ++itr; }
+		}
+		for( typename std::unordered_set<uint64_t>::iterator itr = m_candidates.begin( ); itr != m_candidates.end( ); ) {
+			pair_t p = unkey( *itr );
+			if( m_items[p.first].state == state_removed || m_items[p.second].state == state_removed ) {
+				itr = m_candidates.erase( itr );
+			}
+			else { ++itr; }
+		}
+		for( unsigned int i = 0; i < m_items.size( ); ++i ) {
+			if( m_items[i].state == state_removed ) {
+				m_items[i].state = state_free;
+				m_released.push_back( i );
+			}
+		}
+		m_removed = false;
+	}
+
+	void refresh( unsigned int axis ) {
+		std::vector<endpoint>& ends = m_ends[axis];
+		for( unsigned int i = 0; i < ends.size( ); ++i ) {
+			ends[i].value = value( axis, ends[i].id );
+		}
+	}
+
+	// new boxes go on the end, the sort bubbles them into place
+	void append_added( unsigned int axis ) {
+		if( m_added == 0 ) { return; }
+		for( unsigned int h = 0; h < m_items.size( ); ++h ) {
+			if( m_items[h].state != state_added ) { continue; }
+			endpoint low = { value( axis, 2 * h ), 2 * h };
+			endpoint high = { value( axis, 2 * h + 1 ), 2 * h + 1 };
+			m_ends[axis].push_back( low );
+			m_ends[axis].push_back( high );
+		}
+	}
+
+	// insertion sort, where every swap of ends of two boxes may start or
+	//   stop an overlap
+	void sort( unsigned int axis, std::vector<pair_t>& added, std::vector<pair_t>& removed ) {
+		std::vector<endpoint>& ends = m_ends[axis];
+		for( unsigned int i = 1; i < ends.size( ); ++i ) {
+			if( !before( ends[i], ends[i - 1] ) ) { continue; }
+			const endpoint moving = ends[i];
+			unsigned int j = i;
+			do {
+				const endpoint& passed = ends[j - 1];
+				if( ( moving.id & 1 ) != ( passed.id & 1 ) ) {
+					if( moving.id & 1 ) { stop( moving.id >> 1, passed.id >> 1, removed ); }
+					else { start( moving.id >> 1, passed.id >> 1, added ); }
+				}
+				ends[j] = passed;
+				--j;
+			} while( j > 0 && before( moving, ends[j - 1] ) );
+			ends[j] = moving;
+		}
+	}
+
+	// a low end passed a high end
+	void start( unsigned int h1, unsigned int h2, std::vector<pair_t>& added ) {
+		if( m_both_axes ) {
+			if( overlap_x( h1, h2 ) && overlap_y( h1, h2 ) && m_pairs.insert( key( h1, h2 ) ).second ) {
+				added.push_back( unkey( key( h1, h2 ) ) );
+			}
+		}
+		else if( overlap_x( h1, h2 ) ) {
+			m_candidates.insert( key( h1, h2 ) );
+		}
+	}
+
+	// a high end passed a low end
+	void stop( unsigned int h1, unsigned int h2, std::vector<pair_t>& removed ) {
+		if( m_both_axes ) {
+			if( m_pairs.erase( key( h1, h2 ) ) ) { removed.push_back( unkey( key( h1, h2 ) ) ); }
+		}
+		else {
+			m_candidates.erase( key( h1, h2 ) );
+		}
+	}
+
+	// x only: pairs overlapping on x, checked on y
+	void check_candidates( std::vector<pair_t>& added, std::vector<pair_t>& removed ) {
+		for( typename std::unordered_set<uint64_t>::iterator itr = m_pairs.begin( ); itr != m_pairs.end( ); ) {
+			pair_t p = unkey( *itr );
+			if( !m_candidates.count( *itr ) || !overlap_y( p.first, p.second ) ) {
+				removed.push_back( p );
+				itr = m_pairs.erase( itr );
+			}
+			else { ++itr; }
+		}
+		for( typename std::unordered_set<uint64_t>::const_iterator itr = m_candidates.begin( );
+		     itr != m_candidates.end( ); ++itr ) {
+			pair_t p = unkey( *itr );
+			if( overlap_y( p.first, p.second ) && m_pairs.insert( *itr ).second ) { added.push_back( p ); }
+		}
+	}
+
+	// sorts from scratch and finds every pair with one sweep along x,
+	//   reporting the difference from the pairs held before
+	void rebuild( std::vector<pair_t>& added, std::vector<pair_t>& removed ) {
+		const unsigned int axes = m_both_axes ? 2 : 1;
+		for( unsigned int a = 0; a < 2; ++a ) { m_ends[a].clear( ); }
+		for( unsigned int h = 0; h < m_items.size( ); ++h ) {
+			if( m_items[h].state != state_live && m_items[h].state != state_added ) { continue; }
+			for( unsigned int a = 0; a < axes; ++a ) {
+				endpoint low = { value( a, 2 * h ), 2 * h };
+				endpoint high = { value( a, 2 * h + 1 ), 2 * h + 1 };
+				m_ends[a].push_back( low );
+				m_ends[a].push_back( high );
+			}
+		}
+		for( unsigned int a = 0; a < axes; ++a ) {
+			std::sort( m_ends[a].begin( ), m_ends[a].end( ), before );
+		}
+
+		std::unordered_set<uint64_t> pairs, candidates;
+		std::vector<unsigned int> active, slot( m_items.size( ) );
+		const std::vector<endpoint>& ends = m_ends[0];
+		for( unsigned int i = 0; i < ends.size( ); ++i ) {
+			const unsigned int h = ends[i].id >> 1;
+			if( ends[i].id & 1 ) {
+				// swap out of the active list
+				unsigned int last = active.back( );
+				active[slot[h]] = last;
+				slot[last] = slot[h];
+				active.pop_back( );
+				continue;
+			}
+			for( unsigned int k = 0; k < active.size( ); ++k ) {
+				if( !m_both_axes ) { candidates.insert( key( h, active[k] ) ); }
+				if( overlap_y( h, active[k] ) ) { pairs.insert( key( h, active[k] ) ); }
+			}
+			slot[h] = active.size( );
+			active.push_back( h );
+		}
+
+		for( typename std::unordered_set<uint64_t>::const_iterator itr = m_pairs.begin( ); itr != m_pairs.end( ); ++itr ) {
+			if( !pairs.count( *itr ) ) { removed.push_back( unkey( *itr ) ); }
+		}
+		for( typename std::unordered_set<uint64_t>::const_iterator itr = pairs.begin( ); itr != pairs.end( ); ++itr ) {
+			if( !m_pairs.count( *itr ) ) { added.push_back( unkey( *itr ) ); }
+		}
+		m_pairs.swap( pairs );
+		m_candidates.swap( candidates );
+	}
+}; // End class sweep_and_prune
+
+template<typename T>
+const unsigned int sweep_and_prune<T>::npos;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_SWEEP_AND_PRUNE_HPP
@@ -0,0 +1,234 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <set>
+#include <random>
+#include <cmath>
+
+#include "../boolean.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>       point_t;
+typedef std::vector<point_t> ring_t;
+typedef std::vector<ring_t>  rings_t;
+
+// even-odd membership, the reference for every operation
+bool inside( const rings_t& rings, const point_t& pt ) {
+	bool in = false;
+	for( unsigned int r = 0; r < rings.size( ); ++r ) {
+		const ring_t& ring = rings[r];
+		for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+			if( ( ring[i].y > pt.y ) != ( ring[j].y > pt.y ) &&
+			    pt.x < ( ring[j].x - ring[i].x ) * ( pt.y - ring[i].y ) / ( ring[j].y - ring[i].y ) + ring[i].x ) {
+				in = !in;
+			}
+		}
+	}
+	return in;
+}
+
+bool apply( boolean_op op, bool a, bool b ) {
+	switch( op ) {
+		case op_intersection: return a && b;
+		case op_union:        return a || b;
+		case op_difference:   return a && !b;
+		case op_xor:          return a != b;
+	}
+	return false;
+}
+
+double ring_area( const ring_t& ring ) {
+	double area = 0.0;
+	for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+		area += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+	}
+	return area / 2.0;
+}
+
+double area( const rings_t& rings ) {
+	double total = 0.0;
+	for( unsigned int r = 0; r < rings.size( ); ++r ) { total += ring_area( rings[r] ); }
+	return total;
+}
+
+ring_t rect( double l, double t, double r, double b ) {
+	ring_t ring;
+	ring.push_back( point_t( l, t ) );
+	ring.push_back( point_t( r, t ) );
+	ring.push_back( point_t( r, b ) );
+	ring.push_back( point_t( l, b ) );
+	return ring;
+}
+
+// every operation against the reference at sample points over [lo,hi)^2,
+//   and on integer inputs the area against a count of unit cells
+void check_ops( const rings_t& a, const rings_t& b, double lo, double hi, bool grid ) {
+	const boolean_op ops[4] = { op_intersection, op_union, op_difference, op_xor };
+	for( unsigned int k = 0; k < 4; ++k ) {
+		rings_t result;
+		combine( a, b, ops[k], result );
+
+		const unsigned int n = 60;
+		unsigned int wrong = 0;
+		for( unsigned int i = 0; i < n; ++i ) {
+			for( unsigned int j = 0; j < n; ++j ) {
+				const point_t pt( lo + ( hi - lo ) * ( i + 0.5123 ) / n, lo + ( hi - lo ) * ( j + 0.4871 ) / n );
+				if( inside( result, pt ) != apply( ops[k], inside( a, pt ), inside( b, pt ) ) ) { ++wrong; }
+			}
+		}
+		CHECK( wrong == 0 );
+
+		if( grid ) {
+			double cells = 0.0;
+			for( int x = int( lo ); x < int( hi ); ++x ) {
+				for( int y = int( lo ); y < int( hi ); ++y ) {
+					const point_t pt( x + 0.5, y + 0.5 );
+					if( apply( ops[k], inside( a, pt ), inside( b, pt ) ) ) { cells += 1.0; }
+				}
+			}
+			CHECK( std::fabs( area( result ) - cells ) < 1e-9 );
+		}
+
+		// no ring visits a point twice
+		for( unsigned int r = 0; r < result.size( ); ++r ) {
+			std::set<std::pair<double,double>> seen;
+			for( unsigned int i = 0; i < result[r].size( ); ++i ) {
+				seen.insert( std::make_pair( result[r][i].x, result[r][i].y ) );
+			}
+			CHECK( seen.size( ) == result[r].size( ) );
+		}
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+	for( unsigned int trial = 0; trial < 400; ++trial ) {
+		rings_t a, b;
+		switch( trial % 4 ) {
+		case 0: { // two squares at integer offsets, sharing edges and corners
+			const int s = 2 + gen( ) % 4;
+			const int dx = gen( ) % ( s + 1 ), dy = gen( ) % ( s + 1 );
+			a.push_back( rect( 0, 0, s, s ) );
+			b.push_back( rect( dx, dy, dx + s, dy + s ) );
+			check_ops( a, b, -1.0, 12.0, true );
+			break;
+		}
+		case 1: { // sets of rectangles on a grid, vertices on edges and
+		          //   overlapping edges within each polygon
+			for( unsigned int w = 0; w < 2; ++w ) {
+				rings_t& rings = w == 0 ? a : b;
+				const unsigned int count = 1 + gen( ) % 4;
+				for( unsigned int i = 0; i < count; ++i ) {
+					const int l = gen( ) % 8, t = gen( ) % 8;
+					rings.push_back( rect( l, t, l + 1 + gen( ) % 4, t + 1 + gen( ) % 4 ) );
+				}
+			}
+			check_ops( a, b, -1.0, 13.0, true );
+			break;
+		}
+		case 2: { // a square and a rotated, shifted copy
+			const double angle = unit( gen ) * 2.0 * EUCLIB_PI;
+			const double c = std::cos( angle ), s = std::sin( angle );
+			const double dx = unit( gen ) - 0.5, dy = unit( gen ) - 0.5;
+			ring_t ring = rect( -1.0, -1.0, 1.0, 1.0 );
+			a.push_back( ring );
+			for( unsigned int i = 0; i < ring.size( ); ++i ) {
+				ring[i] = point_t( c * ring[i].x - s * ring[i].y + dx, s * ring[i].x + c * ring[i].y + dy );
+			}
+			b.push_back( ring );
+			check_ops( a, b, -2.0, 2.0, false );
+			break;
+		}
+		default: // star shaped polygons
+			for( unsigned int w = 0; w < 2; ++w ) {
+				ring_t ring;
+				const unsigned int n = 3 + gen( ) % 12;
+				const double cx = unit( gen ), cy = unit( gen );
+				for( unsigned int i = 0; i < n; ++i ) {
+					const double angle = 2.0 * EUCLIB_PI * i / n, radius = 0.2 + unit( gen );
+					ring.push_back( point_t( cx + radius * std::cos( angle ), cy + radius * std::sin( angle ) ) );
+				}
+				( w == 0 ? a : b ).push_back( ring );
+			}
+			check_ops( a, b, -2.0, 2.0, false );
+		}
+	}
+
+	// apart or empty inputs given clockwise still come out counter-clockwise
+	{
+		rings_t a( 1, rect( 0, 2, 2, 0 ) ), b( 1, rect( 5, 6, 6, 5 ) ), none, result;
+		combine( a, b, op_union, result );
+		CHECK( result.size( ) == 2 );
+		for( unsigned int r = 0; r < result.size( ); ++r ) { CHECK( ring_area( result[r] ) > 0.0 ); }
+		combine( a, b, op_difference, result );
+		CHECK( result.size( ) == 1 && ring_area( result[0] ) == 4.0 );
+		combine( a, b, op_intersection, result );
+		CHECK( result.empty( ) );
+		combine( none, b, op_xor, result );
+		CHECK( result.size( ) == 1 && ring_area( result[0] ) == 1.0 );
+	}
+
+	// winding fill rules, two overlapping counter-clockwise squares and a
+	//   clockwise one inside both
+	{
+		rings_t a, none, result;
+		a.push_back( rect( 0, 0, 4, 4 ) );
+		a.push_back( rect( 2, 2, 6, 6 ) );
+		a.push_back( rect( 2, 3, 3, 2 ) );
+		combine( a, none, op_union, result );
+		CHECK( std::fabs( area( result ) - 25.0 ) < 1e-9 );
+		combine( a, none, op_union, result, fill_nonzero );
+		CHECK( std::fabs( area( result ) - 28.0 ) < 1e-9 );
+		combine( a, none, op_union, result, fill_positive );
+		CHECK( std::fabs( area( result ) - 28.0 ) < 1e-9 );
+		a.erase( a.begin( ), a.begin( ) + 2 );
+		combine( a, none, op_union, result, fill_nonzero );
+		CHECK( std::fabs( area( result ) - 1.0 ) < 1e-9 );
+		combine( a, none, op_union, result, fill_positive );
+		CHECK( result.empty( ) );
+	}
+
+	// many polygons merged in pairs
+	{
+		std::vector<rings_t> polys;
+		for( unsigned int i = 0; i < 20; ++i ) {
+			const int l = gen( ) % 10, t = gen( ) % 10;
+			polys.push_back( rings_t( 1, rect( l, t, l + 1 + gen( ) % 3, t + 1 + gen( ) % 3 ) ) );
+		}
+		rings_t result;
+		combine( polys, result, 2 );
+		double cells = 0.0;
+		for( int x = 0; x < 13; ++x ) {
+			for( int y = 0; y < 13; ++y ) {
+				const point_t pt( x + 0.5, y + 0.5 );
+				bool in = false;
+				for( unsigned int i = 0; i < polys.size( ); ++i ) { in = in || inside( polys[i], pt ); }
+				if( in ) { cells += 1.0; }
+				CHECK( inside( result, pt ) == in );
+			}
+		}
+		CHECK( std::fabs( area( result ) - cells ) < 1e-9 );
+	}
+
+	return check_result( "boolean" );
+}
@@ -0,0 +1,57 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_TESTS_CHECK_HPP
+#define EUBLIB_TESTS_CHECK_HPP
+
+#include <iostream>
+
+/* Minimal checking for the tests under tests/, built and run by
+ *   'make check'. Each test is one program: CHECK( ) reports a failed
+ *   condition and counts it, and main( ) returns check_result( ) so a
+ *   failing test stops the run.
+ */
+
+namespace check {
+
+	inline unsigned int& failures( ) {
+		static unsigned int count = 0;
+		return count;
+	}
+
+	inline void report( bool passed, const char* expr, const char* file, int line ) {
+		if( !passed ) {
+			++failures( );
+			std::cerr << file << ":" << line << ": check failed: " << expr << "\n";
+		}
+	}
+
+} // End namespace check
+
+#define CHECK( expr ) check::report( ( expr ), #expr, __FILE__, __LINE__ )
+
+inline int check_result( const char* name ) {
+	if( check::failures( ) != 0 ) {
+		std::cerr << name << ": " << check::failures( ) << " failed\n";
+		return 1;
+	}
+	std::cout << name << ": ok\n";
+	return 0;
+}
+
+#endif // EUBLIB_TESTS_CHECK_HPP
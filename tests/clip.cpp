@@ -0,0 +1,254 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "../euclib_helper.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>       point_t;
+typedef std::vector<point_t> ring_t;
+
+// a star shaped ring round (cx,cy), concave unless 'convex'
+ring_t star( std::mt19937& gen, double cx, double cy, bool convex ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	const unsigned int n = 3 + gen( ) % 20;
+	ring_t ring;
+	for( unsigned int i = 0; i < n; ++i ) {
+		const double angle = 2.0 * EUCLIB_PI * ( i + 0.3 * unit( gen ) ) / n;
+		const double radius = convex ? 0.8 : 0.2 + unit( gen );
+		ring.push_back( point_t{ cx + radius * std::cos( angle ), cy + radius * std::sin( angle ) } );
+	}
+	return ring;
+}
+
+double area( const ring_t& ring, unsigned int first, unsigned int last ) {
+	double sum = 0.0;
+	for( unsigned int i = first, j = last - 1; i < last; j = i++ ) {
+		sum += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+	}
+	return sum / 2.0;
+}
+
+double area( const ring_t& ring ) { return area( ring, 0, ring.size( ) ); }
+
+// even-odd membership over ring[first, last)
+bool inside( const ring_t& ring, unsigned int first, unsigned int last, const point_t& pt ) {
+	bool in = false;
+	for( unsigned int i = first, j = last - 1; i < last; j = i++ ) {
+		if( ( ring[i].y > pt.y ) != ( ring[j].y > pt.y ) &&
+		    pt.x < ( ring[j].x - ring[i].x ) * ( pt.y - ring[i].y ) / ( ring[j].y - ring[i].y ) + ring[i].x ) {
+			in = !in;
+		}
+	}
+	return in;
+}
+
+bool inside( const ring_t& ring, const point_t& pt ) { return inside( ring, 0, ring.size( ), pt ); }
+
+bool inside( const rect2<double>& rect, const point_t& pt ) {
+	return rect.l < pt.x && pt.x < rect.r && rect.t < pt.y && pt.y < rect.b;
+}
+
+// distance from 'pt' to the nearest edge of ring[first, last)
+double boundary_distance( const ring_t& ring, unsigned int first, unsigned int last, const point_t& pt ) {
+	double best = std::numeric_limits<double>::max( );
+	for( unsigned int i = first, j = last - 1; i < last; j = i++ ) {
+		const point_t& a = ring[j];
+		const point_t& b = ring[i];
+		const double ex = b.x - a.x, ey = b.y - a.y, len = ex * ex + ey * ey;
+		double s = len > 0.0 ? ( ( pt.x - a.x ) * ex + ( pt.y - a.y ) * ey ) / len : 0.0;
+		s = std::min( 1.0, std::max( 0.0, s ) );
+		best = std::min( best, std::hypot( a.x + s * ex - pt.x, a.y + s * ey - pt.y ) );
+	}
+	return best;
+}
+
+double boundary_distance( const ring_t& ring, const point_t& pt ) {
+	return boundary_distance( ring, 0, ring.size( ), pt );
+}
+
+ring_t corners( const rect2<double>& rect ) {
+	ring_t ring;
+	ring.push_back( point_t{ rect.l, rect.t } );
+	ring.push_back( point_t{ rect.r, rect.t } );
+	ring.push_back( point_t{ rect.r, rect.b } );
+	ring.push_back( point_t{ rect.l, rect.b } );
+	return ring;
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	clipper<double> clip;
+
+	for( unsigned int trial = 0; trial < 300; ++trial ) {
+		const double l = unit( gen ) * 2.0 - 1.0, t = unit( gen ) * 2.0 - 1.0;
+		const rect2<double> rect( l, l + 0.2 + unit( gen ), t, t + 0.2 + unit( gen ) );
+		const ring_t convex = star( gen, unit( gen ) - 0.5, unit( gen ) - 0.5, true );
+		const ring_t concave = star( gen, unit( gen ) - 0.5, unit( gen ) - 0.5, false );
+		const ring_t other = star( gen, unit( gen ) - 0.5, unit( gen ) - 0.5, false );
+
+		// Sutherland-Hodgman, against a rect and a convex polygon2
+		ring_t to_rect, to_poly;
+		const bool hit_rect = clip.clip( convex, rect, to_rect );
+		const polygon2<double> region( corners( rect ) );
+		clip.clip( convex, region, to_poly );
+
+		// Greiner-Hormann, both concave
+		ring_t pieces;
+		std::vector<unsigned int> offsets;
+		clip.clip( concave, other, pieces, offsets );
+		CHECK( offsets.front( ) == 0 && offsets.back( ) == pieces.size( ) );
+
+		for( unsigned int k = 0; k < 300; ++k ) {
+			const point_t pt{ unit( gen ) * 4.0 - 2.0, unit( gen ) * 4.0 - 2.0 };
+			const bool near_rect = std::fabs( pt.x - rect.l ) < 1e-7 || std::fabs( pt.x - rect.r ) < 1e-7 ||
+			                       std::fabs( pt.y - rect.t ) < 1e-7 || std::fabs( pt.y - rect.b ) < 1e-7;
+			if( !near_rect && boundary_distance( convex, pt ) > 1e-7 &&
+			    ( to_rect.empty( ) || boundary_distance( to_rect, pt ) > 1e-7 ) ) {
+				const bool expect = inside( convex, pt ) && inside( rect, pt );
+				CHECK( hit_rect || !expect );
+				CHECK( ( hit_rect && inside( to_rect, pt ) ) == expect );
+				CHECK( ( to_poly.size( ) >= 3 && inside( to_poly, pt ) ) == expect );
+			}
+
+			if( boundary_distance( concave, pt ) > 1e-6 && boundary_distance( other, pt ) > 1e-6 ) {
+				bool in = false;
+				for( unsigned int p = 0; p + 1 < offsets.size( ); ++p ) {
+					in = in || inside( pieces, offsets[p], offsets[p + 1], pt );
+				}
+				CHECK( in == ( inside( concave, pt ) && inside( other, pt ) ) );
+			}
+		}
+
+		// a concave subject comes back joined along the rect, same area
+		ring_t joined;
+		if( clip.clip( concave, rect, joined ) ) {
+			double expect = 0.0;
+			clip.clip( concave, corners( rect ), pieces, offsets );
+			for( unsigned int p = 0; p + 1 < offsets.size( ); ++p ) {
+				expect += std::fabs( area( pieces, offsets[p], offsets[p + 1] ) );
+			}
+			CHECK( std::fabs( std::fabs( area( joined ) ) - expect ) < 1e-9 );
+		}
+	}
+
+	// a batch of rings against one tile matches clipping each alone
+	{
+		std::vector<ring_t> layer;
+		for( unsigned int i = 0; i < 200; ++i ) {
+			layer.push_back( star( gen, unit( gen ) * 4.0 - 2.0, unit( gen ) * 4.0 - 2.0, i % 2 == 0 ) );
+		}
+		const rect2<double> tile( -0.5, 0.7, -0.3, 0.9 );
+		ring_t vertices, one;
+		std::vector<unsigned int> offsets, source;
+		clip.clip( layer, tile, vertices, offsets, source );
+		CHECK( offsets.size( ) == source.size( ) + 1 );
+		unsigned int piece = 0;
+		for( unsigned int i = 0; i < layer.size( ); ++i ) {
+			if( !clip.clip( layer[i], tile, one ) ) { continue; }
+			CHECK( piece < source.size( ) && source[piece] == i );
+			if( piece >= source.size( ) ) { break; }
+			CHECK( std::fabs( area( vertices, offsets[piece], offsets[piece + 1] ) - area( one ) ) < 1e-12 );
+			++piece;
+		}
+		CHECK( piece == source.size( ) );
+	}
+
+	// segments against a rect and a convex polygon, against fine sampling
+	{
+		const rect2<double> rect( -0.5, 0.5, -0.4, 0.6 );
+		const polygon2<double> region( corners( rect ) );
+		for( unsigned int trial = 0; trial < 2000; ++trial ) {
+			const segment2<double> seg{ point_t{ unit( gen ) * 2.0 - 1.0, unit( gen ) * 2.0 - 1.0 },
+			                            point_t{ unit( gen ) * 2.0 - 1.0, unit( gen ) * 2.0 - 1.0 } };
+			double t0 = 2.0, t1 = -1.0;
+			for( unsigned int k = 0; k <= 1000; ++k ) {
+				const double s = k / 1000.0;
+				const point_t pt{ seg.pt1.x + s * ( seg.pt2.x - seg.pt1.x ), seg.pt1.y + s * ( seg.pt2.y - seg.pt1.y ) };
+				if( inside( rect, pt ) ) { t0 = std::min( t0, s ); t1 = std::max( t1, s ); }
+			}
+			segment2<double> to_rect, to_poly;
+			const bool hit = clip.clip( seg, rect, to_rect );
+			const bool hit_poly = clip.clip( seg, region, to_poly );
+			if( t1 - t0 > 0.01 ) {
+				CHECK( hit && hit_poly );
+				const double len = std::hypot( seg.pt2.x - seg.pt1.x, seg.pt2.y - seg.pt1.y );
+				const double got = std::hypot( to_rect.pt2.x - to_rect.pt1.x, to_rect.pt2.y - to_rect.pt1.y );
+				CHECK( std::fabs( got - ( t1 - t0 ) * len ) < 2e-3 * len );
+				CHECK( std::fabs( to_poly.pt1.x - to_rect.pt1.x ) < 1e-9 && std::fabs( to_poly.pt2.y - to_rect.pt2.y ) < 1e-9 );
+			}
+			else if( t1 < t0 ) {
+				// no sample inside, the clipped part if any is tiny
+				CHECK( !hit || std::hypot( to_rect.pt2.x - to_rect.pt1.x, to_rect.pt2.y - to_rect.pt1.y ) < 2e-3 * 3.0 );
+			}
+		}
+	}
+
+	// squares that only touch give nothing either way round, ones that
+	//   overlap give the overlap with the coordinates given
+	{
+		const ring_t square{ point_t{ 0.0, 0.0 }, point_t{ 2.0, 0.0 }, point_t{ 2.0, 2.0 }, point_t{ 0.0, 2.0 } };
+		const double touching[][4] = { { 2.0, 4.0, 0.0, 2.0 }, { 2.0, 4.0, 2.0, 4.0 }, { 2.0, 4.0, 1.0, 3.0 },
+		                               { 2.0, 4.0, 0.5, 1.5 }, { -1.0, 3.0, 2.0, 5.0 } };
+		ring_t pieces;
+		std::vector<unsigned int> offsets;
+		for( unsigned int i = 0; i < sizeof(touching) / sizeof(touching[0]); ++i ) {
+			const ring_t other = corners( rect2<double>( touching[i][0], touching[i][1], touching[i][2], touching[i][3] ) );
+			CHECK( !clip.clip( square, other, pieces, offsets ) && pieces.empty( ) && offsets.size( ) == 1 );
+			CHECK( !clip.clip( other, square, pieces, offsets ) && pieces.empty( ) && offsets.size( ) == 1 );
+		}
+		// a triangle touching the square at a vertex only
+		const ring_t point_touch{ point_t{ 2.0, 1.0 }, point_t{ 4.0, 0.0 }, point_t{ 4.0, 2.0 } };
+		CHECK( !clip.clip( square, point_touch, pieces, offsets ) && pieces.empty( ) );
+
+		const double overlapping[][5] = { { 1.0, 3.0, 0.0, 2.0, 2.0 }, { 0.0, 2.0, 0.0, 2.0, 4.0 }, { 0.0, 1.0, 0.0, 1.0, 1.0 } };
+		for( unsigned int i = 0; i < sizeof(overlapping) / sizeof(overlapping[0]); ++i ) {
+			const rect2<double> rect( overlapping[i][0], overlapping[i][1], overlapping[i][2], overlapping[i][3] );
+			for( unsigned int swap = 0; swap < 2; ++swap ) {
+				const bool hit = swap == 0 ? clip.clip( square, corners( rect ), pieces, offsets )
+				                           : clip.clip( corners( rect ), square, pieces, offsets );
+				CHECK( hit && offsets.size( ) == 2 && area( pieces ) == overlapping[i][4] );
+				bool exact = true;
+				for( unsigned int p = 0; p < pieces.size( ); ++p ) {
+					exact = exact && ( pieces[p].x == rect.l || pieces[p].x == std::min( rect.r, 2.0 ) ) &&
+					                 ( pieces[p].y == rect.t || pieces[p].y == std::min( rect.b, 2.0 ) );
+				}
+				CHECK( exact );
+			}
+		}
+	}
+
+	// overlap( rect2, polygon2 ), repeated to reuse the clipper
+	{
+		const polygon2<int> poly( point2<int>{ 0, 0 }, point2<int>{ 10, 0 }, point2<int>{ 10, 10 }, point2<int>{ 0, 10 } );
+		for( unsigned int i = 0; i < 3; ++i ) {
+			const polygon2<int> both = overlap( rect2<int>( 5, 15, -5, 5 ), poly );
+			CHECK( both.size( ) == 4 && both.bounding_box( ) == rect2<int>( 5, 10, 0, 5 ) );
+		}
+		CHECK( overlap( rect2<int>( 20, 30, 0, 10 ), poly ) == polygon2<int>::null( ) );
+		CHECK( overlap( poly, rect2<int>( -5, 20, -5, 20 ) ).bounding_box( ) == poly.bounding_box( ) );
+	}
+
+	return check_result( "clip" );
+}
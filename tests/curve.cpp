@@ -0,0 +1,191 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <utility>
+
+#include "../curve.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// bit b of cell[a] to bit b * D + ( D - 1 - a ), one bit at a time
+template<std::size_t D>
+uint64_t brute_morton( const std::array<uint32_t,D>& cell, unsigned int bits ) {
+	uint64_t key = 0;
+	for( unsigned int b = 0; b < bits; ++b ) {
+		for( std::size_t a = 0; a < D; ++a ) {
+			key |= uint64_t( ( cell[a] >> b ) & 1 ) << ( b * D + ( D - 1 - a ) );
+		}
+	}
+	return key;
+}
+
+template<std::size_t D>
+void check_morton( std::mt19937& gen ) {
+	const unsigned int bits = curve_box<double,D>::bits;
+	for( unsigned int i = 0; i < 10000; ++i ) {
+		std::array<uint32_t,D> cell;
+		for( std::size_t a = 0; a < D; ++a ) {
+			cell[a] = bits == 32 ? uint32_t( gen( ) ) : uint32_t( gen( ) ) & ( ( 1u << bits ) - 1 );
+		}
+		CHECK( detail::interleave<D>( cell, bits ) == brute_morton<D>( cell, bits ) );
+	}
+}
+
+// every cell of a 2^bits grid gets its own key below 2^( bits * D ), and
+//   cells next in key order are next to each other in space
+template<std::size_t D, typename Index>
+void check_walk( unsigned int bits, Index index ) {
+	const uint64_t cells = uint64_t(1) << ( bits * D );
+	std::vector<std::array<uint32_t,D>> by_key( cells );
+	std::vector<bool> seen( cells, false );
+	bool unique = true;
+	for( uint64_t i = 0; i < cells; ++i ) {
+		std::array<uint32_t,D> cell;
+		for( std::size_t a = 0; a < D; ++a ) { cell[a] = ( i >> ( a * bits ) ) & ( ( 1u << bits ) - 1 ); }
+		const uint64_t key = index( cell );
+		if( key >= cells || seen[key] ) { unique = false; continue; }
+		seen[key] = true;
+		by_key[key] = cell;
+	}
+	CHECK( unique );
+	unsigned int jumps = 0;
+	for( uint64_t k = 1; unique && k < cells; ++k ) {
+		unsigned int steps = 0;
+		for( std::size_t a = 0; a < D; ++a ) {
+			steps += by_key[k][a] > by_key[k - 1][a] ? by_key[k][a] - by_key[k - 1][a] : by_key[k - 1][a] - by_key[k][a];
+		}
+		jumps += steps != 1;
+	}
+	CHECK( jumps == 0 );
+}
+
+// stable sorting, against std::stable_sort of ( key, value ) pairs
+template<typename K>
+void check_radix( std::mt19937& gen ) {
+	const unsigned int sizes[] = { 0, 1, 2, 100, 5000, 200000 };
+	for( unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s ) {
+		for( unsigned int mode = 0; mode < 3; ++mode ) {
+			std::vector<K> keys( sizes[s] );
+			std::vector<unsigned int> values( sizes[s] );
+			std::vector<std::pair<K, unsigned int>> expect( sizes[s] );
+			for( unsigned int i = 0; i < keys.size( ); ++i ) {
+				K key = K( ( uint64_t( gen( ) ) << 32 ) | gen( ) );
+				// few distinct keys, or high bytes every key shares
+				if( mode == 1 ) { key %= 7; }
+				if( mode == 2 ) { key = K( ( ~K(0) << 12 ) | ( key & 0x0F0F ) ); }
+				keys[i] = key;
+				values[i] = i;
+				expect[i] = std::make_pair( key, i );
+			}
+			std::stable_sort( expect.begin( ), expect.end( ),
+			                  []( const std::pair<K, unsigned int>& a, const std::pair<K, unsigned int>& b ) {
+			                      return a.first < b.first; } );
+			radix_sort( keys, values, 1 + ( s + mode ) % 4 );
+			bool same = keys.size( ) == expect.size( ) && values.size( ) == expect.size( );
+			for( unsigned int i = 0; same && i < keys.size( ); ++i ) {
+				same = keys[i] == expect[i].first && values[i] == expect[i].second;
+			}
+			CHECK( same );
+		}
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+
+	// Morton keys, by the 2 and 3 axis specializations and in general
+	check_morton<2>( gen );
+	check_morton<3>( gen );
+	check_morton<4>( gen );
+	check_morton<5>( gen );
+
+	// Hilbert keys walk the whole grid a cell at a time
+	for( unsigned int bits = 1; bits <= 6; ++bits ) {
+		check_walk<2>( bits, [&]( const std::array<uint32_t,2>& c ) { return detail::hilbert_index<2>( c, bits ); } );
+	}
+	for( unsigned int bits = 1; bits <= 4; ++bits ) {
+		check_walk<3>( bits, [&]( const std::array<uint32_t,3>& c ) { return detail::hilbert_index<3>( c, bits ); } );
+	}
+	check_walk<4>( 2, [&]( const std::array<uint32_t,4>& c ) { return detail::hilbert_index<4>( c, 2 ); } );
+
+	// the 16 bit grid curve: its first 4^6 keys fill a 64 x 64 corner
+	check_walk<2>( 6, [&]( const std::array<uint32_t,2>& c ) { return uint64_t( detail::hilbert_index( c[0], c[1] ) ); } );
+
+	// cells are clamped to the box, a flat axis maps to cell 0
+	{
+		const curve_box<double,2> box( point<double,2>( 0.0, 5.0 ), point<double,2>( 1.0, 5.0 ) );
+		const uint32_t top = ~0u;
+		CHECK( box.cell( point<double,2>( -1.0, 0.0 ) )[0] == 0 && box.cell( point<double,2>( 2.0, 7.0 ) )[0] == top );
+		CHECK( box.cell( point<double,2>( 0.5, 9.0 ) )[1] == 0 && box.cell( point<double,2>( 1.0, 5.0 ) )[0] == top );
+		CHECK( ( curve_box<double,3>::bits == 21 && curve_box<double,2>::bits == 32 ) );
+	}
+
+	// keys of a whole vector, and sorting points along either curve
+	{
+		std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+		std::vector<point<double,3>> points( 20000 );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = point<double,3>( unit( gen ), unit( gen ), unit( gen ) ); }
+		const curve_box<double,3> box( points );
+		for( int c = 0; c < 2; ++c ) {
+			const curve_type curve = c == 0 ? morton_curve : hilbert_curve;
+			std::vector<uint64_t> keys;
+			curve_keys( points, box, keys, curve, 3 );
+			bool same = keys.size( ) == points.size( );
+			for( unsigned int i = 0; same && i < points.size( ); ++i ) {
+				same = keys[i] == ( c == 0 ? morton_key( points[i], box ) : hilbert_key( points[i], box ) );
+			}
+			CHECK( same );
+
+			std::vector<unsigned int> order;
+			spatial_order( points, order, curve, 2 );
+			std::vector<unsigned int> sorted( order );
+			std::sort( sorted.begin( ), sorted.end( ) );
+			bool permutation = sorted.size( ) == points.size( ), ordered = true;
+			for( unsigned int i = 0; permutation && i < sorted.size( ); ++i ) { permutation = sorted[i] == i; }
+			for( unsigned int i = 1; permutation && i < order.size( ); ++i ) {
+				ordered = ordered && ( keys[order[i - 1]] < keys[order[i]] ||
+				                       ( keys[order[i - 1]] == keys[order[i]] && order[i - 1] < order[i] ) );
+			}
+			CHECK( permutation && ordered );
+
+			std::vector<point<double,3>> moved( points );
+			std::vector<unsigned int> payload( points.size( ) );
+			for( unsigned int i = 0; i < payload.size( ); ++i ) { payload[i] = i; }
+			spatial_sort( moved, payload, curve, 4 );
+			CHECK( payload == order );
+			bool followed = true;
+			for( unsigned int i = 0; followed && i < moved.size( ); ++i ) { followed = moved[i] == points[order[i]]; }
+			CHECK( followed );
+
+			moved = points;
+			spatial_sort( moved, curve, 1 );
+			followed = true;
+			for( unsigned int i = 0; followed && i < moved.size( ); ++i ) { followed = moved[i] == points[order[i]]; }
+			CHECK( followed );
+		}
+	}
+
+	check_radix<uint32_t>( gen );
+	check_radix<uint64_t>( gen );
+
+	return check_result( "curve" );
+}
@@ -0,0 +1,142 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <set>
+#include <array>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "../delaunay.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef std::vector<point2<double>>  points_t;
+typedef std::array<unsigned int,3>   triangle_t;
+
+// every triangle, rotated to start at its smallest index
+std::set<triangle_t> triangle_set( const delaunay<double>& dt ) {
+	std::set<triangle_t> result;
+	const std::vector<unsigned int>& tris = dt.triangles( );
+	for( unsigned int i = 0; i < tris.size( ); i += 3 ) {
+		triangle_t t = {{ tris[i], tris[i+1], tris[i+2] }};
+		std::rotate( t.begin( ), std::min_element( t.begin( ), t.end( ) ), t.end( ) );
+		result.insert( t );
+	}
+	return result;
+}
+
+// half edge links, orientation, hull and, against every point, the
+//   empty circumcircle property
+void check_triangulation( const points_t& points, const delaunay<double>& dt, bool empty_circle ) {
+	const std::vector<unsigned int>& tris = dt.triangles( );
+	const std::vector<unsigned int>& halves = dt.halfedges( );
+	CHECK( tris.size( ) == halves.size( ) );
+
+	unsigned int hull_edges = 0;
+	for( unsigned int e = 0; e < halves.size( ); ++e ) {
+		const unsigned int o = halves[e];
+		if( o == delaunay<double>::npos ) { ++hull_edges; continue; }
+		CHECK( halves[o] == e );
+		CHECK( tris[o] == tris[delaunay<double>::next_halfedge( e )] );
+	}
+	std::vector<unsigned int> hull;
+	dt.hull( hull );
+	CHECK( hull.size( ) == hull_edges );
+
+	for( unsigned int i = 0; i < tris.size( ); i += 3 ) {
+		const point2<double>& a = points[tris[i]];
+		const point2<double>& b = points[tris[i+1]];
+		const point2<double>& c = points[tris[i+2]];
+		CHECK( orient2d( a.x, a.y, b.x, b.y, c.x, c.y ) > 0 );
+		if( !empty_circle ) { continue; }
+		unsigned int inside = 0;
+		for( unsigned int j = 0; j < points.size( ); ++j ) {
+			if( incircle( a.x, a.y, b.x, b.y, c.x, c.y, points[j].x, points[j].y ) > 0 ) { ++inside; }
+		}
+		CHECK( inside == 0 );
+	}
+
+	// every distinct point is a vertex
+	std::set<std::pair<double,double>> distinct, used;
+	for( unsigned int i = 0; i < points.size( ); ++i ) { distinct.insert( std::make_pair( points[i].x, points[i].y ) ); }
+	for( unsigned int i = 0; i < tris.size( ); ++i ) { used.insert( std::make_pair( points[tris[i]].x, points[tris[i]].y ) ); }
+	CHECK( tris.empty( ) || used.size( ) == distinct.size( ) );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( -1.0, 1.0 );
+
+	// small sets of each awkward kind against brute force
+	for( unsigned int trial = 0; trial < 40; ++trial ) {
+		points_t points;
+		const unsigned int n = 3 + gen( ) % 300;
+		for( unsigned int i = 0; i < n; ++i ) {
+			switch( trial % 5 ) {
+			case 0: // uniform
+				points.push_back( point2<double>( unit( gen ), unit( gen ) ) );
+				break;
+			case 1: // integer grid with duplicates
+				points.push_back( point2<double>( gen( ) % 12, gen( ) % 12 ) );
+				break;
+			case 2: { // cocircular
+				const double a = ( gen( ) % 64 ) * EUCLIB_PI / 32;
+				points.push_back( point2<double>( std::cos( a ), std::sin( a ) ) );
+				break;
+			}
+			case 3: { // mostly collinear
+				const double a = unit( gen );
+				points.push_back( point2<double>( a, a * 0.5 ) );
+				if( i % 10 == 0 ) { points.push_back( point2<double>( unit( gen ), unit( gen ) ) ); }
+				break;
+			}
+			default: // nearly flat
+				points.push_back( point2<double>( gen( ) % 4, ( gen( ) % 3 ) * 1e-30 ) );
+			}
+		}
+		check_triangulation( points, delaunay<double>( points, 1 ), true );
+	}
+
+	// collinear and tiny inputs have no triangles
+	{
+		points_t points;
+		for( unsigned int i = 0; i < 10; ++i ) { points.push_back( point2<double>( i, 2.0 * i ) ); }
+		CHECK( delaunay<double>( points ).empty( ) );
+		points.resize( 2 );
+		CHECK( delaunay<double>( points ).empty( ) );
+	}
+
+	// the strip-parallel build gives the serial triangulation
+	for( unsigned int kind = 0; kind < 2; ++kind ) {
+		points_t points( 100000 ); // enough for three strips
+		for( unsigned int i = 0; i < points.size( ); ++i ) {
+			if( kind == 0 ) { points[i] = point2<double>( unit( gen ), unit( gen ) ); }
+			else            { points[i] = point2<double>( gen( ) % 400, gen( ) % 400 ); }
+		}
+		const delaunay<double> serial( points, 1 );
+		const delaunay<double> parallel( points, 3 );
+		check_triangulation( points, serial, false );
+		check_triangulation( points, parallel, false );
+		CHECK( triangle_set( serial ) == triangle_set( parallel ) );
+	}
+
+	return check_result( "delaunay" );
+}
@@ -0,0 +1,181 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+
+#include "../kd_tree.hpp"
+#include "../packed_rtree.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// written next to wherever the test runs, removed at the end
+static const char* const path = "index_file.tmp";
+
+// flips one byte of the file at 'offset'
+bool corrupt( long offset ) {
+	std::FILE* file = std::fopen( path, "r+b" );
+	if( !file ) { return false; }
+	bool ok = std::fseek( file, offset, SEEK_SET ) == 0;
+	const int c = ok ? std::fgetc( file ) : EOF;
+	ok = c != EOF && std::fseek( file, offset, SEEK_SET ) == 0 && std::fputc( c ^ 0x5A, file ) != EOF;
+	return std::fclose( file ) == 0 && ok;
+}
+
+// cuts the file down to its first 'bytes'
+bool shorten( long bytes ) {
+	std::FILE* file = std::fopen( path, "rb" );
+	if( !file ) { return false; }
+	std::vector<char> data( bytes );
+	const bool ok = std::fread( data.data( ), 1, bytes, file ) == std::size_t(bytes);
+	std::fclose( file );
+	file = std::fopen( path, "wb" );
+	return ok && file && std::fwrite( data.data( ), 1, bytes, file ) == std::size_t(bytes) && std::fclose( file ) == 0;
+}
+
+// the same answers from a built tree and its mapped copy
+template<typename T, std::size_t D>
+bool same_answers( const kd_tree<T,D>& built, const kd_tree<T,D>& opened, std::mt19937& gen ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	bool same = built.size( ) == opened.size( ) && built.depth( ) == opened.depth( ) &&
+	            built.bucket_size( ) == opened.bucket_size( );
+	typename kd_tree<T,D>::neighbours_t n1, n2;
+	std::vector<unsigned int> r1, r2;
+	for( unsigned int q = 0; same && q < 100; ++q ) {
+		point<T,D> pt, hi;
+		for( std::size_t a = 0; a < D; ++a ) { pt[a] = T( unit( gen ) ); hi[a] = pt[a] + T(0.2); }
+		built.nearest( pt, 1 + q % 8, n1 );
+		opened.nearest( pt, 1 + q % 8, n2 );
+		same = n1 == n2 && built.nearest( pt ) == opened.nearest( pt );
+		r1.clear( ); r2.clear( );
+		built.radius( pt, T(0.15), r1 );
+		opened.radius( pt, T(0.15), r2 );
+		same = same && r1 == r2;
+		r1.clear( ); r2.clear( );
+		built.search( pt, hi, r1 );
+		opened.search( pt, hi, r2 );
+		same = same && r1 == r2;
+	}
+	return same;
+}
+
+template<typename T>
+bool same_answers( const packed_rtree<T>& built, const packed_rtree<T>& opened, std::mt19937& gen ) {
+	bool same = built.size( ) == opened.size( ) && built.node_size( ) == opened.node_size( ) &&
+	            built.bounding_box( ) == opened.bounding_box( );
+	std::vector<unsigned int> r1, r2;
+	for( unsigned int q = 0; same && q < 100; ++q ) {
+		const T x = T( gen( ) % 1000 ), y = T( gen( ) % 1000 );
+		const rect2<T> window( x, x + T(100), y, y + T(100) );
+		r1.clear( ); r2.clear( );
+		built.search( window, r1 );
+		opened.search( window, r2 );
+		same = r1 == r2;
+		built.nearest( point2<T>( x, y ), 1 + q % 8, r1 );
+		opened.nearest( point2<T>( x, y ), 1 + q % 8, r2 );
+		same = same && r1 == r2;
+	}
+	return same;
+}
+
+template<typename T, std::size_t D>
+void check_kd_tree( std::mt19937& gen, unsigned int count ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	std::vector<point<T,D>> points( count );
+	for( unsigned int i = 0; i < count; ++i ) {
+		for( std::size_t a = 0; a < D; ++a ) { points[i][a] = T( unit( gen ) ); }
+	}
+	const kd_tree<T,D> built( points, 1 + count % 9 );
+	CHECK( built.save( path ) && !built.mapped( ) );
+
+	kd_tree<T,D> opened;
+	CHECK( opened.open( path ) && opened.mapped( ) && same_answers( built, opened, gen ) );
+	const kd_tree<T,D> verified( path, true );
+	CHECK( verified.mapped( ) && same_answers( built, verified, gen ) );
+
+	// a copy keeps the mapping alive after the tree it came from is gone
+	kd_tree<T,D>* first = new kd_tree<T,D>( path );
+	const kd_tree<T,D> copy( *first );
+	delete first;
+	CHECK( copy.mapped( ) && same_answers( built, copy, gen ) );
+
+	// another kind or scalar type of index is refused, leaving the tree be
+	packed_rtree<double> other;
+	CHECK( !other.open( path ) && other.empty( ) && !other.mapped( ) );
+	kd_tree<T,D + 1> wider;
+	CHECK( !wider.open( path ) && wider.empty( ) );
+}
+
+template<typename T>
+void check_packed_rtree( std::mt19937& gen, unsigned int count ) {
+	std::vector<rect2<T>> boxes( count );
+	for( unsigned int i = 0; i < count; ++i ) {
+		const T x = T( gen( ) % 1000 ), y = T( gen( ) % 1000 );
+		boxes[i] = i % 29 == 3 ? rect2<T>::null( ) : rect2<T>( x, x + T( 1 + gen( ) % 20 ), y, y + T( 1 + gen( ) % 20 ) );
+	}
+	const packed_rtree<T> built( boxes, 2 + count % 15 );
+	CHECK( built.save( path ) && !built.mapped( ) );
+
+	packed_rtree<T> opened;
+	CHECK( opened.open( path ) && opened.mapped( ) && same_answers( built, opened, gen ) );
+	const packed_rtree<T> verified( path, true );
+	CHECK( verified.mapped( ) && same_answers( built, verified, gen ) );
+	kd_tree<double,2> other;
+	CHECK( !other.open( path ) && other.empty( ) );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	const unsigned int counts[] = { 0, 1, 10, 1000, 20000 };
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		check_kd_tree<double, 2>( gen, counts[c] );
+		check_kd_tree<float, 3>( gen, counts[c] );
+		check_packed_rtree<double>( gen, counts[c] );
+		check_packed_rtree<int>( gen, counts[c] );
+	}
+
+	// damage: a changed array passes the quick checks but not 'verify', a
+	//   changed header or table, or a short file, fails either way
+	{
+		std::vector<point<double,2>> points( 500 );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = point<double,2>( i * 0.5, i * 0.25 ); }
+		const kd_tree<double,2> built( points, 4 );
+		kd_tree<double,2> opened;
+
+		CHECK( built.save( path ) && corrupt( 1000 ) );
+		CHECK( opened.open( path ) && !opened.open( path, true ) && opened.size( ) == 500 );
+
+		const long header[] = { 0, 12, 20, 70, 100 };
+		for( unsigned int h = 0; h < sizeof(header) / sizeof(header[0]); ++h ) {
+			CHECK( built.save( path ) && corrupt( header[h] ) );
+			kd_tree<double,2> damaged;
+			CHECK( !damaged.open( path ) && damaged.empty( ) );
+		}
+
+		CHECK( built.save( path ) && shorten( 2000 ) );
+		CHECK( !opened.open( path ) && opened.size( ) == 500 );
+		CHECK( !opened.open( "no_such_index_file.tmp" ) && opened.size( ) == 500 );
+	}
+
+	std::remove( path );
+	return check_result( "index_file" );
+}
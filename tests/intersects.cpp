@@ -0,0 +1,125 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "../euclib_helper.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>   point_t;
+typedef polygon2<double> poly_t;
+
+// the hull of random points in a disc
+poly_t random_convex( std::mt19937& gen, double cx, double cy, double radius ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	std::vector<point_t> points( 3 + gen( ) % 20 );
+	for( unsigned int i = 0; i < points.size( ); ++i ) {
+		const double angle = 2.0 * EUCLIB_PI * unit( gen ), r = radius * std::sqrt( unit( gen ) );
+		points[i] = point_t{ cx + r * std::cos( angle ), cy + r * std::sin( angle ) };
+	}
+	return poly_t( points );
+}
+
+poly_t moved( const poly_t& poly, double dx, double dy ) {
+	std::vector<point_t> points( poly.size( ) );
+	for( unsigned int i = 0; i < poly.size( ); ++i ) { points[i] = point_t{ poly[i].x + dx, poly[i].y + dy }; }
+	return poly_t( points );
+}
+
+// how far the second has to move along each outward edge normal to
+//   leave the first, the least of which is the penetration depth
+double least_overlap( const poly_t& a, const poly_t& b ) {
+	double best = std::numeric_limits<double>::max( );
+	const poly_t* polys[2] = { &a, &b };
+	for( unsigned int p = 0; p < 2; ++p ) {
+		const poly_t& poly = *polys[p];
+		const poly_t& other = *polys[1 - p];
+		for( unsigned int i = 0, j = poly.size( ) - 1; i < poly.size( ); j = i++ ) {
+			const double nx = poly[i].y - poly[j].y, ny = poly[j].x - poly[i].x;
+			const double len = std::sqrt( nx * nx + ny * ny );
+			if( len == 0.0 ) { continue; }
+			double hi = -1e300, lo = 1e300;
+			for( unsigned int k = 0; k < poly.size( ); ++k ) { hi = std::max( hi, ( nx * poly[k].x + ny * poly[k].y ) / len ); }
+			for( unsigned int k = 0; k < other.size( ); ++k ) { lo = std::min( lo, ( nx * other[k].x + ny * other[k].y ) / len ); }
+			best = std::min( best, hi - lo );
+		}
+	}
+	return best;
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+	// against the overlap, and the penetration against every edge normal
+	unsigned int hits = 0;
+	for( unsigned int trial = 0; trial < 2000; ++trial ) {
+		const poly_t a = random_convex( gen, unit( gen ), unit( gen ), 0.1 + unit( gen ) );
+		const poly_t b = random_convex( gen, 2.0 * unit( gen ), 2.0 * unit( gen ), 0.1 + unit( gen ) );
+		const bool touching = overlap( a, b ) != poly_t::null( );
+		CHECK( intersects( a, b ) == touching );
+		CHECK( intersects( b, a ) == touching );
+
+		penetration pen;
+		CHECK( intersects( a, b, pen ) == touching );
+		if( !touching ) { continue; }
+		++hits;
+		CHECK( std::fabs( pen.depth - least_overlap( a, b ) ) < 1e-4 );
+		CHECK( std::fabs( pen.normal.x * pen.normal.x + pen.normal.y * pen.normal.y - 1.0f ) < 1e-4 );
+		// moving the second along the normal by the depth just separates them
+		const double push = pen.depth + 1e-4;
+		CHECK( !intersects( a, moved( b, pen.normal.x * push, pen.normal.y * push ) ) );
+		if( pen.depth > 1e-2 ) {
+			const double part = pen.depth - 1e-3;
+			CHECK( intersects( a, moved( b, pen.normal.x * part, pen.normal.y * part ) ) );
+		}
+	}
+	CHECK( hits > 200 );
+
+	// a kept axis gives the same answers as a fresh one while moving
+	{
+		const poly_t a = random_convex( gen, 0.0, 0.0, 1.0 );
+		const poly_t b = random_convex( gen, 0.0, 0.0, 1.0 );
+		separating_axis axis;
+		for( unsigned int step = 0; step < 400; ++step ) {
+			const double x = 3.0 * std::cos( step * 0.05 ), y = 2.0 * std::sin( step * 0.03 );
+			const poly_t c = moved( b, x, y );
+			CHECK( intersects( a, c, axis ) == intersects( a, c ) );
+		}
+	}
+
+	// integral coordinates, touching corners count as intersecting
+	{
+		typedef polygon2<int> ipoly_t;
+		const ipoly_t a( point2<int>{ 0, 0 }, point2<int>{ 10, 0 }, point2<int>{ 10, 10 }, point2<int>{ 0, 10 } );
+		const ipoly_t b( point2<int>{ 8, 3 }, point2<int>{ 18, 3 }, point2<int>{ 18, 13 }, point2<int>{ 8, 13 } );
+		const ipoly_t c( point2<int>{ 10, 10 }, point2<int>{ 20, 10 }, point2<int>{ 20, 20 }, point2<int>{ 10, 20 } );
+		const ipoly_t d( point2<int>{ 11, 0 }, point2<int>{ 20, 0 }, point2<int>{ 20, 9 }, point2<int>{ 11, 9 } );
+		penetration pen;
+		CHECK( intersects( a, b, pen ) );
+		CHECK( pen.depth == 2.0f && pen.normal.x == 1.0f && pen.normal.y == 0.0f );
+		CHECK( intersects( a, c ) );
+		CHECK( !intersects( a, d ) );
+	}
+
+	return check_result( "intersects" );
+}
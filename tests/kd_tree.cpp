@@ -0,0 +1,136 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "../kd_tree.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// small integral coordinates so many points tie on distance and on the
+//   box and radius edges
+template<typename T, std::size_t D>
+point<T,D> random_point( std::mt19937& gen, unsigned int range ) {
+	point<T,D> pt;
+	for( std::size_t a = 0; a < D; ++a ) { pt[a] = T( gen( ) % range ); }
+	return pt;
+}
+
+template<typename T, std::size_t D>
+T distance_sq( const point<T,D>& p1, const point<T,D>& p2 ) {
+	T sum = T( );
+	for( std::size_t a = 0; a < D; ++a ) { sum += ( p1[a] - p2[a] ) * ( p1[a] - p2[a] ); }
+	return sum;
+}
+
+template<typename T, std::size_t D>
+void check_tree( const kd_tree<T,D>& tree, const std::vector<point<T,D>>& points,
+                 std::mt19937& gen, unsigned int range ) {
+	CHECK( tree.size( ) == points.size( ) );
+	typename kd_tree<T,D>::neighbours_t result;
+	std::vector<unsigned int> found, expect;
+	for( unsigned int q = 0; q < 100; ++q ) {
+		const point<T,D> pt = random_point<T,D>( gen, range + 2 );
+
+		// the k nearest, by distance, every one within the limit
+		const unsigned int k = 1 + q % 12;
+		const T limit = q % 4 == 0 ? T( range / 4 ) : std::numeric_limits<T>::max( );
+		tree.nearest( pt, k, result, limit );
+		std::vector<T> distances;
+		for( unsigned int i = 0; i < points.size( ); ++i ) {
+			const T d = distance_sq( points[i], pt );
+			if( q % 4 != 0 || d <= limit * limit ) { distances.push_back( d ); }
+		}
+		std::sort( distances.begin( ), distances.end( ) );
+		CHECK( result.size( ) == std::min<std::size_t>( k, distances.size( ) ) );
+		for( unsigned int i = 0; i < result.size( ) && i < distances.size( ); ++i ) {
+			CHECK( result[i].first == distances[i] && distance_sq( points[result[i].second], pt ) == distances[i] );
+		}
+		// the single nearest, with no limit
+		if( !points.empty( ) ) {
+			T best = distance_sq( points[0], pt );
+			for( unsigned int i = 1; i < points.size( ); ++i ) { best = std::min( best, distance_sq( points[i], pt ) ); }
+			CHECK( distance_sq( points[tree.nearest( pt )], pt ) == best );
+		}
+
+		// every point within a radius, edges included
+		const T r = T( gen( ) % ( range / 2 + 1 ) );
+		found.clear( );
+		tree.radius( pt, r, found );
+		expect.clear( );
+		for( unsigned int i = 0; i < points.size( ); ++i ) {
+			if( distance_sq( points[i], pt ) <= r * r ) { expect.push_back( i ); }
+		}
+		std::sort( found.begin( ), found.end( ) );
+		CHECK( found == expect );
+
+		// every point in a box, edges included
+		point<T,D> lo = random_point<T,D>( gen, range ), hi = lo;
+		for( std::size_t a = 0; a < D; ++a ) { hi[a] += T( gen( ) % ( range / 2 + 1 ) ); }
+		found.clear( );
+		tree.search( lo, hi, found );
+		expect.clear( );
+		for( unsigned int i = 0; i < points.size( ); ++i ) {
+			bool in = true;
+			for( std::size_t a = 0; a < D; ++a ) { in = in && lo[a] <= points[i][a] && points[i][a] <= hi[a]; }
+			if( in ) { expect.push_back( i ); }
+		}
+		std::sort( found.begin( ), found.end( ) );
+		CHECK( found == expect );
+	}
+}
+
+template<typename T, std::size_t D>
+void check_type( std::mt19937& gen ) {
+	const unsigned int counts[] = { 0, 1, 2, 9, 100, 3000 };
+	const unsigned int buckets[] = { 1, 3, 8, 32 };
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		const unsigned int range = counts[c] < 100 ? 10 : 40;
+		std::vector<point<T,D>> points( counts[c] );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = random_point<T,D>( gen, range ); }
+		for( unsigned int b = 0; b < sizeof(buckets) / sizeof(buckets[0]); ++b ) {
+			const kd_tree<T,D> tree( points, buckets[b], 1 + b % 3 );
+			CHECK( tree.bucket_size( ) == buckets[b] );
+			CHECK( ( points.size( ) + ( 1u << tree.depth( ) ) - 1 ) >> tree.depth( ) <= buckets[b] );
+			check_tree( tree, points, gen, range );
+		}
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_type<double, 2>( gen );
+	check_type<float, 3>( gen );
+	check_type<double, 5>( gen );
+
+	// all points equal, nothing to split on
+	{
+		const std::vector<point<double,2>> points( 100, point<double,2>( 0.5, 0.5 ) );
+		const kd_tree<double,2> tree( points, 4 );
+		std::vector<unsigned int> found;
+		tree.radius( point<double,2>( 0.5, 0.5 ), 0.0, found );
+		CHECK( found.size( ) == 100 );
+		const kd_tree<double,2> none;
+		CHECK( none.empty( ) && none.nearest( point<double,2>( 0.0, 0.0 ) ) == none.npos );
+	}
+
+	return check_result( "kd_tree" );
+}
@@ -0,0 +1,172 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "../loose_quadtree.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// handle -> box, null for free handles
+typedef std::vector<rect2<double>> boxes_t;
+
+// mostly small boxes, some large, some reaching outside the world
+rect2<double> random_box( std::mt19937& gen ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	const double size = gen( ) % 10 == 0 ? 0.5 : 0.02;
+	const double x = unit( gen ) * 1.2 - 0.1, y = unit( gen ) * 1.2 - 0.1;
+	return rect2<double>( x, x + size * unit( gen ), y, y + size * unit( gen ) );
+}
+
+bool brute_overlap( const rect2<double>& a, const rect2<double>& b ) {
+	return a != rect2<double>::null( ) && a.l <= b.r && b.l <= a.r && a.t <= b.b && b.t <= a.b;
+}
+
+void check_tree( const loose_quadtree<double>& tree, const boxes_t& boxes, std::mt19937& gen ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	unsigned int live = 0;
+	for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+		const bool stored = boxes[h] != rect2<double>::null( );
+		live += stored;
+		CHECK( tree.contains( h ) == stored );
+		if( stored ) { CHECK( tree.box( h ) == boxes[h] && tree.depth( h ) <= tree.max_depth( ) ); }
+	}
+	CHECK( tree.size( ) == live );
+
+	// every node in use is visited once, and only the root may sit empty
+	unsigned int nodes = 0, objects = 0;
+	tree.visit_nodes( [&]( unsigned int depth, const rect2<double>&, unsigned int held, unsigned int children ) {
+		++nodes;
+		objects += held;
+		CHECK( depth == 0 || held > 0 || children > 0 );
+	} );
+	CHECK( nodes == tree.nodes( ) && objects == live );
+	std::vector<loose_quadtree<double>::level_stats> stats;
+	tree.stats( stats );
+	unsigned int stat_nodes = 0, stat_objects = 0;
+	for( unsigned int d = 0; d < stats.size( ); ++d ) {
+		stat_nodes += stats[d].nodes;
+		stat_objects += stats[d].objects;
+	}
+	CHECK( stats.size( ) == tree.max_depth( ) + 1 && stat_nodes == nodes && stat_objects == live );
+
+	std::vector<unsigned int> result, expect;
+	for( unsigned int q = 0; q < 30; ++q ) {
+		const double x = unit( gen ) * 1.2 - 0.1, y = unit( gen ) * 1.2 - 0.1;
+		const rect2<double> window( x, x + 0.2 * unit( gen ), y, y + 0.2 * unit( gen ) );
+		result.clear( );
+		tree.search( window, result );
+		expect.clear( );
+		for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+			if( brute_overlap( boxes[h], window ) ) { expect.push_back( h ); }
+		}
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result == expect );
+
+		const point2<double> pt( x, y );
+		result.clear( );
+		tree.search( pt, result );
+		expect.clear( );
+		for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+			if( brute_overlap( boxes[h], rect2<double>( x, x, y, y ) ) ) { expect.push_back( h ); }
+		}
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result == expect );
+	}
+}
+
+// random inserts, removes and moves against a plain array
+void check_random( std::mt19937& gen, unsigned int max_depth ) {
+	loose_quadtree<double> tree( rect2<double>( 0.0, 1.0, 0.0, 1.0 ), max_depth );
+	boxes_t boxes;
+	std::vector<unsigned int> live;
+	for( unsigned int step = 0; step < 5000; ++step ) {
+		const unsigned int op = gen( ) % 10;
+		if( op < 5 || live.empty( ) ) {
+			const rect2<double> box = random_box( gen );
+			const unsigned int h = tree.insert( box );
+			CHECK( h != tree.npos && !( h < boxes.size( ) && boxes[h] != rect2<double>::null( ) ) );
+			if( h >= boxes.size( ) ) { boxes.resize( h + 1, rect2<double>::null( ) ); }
+			boxes[h] = box;
+			live.push_back( h );
+		}
+		else if( op < 7 ) {
+			const unsigned int at = gen( ) % live.size( );
+			CHECK( tree.remove( live[at] ) );
+			CHECK( !tree.remove( live[at] ) );
+			boxes[live[at]] = rect2<double>::null( );
+			live[at] = live.back( );
+			live.pop_back( );
+		}
+		else {
+			// small nudges mostly stay in their node, the rest move anywhere
+			const unsigned int h = live[gen( ) % live.size( )];
+			rect2<double> box = random_box( gen );
+			if( op < 9 ) {
+				const double dx = ( boxes[h].l - box.l ) * 0.99, dy = ( boxes[h].t - box.t ) * 0.99;
+				box = rect2<double>( box.l + dx, box.r + dx, box.t + dy, box.b + dy );
+			}
+			CHECK( tree.update( h, box ) );
+			boxes[h] = box;
+		}
+		if( step % 500 == 0 ) { check_tree( tree, boxes, gen ); }
+	}
+	check_tree( tree, boxes, gen );
+
+	// everything removed gives the nodes back
+	for( unsigned int i = 0; i < live.size( ); ++i ) {
+		tree.remove( live[i] );
+		boxes[live[i]] = rect2<double>::null( );
+	}
+	CHECK( tree.empty( ) && tree.nodes( ) == 1 );
+	check_tree( tree, boxes, gen );
+	CHECK( tree.insert( rect2<double>::null( ) ) == tree.npos );
+	CHECK( !tree.update( 0, random_box( gen ) ) );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_random( gen, 0 );
+	check_random( gen, 3 );
+	check_random( gen, 8 );
+
+	// small boxes settle deep, a box the size of the world stays at the root
+	{
+		loose_quadtree<double> tree( rect2<double>( 0.0, 1.0, 0.0, 1.0 ), 6 );
+		const unsigned int small = tree.insert( rect2<double>( 0.3, 0.301, 0.6, 0.601 ) );
+		const unsigned int large = tree.insert( rect2<double>( 0.0, 1.0, 0.0, 1.0 ) );
+		CHECK( tree.depth( small ) == 6 && tree.depth( large ) == 0 );
+		tree.clear( );
+		CHECK( tree.empty( ) && tree.nodes( ) == 1 && !tree.contains( small ) );
+	}
+
+	// integral boxes
+	{
+		loose_quadtree<int> tree( rect2<int>( 0, 128, 0, 128 ), 5 );
+		for( int i = 0; i < 100; ++i ) { tree.insert( rect2<int>( i, i + 1, 0, 1 ) ); }
+		std::vector<unsigned int> result;
+		tree.search( rect2<int>( 10, 12, 1, 5 ), result );
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result.size( ) == 4 && result.front( ) == 9 && result.back( ) == 12 );
+	}
+
+	return check_result( "loose_quadtree" );
+}
@@ -0,0 +1,134 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "../euclib_helper.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>   point_t;
+typedef polygon2<double> poly_t;
+
+// the hull of random points in a disc
+poly_t random_convex( std::mt19937& gen, double cx, double cy, double radius ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	std::vector<point_t> points( 3 + gen( ) % 20 );
+	for( unsigned int i = 0; i < points.size( ); ++i ) {
+		const double angle = 2.0 * EUCLIB_PI * unit( gen ), r = radius * std::sqrt( unit( gen ) );
+		points[i] = point_t{ cx + r * std::cos( angle ), cy + r * std::sin( angle ) };
+	}
+	return poly_t( points );
+}
+
+// the hull of every pairwise vertex sum
+template<typename T>
+polygon2<T> brute_sum( const polygon2<T>& a, const polygon2<T>& b ) {
+	std::vector<point2<T>> points;
+	for( unsigned int i = 0; i < a.size( ); ++i ) {
+		for( unsigned int j = 0; j < b.size( ); ++j ) {
+			points.push_back( point2<T>{ a[i].x + b[j].x, a[i].y + b[j].y } );
+		}
+	}
+	return polygon2<T>( points );
+}
+
+double distance_to_edge( const point_t& a, const point_t& b, const point_t& pt ) {
+	const double ex = b.x - a.x, ey = b.y - a.y, len = ex * ex + ey * ey;
+	double s = len > 0.0 ? ( ( pt.x - a.x ) * ex + ( pt.y - a.y ) * ey ) / len : 0.0;
+	s = std::min( 1.0, std::max( 0.0, s ) );
+	return std::hypot( a.x + s * ex - pt.x, a.y + s * ey - pt.y );
+}
+
+// every vertex of 'a' lies on the boundary of 'b'
+bool on_boundary( const poly_t& a, const poly_t& b, double eps ) {
+	for( unsigned int i = 0; i < a.size( ); ++i ) {
+		double best = std::numeric_limits<double>::max( );
+		for( unsigned int k = 0, j = b.size( ) - 1; k < b.size( ); j = k++ ) {
+			best = std::min( best, distance_to_edge( b[j], b[k], a[i] ) );
+		}
+		if( best > eps ) { return false; }
+	}
+	return true;
+}
+
+// counter-clockwise and strictly convex, no collinear vertices
+bool strictly_convex( const poly_t& poly ) {
+	const unsigned int n = poly.size( );
+	for( unsigned int i = 0; i < n; ++i ) {
+		const point_t& a = poly[( i + n - 1 ) % n];
+		const point_t& b = poly[i];
+		const point_t& c = poly[( i + 1 ) % n];
+		if( ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x ) <= 0.0 ) { return false; }
+	}
+	return true;
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+	// the merged edges trace the hull of all n*m vertex sums
+	std::vector<poly_t> others;
+	for( unsigned int trial = 0; trial < 1000; ++trial ) {
+		const poly_t a = random_convex( gen, unit( gen ) * 4.0 - 2.0, unit( gen ) * 4.0 - 2.0, 0.1 + unit( gen ) );
+		const poly_t b = random_convex( gen, unit( gen ) * 4.0 - 2.0, unit( gen ) * 4.0 - 2.0, 0.1 + unit( gen ) );
+		const poly_t sum = minkowski_sum( a, b );
+		const poly_t brute = brute_sum( a, b );
+		CHECK( sum.size( ) <= a.size( ) + b.size( ) );
+		CHECK( strictly_convex( sum ) );
+		CHECK( sum.bounding_box( ) == brute.bounding_box( ) );
+		CHECK( on_boundary( sum, brute, 1e-12 ) && on_boundary( brute, sum, 1e-12 ) );
+		others.push_back( b );
+	}
+
+	// the batch matches one call per shape, reusing the results
+	{
+		const poly_t a = random_convex( gen, 0.0, 0.0, 1.0 );
+		others.push_back( poly_t::null( ) );
+		std::vector<poly_t> result;
+		for( unsigned int pass = 0; pass < 2; ++pass ) {
+			minkowski_sum( a, others, result );
+			CHECK( result.size( ) == others.size( ) );
+			for( unsigned int k = 0; k < others.size( ); ++k ) {
+				CHECK( result[k] == minkowski_sum( a, others[k] ) );
+			}
+		}
+		CHECK( result.back( ) == poly_t::null( ) );
+		CHECK( minkowski_sum( poly_t::null( ), a ) == poly_t::null( ) );
+	}
+
+	// integral coordinates, parallel edges merge into one
+	{
+		typedef polygon2<int> ipoly_t;
+		const ipoly_t square( point2<int>{ 0, 0 }, point2<int>{ 2, 0 }, point2<int>{ 2, 2 }, point2<int>{ 0, 2 } );
+		const ipoly_t triangle( point2<int>{ 0, 0 }, point2<int>{ 1, 0 }, point2<int>{ 0, 1 } );
+		const ipoly_t sum = minkowski_sum( square, triangle );
+		CHECK( sum.size( ) == 5 );
+		CHECK( sum.bounding_box( ) == rect2<int>( 0, 3, 0, 3 ) );
+		const point2<int> expect[5] = { point2<int>{ 0, 0 }, point2<int>{ 3, 0 }, point2<int>{ 3, 2 },
+		                                point2<int>{ 2, 3 }, point2<int>{ 0, 3 } };
+		for( unsigned int i = 0; i < 5 && i < sum.size( ); ++i ) { CHECK( sum[i] == expect[i] ); }
+		CHECK( minkowski_sum( square, square ).size( ) == 4 );
+	}
+
+	return check_result( "minkowski" );
+}
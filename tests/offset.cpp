@@ -0,0 +1,151 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <set>
+#include <cmath>
+
+#include "../offset.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>       point_t;
+typedef std::vector<point_t> ring_t;
+typedef std::vector<ring_t>  rings_t;
+
+double area( const rings_t& rings ) {
+	double total = 0.0;
+	for( unsigned int r = 0; r < rings.size( ); ++r ) {
+		const ring_t& ring = rings[r];
+		for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+			total += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+		}
+	}
+	return total / 2.0;
+}
+
+bool proper_cross( const point_t& a, const point_t& b, const point_t& c, const point_t& d ) {
+	const double d1 = ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+	const double d2 = ( b.x - a.x ) * ( d.y - a.y ) - ( b.y - a.y ) * ( d.x - a.x );
+	const double d3 = ( d.x - c.x ) * ( a.y - c.y ) - ( d.y - c.y ) * ( a.x - c.x );
+	const double d4 = ( d.x - c.x ) * ( b.y - c.y ) - ( d.y - c.y ) * ( b.x - c.x );
+	return ( ( d1 > 0 && d2 < 0 ) || ( d1 < 0 && d2 > 0 ) ) && ( ( d3 > 0 && d4 < 0 ) || ( d3 < 0 && d4 > 0 ) );
+}
+
+// no ring repeats a point and no two edges of any rings cross
+bool simple( const rings_t& rings ) {
+	std::vector<std::pair<point_t,point_t>> edges;
+	for( unsigned int r = 0; r < rings.size( ); ++r ) {
+		std::set<std::pair<double,double>> seen;
+		for( unsigned int i = 0; i < rings[r].size( ); ++i ) {
+			if( !seen.insert( std::make_pair( rings[r][i].x, rings[r][i].y ) ).second ) { return false; }
+			edges.push_back( std::make_pair( rings[r][i], rings[r][( i + 1 ) % rings[r].size( )] ) );
+		}
+	}
+	for( unsigned int i = 0; i < edges.size( ); ++i ) {
+		for( unsigned int j = i + 1; j < edges.size( ); ++j ) {
+			if( proper_cross( edges[i].first, edges[i].second, edges[j].first, edges[j].second ) ) { return false; }
+		}
+	}
+	return true;
+}
+
+int main( ) {
+	// an L, area 64, with one reflex corner
+	std::vector<point_t> l_points;
+	l_points.push_back( point_t( 0, 0 ) );
+	l_points.push_back( point_t( 10, 0 ) );
+	l_points.push_back( point_t( 10, 4 ) );
+	l_points.push_back( point_t( 4, 4 ) );
+	l_points.push_back( point_t( 4, 10 ) );
+	l_points.push_back( point_t( 0, 10 ) );
+	const simple_polygon2<double> l_shape( l_points );
+	rings_t rings;
+
+	// mitered, each convex corner adds k^2 and the reflex one takes it away
+	offset( l_shape, 0.5, rings, join_miter );
+	CHECK( rings.size( ) == 1 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - 85.0 ) < 1e-9 );
+	offset( l_shape, -0.5, rings, join_miter );
+	CHECK( rings.size( ) == 1 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - 45.0 ) < 1e-9 );
+
+	// squared corners cut k^2 (3 - 2 sqrt(2)) from each mitered one
+	offset( l_shape, 0.5, rings, join_square );
+	CHECK( rings.size( ) == 1 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - ( 85.0 - 5 * 0.25 * ( 3.0 - 2.0 * std::sqrt( 2.0 ) ) ) ) < 1e-9 );
+
+	// round corners approach the exact quarter circles
+	offset( l_shape, 0.5, rings, join_round, 2.0, 1e-4 );
+	CHECK( rings.size( ) == 1 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - ( 83.75 + 5 * 0.25 * EUCLIB_PI / 4 ) ) < 1e-3 );
+	offset( l_shape, -0.5, rings, join_round, 2.0, 1e-4 );
+	CHECK( rings.size( ) == 1 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - ( 45.25 - 0.25 * EUCLIB_PI / 4 ) ) < 1e-3 );
+
+	// deflating past the arm width leaves nothing, a thin waist splits
+	offset( l_shape, -2.5, rings, join_miter );
+	CHECK( rings.empty( ) );
+	std::vector<point_t> waist;
+	waist.push_back( point_t( 0, 0 ) );
+	waist.push_back( point_t( 4, 0 ) );
+	waist.push_back( point_t( 4, 4 ) );
+	waist.push_back( point_t( 5, 4 ) );
+	waist.push_back( point_t( 5, 0 ) );
+	waist.push_back( point_t( 9, 0 ) );
+	waist.push_back( point_t( 9, 5 ) );
+	waist.push_back( point_t( 0, 5 ) );
+	offset( simple_polygon2<double>( waist ), -1.0, rings, join_miter );
+	CHECK( rings.size( ) == 2 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - 12.0 ) < 1e-9 );
+
+	// inflating a box closes its narrow mouth, leaving the cavity a hole
+	std::vector<point_t> box;
+	box.push_back( point_t( 0, 0 ) );
+	box.push_back( point_t( 9, 0 ) );
+	box.push_back( point_t( 9, 9 ) );
+	box.push_back( point_t( 5, 9 ) );
+	box.push_back( point_t( 5, 7 ) );
+	box.push_back( point_t( 7, 7 ) );
+	box.push_back( point_t( 7, 2 ) );
+	box.push_back( point_t( 2, 2 ) );
+	box.push_back( point_t( 2, 7 ) );
+	box.push_back( point_t( 4, 7 ) );
+	box.push_back( point_t( 4, 9 ) );
+	box.push_back( point_t( 0, 9 ) );
+	offset( simple_polygon2<double>( box ), 0.75, rings, join_miter );
+	CHECK( rings.size( ) == 2 && simple( rings ) );
+	CHECK( std::fabs( area( rings ) - ( 10.5 * 10.5 - 3.5 * 3.5 ) ) < 1e-9 );
+
+	// integral coordinates
+	std::vector<point2<int>> int_points;
+	for( unsigned int i = 0; i < l_points.size( ); ++i ) {
+		int_points.push_back( point2<int>( int( l_points[i].x ) * 2, int( l_points[i].y ) * 2 ) );
+	}
+	std::vector<std::vector<point2<int>>> int_rings;
+	offset( simple_polygon2<int>( int_points ), 1.0, int_rings, join_miter );
+	CHECK( int_rings.size( ) == 1 );
+	rings.assign( 1, ring_t( ) );
+	for( unsigned int i = 0; i < int_rings[0].size( ); ++i ) {
+		rings[0].push_back( point_t( int_rings[0][i].x, int_rings[0][i].y ) );
+	}
+	CHECK( area( rings ) == 256.0 + 80.0 + 4.0 );
+
+	return check_result( "offset" );
+}
@@ -0,0 +1,142 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "../euclib_helper.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>   point_t;
+typedef polygon2<double> poly_t;
+
+// the hull of random points in a disc
+poly_t random_convex( std::mt19937& gen, double cx, double cy, double radius ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	std::vector<point_t> points( 3 + gen( ) % 20 );
+	for( unsigned int i = 0; i < points.size( ); ++i ) {
+		const double angle = 2.0 * EUCLIB_PI * unit( gen ), r = radius * std::sqrt( unit( gen ) );
+		points[i] = point_t{ cx + r * std::cos( angle ), cy + r * std::sin( angle ) };
+	}
+	return poly_t( points );
+}
+
+double cross( const point_t& a, const point_t& b, const point_t& c ) {
+	return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+}
+
+// twice the signed area
+double area( const poly_t& poly ) {
+	double sum = 0.0;
+	for( unsigned int i = 0, j = poly.size( ) - 1; i < poly.size( ); j = i++ ) {
+		sum += poly[j].x * poly[i].y - poly[i].x * poly[j].y;
+	}
+	return sum;
+}
+
+// 'pt' strictly inside the convex 'poly' of either orientation
+bool inside( const poly_t& poly, const point_t& pt ) {
+	if( poly == poly_t::null( ) ) { return false; }
+	const double sign = area( poly ) > 0.0 ? 1.0 : -1.0;
+	for( unsigned int i = 0, j = poly.size( ) - 1; i < poly.size( ); j = i++ ) {
+		if( sign * cross( poly[j], poly[i], pt ) <= 0.0 ) { return false; }
+	}
+	return true;
+}
+
+// distance from 'pt' to the boundary of 'poly'
+double boundary_distance( const poly_t& poly, const point_t& pt ) {
+	double best = std::numeric_limits<double>::max( );
+	if( poly == poly_t::null( ) ) { return best; }
+	for( unsigned int i = 0, j = poly.size( ) - 1; i < poly.size( ); j = i++ ) {
+		const point_t& a = poly[j];
+		const point_t& b = poly[i];
+		const double ex = b.x - a.x, ey = b.y - a.y, len = ex * ex + ey * ey;
+		double s = len > 0.0 ? ( ( pt.x - a.x ) * ex + ( pt.y - a.y ) * ey ) / len : 0.0;
+		s = std::min( 1.0, std::max( 0.0, s ) );
+		const double dx = a.x + s * ex - pt.x, dy = a.y + s * ey - pt.y;
+		best = std::min( best, std::sqrt( dx * dx + dy * dy ) );
+	}
+	return best;
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+	// the overlap holds exactly the points inside both, away from the edges
+	for( unsigned int trial = 0; trial < 500; ++trial ) {
+		const poly_t a = random_convex( gen, unit( gen ), unit( gen ), 0.1 + unit( gen ) );
+		const poly_t b = random_convex( gen, unit( gen ), unit( gen ), 0.1 + unit( gen ) );
+		const poly_t both = overlap( a, b );
+		CHECK( overlap( b, a ) == poly_t::null( ) ? both == poly_t::null( ) : both != poly_t::null( ) );
+
+		if( both != poly_t::null( ) ) {
+			CHECK( both.size( ) >= 3 );
+			const double sign = area( both ) > 0.0 ? 1.0 : -1.0;
+			for( unsigned int i = 0; i < both.size( ); ++i ) {
+				const unsigned int n = both.size( );
+				CHECK( sign * cross( both[( i + n - 1 ) % n], both[i], both[( i + 1 ) % n] ) >= -1e-12 );
+			}
+		}
+
+		for( unsigned int k = 0; k < 400; ++k ) {
+			const point_t pt{ unit( gen ) * 3.0 - 1.0, unit( gen ) * 3.0 - 1.0 };
+			if( boundary_distance( a, pt ) < 1e-7 || boundary_distance( b, pt ) < 1e-7 ||
+			    boundary_distance( both, pt ) < 1e-7 ) {
+				continue;
+			}
+			CHECK( inside( both, pt ) == ( inside( a, pt ) && inside( b, pt ) ) );
+		}
+	}
+
+	// one inside the other, apart, and touching along an edge
+	{
+		const poly_t big( point_t{ 0, 0 }, point_t{ 10, 0 }, point_t{ 10, 10 }, point_t{ 0, 10 } );
+		const poly_t small( point_t{ 2, 2 }, point_t{ 4, 2 }, point_t{ 4, 4 }, point_t{ 2, 4 } );
+		const poly_t apart( point_t{ 20, 0 }, point_t{ 30, 0 }, point_t{ 30, 10 }, point_t{ 20, 10 } );
+		const poly_t beside( point_t{ 10, 0 }, point_t{ 20, 0 }, point_t{ 20, 10 }, point_t{ 10, 10 } );
+		CHECK( overlap( big, small ) == small );
+		CHECK( overlap( small, big ) == small );
+		CHECK( overlap( big, apart ) == poly_t::null( ) );
+		CHECK( overlap( big, beside ) == poly_t::null( ) );
+	}
+
+	// integral coordinates
+	{
+		typedef polygon2<int> ipoly_t;
+		const ipoly_t a( point2<int>{ 0, 0 }, point2<int>{ 10, 0 }, point2<int>{ 10, 10 }, point2<int>{ 0, 10 } );
+		const ipoly_t b( point2<int>{ 5, 5 }, point2<int>{ 15, 5 }, point2<int>{ 15, 15 }, point2<int>{ 5, 15 } );
+		const ipoly_t both = overlap( a, b );
+		CHECK( both.size( ) == 4 );
+		CHECK( both.bounding_box( ) == rect2<int>( 5, 10, 5, 10 ) );
+
+		// turns past the range of int, worked in double
+		const int big = 1000000000, bigger = 1050000000;
+		const ipoly_t wide( point2<int>{ -big, -big }, point2<int>{ big, -big }, point2<int>{ big, big }, point2<int>{ -big, big } );
+		const ipoly_t corner( point2<int>{ 0, 0 }, point2<int>{ bigger, 0 }, point2<int>{ bigger, bigger }, point2<int>{ 0, bigger } );
+		CHECK( wide.size( ) == 4 && corner.size( ) == 4 );
+		CHECK( overlap( wide, corner ).bounding_box( ) == rect2<int>( 0, big, 0, big ) );
+		CHECK( overlap( corner, wide ).bounding_box( ) == rect2<int>( 0, big, 0, big ) );
+	}
+
+	return check_result( "overlap" );
+}
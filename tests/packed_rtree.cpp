@@ -0,0 +1,149 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../packed_rtree.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef std::vector<rect2<double>> boxes_t;
+
+boxes_t random_boxes( std::mt19937& gen, unsigned int count ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	boxes_t boxes( count );
+	for( unsigned int i = 0; i < count; ++i ) {
+		const double x = unit( gen ), y = unit( gen );
+		boxes[i] = rect2<double>( x, x + 0.05 * unit( gen ), y, y + 0.05 * unit( gen ) );
+	}
+	// a few null boxes, left out of the tree
+	for( unsigned int i = 0; i < count; i += 37 ) { boxes[i] = rect2<double>::null( ); }
+	return boxes;
+}
+
+bool brute_overlap( const rect2<double>& a, const rect2<double>& b ) {
+	return a != rect2<double>::null( ) && a.l <= b.r && b.l <= a.r && a.t <= b.b && b.t <= a.b;
+}
+
+double box_distance( const rect2<double>& box, double x, double y ) {
+	const double dx = std::max( std::max( box.l - x, x - box.r ), 0.0 );
+	const double dy = std::max( std::max( box.t - y, y - box.b ), 0.0 );
+	return std::sqrt( dx * dx + dy * dy );
+}
+
+void check_tree( const packed_rtree<double>& tree, const boxes_t& boxes, std::mt19937& gen ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	unsigned int stored = 0;
+	for( unsigned int i = 0; i < boxes.size( ); ++i ) { stored += boxes[i] != rect2<double>::null( ); }
+	CHECK( tree.size( ) == stored );
+
+	std::vector<unsigned int> result, expect;
+	for( unsigned int q = 0; q < 200; ++q ) {
+		// windows, some hitting box edges exactly
+		const double x = unit( gen ), y = unit( gen );
+		rect2<double> window( x, x + 0.2 * unit( gen ), y, y + 0.2 * unit( gen ) );
+		if( q % 10 == 0 && boxes[q + 1] != rect2<double>::null( ) ) {
+			window = rect2<double>( boxes[q + 1].r, boxes[q + 1].r + 0.1, boxes[q + 1].b, boxes[q + 1].b + 0.1 );
+		}
+		result.clear( );
+		tree.search( window, result );
+		expect.clear( );
+		for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+			if( brute_overlap( boxes[i], window ) ) { expect.push_back( i ); }
+		}
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result == expect );
+
+		// points
+		const point2<double> pt( unit( gen ), unit( gen ) );
+		result.clear( );
+		tree.search( pt, result );
+		expect.clear( );
+		for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+			if( brute_overlap( boxes[i], rect2<double>( pt.x, pt.x, pt.y, pt.y ) ) ) { expect.push_back( i ); }
+		}
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result == expect );
+
+		// the k nearest, in order, within a distance
+		const unsigned int k = 1 + q % 20;
+		const double max_distance = q % 3 == 0 ? 0.05 : std::numeric_limits<double>::infinity( );
+		tree.nearest( pt, k, result, max_distance );
+		std::vector<double> distances;
+		for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+			if( boxes[i] == rect2<double>::null( ) ) { continue; }
+			const double d = box_distance( boxes[i], pt.x, pt.y );
+			if( d <= max_distance ) { distances.push_back( d ); }
+		}
+		std::sort( distances.begin( ), distances.end( ) );
+		CHECK( result.size( ) == std::min<unsigned int>( k, distances.size( ) ) );
+		for( unsigned int i = 0; i < result.size( ) && i < distances.size( ); ++i ) {
+			CHECK( std::fabs( box_distance( boxes[result[i]], pt.x, pt.y ) - distances[i] ) < 1e-12 );
+		}
+	}
+
+	// a visitor can stop the search
+	unsigned int seen = 0;
+	tree.search( tree.bounding_box( ), [&]( unsigned int ) { return ++seen < 5; } );
+	CHECK( seen == std::min( 5u, tree.size( ) ) );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+
+	const rtree_packing packings[2] = { hilbert_packing, str_packing };
+	const unsigned int counts[] = { 1, 2, 17, 1000, 5000 };
+	const unsigned int node_sizes[] = { 2, 3, 16, 64 };
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		const boxes_t boxes = random_boxes( gen, counts[c] );
+		for( unsigned int n = 0; n < sizeof(node_sizes) / sizeof(node_sizes[0]); ++n ) {
+			for( unsigned int p = 0; p < 2; ++p ) {
+				const packed_rtree<double> tree( boxes, node_sizes[n], 1 + c % 3, packings[p] );
+				CHECK( tree.node_size( ) == node_sizes[n] );
+				check_tree( tree, boxes, gen );
+			}
+		}
+	}
+
+	// an empty tree answers nothing
+	{
+		const packed_rtree<double> tree( boxes_t( 5, rect2<double>::null( ) ) );
+		std::vector<unsigned int> result;
+		tree.search( rect2<double>( 0.0, 1.0, 0.0, 1.0 ), result );
+		tree.nearest( point2<double>( 0.5, 0.5 ), 3, result );
+		CHECK( tree.empty( ) && result.empty( ) && tree.bounding_box( ) == rect2<double>::null( ) );
+	}
+
+	// integral boxes
+	{
+		std::vector<rect2<int>> boxes;
+		for( int i = 0; i < 100; ++i ) { boxes.push_back( rect2<int>( i, i + 1, 0, 1 ) ); }
+		const packed_rtree<int> tree( boxes, 4 );
+		std::vector<unsigned int> result;
+		tree.search( rect2<int>( 10, 12, 1, 5 ), result );
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result.size( ) == 4 && result.front( ) == 9 && result.back( ) == 12 );
+		CHECK( tree.bounding_box( ) == rect2<int>( 0, 100, 0, 1 ) );
+	}
+
+	return check_result( "packed_rtree" );
+}
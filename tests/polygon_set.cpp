@@ -0,0 +1,178 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "../polygon_set.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>       point_t;
+typedef std::vector<point_t> ring_t;
+
+// a star shaped ring round (cx,cy), either winding
+ring_t star( std::mt19937& gen, double cx, double cy ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	const unsigned int n = 3 + gen( ) % 20;
+	ring_t ring;
+	for( unsigned int i = 0; i < n; ++i ) {
+		const double angle = 2.0 * EUCLIB_PI * ( i + 0.5 * unit( gen ) ) / n;
+		const double radius = 0.1 + unit( gen );
+		ring.push_back( point_t{ cx + radius * std::cos( angle ), cy + radius * std::sin( angle ) } );
+	}
+	if( gen( ) % 2 == 0 ) { std::reverse( ring.begin( ), ring.end( ) ); }
+	return ring;
+}
+
+double signed_area( const ring_t& ring ) {
+	if( ring.size( ) < 3 ) { return 0.0; }
+	double sum = 0.0;
+	for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+		sum += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+	}
+	return sum / 2.0;
+}
+
+rect2<double> box_of( const ring_t& ring ) {
+	if( ring.empty( ) ) { return rect2<double>::null( ); }
+	double l = ring[0].x, r = l, t = ring[0].y, b = t;
+	for( unsigned int i = 1; i < ring.size( ); ++i ) {
+		l = std::min( l, ring[i].x ); r = std::max( r, ring[i].x );
+		t = std::min( t, ring[i].y ); b = std::max( b, ring[i].y );
+	}
+	return rect2<double>( l, r, t, b );
+}
+
+bool near( const point_t& a, const point_t& b ) {
+	return std::fabs( a.x - b.x ) < 1e-9 && std::fabs( a.y - b.y ) < 1e-9;
+}
+
+bool near( const rect2<double>& a, const rect2<double>& b ) {
+	return std::fabs( a.l - b.l ) < 1e-9 && std::fabs( a.r - b.r ) < 1e-9 &&
+	       std::fabs( a.t - b.t ) < 1e-9 && std::fabs( a.b - b.b ) < 1e-9;
+}
+
+// the set holds exactly 'rings', vertex for vertex
+void check_set( const polygon_set<double>& set, const std::vector<ring_t>& rings ) {
+	CHECK( set.size( ) == rings.size( ) && set.offsets( ).size( ) == rings.size( ) + 1 );
+	std::vector<float> areas, signed_areas;
+	set.areas( areas );
+	set.signed_areas( signed_areas );
+	double total = 0.0;
+	unsigned int p = 0;
+	for( auto itr = set.begin( ); itr != set.end( ); ++itr, ++p ) {
+		const polygon_view<double> view = *itr;
+		const ring_t& ring = rings[p];
+		CHECK( view.size( ) == ring.size( ) && set.offsets( )[p + 1] - set.offsets( )[p] == ring.size( ) );
+		bool same = view.size( ) == ring.size( );
+		for( unsigned int i = 0; same && i < ring.size( ); ++i ) { same = near( view[i], ring[i] ); }
+		CHECK( same );
+		if( ring.empty( ) ) { CHECK( view.bounding_box( ) == rect2<double>::null( ) ); }
+		else { CHECK( near( view.bounding_box( ), box_of( ring ) ) ); }
+		const double area = signed_area( ring );
+		CHECK( std::fabs( signed_areas[p] - area ) < 1e-5 && std::fabs( view.signed_area( ) - area ) < 1e-5 );
+		CHECK( std::fabs( areas[p] - std::fabs( area ) ) < 1e-5 );
+		total += std::fabs( area );
+	}
+	CHECK( p == rings.size( ) );
+	CHECK( std::fabs( set.area( ) - total ) < 1e-4 );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+	// rings added as vectors, simple polygons, hulls and views
+	polygon_set<double> set;
+	std::vector<ring_t> rings;
+	for( unsigned int i = 0; i < 500; ++i ) {
+		ring_t ring = star( gen, unit( gen ) * 10.0, unit( gen ) * 10.0 );
+		switch( i % 4 ) {
+			case 0: set.add( ring ); break;
+			case 1: set.add( simple_polygon2<double>( ring ) ); break;
+			case 2: {
+				const polygon2<double> hull( ring );
+				ring.assign( hull.size( ), point_t( ) );
+				for( unsigned int k = 0; k < hull.size( ); ++k ) { ring[k] = hull[k]; }
+				set.add( hull );
+				break;
+			}
+			case 3: set.add( set[i - 1] ); ring = rings[i - 1]; break;
+		}
+		rings.push_back( ring );
+	}
+	set.add( ring_t( ) );
+	rings.push_back( ring_t( ) );
+	check_set( set, rings );
+	CHECK( set.vertex_count( ) == set.points( ).size( ) );
+	CHECK( set.bounding_box( ) == box_of( set.points( ) ) );
+
+	// whole-set transforms match moving each ring
+	set.translate( 1.5, -2.0 );
+	for( unsigned int p = 0; p < rings.size( ); ++p ) {
+		for( unsigned int i = 0; i < rings[p].size( ); ++i ) { rings[p][i] = point_t{ rings[p][i].x + 1.5, rings[p][i].y - 2.0 }; }
+	}
+	check_set( set, rings );
+
+	const point_t about{ 3.0, 4.0 };
+	set.scale( about, 0.5 );
+	for( unsigned int p = 0; p < rings.size( ); ++p ) {
+		for( unsigned int i = 0; i < rings[p].size( ); ++i ) {
+			rings[p][i] = point_t{ about.x + ( rings[p][i].x - about.x ) * 0.5, about.y + ( rings[p][i].y - about.y ) * 0.5 };
+		}
+	}
+	check_set( set, rings );
+
+	const line2<double> over( point_t{ 0.0, 0.0 }, point_t{ 1.0, 2.0 } );
+	set.rotate( about, 0.7f );
+	set.mirror( over );
+	for( unsigned int p = 0; p < rings.size( ); ++p ) {
+		for( unsigned int i = 0; i < rings[p].size( ); ++i ) {
+			rings[p][i] = mirror( rotate( rings[p][i], about, 0.7f, true ), over );
+		}
+	}
+	check_set( set, rings );
+
+	// copied out as a hull, the same as hulling the ring
+	for( unsigned int p = 0; p < 50; ++p ) {
+		CHECK( set[p].to_polygon( ) == polygon2<double>( rings[p] ) );
+	}
+
+	// built from polygons in one go
+	{
+		std::vector<polygon2<double>> polys;
+		std::vector<ring_t> hulls;
+		for( unsigned int i = 0; i < 100; ++i ) {
+			polys.push_back( polygon2<double>( star( gen, unit( gen ), unit( gen ) ) ) );
+			hulls.push_back( ring_t( ) );
+			for( unsigned int k = 0; k < polys.back( ).size( ); ++k ) { hulls.back( ).push_back( polys.back( )[k] ); }
+		}
+		const polygon_set<double> from( polys );
+		check_set( from, hulls );
+		CHECK( from.end( ) - from.begin( ) == 100 && from.begin( )[7].size( ) == polys[7].size( ) );
+	}
+
+	set.clear( );
+	CHECK( set.empty( ) && set.offsets( ).size( ) == 1 && set.bounding_box( ) == rect2<double>::null( ) );
+
+	return check_result( "polygon_set" );
+}
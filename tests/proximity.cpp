@@ -0,0 +1,116 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+
+#include "../proximity.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+template<typename T>
+double distance_sq( const point2<T>& a, const point2<T>& b ) {
+	const double dx = double( a.x ) - double( b.x );
+	const double dy = double( a.y ) - double( b.y );
+	return dx * dx + dy * dy;
+}
+
+// closest_pair( ) and all_nearest( ) against brute force
+template<typename T>
+void check_points( const std::vector<point2<T>>& points, unsigned int threads ) {
+	const unsigned int n = points.size( );
+
+	const std::pair<unsigned int, unsigned int> pair = closest_pair( points, threads );
+	if( n >= 2 ) {
+		double best = std::numeric_limits<double>::infinity( );
+		for( unsigned int i = 0; i < n; ++i ) {
+			for( unsigned int j = i + 1; j < n; ++j ) { best = std::min( best, distance_sq( points[i], points[j] ) ); }
+		}
+		CHECK( pair.first < pair.second && pair.second < n );
+		CHECK( distance_sq( points[pair.first], points[pair.second] ) == best );
+	}
+
+	std::vector<unsigned int> nearest;
+	all_nearest( points, nearest, threads );
+	CHECK( nearest.size( ) == n );
+	if( n < 2 ) { return; }
+	for( unsigned int i = 0; i < n; ++i ) {
+		double best = std::numeric_limits<double>::infinity( );
+		for( unsigned int j = 0; j < n; ++j ) {
+			if( j != i ) { best = std::min( best, distance_sq( points[i], points[j] ) ); }
+		}
+		CHECK( nearest[i] != i && nearest[i] < n );
+		CHECK( nearest[i] >= n || distance_sq( points[i], points[nearest[i]] ) == best );
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+	for( unsigned int trial = 0; trial < 200; ++trial ) {
+		std::vector<point2<double>> points( gen( ) % 400 );
+		for( unsigned int i = 0; i < points.size( ); ++i ) {
+			switch( trial % 4 ) {
+			case 0: // uniform
+				points[i] = point2<double>( unit( gen ), unit( gen ) );
+				break;
+			case 1: // small grid, many duplicates
+				points[i] = point2<double>( gen( ) % 10, gen( ) % 10 );
+				break;
+			case 2: // one vertical line
+				points[i] = point2<double>( 0.5, unit( gen ) );
+				break;
+			default: // narrow columns
+				points[i] = point2<double>( unit( gen ) * 1e-3 + gen( ) % 3, unit( gen ) );
+			}
+		}
+		check_points( points, 1 );
+		check_points( points, 3 );
+	}
+
+	// integral and single precision coordinates
+	{
+		std::vector<point2<int>> points( 300 );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = point2<int>( gen( ) % 100, gen( ) % 100 ); }
+		check_points( points, 2 );
+	}
+	{
+		std::vector<point2<float>> points( 300 );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = point2<float>( unit( gen ), unit( gen ) ); }
+		check_points( points, 2 );
+	}
+
+	// larger sets agree between thread counts and with each other
+	{
+		std::vector<point2<double>> points( 200000 );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = point2<double>( unit( gen ), unit( gen ) ); }
+		std::vector<unsigned int> serial, parallel;
+		all_nearest( points, serial, 1 );
+		all_nearest( points, parallel, 3 );
+		CHECK( serial == parallel );
+		const std::pair<unsigned int, unsigned int> pair = closest_pair( points, 3 );
+		CHECK( pair == closest_pair( points, 1 ) );
+		double best = std::numeric_limits<double>::infinity( );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { best = std::min( best, distance_sq( points[i], points[serial[i]] ) ); }
+		CHECK( distance_sq( points[pair.first], points[pair.second] ) == best );
+	}
+
+	return check_result( "proximity" );
+}
@@ -0,0 +1,128 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <utility>
+
+#include "../rect_array.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// closed intervals, touching boxes overlap
+template<typename T>
+bool brute_overlap( const rect2<T>& a, const rect2<T>& b ) {
+	return a.l <= b.r && b.l <= a.r && a.t <= b.b && b.t <= a.b;
+}
+
+// small integral coordinates so boxes often share an edge or corner,
+//   at least one wide since an empty rect2<int> is null
+template<typename T>
+rect2<T> random_rect( std::mt19937& gen ) {
+	const T l = T( gen( ) % 40 ), t = T( gen( ) % 40 );
+	return rect2<T>( l, l + T( 1 + gen( ) % 8 ), t, t + T( 1 + gen( ) % 8 ) );
+}
+
+bool has_bit( const std::vector<uint64_t>& mask, unsigned int i ) {
+	return i / 64 < mask.size( ) && ( ( mask[i / 64] >> ( i % 64 ) ) & 1 ) != 0;
+}
+
+template<typename T>
+void check_type( std::mt19937& gen ) {
+	// sizes around the 64 box words and the vector widths
+	const unsigned int sizes[] = { 0, 1, 3, 4, 7, 8, 63, 64, 65, 130, 500 };
+	for( unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s ) {
+		std::vector<rect2<T>> rects( sizes[s] );
+		for( unsigned int i = 0; i < rects.size( ); ++i ) { rects[i] = random_rect<T>( gen ); }
+		rect_array<T> array( rects );
+		CHECK( array.size( ) == rects.size( ) );
+		for( unsigned int i = 0; i < rects.size( ); ++i ) { CHECK( array[i] == rects[i] ); }
+
+		std::vector<uint64_t> mask;
+		std::vector<unsigned int> indices;
+		for( unsigned int q = 0; q < 50; ++q ) {
+			const rect2<T> query = random_rect<T>( gen );
+			array.overlaps( query, mask );
+			array.overlaps( query, indices );
+			CHECK( mask.size( ) == ( rects.size( ) + 63 ) / 64 );
+			unsigned int next = 0;
+			for( unsigned int i = 0; i < rects.size( ); ++i ) {
+				const bool expect = brute_overlap( rects[i], query );
+				CHECK( has_bit( mask, i ) == expect );
+				if( expect ) {
+					CHECK( next < indices.size( ) && indices[next] == i );
+					++next;
+				}
+			}
+			CHECK( next == indices.size( ) );
+
+			const point2<T> pt( T( gen( ) % 48 ), T( gen( ) % 48 ) );
+			array.contains( pt, indices );
+			next = 0;
+			for( unsigned int i = 0; i < rects.size( ); ++i ) {
+				if( rects[i].l <= pt.x && pt.x <= rects[i].r && rects[i].t <= pt.y && pt.y <= rects[i].b ) {
+					CHECK( next < indices.size( ) && indices[next] == i );
+					++next;
+				}
+			}
+			CHECK( next == indices.size( ) );
+		}
+
+		// a null query matches nothing
+		array.overlaps( rect2<T>::null( ), indices );
+		CHECK( indices.empty( ) );
+
+		// box i against box i, and every pair
+		std::vector<rect2<T>> others( rects.size( ) / 2 + 1 );
+		for( unsigned int i = 0; i < others.size( ); ++i ) { others[i] = random_rect<T>( gen ); }
+		const rect_array<T> other( others );
+		array.overlaps( other, mask );
+		const unsigned int n = std::min( rects.size( ), others.size( ) );
+		CHECK( mask.size( ) == ( n + 63 ) / 64 );
+		for( unsigned int i = 0; i < n; ++i ) {
+			CHECK( has_bit( mask, i ) == brute_overlap( rects[i], others[i] ) );
+		}
+		std::vector<std::pair<unsigned int, unsigned int>> pairs;
+		array.overlaps( other, pairs );
+		unsigned int count = 0;
+		for( unsigned int j = 0; j < others.size( ); ++j ) {
+			for( unsigned int i = 0; i < rects.size( ); ++i ) {
+				if( !brute_overlap( rects[i], others[j] ) ) { continue; }
+				CHECK( count < pairs.size( ) && pairs[count] == std::make_pair( i, j ) );
+				++count;
+			}
+		}
+		CHECK( count == pairs.size( ) );
+
+		// moving a box
+		if( !rects.empty( ) ) {
+			rects[0] = random_rect<T>( gen );
+			array.set( 0, rects[0] );
+			CHECK( array[0] == rects[0] );
+		}
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_type<float>( gen );
+	check_type<double>( gen );
+	check_type<int>( gen );
+	return check_result( "rect_array" );
+}
@@ -0,0 +1,164 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../rp_forest.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// points round a few centres, as real data clusters
+template<typename T, std::size_t D>
+std::vector<point<T,D>> random_points( std::mt19937& gen, unsigned int count ) {
+	std::normal_distribution<double> normal( 0.0, 1.0 );
+	std::vector<point<T,D>> centres( 10 ), points( count );
+	for( unsigned int c = 0; c < centres.size( ); ++c ) {
+		for( std::size_t a = 0; a < D; ++a ) { centres[c][a] = T( 10.0 * normal( gen ) ); }
+	}
+	for( unsigned int i = 0; i < count; ++i ) {
+		const point<T,D>& centre = centres[gen( ) % centres.size( )];
+		for( std::size_t a = 0; a < D; ++a ) { points[i][a] = T( centre[a] + normal( gen ) ); }
+	}
+	return points;
+}
+
+template<typename T, std::size_t D>
+double distance_sq( const point<T,D>& p1, const point<T,D>& p2 ) {
+	double sum = 0.0;
+	for( std::size_t a = 0; a < D; ++a ) { sum += ( double(p1[a]) - p2[a] ) * ( double(p1[a]) - p2[a] ); }
+	return sum;
+}
+
+// the k-th smallest distance from 'pt', by brute force
+template<typename T, std::size_t D>
+double kth_distance( const std::vector<point<T,D>>& points, const point<T,D>& pt, unsigned int k ) {
+	std::vector<double> distances( points.size( ) );
+	for( unsigned int i = 0; i < points.size( ); ++i ) { distances[i] = distance_sq( points[i], pt ); }
+	k = std::min<unsigned int>( k, distances.size( ) );
+	std::nth_element( distances.begin( ), distances.begin( ) + ( k - 1 ), distances.end( ) );
+	return distances[k - 1];
+}
+
+// distances as the forest sums them, in T and in another order
+template<typename T>
+bool close( double a, double b ) {
+	return std::fabs( a - b ) <= 64 * std::numeric_limits<T>::epsilon( ) * std::max( 1.0, b );
+}
+
+// results are distinct points, closest first, with their true distances;
+//   returns how many are among the true k nearest, ties included
+template<typename T, std::size_t D>
+unsigned int check_result_list( const std::vector<point<T,D>>& points, const point<T,D>& pt, unsigned int k,
+                                const typename rp_forest<T,D>::neighbours_t& found ) {
+	CHECK( found.size( ) <= k );
+	std::vector<unsigned int> indices;
+	bool valid = true;
+	for( unsigned int j = 0; valid && j < found.size( ); ++j ) {
+		valid = found[j].second < points.size( ) && close<T>( found[j].first, distance_sq( points[found[j].second], pt ) ) &&
+		        ( j == 0 || found[j - 1].first <= found[j].first );
+		indices.push_back( found[j].second );
+	}
+	std::sort( indices.begin( ), indices.end( ) );
+	CHECK( valid && std::unique( indices.begin( ), indices.end( ) ) == indices.end( ) );
+	if( found.empty( ) ) { return 0; }
+	const double bound = kth_distance( points, pt, k );
+	unsigned int hits = 0;
+	for( unsigned int j = 0; j < found.size( ); ++j ) {
+		hits += distance_sq( points[found[j].second], pt ) <= bound * ( 1.0 + 1e-5 );
+	}
+	return hits;
+}
+
+template<typename T, std::size_t D>
+void check_forest( std::mt19937& gen, unsigned int count, double least_recall ) {
+	const std::vector<point<T,D>> points = random_points<T,D>( gen, count );
+	const std::vector<point<T,D>> queries = random_points<T,D>( gen, 200 );
+	const unsigned int k = 10;
+	const rp_forest<T,D> forest( points, 8, 16, 3 );
+	CHECK( forest.size( ) == count && forest.trees( ) == 8 && forest.leaf_size( ) == 16 );
+
+	// recall by brute force, against the forest's own measure
+	typename rp_forest<T,D>::neighbours_t found;
+	typename rp_forest<T,D>::query_buffer buffer;
+	unsigned int hits = 0;
+	for( unsigned int q = 0; q < queries.size( ); ++q ) {
+		forest.nearest( queries[q], k, found, buffer );
+		CHECK( found.size( ) == std::min( k, count ) );
+		hits += check_result_list( points, queries[q], k, found );
+	}
+	const double recall = double(hits) / ( queries.size( ) * std::min( k, count ) );
+	CHECK( recall >= least_recall && std::fabs( forest.recall( queries, k, 0, 2 ) - recall ) < 0.01 );
+
+	// a wider search finds nearly all, ranking everything finds all
+	CHECK( forest.recall( queries, k, 64 * k ) >= std::max( recall, 0.9 ) );
+	CHECK( forest.recall( queries, k, count * 8 ) == 1.0 );
+
+	// batches answer as single queries do, padding short lists
+	const unsigned int wide = count + 3;
+	forest.nearest( queries, wide, found, 0, 4 );
+	CHECK( found.size( ) == queries.size( ) * wide );
+	typename rp_forest<T,D>::neighbours_t single;
+	bool same = true;
+	for( unsigned int q = 0; same && q < queries.size( ); q += 17 ) {
+		forest.nearest( queries[q], wide, single );
+		for( unsigned int j = 0; same && j < wide; ++j ) {
+			same = j < single.size( ) ? found[q * wide + j] == single[j] : found[q * wide + j].second == forest.npos;
+		}
+	}
+	CHECK( same );
+
+	// the seed alone fixes the forest
+	const rp_forest<T,D> again( points, 8, 16, 1 );
+	same = true;
+	for( unsigned int q = 0; same && q < queries.size( ); q += 7 ) {
+		forest.nearest( queries[q], k, found );
+		again.nearest( queries[q], k, single );
+		same = found == single;
+	}
+	CHECK( same );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_forest<float, 3>( gen, 5, 1.0 );
+	check_forest<float, 3>( gen, 3000, 0.85 );
+	check_forest<double, 8>( gen, 3000, 0.5 );
+	check_forest<float, 17>( gen, 2000, 0.4 );
+
+	// every point the same, and nothing to search
+	{
+		const std::vector<point<double,4>> points( 100, point<double,4>( 1.0, 2.0, 3.0, 4.0 ) );
+		const rp_forest<double,4> forest( points, 4, 8 );
+		rp_forest<double,4>::neighbours_t found;
+		forest.nearest( point<double,4>( 1.0, 2.0, 3.0, 5.0 ), 5, found );
+		CHECK( found.size( ) == 5 && found[0].first == 1.0 && found[4].first == 1.0 );
+
+		const rp_forest<double,4> none;
+		none.nearest( points[0], 5, found );
+		CHECK( none.empty( ) && found.empty( ) && none.recall( points, 5 ) == 1.0 );
+		const rp_forest<double,4> bare( points, 0 );
+		bare.nearest( points[0], 5, found );
+		CHECK( bare.trees( ) == 0 && found.empty( ) );
+	}
+
+	return check_result( "rp_forest" );
+}
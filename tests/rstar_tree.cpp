@@ -0,0 +1,194 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../rstar_tree.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// handle -> box, null for free handles
+typedef std::vector<rect2<double>> boxes_t;
+
+rect2<double> random_box( std::mt19937& gen, double size ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	const double x = unit( gen ), y = unit( gen );
+	return rect2<double>( x, x + size * unit( gen ), y, y + size * unit( gen ) );
+}
+
+bool brute_overlap( const rect2<double>& a, const rect2<double>& b ) {
+	return a != rect2<double>::null( ) && a.l <= b.r && b.l <= a.r && a.t <= b.b && b.t <= a.b;
+}
+
+double box_distance( const rect2<double>& box, double x, double y ) {
+	const double dx = std::max( std::max( box.l - x, x - box.r ), 0.0 );
+	const double dy = std::max( std::max( box.t - y, y - box.b ), 0.0 );
+	return std::sqrt( dx * dx + dy * dy );
+}
+
+template<unsigned int M>
+void check_tree( const rstar_tree<double, M>& tree, const boxes_t& boxes, std::mt19937& gen ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	unsigned int live = 0;
+	for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+		const bool stored = boxes[h] != rect2<double>::null( );
+		live += stored;
+		CHECK( tree.contains( h ) == stored );
+		if( stored ) { CHECK( tree.box( h ) == boxes[h] ); }
+	}
+	CHECK( tree.size( ) == live );
+	// R*-tree nodes stay at least 40% full
+	CHECK( live == 0 || std::pow( double(M * 2 / 5), tree.height( ) - 1.0 ) <= 2.0 * live );
+
+	std::vector<unsigned int> result, expect;
+	for( unsigned int q = 0; q < 20; ++q ) {
+		const rect2<double> window = random_box( gen, 0.3 );
+		result.clear( );
+		tree.search( window, result );
+		expect.clear( );
+		for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+			if( brute_overlap( boxes[h], window ) ) { expect.push_back( h ); }
+		}
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result == expect );
+
+		const point2<double> pt( unit( gen ), unit( gen ) );
+		result.clear( );
+		tree.search( pt, result );
+		expect.clear( );
+		for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+			if( brute_overlap( boxes[h], rect2<double>( pt.x, pt.x, pt.y, pt.y ) ) ) { expect.push_back( h ); }
+		}
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result == expect );
+
+		const unsigned int k = 1 + q % 10;
+		tree.nearest( pt, k, result );
+		std::vector<double> distances;
+		for( unsigned int h = 0; h < boxes.size( ); ++h ) {
+			if( boxes[h] != rect2<double>::null( ) ) { distances.push_back( box_distance( boxes[h], pt.x, pt.y ) ); }
+		}
+		std::sort( distances.begin( ), distances.end( ) );
+		CHECK( result.size( ) == std::min<unsigned int>( k, distances.size( ) ) );
+		for( unsigned int i = 0; i < result.size( ) && i < distances.size( ); ++i ) {
+			CHECK( box_distance( boxes[result[i]], pt.x, pt.y ) == distances[i] );
+		}
+	}
+}
+
+// random inserts, removes and moves against a plain array
+template<unsigned int M>
+void check_random( std::mt19937& gen ) {
+	rstar_tree<double, M> tree;
+	boxes_t boxes;
+	std::vector<unsigned int> live;
+	for( unsigned int step = 0; step < 6000; ++step ) {
+		const unsigned int op = gen( ) % 10;
+		if( op < 5 || live.empty( ) ) {
+			const rect2<double> box = random_box( gen, 0.05 );
+			const unsigned int h = tree.insert( box );
+			CHECK( h != tree.npos && !( h < boxes.size( ) && boxes[h] != rect2<double>::null( ) ) );
+			if( h >= boxes.size( ) ) { boxes.resize( h + 1, rect2<double>::null( ) ); }
+			boxes[h] = box;
+			live.push_back( h );
+		}
+		else if( op < 7 ) {
+			const unsigned int at = gen( ) % live.size( );
+			CHECK( tree.remove( live[at] ) );
+			CHECK( !tree.remove( live[at] ) );
+			boxes[live[at]] = rect2<double>::null( );
+			live[at] = live.back( );
+			live.pop_back( );
+		}
+		else {
+			// small nudges stay in place, teleports move the box elsewhere
+			const unsigned int h = live[gen( ) % live.size( )];
+			rect2<double> box = random_box( gen, 0.05 );
+			if( op < 9 ) {
+				const double dx = ( boxes[h].l - box.l ) * 0.99, dy = ( boxes[h].t - box.t ) * 0.99;
+				box = rect2<double>( box.l + dx, box.r + dx, box.t + dy, box.b + dy );
+			}
+			CHECK( tree.update( h, box ) );
+			boxes[h] = box;
+		}
+		if( step % 500 == 0 ) { check_tree( tree, boxes, gen ); }
+	}
+	check_tree( tree, boxes, gen );
+
+	// everything removed leaves an empty tree that still works
+	for( unsigned int i = 0; i < live.size( ); ++i ) {
+		tree.remove( live[i] );
+		boxes[live[i]] = rect2<double>::null( );
+	}
+	CHECK( tree.empty( ) && tree.height( ) == 1 && tree.bounding_box( ) == rect2<double>::null( ) );
+	check_tree( tree, boxes, gen );
+	CHECK( tree.insert( rect2<double>::null( ) ) == tree.npos );
+	CHECK( !tree.update( 0, random_box( gen, 0.1 ) ) );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_random<8>( gen );
+	check_random<16>( gen );
+
+	// many equal boxes, where splits cannot separate anything
+	{
+		rstar_tree<double, 8> tree;
+		const rect2<double> box( 0.25, 0.5, 0.25, 0.5 );
+		for( unsigned int i = 0; i < 200; ++i ) { tree.insert( box ); }
+		std::vector<unsigned int> result;
+		tree.search( point2<double>( 0.3, 0.3 ), result );
+		CHECK( result.size( ) == 200 && tree.bounding_box( ) == box );
+	}
+
+	// boxes moved far go to another leaf instead of stretching theirs, so
+	//   a nearest query still opens only the few leaves around it
+	{
+		std::mt19937 gen( 2 );
+		std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+		rstar_tree<double, 16> tree;
+		for( unsigned int i = 0; i < 200; ++i ) { tree.insert( random_box( gen, 0.01 ) ); }
+		for( unsigned int round = 0; round < 5; ++round ) {
+			for( unsigned int h = 0; h < 200; ++h ) { tree.update( h, random_box( gen, 0.01 ) ); }
+		}
+		rstar_tree<double, 16>::nearest_queue queue;
+		unsigned int waiting = 0;
+		for( unsigned int q = 0; q < 100; ++q ) {
+			tree.nearest( point2<double>( unit( gen ), unit( gen ) ), []( unsigned int, double ) { return false; }, queue );
+			waiting += queue.size( );
+		}
+		CHECK( waiting < 100 * 50 );
+	}
+
+	// integral boxes
+	{
+		rstar_tree<int> tree;
+		for( int i = 0; i < 100; ++i ) { tree.insert( rect2<int>( i, i + 1, 0, 1 ) ); }
+		std::vector<unsigned int> result;
+		tree.search( rect2<int>( 10, 12, 1, 5 ), result );
+		std::sort( result.begin( ), result.end( ) );
+		CHECK( result.size( ) == 4 && result.front( ) == 9 && result.back( ) == 12 );
+		CHECK( tree.bounding_box( ) == rect2<int>( 0, 100, 0, 1 ) );
+	}
+
+	return check_result( "rstar_tree" );
+}
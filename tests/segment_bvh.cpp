@@ -0,0 +1,250 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../segment_bvh.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// endpoints as the tree stores them, base point and base point + vector
+template<typename T>
+struct ends {
+	T x0, y0, x1, y1;
+};
+
+template<typename T>
+ends<T> ends_of( const segment<T,2>& seg ) {
+	const point<T,2>& p = seg.base_point( );
+	const vector<T,2>& v = seg.base_vector( );
+	ends<T> e = { p[0], p[1], p[0] + v[0], p[1] + v[1] };
+	return e;
+}
+
+// the ray against one segment, worked the same way as the tree so ties
+//   and edge hits agree exactly
+template<typename T>
+bool brute_cross( const ends<T>& c, T ox, T oy, T dx, T dy, T max_t, T& t ) {
+	const T ex = c.x1 - c.x0, ey = c.y1 - c.y0;
+	const T ax = c.x0 - ox, ay = c.y0 - oy;
+	const T denom = dx * ey - dy * ex;
+	const T along = ax * dy - ay * dx;
+	if( denom == 0 ) {
+		if( along != 0 ) { return false; }
+		const T dd = dx * dx + dy * dy;
+		if( dd == 0 ) { return false; }
+		T ta = ( ax * dx + ay * dy ) / dd;
+		T tb = ( ( c.x1 - ox ) * dx + ( c.y1 - oy ) * dy ) / dd;
+		if( ta > tb ) { std::swap( ta, tb ); }
+		if( tb < 0 || ta > max_t ) { return false; }
+		t = std::max( ta, T(0) );
+		return true;
+	}
+	t = ( ax * ey - ay * ex ) / denom;
+	const T u = along / denom;
+	return t >= 0 && t <= max_t && u >= 0 && u <= 1;
+}
+
+// random segments, a share of them axis aligned on a coarse lattice so
+//   rays run along them and through their endpoints
+template<typename T>
+segment<T,2> random_segment( std::mt19937& gen ) {
+	std::uniform_real_distribution<T> unit( 0, 1 );
+	if( gen( ) % 4 == 0 ) {
+		const T x = T( gen( ) % 20 ) / 20, y = T( gen( ) % 20 ) / 20, len = T( 1 + gen( ) % 4 ) / 20;
+		return gen( ) % 2 == 0 ? segment<T,2>( point<T,2>( x, y ), point<T,2>( x + len, y ) )
+		                       : segment<T,2>( point<T,2>( x, y ), point<T,2>( x, y + len ) );
+	}
+	const T x = unit( gen ), y = unit( gen );
+	return segment<T,2>( point<T,2>( x, y ), point<T,2>( x + ( unit( gen ) - T(0.5) ) / 10, y + ( unit( gen ) - T(0.5) ) / 10 ) );
+}
+
+// equal up to the rounding of the slab test, which may skip a box whose
+//   hit is an ulp or so nearer than the one found
+template<typename T>
+bool close( T a, T b ) {
+	return std::fabs( a - b ) <= 8 * std::numeric_limits<T>::epsilon( ) * std::max( T(1), std::fabs( b ) );
+}
+
+template<typename T>
+typename segment_bvh<T>::ray random_ray( std::mt19937& gen ) {
+	std::uniform_real_distribution<T> unit( 0, 1 );
+	typename segment_bvh<T>::ray r;
+	switch( gen( ) % 4 ) {
+		case 0:  // along a lattice line
+			r.origin = point<T,2>( T( gen( ) % 20 ) / 20, -T(0.1) );
+			r.direction = vector<T,2>( 0, 1 );
+			break;
+		case 1:
+			r.origin = point<T,2>( -T(0.1), T( gen( ) % 20 ) / 20 );
+			r.direction = vector<T,2>( 1, 0 );
+			break;
+		default:
+			r.origin = point<T,2>( unit( gen ), unit( gen ) );
+			r.direction = vector<T,2>( unit( gen ) - T(0.5), unit( gen ) - T(0.5) );
+			break;
+	}
+	r.max_t = gen( ) % 3 == 0 ? std::numeric_limits<T>::max( ) : T( 1 + gen( ) % 3 );
+	return r;
+}
+
+// 'hit' names a segment the ray really crosses at hit.t
+template<typename T>
+bool hits_at( const std::vector<ends<T>>& segs, const typename segment_bvh<T>::ray& r,
+              const typename segment_bvh<T>::ray_hit& hit ) {
+	T t;
+	return hit.index < segs.size( ) &&
+	       brute_cross( segs[hit.index], r.origin[0], r.origin[1], r.direction[0], r.direction[1], r.max_t, t ) &&
+	       t == hit.t;
+}
+
+template<typename T>
+void check_tree( const segment_bvh<T>& tree, const std::vector<ends<T>>& segs,
+                 std::mt19937& gen, unsigned int queries ) {
+	CHECK( tree.size( ) == segs.size( ) );
+	std::vector<typename segment_bvh<T>::ray> rays;
+	std::vector<typename segment_bvh<T>::ray_hit> all, expect;
+	for( unsigned int q = 0; q < queries; ++q ) {
+		const typename segment_bvh<T>::ray r = random_ray<T>( gen );
+		rays.push_back( r );
+		const T ox = r.origin[0], oy = r.origin[1], dx = r.direction[0], dy = r.direction[1];
+		expect.clear( );
+		for( unsigned int i = 0; i < segs.size( ); ++i ) {
+			T t;
+			if( brute_cross( segs[i], ox, oy, dx, dy, r.max_t, t ) ) {
+				typename segment_bvh<T>::ray_hit hit = { i, t };
+				expect.push_back( hit );
+			}
+		}
+		std::sort( expect.begin( ), expect.end( ), []( const typename segment_bvh<T>::ray_hit& h1,
+		                                               const typename segment_bvh<T>::ray_hit& h2 ) {
+			return h1.t < h2.t || ( h1.t == h2.t && h1.index < h2.index ); } );
+
+		// every hit, nearest first
+		tree.all_hits( r.origin, r.direction, r.max_t, all );
+		bool same = all.size( ) == expect.size( );
+		for( unsigned int i = 0; same && i < all.size( ); ++i ) {
+			same = all[i].index == expect[i].index && all[i].t == expect[i].t;
+		}
+		CHECK( same );
+
+		// the first, any hit with the least t
+		typename segment_bvh<T>::ray_hit hit;
+		const bool found = tree.first_hit( r.origin, r.direction, r.max_t, hit );
+		CHECK( found == !expect.empty( ) && tree.any_hit( r.origin, r.direction, r.max_t ) == found );
+		if( found ) { CHECK( close( hit.t, expect[0].t ) && hits_at( segs, r, hit ) ); }
+		else { CHECK( hit.index == tree.npos ); }
+	}
+
+	// packets find the same first hits as single rays, ties maybe on
+	//   another segment
+	std::vector<typename segment_bvh<T>::ray_hit> hits;
+	tree.first_hits( rays, hits, 1 + queries % 3 );
+	CHECK( hits.size( ) == rays.size( ) );
+	for( unsigned int q = 0; q < rays.size( ); ++q ) {
+		typename segment_bvh<T>::ray_hit hit;
+		tree.first_hit( rays[q].origin, rays[q].direction, rays[q].max_t, hit );
+		if( hit.index == tree.npos ) { CHECK( hits[q].index == tree.npos ); }
+		else { CHECK( close( hits[q].t, hit.t ) && hits_at( segs, rays[q], hits[q] ) ); }
+	}
+}
+
+template<typename T>
+void check_type( std::mt19937& gen ) {
+	const unsigned int counts[] = { 0, 1, 5, 100, 3000 };
+	const unsigned int leaf_sizes[] = { 1, 4, 16 };
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		std::vector<segment<T,2>> segments( counts[c] );
+		std::vector<ends<T>> segs( counts[c] );
+		for( unsigned int i = 0; i < segments.size( ); ++i ) {
+			segments[i] = random_segment<T>( gen );
+			segs[i] = ends_of( segments[i] );
+		}
+		for( unsigned int l = 0; l < sizeof(leaf_sizes) / sizeof(leaf_sizes[0]); ++l ) {
+			const segment_bvh<T> tree( segments, leaf_sizes[l], 1 + l );
+			CHECK( tree.leaf_size( ) == leaf_sizes[l] );
+			check_tree( tree, segs, gen, 200 );
+		}
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_type<double>( gen );
+	check_type<float>( gen );
+
+	// enough segments for subtrees built in parallel, from endpoints
+	{
+		std::vector<ends<double>> segs( 40000 );
+		for( unsigned int i = 0; i < segs.size( ); ++i ) { segs[i] = ends_of( random_segment<double>( gen ) ); }
+		segment_bvh<double> tree;
+		tree.build( segs.size( ), [&]( unsigned int i, double& x0, double& y0, double& x1, double& y1 ) {
+			x0 = segs[i].x0; y0 = segs[i].y0; x1 = segs[i].x1; y1 = segs[i].y1;
+		}, 4, 4 );
+		check_tree( tree, segs, gen, 50 );
+	}
+
+	// from segment2 and point2, the same answers as from segment and point
+	{
+		std::vector<segment<float,2>> segments( 500 );
+		std::vector<segment2<float>> plain( segments.size( ) );
+		for( unsigned int i = 0; i < segments.size( ); ++i ) {
+			segments[i] = random_segment<float>( gen );
+			const ends<float> e = ends_of( segments[i] );
+			plain[i] = segment2<float>( e.x0, e.y0, e.x1, e.y1 );
+		}
+		const segment_bvh<float> tree( segments ), other( plain );
+		segment_bvh<float> built;
+		built.build( plain, 2 );
+		std::vector<segment_bvh<float>::ray_hit> all, expect;
+		bool same = other.size( ) == tree.size( ) && built.size( ) == tree.size( );
+		for( unsigned int q = 0; same && q < 200; ++q ) {
+			const segment_bvh<float>::ray r = random_ray<float>( gen );
+			const point2<float> origin( r.origin[0], r.origin[1] ), direction( r.direction[0], r.direction[1] );
+			segment_bvh<float>::ray_hit h1, h2, h3;
+			same = tree.first_hit( r.origin, r.direction, r.max_t, h1 ) == other.first_hit( origin, direction, r.max_t, h2 ) &&
+			       built.first_hit( origin, direction, r.max_t, h3 ) == ( h1.index != tree.npos ) &&
+			       h1.t == h2.t && close( h3.t, h1.t ) &&
+			       tree.any_hit( r.origin, r.direction, r.max_t ) == other.any_hit( origin, direction, r.max_t );
+			tree.all_hits( r.origin, r.direction, r.max_t, expect );
+			built.all_hits( origin, direction, r.max_t, all );
+			same = same && all.size( ) == expect.size( );
+			for( unsigned int i = 0; same && i < all.size( ); ++i ) {
+				same = all[i].index == expect[i].index && all[i].t == expect[i].t;
+			}
+		}
+		CHECK( same );
+	}
+
+	// a wall between two points
+	{
+		std::vector<segment<double,2>> wall( 1, segment<double,2>( point<double,2>( 1.0, -1.0 ), point<double,2>( 1.0, 1.0 ) ) );
+		const segment_bvh<double> tree( wall );
+		CHECK( !tree.visible( point<double,2>( 0.0, 0.0 ), point<double,2>( 2.0, 0.0 ) ) );
+		CHECK( tree.visible( point<double,2>( 0.0, 0.0 ), point<double,2>( 0.5, 3.0 ) ) );
+		CHECK( segment_bvh<double>( ).visible( point<double,2>( 0.0, 0.0 ), point<double,2>( 2.0, 0.0 ) ) );
+		CHECK( !tree.visible( point2<double>( 0.0, 0.0 ), point2<double>( 2.0, 0.0 ) ) );
+		CHECK( tree.visible( point2<double>( 0.0, 0.0 ), point2<double>( 0.5, 3.0 ) ) );
+	}
+
+	return check_result( "segment_bvh" );
+}
@@ -0,0 +1,175 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "../simple_polygon.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>       point_t;
+typedef std::vector<point_t> ring_t;
+
+// a star shaped ring round the origin, simple but usually concave
+ring_t star( std::mt19937& gen, unsigned int n ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	ring_t ring;
+	for( unsigned int i = 0; i < n; ++i ) {
+		const double angle = 2.0 * EUCLIB_PI * ( i + 0.5 * unit( gen ) ) / n;
+		const double radius = 0.1 + unit( gen );
+		ring.push_back( point_t{ radius * std::cos( angle ), radius * std::sin( angle ) } );
+	}
+	return ring;
+}
+
+// a comb of 'teeth' upward teeth on integral coordinates, many
+//   horizontal edges and split/merge vertices at equal heights
+ring_t comb( unsigned int teeth ) {
+	ring_t ring;
+	ring.push_back( point_t{ 0.0, 0.0 } );
+	ring.push_back( point_t{ 2.0 * teeth - 1.0, 0.0 } );
+	for( unsigned int i = teeth; i-- > 0; ) {
+		ring.push_back( point_t{ 2.0 * i + 1.0, 4.0 } );
+		ring.push_back( point_t{ 2.0 * i, 4.0 } );
+		if( i != 0 ) {
+			ring.push_back( point_t{ 2.0 * i, 1.0 } );
+			ring.push_back( point_t{ 2.0 * i - 1.0, 1.0 } );
+		}
+	}
+	return ring;
+}
+
+double cross( const point_t& a, const point_t& b, const point_t& c ) {
+	return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+}
+
+double area( const ring_t& ring ) {
+	double sum = 0.0;
+	for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+		sum += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+	}
+	return sum / 2.0;
+}
+
+// even-odd membership
+bool inside( const ring_t& ring, const point_t& pt ) {
+	bool in = false;
+	for( unsigned int i = 0, j = ring.size( ) - 1; i < ring.size( ); j = i++ ) {
+		if( ( ring[i].y > pt.y ) != ( ring[j].y > pt.y ) &&
+		    pt.x < ( ring[j].x - ring[i].x ) * ( pt.y - ring[i].y ) / ( ring[j].y - ring[i].y ) + ring[i].x ) {
+			in = !in;
+		}
+	}
+	return in;
+}
+
+// 'pt' strictly inside the counter-clockwise triangle, by more than 'eps'
+int in_triangle( const point_t& a, const point_t& b, const point_t& c, const point_t& pt, double eps ) {
+	const double len = std::max( std::max( std::hypot( b.x - a.x, b.y - a.y ), std::hypot( c.x - b.x, c.y - b.y ) ),
+	                             std::hypot( a.x - c.x, a.y - c.y ) );
+	const double d0 = cross( a, b, pt ), d1 = cross( b, c, pt ), d2 = cross( c, a, pt );
+	if( d0 > eps * len && d1 > eps * len && d2 > eps * len ) { return 1; }
+	if( d0 < -eps * len || d1 < -eps * len || d2 < -eps * len ) { return 0; }
+	return -1;  // too close to an edge to say
+}
+
+// triangles cover the ring exactly once: counter-clockwise, n-2 of them,
+//   same total area, and sampled points land in one triangle inside the
+//   ring and none outside
+void check_triangulation( const ring_t& ring, std::mt19937& gen ) {
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	const simple_polygon2<double> poly( ring );
+	std::vector<unsigned int> triangles;
+	poly.triangulate( triangles );
+	CHECK( triangles.size( ) == 3 * ( ring.size( ) - 2 ) );
+
+	double total = 0.0;
+	for( unsigned int k = 0; k + 2 < triangles.size( ); k += 3 ) {
+		CHECK( triangles[k] < ring.size( ) && triangles[k + 1] < ring.size( ) && triangles[k + 2] < ring.size( ) );
+		const double twice = cross( ring[triangles[k]], ring[triangles[k + 1]], ring[triangles[k + 2]] );
+		CHECK( twice >= 0.0 );
+		total += twice / 2.0;
+	}
+	CHECK( std::fabs( total - std::fabs( area( ring ) ) ) < 1e-9 * ( 1.0 + total ) );
+
+	const rect2<double> box = poly.bounding_box( );
+	for( unsigned int s = 0; s < 500; ++s ) {
+		const point_t pt{ box.l + unit( gen ) * box.width( ), box.t + unit( gen ) * box.height( ) };
+		unsigned int covered = 0;
+		bool unsure = false;
+		for( unsigned int k = 0; k + 2 < triangles.size( ); k += 3 ) {
+			const int in = in_triangle( ring[triangles[k]], ring[triangles[k + 1]], ring[triangles[k + 2]], pt, 1e-9 );
+			if( in < 0 ) { unsure = true; }
+			else { covered += in; }
+		}
+		if( !unsure ) { CHECK( covered == ( inside( ring, pt ) ? 1u : 0u ) ); }
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+
+	// random stars of both windings
+	for( unsigned int trial = 0; trial < 300; ++trial ) {
+		ring_t ring = star( gen, 3 + gen( ) % 60 );
+		if( trial % 2 == 1 ) { std::reverse( ring.begin( ), ring.end( ) ); }
+		check_triangulation( ring, gen );
+	}
+
+	// a large star, through the same reused sweep
+	{
+		detail::monotone_triangulator sweep;
+		std::vector<unsigned int> once, again;
+		const simple_polygon2<double> poly( star( gen, 5000 ) );
+		poly.triangulate( once, sweep );
+		poly.triangulate( again, sweep );
+		CHECK( once.size( ) == 3 * ( poly.size( ) - 2 ) && once == again );
+	}
+
+	// horizontal edges and vertices level with each other
+	for( unsigned int teeth = 1; teeth < 8; ++teeth ) {
+		ring_t ring = comb( teeth );
+		check_triangulation( ring, gen );
+		std::reverse( ring.begin( ), ring.end( ) );
+		check_triangulation( ring, gen );
+	}
+
+	// a closed ring drops its repeated point, too few points is null
+	{
+		ring_t ring = star( gen, 10 );
+		ring.push_back( ring.front( ) );
+		CHECK( simple_polygon2<double>( ring ).size( ) == 10 );
+		CHECK( simple_polygon2<double>( point_t{ 0, 0 }, point_t{ 1, 0 } ) == simple_polygon2<double>::null( ) );
+	}
+
+	// integral coordinates
+	{
+		const simple_polygon2<int> poly( point2<int>{ 0, 0 }, point2<int>{ 4, 0 }, point2<int>{ 4, 4 },
+		                                 point2<int>{ 2, 1 }, point2<int>{ 0, 4 } );
+		std::vector<unsigned int> triangles;
+		poly.triangulate( triangles );
+		CHECK( triangles.size( ) == 9 );
+		CHECK( poly.area( ) == 10.0f );
+	}
+
+	return check_result( "simple_polygon" );
+}
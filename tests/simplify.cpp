@@ -0,0 +1,104 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "../simplify.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef point2<double>       point_t;
+typedef std::vector<point_t> line_t;
+
+// a smooth random walk in the unit square, crossing itself often
+line_t track( unsigned int n, unsigned int seed ) {
+	std::mt19937 gen( seed );
+	std::normal_distribution<double> turn( 0.0, 0.05 );
+	line_t line( n );
+	double x = 0.5, y = 0.5, heading = 0.0;
+	for( unsigned int i = 0; i < n; ++i ) {
+		heading += turn( gen );
+		x += 1e-3 * std::cos( heading );
+		y += 1e-3 * std::sin( heading );
+		if( x < 0.0 || x > 1.0 ) { heading = EUCLIB_PI - heading; x = std::min( 1.0, std::max( 0.0, x ) ); }
+		if( y < 0.0 || y > 1.0 ) { heading = -heading; y = std::min( 1.0, std::max( 0.0, y ) ); }
+		line[i] = point_t( x, y );
+	}
+	return line;
+}
+
+bool cross( const point_t& a, const point_t& b, const point_t& c, const point_t& d ) {
+	return detail::segments_touch( a, b, c, d );
+}
+
+// every pair of non-adjacent chords that touch stands for two stretches
+//   of the line that touch as well
+unsigned int new_crossings( const line_t& line, const std::vector<unsigned int>& kept, bool closed ) {
+	const unsigned int n = line.size( ), m = kept.size( );
+	const unsigned int segs = closed ? m : m - 1;
+	unsigned int count = 0;
+	for( unsigned int s = 0; s < segs; ++s ) {
+		for( unsigned int t = s + 2; t < segs; ++t ) {
+			if( closed && s == 0 && t == segs - 1 ) { continue; }
+			if( !cross( line[kept[s]], line[kept[( s + 1 ) % m]], line[kept[t]], line[kept[( t + 1 ) % m]] ) ) { continue; }
+			const unsigned int s_end = s + 1 == m ? n : kept[s + 1];
+			const unsigned int t_end = t + 1 == m ? n : kept[t + 1];
+			bool before = false;
+			for( unsigned int i = kept[s]; i < s_end && !before; ++i ) {
+				for( unsigned int j = kept[t]; j < t_end && !before; ++j ) {
+					before = cross( line[i], line[( i + 1 ) % n], line[j], line[( j + 1 ) % n] );
+				}
+			}
+			if( !before ) { ++count; }
+		}
+	}
+	return count;
+}
+
+int main( ) {
+	for( unsigned int trial = 0; trial < 20; ++trial ) {
+		const line_t line = track( 3000, trial );
+		const double tolerance = 0.002 * ( 1 + trial % 5 );
+		for( unsigned int closed = 0; closed < 2; ++closed ) {
+			std::vector<unsigned int> plain, kept;
+			douglas_peucker( line, tolerance, plain, false, closed != 0 );
+			douglas_peucker( line, tolerance, kept, true, closed != 0 );
+			CHECK( kept.size( ) >= plain.size( ) );
+			CHECK( kept.front( ) == 0 );
+			CHECK( closed || kept.back( ) == line.size( ) - 1 );
+			for( unsigned int i = 1; i < kept.size( ); ++i ) { CHECK( kept[i - 1] < kept[i] ); }
+			CHECK( new_crossings( line, kept, closed != 0 ) == 0 );
+		}
+	}
+
+	// a line crossing itself keeps the crossing without extra vertices
+	{
+		line_t line;
+		for( unsigned int i = 0; i <= 100; ++i ) { line.push_back( point_t( i, i % 2 == 0 ? 0.0 : 0.01 ) ); }
+		for( unsigned int i = 0; i <= 100; ++i ) { line.push_back( point_t( 50.005, 50.0 - i ) ); }
+		std::vector<unsigned int> plain, kept;
+		douglas_peucker( line, 0.1, plain, false );
+		douglas_peucker( line, 0.1, kept, true );
+		CHECK( kept == plain );
+	}
+
+	return check_result( "simplify" );
+}
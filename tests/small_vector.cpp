@@ -0,0 +1,162 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cmath>
+
+#include "../polygon.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// counts live objects so a leak or a double destroy shows up
+struct counted {
+	static int& live( ) {
+		static int count = 0;
+		return count;
+	}
+
+	std::string value;
+
+	counted( ) { ++live( ); }
+	counted( int v ) : value( std::to_string( v ) ) { ++live( ); }
+	counted( const counted& c ) : value( c.value ) { ++live( ); }
+	counted( counted&& c ) : value( std::move( c.value ) ) { ++live( ); }
+	~counted( ) { --live( ); }
+
+	counted& operator = ( const counted& c ) { value = c.value; return *this; }
+	counted& operator = ( counted&& c ) { value = std::move( c.value ); return *this; }
+	bool operator == ( const counted& c ) const { return value == c.value; }
+};
+
+typedef small_vector<counted, 4> small_t;
+
+bool same( const small_t& vec, const std::vector<counted>& ref ) {
+	if( vec.size( ) != ref.size( ) ) { return false; }
+	for( unsigned int i = 0; i < ref.size( ); ++i ) {
+		if( !( vec[i] == ref[i] ) ) { return false; }
+	}
+	return std::vector<counted>( vec.begin( ), vec.end( ) ) == ref;
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+
+	// random operations against std::vector
+	{
+		small_t vec, other;
+		std::vector<counted> ref, other_ref;
+		for( unsigned int step = 0; step < 20000; ++step ) {
+			const int value = gen( ) % 1000;
+			switch( gen( ) % 12 ) {
+				case 0: case 1: case 2:
+					vec.push_back( counted( value ) ); ref.push_back( counted( value ) ); break;
+				case 3:
+					vec.emplace_back( value ); ref.emplace_back( value ); break;
+				case 4:
+					if( !ref.empty( ) ) { vec.pop_back( ); ref.pop_back( ); }
+					break;
+				case 5: {
+					const unsigned int count = gen( ) % 10;
+					vec.resize( count, counted( value ) ); ref.resize( count, counted( value ) );
+					break;
+				}
+				case 6:
+					if( !ref.empty( ) ) {
+						const unsigned int at = gen( ) % ref.size( );
+						vec.erase( vec.begin( ) + at ); ref.erase( ref.begin( ) + at );
+					}
+					break;
+				case 7:
+					// pushing one of its own elements while full
+					if( !ref.empty( ) ) {
+						const unsigned int at = gen( ) % ref.size( );
+						vec.push_back( vec[at] ); ref.push_back( ref[at] );
+					}
+					break;
+				case 8:
+					vec.swap( other ); ref.swap( other_ref ); break;
+				case 9:
+					other = vec; other_ref = ref; break;
+				case 10:
+					other = std::move( vec ); other_ref = std::move( ref );
+					CHECK( vec.empty( ) );
+					vec.clear( ); ref.clear( );
+					break;
+				case 11:
+					if( gen( ) % 8 == 0 ) { vec.clear( ); ref.clear( ); }
+					break;
+			}
+			CHECK( same( vec, ref ) && same( other, other_ref ) );
+			CHECK( vec.capacity( ) >= vec.size( ) && ( vec.is_inline( ) ? vec.capacity( ) == 4 : vec.capacity( ) > 4 ) );
+		}
+		CHECK( counted::live( ) == int( ref.size( ) + other_ref.size( ) + vec.size( ) + other.size( ) ) );
+	}
+	CHECK( counted::live( ) == 0 );
+
+	// stays inline up to N, then spills to the heap
+	{
+		small_t vec;
+		for( int i = 0; i < 4; ++i ) { vec.push_back( counted( i ) ); }
+		CHECK( vec.is_inline( ) );
+		vec.push_back( counted( 4 ) );
+		CHECK( !vec.is_inline( ) && vec.size( ) == 5 );
+		CHECK( vec.front( ).value == "0" && vec.back( ).value == "4" );
+
+		// a copy of a small vector is inline again, a move takes the buffer
+		small_t copy( vec.begin( ), vec.begin( ) + 3 );
+		CHECK( copy.is_inline( ) && copy.size( ) == 3 );
+		const counted* data = vec.data( );
+		small_t moved( std::move( vec ) );
+		CHECK( moved.data( ) == data && vec.empty( ) && vec.is_inline( ) );
+
+		// moving and swapping inline elements
+		small_t other( std::move( copy ) );
+		CHECK( other.is_inline( ) && other.size( ) == 3 && copy.empty( ) );
+		swap( other, moved );
+		CHECK( other.size( ) == 5 && !other.is_inline( ) && moved.size( ) == 3 && moved.is_inline( ) );
+		CHECK( other[4].value == "4" && moved[2].value == "2" );
+
+		bool threw = false;
+		try { moved.at( 3 ); }
+		catch( const std::out_of_range& ) { threw = true; }
+		CHECK( threw );
+	}
+	CHECK( counted::live( ) == 0 );
+
+	// polygons above and below the inline size
+	{
+		for( unsigned int n = 3; n < 40; ++n ) {
+			std::vector<point2<double>> points;
+			for( unsigned int i = 0; i < n; ++i ) {
+				const double angle = 2.0 * EUCLIB_PI * i / n;
+				points.push_back( point2<double>{ std::cos( angle ), std::sin( angle ) } );
+			}
+			polygon2<double> poly( points );
+			CHECK( poly.size( ) == n );
+			polygon2<double> copy( poly ), moved( std::move( poly ) );
+			CHECK( copy == moved && moved.size( ) == n );
+		}
+	}
+
+	return check_result( "small_vector" );
+}
@@ -0,0 +1,150 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <iterator>
+
+#include "../sweep_and_prune.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef std::set<std::pair<unsigned int, unsigned int>> pair_set;
+
+// coordinates on a coarse grid so boxes often touch and share ends
+template<typename T>
+rect2<T> random_box( std::mt19937& gen ) {
+	const T l = T( gen( ) % 200 ), t = T( gen( ) % 200 );
+	return rect2<T>( l, l + T( 1 + gen( ) % 12 ), t, t + T( 1 + gen( ) % 12 ) );
+}
+
+template<typename T>
+pair_set brute_pairs( const std::vector<rect2<T>>& boxes ) {
+	pair_set result;
+	for( unsigned int j = 0; j < boxes.size( ); ++j ) {
+		if( boxes[j] == rect2<T>::null( ) ) { continue; }
+		for( unsigned int i = 0; i < j; ++i ) {
+			if( boxes[i] == rect2<T>::null( ) ) { continue; }
+			if( boxes[i].l <= boxes[j].r && boxes[j].l <= boxes[i].r &&
+			    boxes[i].t <= boxes[j].b && boxes[j].t <= boxes[i].b ) { result.insert( std::make_pair( i, j ) ); }
+		}
+	}
+	return result;
+}
+
+// frames of random moves, inserts and removes; each step( ) reports
+//   exactly the change in the overlapping pairs
+template<typename T>
+void check_frames( std::mt19937& gen, bool both_axes, unsigned int count ) {
+	sweep_and_prune<T> sweep( both_axes );
+	std::vector<rect2<T>> boxes;   // handle -> box, null once removed
+	std::vector<unsigned int> live;
+	pair_set now;
+	std::vector<std::pair<unsigned int, unsigned int>> added, removed, all;
+	for( unsigned int frame = 0; frame < 60; ++frame ) {
+		// a burst of inserts now and then, to take the rebuild path
+		const unsigned int inserts = frame == 0 ? count : ( frame % 15 == 0 ? count / 4 : gen( ) % 5 );
+		for( unsigned int i = 0; i < inserts; ++i ) {
+			const rect2<T> box = random_box<T>( gen );
+			const unsigned int h = sweep.insert( box );
+			CHECK( h != sweep.npos && sweep.contains( h ) );
+			if( h >= boxes.size( ) ) { boxes.resize( h + 1, rect2<T>::null( ) ); }
+			CHECK( boxes[h] == rect2<T>::null( ) );
+			boxes[h] = box;
+			live.push_back( h );
+		}
+		for( unsigned int i = 0; i < 3 && !live.empty( ); ++i ) {
+			const unsigned int at = gen( ) % live.size( );
+			CHECK( sweep.remove( live[at] ) && !sweep.remove( live[at] ) );
+			boxes[live[at]] = rect2<T>::null( );
+			live[at] = live.back( );
+			live.pop_back( );
+		}
+		// most boxes drift a little, a few jump
+		for( unsigned int i = 0; i < live.size( ); ++i ) {
+			const unsigned int h = live[i];
+			rect2<T> box = boxes[h];
+			if( gen( ) % 20 == 0 ) { box = random_box<T>( gen ); }
+			else {
+				const T dx = T( int( gen( ) % 5 ) - 2 ), dy = T( int( gen( ) % 5 ) - 2 );
+				box = rect2<T>( box.l + dx, box.r + dx, box.t + dy, box.b + dy );
+			}
+			CHECK( sweep.update( h, box ) );
+			boxes[h] = box;
+		}
+
+		added.clear( );
+		removed.clear( );
+		sweep.step( added, removed );
+		const pair_set next = brute_pairs( boxes );
+		pair_set expect_added, expect_removed;
+		std::set_difference( next.begin( ), next.end( ), now.begin( ), now.end( ),
+		                     std::inserter( expect_added, expect_added.end( ) ) );
+		std::set_difference( now.begin( ), now.end( ), next.begin( ), next.end( ),
+		                     std::inserter( expect_removed, expect_removed.end( ) ) );
+		CHECK( pair_set( added.begin( ), added.end( ) ) == expect_added && added.size( ) == expect_added.size( ) );
+		CHECK( pair_set( removed.begin( ), removed.end( ) ) == expect_removed && removed.size( ) == expect_removed.size( ) );
+		sweep.pairs( all );
+		CHECK( pair_set( all.begin( ), all.end( ) ) == next && sweep.pair_count( ) == next.size( ) );
+		CHECK( sweep.size( ) == live.size( ) );
+		now = next;
+	}
+
+	// removing everything reports every pair gone
+	for( unsigned int i = 0; i < live.size( ); ++i ) { sweep.remove( live[i] ); }
+	added.clear( );
+	removed.clear( );
+	sweep.step( added, removed );
+	CHECK( sweep.empty( ) && added.empty( ) && pair_set( removed.begin( ), removed.end( ) ) == now );
+	CHECK( sweep.insert( rect2<T>::null( ) ) == sweep.npos );
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	const unsigned int counts[] = { 1, 30, 400 };
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		check_frames<double>( gen, true, counts[c] );
+		check_frames<double>( gen, false, counts[c] );
+		check_frames<int>( gen, true, counts[c] );
+		check_frames<int>( gen, false, counts[c] );
+	}
+
+	// a box inserted and removed between steps is never reported, and a
+	//   removed handle is not reused before the step reporting it
+	{
+		sweep_and_prune<double> sweep;
+		std::vector<std::pair<unsigned int, unsigned int>> added, removed;
+		const unsigned int a = sweep.insert( rect2<double>( 0.0, 1.0, 0.0, 1.0 ) );
+		const unsigned int b = sweep.insert( rect2<double>( 1.0, 2.0, 1.0, 2.0 ) );
+		const unsigned int c = sweep.insert( rect2<double>( 0.5, 1.5, 0.5, 1.5 ) );
+		sweep.remove( c );
+		sweep.step( added, removed );
+		CHECK( added.size( ) == 1 && added[0] == std::make_pair( a, b ) && removed.empty( ) );
+		sweep.remove( b );
+		const unsigned int d = sweep.insert( rect2<double>( 5.0, 6.0, 5.0, 6.0 ) );
+		CHECK( d != b );
+		added.clear( );
+		sweep.step( added, removed );
+		CHECK( added.empty( ) && removed.size( ) == 1 && removed[0] == std::make_pair( a, b ) );
+	}
+
+	return check_result( "sweep_and_prune" );
+}
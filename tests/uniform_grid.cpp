@@ -0,0 +1,197 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../uniform_grid.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+// small integral coordinates so keys often sit on window and radius edges
+template<typename T>
+point2<T> random_point( std::mt19937& gen ) {
+	return point2<T>( T( gen( ) % 100 ), T( gen( ) % 100 ) );
+}
+
+template<typename T>
+rect2<T> random_box( std::mt19937& gen, unsigned int size ) {
+	const T l = T( gen( ) % 100 ), t = T( gen( ) % 100 );
+	return rect2<T>( l, l + T( 1 + gen( ) % size ), t, t + T( 1 + gen( ) % size ) );
+}
+
+template<typename T>
+double box_distance( const rect2<T>& box, const point2<T>& pt ) {
+	const double dx = std::max( std::max( double(box.l) - pt.x, double(pt.x) - box.r ), 0.0 );
+	const double dy = std::max( std::max( double(box.t) - pt.y, double(pt.y) - box.b ), 0.0 );
+	return dx * dx + dy * dy;
+}
+
+// every key filed once, under its own cell, in input order within the cell
+template<typename T>
+void check_cells( const uniform_grid<T>& grid, const std::vector<point2<T>>& centres,
+                  const std::vector<bool>& stored ) {
+	CHECK( grid.cell_start( 0 ) == 0 && grid.cell_start( grid.cells( ) ) == grid.size( ) );
+	std::vector<unsigned int> seen( centres.size( ), 0 );
+	for( unsigned int c = 0; c < grid.cells( ); ++c ) {
+		for( const unsigned int* i = grid.cell_begin( c ); i != grid.cell_end( c ); ++i ) {
+			++seen[*i];
+			CHECK( grid.cell_of( centres[*i] ) == c );
+			if( i != grid.cell_begin( c ) ) { CHECK( *( i - 1 ) < *i ); }
+		}
+	}
+	for( unsigned int i = 0; i < centres.size( ); ++i ) { CHECK( seen[i] == ( stored[i] ? 1u : 0u ) ); }
+}
+
+template<typename T>
+void check_points( std::mt19937& gen ) {
+	const unsigned int counts[] = { 0, 1, 2, 50, 2000 };
+	const double cell_sizes[] = { 0.0, 1.0, 7.5, 1000.0 };
+	uniform_grid<T> grid;
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		std::vector<point2<T>> points( counts[c] );
+		std::vector<bool> stored( counts[c], true );
+		for( unsigned int i = 0; i < points.size( ); ++i ) { points[i] = random_point<T>( gen ); }
+		for( unsigned int s = 0; s < sizeof(cell_sizes) / sizeof(cell_sizes[0]); ++s ) {
+			// rebuilt in place, with varying thread counts
+			grid.build( points, cell_sizes[s], 1 + s % 3 );
+			CHECK( grid.size( ) == points.size( ) );
+			check_cells( grid, points, stored );
+
+			std::vector<unsigned int> found, expect;
+			for( unsigned int q = 0; q < 50; ++q ) {
+				const rect2<T> window = random_box<T>( gen, 30 );
+				found.clear( );
+				grid.search( window, found );
+				expect.clear( );
+				for( unsigned int i = 0; i < points.size( ); ++i ) {
+					if( window.l <= points[i].x && points[i].x <= window.r &&
+					    window.t <= points[i].y && points[i].y <= window.b ) { expect.push_back( i ); }
+				}
+				std::sort( found.begin( ), found.end( ) );
+				CHECK( found == expect );
+
+				const point2<T> pt = random_point<T>( gen );
+				const double distance = double( gen( ) % 20 );
+				found.clear( );
+				grid.radius( pt, distance, found );
+				expect.clear( );
+				for( unsigned int i = 0; i < points.size( ); ++i ) {
+					const double dx = double(points[i].x) - pt.x, dy = double(points[i].y) - pt.y;
+					if( dx * dx + dy * dy <= distance * distance ) { expect.push_back( i ); }
+				}
+				std::sort( found.begin( ), found.end( ) );
+				CHECK( found == expect );
+
+				// one ring of cells holds everything in the 3 x 3 block
+				if( !points.empty( ) ) {
+					const unsigned int cell = grid.cell_of( pt );
+					const int col = cell % grid.columns( ), row = cell / grid.columns( );
+					found.clear( );
+					grid.neighbourhood( pt, 1, [&]( unsigned int i ) { found.push_back( i ); return true; } );
+					expect.clear( );
+					for( unsigned int i = 0; i < points.size( ); ++i ) {
+						const unsigned int other = grid.cell_of( points[i] );
+						const int dc = int(other % grid.columns( )) - col, dr = int(other / grid.columns( )) - row;
+						if( std::abs( dc ) <= 1 && std::abs( dr ) <= 1 ) { expect.push_back( i ); }
+					}
+					std::sort( found.begin( ), found.end( ) );
+					CHECK( found == expect );
+				}
+			}
+
+			// a visitor can stop the search
+			unsigned int visits = 0;
+			grid.search( rect2<T>( T(0), T(100), T(0), T(100) ), [&]( unsigned int ) { return ++visits < 3; } );
+			CHECK( visits == std::min( 3u, grid.size( ) ) );
+		}
+	}
+}
+
+template<typename T>
+void check_boxes( std::mt19937& gen ) {
+	const unsigned int counts[] = { 1, 40, 1500 };
+	for( unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c ) {
+		std::vector<rect2<T>> boxes( counts[c] );
+		std::vector<bool> stored( counts[c], true );
+		for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+			// mostly small boxes, a few large ones to widen the searches
+			boxes[i] = random_box<T>( gen, i % 50 == 0 ? 40 : 6 );
+			if( i % 23 == 5 ) { boxes[i] = rect2<T>::null( ); stored[i] = false; }
+		}
+		const uniform_grid<T> grid( boxes, 0.0, 1 + c % 3 );
+		CHECK( grid.size( ) == unsigned( std::count( stored.begin( ), stored.end( ), true ) ) );
+
+		std::vector<unsigned int> found, expect;
+		for( unsigned int q = 0; q < 100; ++q ) {
+			const rect2<T> window = random_box<T>( gen, 20 );
+			found.clear( );
+			grid.search( window, found );
+			expect.clear( );
+			for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+				if( stored[i] && boxes[i].l <= window.r && window.l <= boxes[i].r &&
+				    boxes[i].t <= window.b && window.t <= boxes[i].b ) { expect.push_back( i ); }
+			}
+			std::sort( found.begin( ), found.end( ) );
+			CHECK( found == expect );
+
+			const point2<T> pt = random_point<T>( gen );
+			const double distance = double( gen( ) % 15 );
+			found.clear( );
+			grid.radius( pt, distance, found );
+			expect.clear( );
+			for( unsigned int i = 0; i < boxes.size( ); ++i ) {
+				if( stored[i] && box_distance( boxes[i], pt ) <= distance * distance ) { expect.push_back( i ); }
+			}
+			std::sort( found.begin( ), found.end( ) );
+			CHECK( found == expect );
+		}
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	check_points<double>( gen );
+	check_points<int>( gen );
+	check_boxes<double>( gen );
+	check_boxes<int>( gen );
+
+	// null points are left out
+	{
+		std::vector<point2<double>> points( 10, point2<double>( 1.0, 2.0 ) );
+		points[3] = point2<double>::null( );
+		const uniform_grid<double> grid( points );
+		std::vector<unsigned int> found;
+		grid.radius( point2<double>( 1.0, 2.0 ), 0.0, found );
+		CHECK( grid.size( ) == 9 && found.size( ) == 9 && std::find( found.begin( ), found.end( ), 3u ) == found.end( ) );
+	}
+
+	// an empty grid answers nothing
+	{
+		const uniform_grid<double> grid;
+		std::vector<unsigned int> found;
+		grid.search( rect2<double>( 0.0, 1.0, 0.0, 1.0 ), found );
+		grid.radius( point2<double>( 0.0, 0.0 ), 5.0, found );
+		CHECK( grid.empty( ) && found.empty( ) );
+	}
+
+	return check_result( "uniform_grid" );
+}
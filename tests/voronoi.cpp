@@ -0,0 +1,196 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "../voronoi.hpp"
+#include "check.hpp"
+
+using namespace euclib;
+
+typedef std::vector<point2<double>> points_t;
+
+double distance_sq( const point2<double>& a, const point2<double>& b ) {
+	return ( a.x - b.x ) * ( a.x - b.x ) + ( a.y - b.y ) * ( a.y - b.y );
+}
+
+unsigned int brute_nearest( const points_t& sites, const point2<double>& pt ) {
+	unsigned int best = 0;
+	for( unsigned int i = 1; i < sites.size( ); ++i ) {
+		if( distance_sq( sites[i], pt ) < distance_sq( sites[best], pt ) ) { best = i; }
+	}
+	return best;
+}
+
+// 'pt' inside or on the counterclockwise convex 'cell', within 'eps'
+bool in_cell( const std::vector<point2<double>>& cell, const point2<double>& pt, double eps ) {
+	if( cell.size( ) < 3 ) { return false; }
+	for( unsigned int i = 0; i < cell.size( ); ++i ) {
+		const point2<double>& a = cell[i];
+		const point2<double>& b = cell[( i + 1 ) % cell.size( )];
+		const double cross = ( b.x - a.x ) * ( pt.y - a.y ) - ( b.y - a.y ) * ( pt.x - a.x );
+		if( cross < -eps ) { return false; }
+	}
+	return true;
+}
+
+// a linear field, which Sibson's interpolation reproduces exactly
+double field( const point2<double>& pt ) {
+	return 2.0 * pt.x + 3.0 * pt.y + 1.0;
+}
+
+void check_diagram( const points_t& sites, const rect2<double>& box ) {
+	const voronoi<double> diagram( sites, box, 1 );
+	CHECK( diagram.size( ) == sites.size( ) );
+
+	// the cells tile the bounds, each corner nearer its site than any other
+	double total = 0.0;
+	std::vector<point2<double>> cell;
+	for( unsigned int i = 0; i < sites.size( ); ++i ) {
+		const double area = diagram.cell_area( i );
+		CHECK( area >= -1e-12 );
+		total += area;
+		if( i >= 200 ) { continue; }
+		diagram.cell( i, cell );
+		for( unsigned int j = 0; j < cell.size( ); ++j ) {
+			const double own = distance_sq( cell[j], sites[i] );
+			CHECK( distance_sq( cell[j], sites[brute_nearest( sites, cell[j] )] ) >= own - 1e-9 );
+		}
+	}
+	CHECK( std::fabs( total - box.width( ) * box.height( ) ) < 1e-9 );
+
+	// each corner of the bounds is in the cell of its nearest site
+	const point2<double> corners[4] = { box.tl( ), box.tr( ), box.br( ), box.bl( ) };
+	for( unsigned int k = 0; k < 4; ++k ) {
+		diagram.cell( brute_nearest( sites, corners[k] ), cell );
+		CHECK( in_cell( cell, corners[k], 1e-9 ) );
+	}
+
+	std::mt19937 gen( 5 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	points_t queries( 1000 );
+	for( unsigned int k = 0; k < queries.size( ); ++k ) {
+		queries[k] = point2<double>( box.l + unit( gen ) * box.width( ), box.t + unit( gen ) * box.height( ) );
+	}
+
+	// nearest site, single and batched
+	std::vector<unsigned int> nearest;
+	diagram.nearest_site( queries, nearest, 2 );
+	CHECK( nearest.size( ) == queries.size( ) );
+	for( unsigned int k = 0; k < queries.size( ); ++k ) {
+		const double best = distance_sq( sites[brute_nearest( sites, queries[k] )], queries[k] );
+		CHECK( distance_sq( sites[diagram.nearest_site( queries[k] )], queries[k] ) == best );
+		CHECK( nearest[k] == diagram.nearest_site( queries[k] ) );
+	}
+
+	// Sibson's interpolation reproduces a linear field inside the hull
+	//   and the site values at the sites
+	std::vector<double> values( sites.size( ) );
+	for( unsigned int i = 0; i < sites.size( ); ++i ) { values[i] = field( sites[i] ); }
+	std::vector<double> results;
+	diagram.interpolate( queries, values, results, 2 );
+	CHECK( results.size( ) == queries.size( ) );
+	for( unsigned int k = 0; k < queries.size( ); ++k ) {
+		double single = 0.0;
+		const bool inside = diagram.interpolate( queries[k], values, single );
+		CHECK( inside == !std::isnan( results[k] ) );
+		if( inside ) {
+			CHECK( std::fabs( single - field( queries[k] ) ) < 1e-9 );
+			CHECK( std::fabs( results[k] - field( queries[k] ) ) < 1e-9 );
+		}
+	}
+	for( unsigned int i = 0; i < sites.size( ) && i < 200; ++i ) {
+		double value = 0.0;
+		CHECK( diagram.interpolate( sites[i], values, value ) );
+		CHECK( std::fabs( value - values[i] ) < 1e-9 );
+	}
+}
+
+int main( ) {
+	std::mt19937 gen( 1 );
+	std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+	const rect2<double> box( 0.0, 1.0, 0.0, 1.0 );
+
+	// uniform sites
+	{
+		points_t sites( 2000 );
+		for( unsigned int i = 0; i < sites.size( ); ++i ) { sites[i] = point2<double>( unit( gen ), unit( gen ) ); }
+		check_diagram( sites, box );
+	}
+
+	// a regular grid, cocircular everywhere, with one duplicate site
+	{
+		points_t sites;
+		for( unsigned int i = 0; i < 30; ++i ) {
+			for( unsigned int j = 0; j < 30; ++j ) { sites.push_back( point2<double>( ( i + 0.5 ) / 30, ( j + 0.5 ) / 30 ) ); }
+		}
+		sites.push_back( sites[5] );
+		check_diagram( sites, box );
+	}
+
+	// sites spilling past the bounds
+	{
+		points_t sites( 2000 );
+		for( unsigned int i = 0; i < sites.size( ); ++i ) {
+			sites[i] = point2<double>( unit( gen ) * 2.0 - 0.5, unit( gen ) * 2.0 - 0.5 );
+		}
+		check_diagram( sites, box );
+	}
+
+	// a single triangle
+	{
+		points_t sites;
+		sites.push_back( point2<double>( 0.1, 0.1 ) );
+		sites.push_back( point2<double>( 0.9, 0.2 ) );
+		sites.push_back( point2<double>( 0.5, 0.9 ) );
+		check_diagram( sites, box );
+	}
+
+	// a lone site takes the whole bounds, two sites split them
+	{
+		points_t sites( 1, point2<double>( 0.3, 0.6 ) );
+		check_diagram( sites, box );
+		sites.push_back( point2<double>( 0.7, 0.2 ) );
+		check_diagram( sites, box );
+	}
+
+	// sites on a line, across the bounds, along an edge and with a
+	//   duplicate, interpolated linearly between neighbours on the line
+	{
+		points_t sites;
+		for( unsigned int i = 0; i < 9; ++i ) { sites.push_back( point2<double>( 0.125 * ( i * 5 % 9 ), 0.125 * ( i * 5 % 9 ) ) ); }
+		sites.push_back( sites[3] );
+		check_diagram( sites, box );
+		const voronoi<double> diagram( sites, box, 1 );
+		CHECK( diagram.cell_area( 9 ) == 0.0 );
+		std::vector<double> values( sites.size( ) );
+		for( unsigned int i = 0; i < sites.size( ); ++i ) { values[i] = field( sites[i] ); }
+		double value = 0.0;
+		CHECK( diagram.interpolate( point2<double>( 0.3, 0.3 ), values, value ) );
+		CHECK( std::fabs( value - field( point2<double>( 0.3, 0.3 ) ) ) < 1e-9 );
+		CHECK( !diagram.interpolate( point2<double>( 0.3, 0.4 ), values, value ) );
+
+		sites.clear( );
+		for( unsigned int i = 0; i < 50; ++i ) { sites.push_back( point2<double>( 0.0, unit( gen ) ) ); }
+		check_diagram( sites, box );
+	}
+
+	return check_result( "voronoi" );
+}
@@ -0,0 +1,426 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_UNIFORM_GRID_HPP
+#define EUBLIB_UNIFORM_GRID_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <cmath>
+#include "point.hpp"
+#include "rect.hpp"
+#include "euclib_parallel.hpp"
+
+/*
+ * Uniform grid over point2 or rect2
+ *
+ *   The bounding box of the keys is cut into square cells and the keys are
+ *   counting sorted by cell: one array holds every key grouped by cell,
+ *   and cell c owns [cell_start( c ), cell_start( c + 1 )) of it. There are
+ *   no per cell containers, so a rebuild is a handful of passes over flat
+ *   arrays, each run with parallel_for( ). Inside a cell keys keep the
+ *   order they were given in, whatever the thread count.
+ *
+ *   A rect2 is filed under the cell of its centre only. Searches widen by
+ *   the largest half width and height seen, which suits objects of
+ *   similar size; one huge box makes every search scan more cells.
+ *
+ *   Searches report the index the key had in the vector it was built
+ *   from. Null keys are left out.
+ */
+
+namespace euclib {
+
+template<typename T>
+class uniform_grid {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with scalar types
+	//   or types with a specific specialization
+	static_assert( limit_t::is_specialized,
+	               "type not compatible with std::numeric_limits" );
+
+	// prefix sums run in blocks of this many cells
+	static const unsigned int scan_block = 1 << 16;
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+
+// Variables
+private:
+
+	unsigned int               m_count;
+	unsigned int               m_stride;      // 2 for points, 4 for boxes
+	double                     m_left, m_top;
+	double                     m_cell_size;
+	double                     m_inv_cell;
+	unsigned int               m_columns, m_rows;
+	double                     m_reach_x;     // largest half width of a box
+	double                     m_reach_y;     // largest half height of a box
+	std::vector<unsigned int>  m_cell_start;  // cells( ) + 1 offsets
+	std::vector<unsigned int>  m_indices;     // input index of each key, by cell
+	std::vector<T>             m_coords;      // x, y or l, r, t, b, by cell
+
+	// scratch kept between builds
+	std::vector<unsigned int>               m_cell_of;
+	std::unique_ptr<std::atomic<unsigned int>[]>  m_cursor;
+	unsigned int                            m_cursor_size;
+
+
+// Constructors
+public:
+
+	uniform_grid( ) :
+		m_count( 0 ),
+		m_stride( 2 ),
+		m_left( 0.0 ), m_top( 0.0 ),
+		m_cell_size( 1.0 ), m_inv_cell( 1.0 ),
+		m_columns( 1 ), m_rows( 1 ),
+		m_reach_x( 0.0 ), m_reach_y( 0.0 ),
+		m_cell_start( 2, 0 ),
+		m_cursor_size( 0 )
+	{ }
+
+	// 'cell_size' 0 picks one giving about two keys a cell, 'threads' as
+	//   for parallel_for( ), 0 for one per core
+	uniform_grid( const std::vector<point2<T>>& points, double cell_size = 0.0,
+	              unsigned int threads = 0 ) :
+		m_cursor_size( 0 ) {
+		build( points, cell_size, threads );
+	}
+
+	uniform_grid( const std::vector<rect2<T>>& boxes, double cell_size = 0.0,
+	              unsigned int threads = 0 ) :
+		m_cursor_size( 0 ) {
+		build( boxes, cell_size, threads );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const    { return m_count; }
+	bool empty( ) const           { return m_count == 0; }
+	unsigned int columns( ) const { return m_columns; }
+	unsigned int rows( ) const    { return m_rows; }
+	unsigned int cells( ) const   { return m_columns * m_rows; }
+	double cell_size( ) const     { return m_cell_size; }
+
+	void build( const std::vector<point2<T>>& points, double cell_size = 0.0,
+	            unsigned int threads = 0 ) {
+		m_stride = 2;
+		build( points.size( ), cell_size, threads,
+		       [&]( unsigned int i ) { return points[i] == point2<T>::null( ); },
+		       [&]( unsigned int i, double& x, double& y, double& hw, double& hh ) {
+		           x = points[i].x;
+		           y = points[i].y;
+		           hw = hh = 0.0;
+		       },
+		       [&]( unsigned int i, T* out ) {
+		           out[0] = points[i].x;
+		           out[1] = points[i].y;
+		       } );
+	}
+
+	void build( const std::vector<rect2<T>>& boxes, double cell_size = 0.0,
+	            unsigned int threads = 0 ) {
+		m_stride = 4;
+		build( boxes.size( ), cell_size, threads,
+		       [&]( unsigned int i ) { return boxes[i] == rect2<T>::null( ); },
+		       [&]( unsigned int i, double& x, double& y, double& hw, double& hh ) {
+		           const rect2<T>& rc = boxes[i];
+		           x = ( double(rc.l) + double(rc.r) ) / 2.0;
+		           y = ( double(rc.t) + double(rc.b) ) / 2.0;
+		           hw = ( double(rc.r) - double(rc.l) ) / 2.0;
+		           hh = ( double(rc.b) - double(rc.t) ) / 2.0;
+		       },
+		       [&]( unsigned int i, T* out ) {
+		           out[0] = boxes[i].l;
+		           out[1] = boxes[i].r;
+		           out[2] = boxes[i].t;
+		           out[3] = boxes[i].b;
+		       } );
+	}
+
+	// cell holding 'pt', the nearest cell when it is outside the grid
+	unsigned int cell_of( const point2<T>& pt ) const {
+		return cell_row( pt.y ) * m_columns + cell_column( pt.x );
+	}
+
+	unsigned int cell( unsigned int column, unsigned int row ) const {
+		return row * m_columns + column;
+	}
+
+	// the input indices filed under cell 'c' are [cell_begin( c ), cell_end( c ))
+	const unsigned int* cell_begin( unsigned int c ) const { return m_indices.data( ) + m_cell_start[c]; }
+	const unsigned int* cell_end( unsigned int c ) const   { return m_indices.data( ) + m_cell_start[c + 1]; }
+	unsigned int cell_start( unsigned int c ) const        { return m_cell_start[c]; }
+
+	// calls visit( index ) for every key filed in the cells up to 'rings'
+	//   cells away from 'c' in x and y, stopping early if visit returns false
+	template<typename Visitor>
+	void neighbourhood( unsigned int c, unsigned int rings, Visitor visit ) const {
+		unsigned int column = c % m_columns, row = c / m_columns;
+		unsigned int c0 = column > rings ? column - rings : 0;
+		unsigned int r0 = row > rings ? row - rings : 0;
+		unsigned int c1 = std::min( column + rings, m_columns - 1 );
+		unsigned int r1 = std::min( row + rings, m_rows - 1 );
+		scan( c0, c1, r0, r1, [&]( unsigned int pos ) { return visit( m_indices[pos] ); } );
+	}
+
+	template<typename Visitor>
+	void neighbourhood( const point2<T>& pt, unsigned int rings, Visitor visit ) const {
+		neighbourhood( cell_of( pt ), rings, visit );
+	}
+
+	// calls visit( index ) for every key within 'distance' of 'pt', for a
+	//   box its nearest point, stopping early if visit returns false
+	template<typename Visitor>
+	void radius( const point2<T>& pt, double distance, Visitor visit ) const {
+		if( m_count == 0 || distance < 0.0 ) { return; }
+		const double x = pt.x, y = pt.y, bound = distance * distance;
+		scan( cell_column( x - distance - m_reach_x ), cell_column( x + distance + m_reach_x ),
+		      cell_row( y - distance - m_reach_y ), cell_row( y + distance + m_reach_y ),
+		      [&]( unsigned int pos ) {
+		          const T* k = &m_coords[std::size_t(pos) * m_stride];
+		          double dx, dy;
+		          if( m_stride == 2 ) {
+		              dx = double(k[0]) - x;
+		              dy = double(k[1]) - y;
+		          }
+		          else {
+		              dx = std::max( std::max( double(k[0]) - x, x - double(k[1]) ), 0.0 );
+		              dy = std::max( std::max( double(k[2]) - y, y - double(k[3]) ), 0.0 );
+		          }
+		          return dx * dx + dy * dy > bound || visit( m_indices[pos] );
+		      } );
+	}
+
+	// appends the indices of the keys within 'distance' of 'pt'
+	void radius( const point2<T>& pt, double distance, std::vector<unsigned int>& result ) const {
+		radius( pt, distance, [&]( unsigned int index ) {
+			result.push_back( index );
+			return true;
+		} );
+	}
+
+	// calls visit( index ) for every key inside or overlapping 'window',
+	//   stopping early if visit returns false. Touching counts.
+	template<typename Visitor>
+	void search( const rect2<T>& window, Visitor visit ) const {
+		if( m_count == 0 || window == rect2<T>::null( ) ) { return; }
+		const T l = window.l, r = window.r, t = window.t, b = window.b;
+		scan( cell_column( double(l) - m_reach_x ), cell_column( double(r) + m_reach_x ),
+		      cell_row( double(t) - m_reach_y ), cell_row( double(b) + m_reach_y ),
+		      [&]( unsigned int pos ) {
+		          const T* k = &m_coords[std::size_t(pos) * m_stride];
+		          bool hit = m_stride == 2 ?
+		              ( l <= k[0] && k[0] <= r && t <= k[1] && k[1] <= b ) :
+		              ( k[0] <= r && l <= k[1] && k[2] <= b && t <= k[3] );
+		          return !hit || visit( m_indices[pos] );
+		      } );
+	}
+
+	void search( const rect2<T>& window, std::vector<unsigned int>& result ) const {
+		search( window, [&]( unsigned int index ) {
+			result.push_back( index );
+			return true;
+		} );
+	}
+
+private:
+
+	unsigned int cell_column( double x ) const {
+		double c = ( x - m_left ) * m_inv_cell;
+		return c < 1.0 ? 0 : ( c >= m_columns - 1 ? m_columns - 1 : (unsigned int)c );
+	}
+
+	unsigned int cell_row( double y ) const {
+		double c = ( y - m_top ) * m_inv_cell;
+		return c < 1.0 ? 0 : ( c >= m_rows - 1 ? m_rows - 1 : (unsigned int)c );
+	}
+
+	// calls fn( position ) for every key in cells [c0, c1] x [r0, r1]
+	//   until it returns false
+	template<typename Function>
+	void scan( unsigned int c0, unsigned int c1, unsigned int r0, unsigned int r1, Function fn ) const {
+		for( unsigned int row = r0; row <= r1; ++row ) {
+			// a row of cells is one run of the array
+			unsigned int first = m_cell_start[row * m_columns + c0];
+			unsigned int last = m_cell_start[row * m_columns + c1 + 1];
+			for( unsigned int pos = first; pos < last; ++pos ) {
+				if( !fn( pos ) ) { return; }
+			}
+		}
+	}
+
+	// post increment, a locked add only when other threads may race
+	static unsigned int bump( std::atomic<unsigned int>& counter, unsigned int threads ) {
+		if( threads > 1 ) { return counter.fetch_add( 1, std::memory_order_relaxed ); }
+		unsigned int value = counter.load( std::memory_order_relaxed );
+		counter.store( value + 1, std::memory_order_relaxed );
+		return value;
+	}
+
+	// 'skip( i )' is true for null keys, 'centre( i, x, y, hw, hh )' gives
+	//   the filing point and half extents and 'store( i, out )' writes
+	//   m_stride coordinates
+	template<typename Skip, typename Centre, typename Store>
+	void build( unsigned int count, double cell_size, unsigned int threads,
+	            Skip skip, Centre centre, Store store ) {
+		if( threads == 0 ) { threads = default_threads( ); }
+		#ifdef EUCLIB_NO_THREADS
+			threads = 1;
+		#endif
+
+		// bounds and largest half extents, one slot per chunk
+		const unsigned int chunk = 1 << 14;
+		const unsigned int chunks = ( count + chunk - 1 ) / chunk;
+		std::vector<double> bounds( 6 * std::size_t(chunks) );
+		std::vector<unsigned int> kept( chunks );
+		parallel_for( 0, chunks, [&]( unsigned int c ) {
+			double l = std::numeric_limits<double>::max( ), t = l, r = -l, b = -l, hw = 0.0, hh = 0.0;
+			unsigned int n = 0;
+			for( unsigned int i = c * chunk, e = std::min( count, i + chunk ); i < e; ++i ) {
+				if( skip( i ) ) { continue; }
+				double x, y, w, h;
+				centre( i, x, y, w, h );
+				l = std::min( l, x ); r = std::max( r, x );
+				t = std::min( t, y ); b = std::max( b, y );
+				hw = std::max( hw, w ); hh = std::max( hh, h );
+				++n;
+			}
+			double* out = &bounds[6 * std::size_t(c)];
+			out[0] = l; out[1] = r; out[2] = t; out[3] = b; out[4] = hw; out[5] = hh;
+			kept[c] = n;
+		}, threads, 1 );
+
+		double l = std::numeric_limits<double>::max( ), t = l, r = -l, b = -l;
+		m_reach_x = m_reach_y = 0.0;
+		m_count = 0;
+		for( unsigned int c = 0; c < chunks; ++c ) {
+			if( kept[c] == 0 ) { continue; }
+			const double* in = &bounds[6 * std::size_t(c)];
+			l = std::min( l, in[0] ); r = std::max( r, in[1] );
+			t = std::min( t, in[2] ); b = std::max( b, in[3] );
+			m_reach_x = std::max( m_reach_x, in[4] );
+			m_reach_y = std::max( m_reach_y, in[5] );
+			m_count += kept[c];
+		}
+		if( m_count == 0 ) { l = r = t = b = 0.0; }
+		const double extent = std::max( r - l, b - t );
+
+		// about two keys a cell, and never more than four cells a key
+		if( !( cell_size > 0.0 ) ) {
+			cell_size = std::sqrt( 2.0 * std::max( r - l, extent * 1e-6 ) *
+			                             std::max( b - t, extent * 1e-6 ) / std::max( m_count, 1u ) );
+			if( !( cell_size > 0.0 ) ) { cell_size = 1.0; }
+		}
+		const double max_cells = 4.0 * std::max( m_count, 1u );
+		while( ( std::floor( ( r - l ) / cell_size ) + 1.0 ) * ( std::floor( ( b - t ) / cell_size ) + 1.0 ) > max_cells ) {
+			cell_size *= 1.5;
+		}
+		m_left = l;
+		m_top = t;
+		m_cell_size = cell_size;
+		m_inv_cell = 1.0 / cell_size;
+		m_columns = (unsigned int)std::floor( ( r - l ) * m_inv_cell ) + 1;
+		m_rows = (unsigned int)std::floor( ( b - t ) * m_inv_cell ) + 1;
+		const unsigned int cells = m_columns * m_rows;
+
+		// counting sort: cell of every key, keys per cell, offsets, scatter
+		m_cell_of.resize( count );
+		if( m_cursor_size < cells ) {
+			m_cursor.reset( new std::atomic<unsigned int>[cells] );
+			m_cursor_size = cells;
+		}
+		std::atomic<unsigned int>* cursor = m_cursor.get( );
+		parallel_for( 0, cells, [&]( unsigned int c ) {
+			cursor[c].store( 0, std::memory_order_relaxed );
+		}, threads, 4096 );
+		parallel_for( 0, count, [&]( unsigned int i ) {
+			if( skip( i ) ) {
+				m_cell_of[i] = npos;
+				return;
+			}
+			double x, y, w, h;
+			centre( i, x, y, w, h );
+			unsigned int c = cell_row( y ) * m_columns + cell_column( x );
+			m_cell_of[i] = c;
+			bump( cursor[c], threads );
+		}, threads, 4096 );
+
+		m_cell_start.resize( cells + 1 );
+		const unsigned int blocks = ( cells + scan_block - 1 ) / scan_block;
+		std::vector<unsigned int> block_sum( blocks + 1, 0 );
+		parallel_for( 0, blocks, [&]( unsigned int k ) {
+			unsigned int sum = 0;
+			for( unsigned int c = k * scan_block, e = std::min( cells, c + scan_block ); c < e; ++c ) {
+				sum += cursor[c].load( std::memory_order_relaxed );
+			}
+			block_sum[k + 1] = sum;
+		}, threads, 1 );
+		for( unsigned int k = 0; k < blocks; ++k ) { block_sum[k + 1] += block_sum[k]; }
+		parallel_for( 0, blocks, [&]( unsigned int k ) {
+			unsigned int sum = block_sum[k];
+			for( unsigned int c = k * scan_block, e = std::min( cells, c + scan_block ); c < e; ++c ) {
+				unsigned int n = cursor[c].load( std::memory_order_relaxed );
+				m_cell_start[c] = sum;
+				cursor[c].store( sum, std::memory_order_relaxed );
+				sum += n;
+			}
+		}, threads, 1 );
+		m_cell_start[cells] = m_count;
+
+		m_indices.resize( m_count );
+		parallel_for( 0, count, [&]( unsigned int i ) {
+			if( m_cell_of[i] == npos ) { return; }
+			m_indices[bump( cursor[m_cell_of[i]], threads )] = i;
+		}, threads, 4096 );
+
+		// threads scatter in any order, put each cell back in input order
+		if( threads > 1 ) {
+			parallel_for( 0, cells, [&]( unsigned int c ) {
+				std::sort( m_indices.begin( ) + m_cell_start[c], m_indices.begin( ) + m_cell_start[c + 1] );
+			}, threads, 1024 );
+		}
+
+		m_coords.resize( std::size_t(m_count) * m_stride );
+		parallel_for( 0, m_count, [&]( unsigned int pos ) {
+			store( m_indices[pos], &m_coords[std::size_t(pos) * m_stride] );
+		}, threads, 4096 );
+	}
+}; // End class uniform_grid
+
+template<typename T>
+const unsigned int uniform_grid<T>::npos;
+
+template<typename T>
+const unsigned int uniform_grid<T>::scan_block;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_UNIFORM_GRID_HPP
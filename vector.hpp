@@ -19,6 +19,8 @@
 #ifndef EUBLIB_VECTOR_HPP
 #define EUBLIB_VECTOR_HPP
 
+#include <algorithm>
+
 #include "euclib_math.hpp"
 #include "point.hpp"
 
@@ -0,0 +1,640 @@
+/*
+ *	Copyright (C) 2010-2011 Jonathan Marini
+ *
+ *	This program is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU Lesser General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	This program is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU Lesser General Public License for more details.
+ *
+ *	You should have received a copy of the GNU Lesser General Public License
+ *	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EUBLIB_VORONOI_HPP
+#define EUBLIB_VORONOI_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "point.hpp"
+#include "rect.hpp"
+#include "euclib_parallel.hpp"
+#include "predicates.hpp"
+#include "delaunay.hpp"
+
+/*
+ * Voronoi diagram of point2 sites, clipped to a rect2
+ *
+ *   The diagram is read off the Delaunay triangulation: the cell of a
+ *   site has a corner at the circumcentre of each triangle around it.
+ *   Cells of hull sites, and cells with a corner outside the bounds, are
+ *   instead cut from the bounds by the bisector with each Delaunay
+ *   neighbour, which is all the cell depends on.
+ *
+ *   Cells are kept in one array of corners, counterclockwise in the
+ *   sense of orient2d( ), cell i being vertices( )[offsets( )[i]] up to
+ *   vertices( )[offsets( )[i + 1]]. Duplicate sites but one, and sites
+ *   whose cell misses the bounds, have empty cells. When the sites are
+ *   all on a line there is no triangulation: the sites are then sorted
+ *   along the line and each cell is the strip of the bounds between the
+ *   bisectors with the sites before and after it, a lone site taking the
+ *   whole bounds.
+ *
+ *   nearest_site( ) starts at a site from a coarse grid and walks to
+ *   nearer Delaunay neighbours, which always ends at the nearest site.
+ *   interpolate( ) is Sibson's natural neighbour interpolation [1]: the
+ *   weight of each site is the area the query's cell would take from
+ *   its cell, found from the triangles whose circumcircle holds the
+ *   query [2]. Queries outside the hull have no natural neighbours. For
+ *   sites on a line the hull is the line between the end sites, along
+ *   which the two sites either side are interpolated linearly.
+ *
+ * References
+ *   [1] R. Sibson. "A brief description of natural neighbour
+ *         interpolation". Interpreting Multivariate Data, pp. 21-36,
+ *         1981.
+ *   [2] D. F. Watson. "Contouring: A Guide to the Analysis and Display
+ *         of Spatial Data". Pergamon, 1992.
+ */
+
+namespace euclib {
+
+template<typename T>
+class voronoi {
+// Typedefs
+protected:
+
+	typedef std::numeric_limits<T> limit_t;
+
+	// This class can only be used with floating point types
+	static_assert( !limit_t::is_integer, "voronoi needs a floating point type" );
+
+public:
+
+	static const unsigned int npos = ~0u;
+
+	// scratch space for interpolate( ), kept between calls to reuse the memory
+	struct query_buffer {
+		std::vector<unsigned int>  stack;
+		std::vector<unsigned int>  cavity;   // triangles whose circumcircle holds the query
+	};
+
+
+// Variables
+private:
+
+	delaunay<T>                m_delaunay;
+	rect2<T>                   m_bounds;
+	std::vector<unsigned int>  m_offsets;   // size( ) + 1
+	std::vector<point2<T>>     m_vertices;
+	std::vector<unsigned int>  m_inedges;   // a half edge ending at each site, hull ones first
+	std::vector<unsigned int>  m_line;      // sites on a line, in order along it, one of each duplicate
+	std::vector<double>        m_along;     // the position of each of m_line on the line
+	std::vector<unsigned int>  m_grid;      // a site in or near each cell
+	unsigned int               m_columns;
+	unsigned int               m_rows;
+	double                     m_grid_l, m_grid_t, m_grid_sx, m_grid_sy;
+
+
+// Constructors
+public:
+
+	voronoi( ) : m_columns( 0 ), m_rows( 0 ) { }
+
+	// 'threads' as for parallel_for( ), 0 for one per core
+	voronoi( const std::vector<point2<T>>& sites, const rect2<T>& bounds, unsigned int threads = 0 ) {
+		build( sites, bounds, threads );
+	}
+
+
+// Methods
+public:
+
+	unsigned int size( ) const { return m_delaunay.points( ).size( ); }
+	bool empty( ) const        { return m_delaunay.points( ).empty( ); }
+
+	const rect2<T>& bounds( ) const                   { return m_bounds; }
+	const std::vector<point2<T>>& sites( ) const      { return m_delaunay.points( ); }
+	const delaunay<T>& triangulation( ) const         { return m_delaunay; }
+	const std::vector<unsigned int>& offsets( ) const { return m_offsets; }
+	const std::vector<point2<T>>& vertices( ) const   { return m_vertices; }
+
+	void build( const std::vector<point2<T>>& sites, const rect2<T>& bounds, unsigned int threads = 0 ) {
+		m_bounds = bounds;
+		m_delaunay.build( sites, threads );
+		const unsigned int n = sites.size( );
+		const std::vector<unsigned int>& tri = m_delaunay.triangles( );
+		const std::vector<unsigned int>& twin = m_delaunay.halfedges( );
+
+		m_inedges.assign( n, npos );
+		for( unsigned int e = 0; e < tri.size( ); ++e ) {
+			const unsigned int p = tri[next( e )];
+			if( m_inedges[p] == npos || twin[e] == npos ) { m_inedges[p] = e; }
+		}
+		build_grid( );
+		build_line( );
+		if( m_delaunay.empty( ) ) {
+			// strips between the bisectors with the sites either side
+			std::vector<double> polygon, clipped;
+			std::vector<unsigned int> neighbours;
+			m_offsets.assign( n + 1, 0 );
+			m_vertices.clear( );
+			std::vector<unsigned int> order( n, npos );
+			for( unsigned int k = 0; k < m_line.size( ); ++k ) { order[m_line[k]] = k; }
+			for( unsigned int i = 0; i < n; ++i ) {
+				const unsigned int k = order[i];
+				if( k != npos ) {
+					neighbours.clear( );
+					if( k > 0 ) { neighbours.push_back( m_line[k - 1] ); }
+					if( k + 1 < m_line.size( ) ) { neighbours.push_back( m_line[k + 1] ); }
+					clip_bounds( i, neighbours, polygon, clipped, m_vertices );
+				}
+				m_offsets[i + 1] = m_vertices.size( );
+			}
+			return;
+		}
+
+		// circumcentres, relative to the first corner for precision
+		std::vector<double> centres( 2 * tri.size( ) / 3 );
+		parallel_for( 0, tri.size( ) / 3, [&]( unsigned int t ) {
+			circumcentre( sites[tri[3 * t]], sites[tri[3 * t + 1]], sites[tri[3 * t + 2]],
+			              centres[2 * t], centres[2 * t + 1] );
+		}, threads, 4096 );
+
+		// cells by blocks, each into its own array, then joined
+		const unsigned int block = 1024;
+		const unsigned int blocks = ( n + block - 1 ) / block;
+		std::vector<std::vector<point2<T>>> corners( blocks );
+		m_offsets.assign( n + 1, 0 );
+		parallel_for( 0, blocks, [&]( unsigned int b ) {
+			std::vector<double> polygon, clipped;
+			std::vector<unsigned int> around, neighbours;
+			for( unsigned int i = b * block, e = std::min( i + block, n ); i < e; ++i ) {
+				const std::size_t first = corners[b].size( );
+				cell( i, centres, polygon, clipped, around, neighbours, corners[b] );
+				m_offsets[i + 1] = corners[b].size( ) - first;
+			}
+		}, threads, 1 );
+		for( unsigned int i = 0; i < n; ++i ) { m_offsets[i + 1] += m_offsets[i]; }
+		m_vertices.resize( m_offsets[n] );
+		parallel_for( 0, blocks, [&]( unsigned int b ) {
+			std::copy( corners[b].begin( ), corners[b].end( ), m_vertices.begin( ) + m_offsets[b * block] );
+			std::vector<point2<T>>( ).swap( corners[b] );
+		}, threads, 1 );
+	}
+
+	// the corners of the cell of site i, counterclockwise
+	void cell( unsigned int i, std::vector<point2<T>>& result ) const {
+		result.assign( m_vertices.begin( ) + m_offsets[i], m_vertices.begin( ) + m_offsets[i + 1] );
+	}
+
+	double cell_area( unsigned int i ) const {
+		double area = 0.0;
+		for( unsigned int j = m_offsets[i], e = m_offsets[i + 1]; j < e; ++j ) {
+			const point2<T>& a = m_vertices[j];
+			const point2<T>& b = m_vertices[j + 1 == e ? m_offsets[i] : j + 1];
+			area += double(a.x) * double(b.y) - double(b.x) * double(a.y);
+		}
+		return area / 2.0;
+	}
+
+	// the site closest to 'pt', or npos when there are none. Of
+	//   duplicate sites only one is ever returned.
+	unsigned int nearest_site( const point2<T>& pt ) const {
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+		if( sites.empty( ) ) { return npos; }
+		if( m_delaunay.empty( ) ) {
+			// all on a line, nearest is nearest along it
+			const unsigned int k = line_position( pt );
+			if( k == 0 ) { return m_line.front( ); }
+			if( k == m_line.size( ) ) { return m_line.back( ); }
+			const unsigned int a = m_line[k - 1], b = m_line[k];
+			return distance_sq( sites[b], pt ) < distance_sq( sites[a], pt ) ? b : a;
+		}
+
+		const std::vector<unsigned int>& tri = m_delaunay.triangles( );
+		const std::vector<unsigned int>& twin = m_delaunay.halfedges( );
+		unsigned int site = seed( pt );
+		double closest = distance_sq( sites[site], pt );
+		for( bool moved = true; moved; ) {
+			moved = false;
+			const unsigned int start = m_inedges[site];
+			unsigned int e = start;
+			do {
+				const unsigned int other[2] = { tri[e], tri[prev( e )] };
+				for( unsigned int k = 0; k < 2; ++k ) {
+					const double d = distance_sq( sites[other[k]], pt );
+					if( d < closest ) {
+						closest = d;
+						site = other[k];
+						moved = true;
+					}
+				}
+				if( moved ) { break; }
+				e = twin[next( e )];
+			} while( e != npos && e != start );
+		}
+		return site;
+	}
+
+	// nearest_site( ) for every query in parallel
+	void nearest_site( const std::vector<point2<T>>& queries, std::vector<unsigned int>& result,
+	                   unsigned int threads = 0 ) const {
+		result.resize( queries.size( ) );
+		parallel_for( 0, queries.size( ), [&]( unsigned int q ) {
+			result[q] = nearest_site( queries[q] );
+		}, threads, 256 );
+	}
+
+	// Sibson's interpolation at 'pt' of 'values', one per site. Returns
+	//   false, leaving 'result' alone, when 'pt' is outside the hull.
+	bool interpolate( const point2<T>& pt, const std::vector<T>& values, T& result,
+	                  query_buffer& buffer ) const {
+		if( m_delaunay.empty( ) ) { return interpolate_line( pt, values, result ); }
+		const unsigned int start = locate( pt );
+		if( start == npos ) { return false; }
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+		const std::vector<unsigned int>& tri = m_delaunay.triangles( );
+		const std::vector<unsigned int>& twin = m_delaunay.halfedges( );
+		const double px = pt.x, py = pt.y;
+
+		for( unsigned int e = 3 * start; e < 3 * start + 3; ++e ) {
+			const point2<T>& a = sites[tri[e]];
+			if( a.x == pt.x && a.y == pt.y ) {
+				result = values[tri[e]];
+				return true;
+			}
+		}
+		for( unsigned int e = 3 * start; e < 3 * start + 3; ++e ) {
+			if( twin[e] != npos ) { continue; }
+			const point2<T>& a = sites[tri[e]];
+			const point2<T>& b = sites[tri[next( e )]];
+			if( orient2d( a.x, a.y, b.x, b.y, px, py ) == 0.0 ) {
+				// on the hull, between two sites only
+				const double s = std::fabs( b.x - a.x ) > std::fabs( b.y - a.y ) ?
+				                 ( px - a.x ) / ( double(b.x) - a.x ) : ( py - a.y ) / ( double(b.y) - a.y );
+				result = T( ( 1.0 - s ) * values[tri[e]] + s * values[tri[next( e )]] );
+				return true;
+			}
+		}
+
+		// the triangles whose circumcircle holds 'pt'
+		buffer.cavity.assign( 1, start );
+		buffer.stack.assign( 1, start );
+		while( !buffer.stack.empty( ) ) {
+			const unsigned int t = buffer.stack.back( );
+			buffer.stack.pop_back( );
+			for( unsigned int e = 3 * t; e < 3 * t + 3; ++e ) {
+				if( twin[e] == npos || in_cavity( buffer, twin[e] / 3 ) ) { continue; }
+				const unsigned int n = twin[e] / 3;
+				const point2<T>& a = sites[tri[3 * n]];
+				const point2<T>& b = sites[tri[3 * n + 1]];
+				const point2<T>& c = sites[tri[3 * n + 2]];
+				if( incircle( a.x, a.y, b.x, b.y, c.x, c.y, px, py ) > 0.0 ) {
+					buffer.cavity.push_back( n );
+					buffer.stack.push_back( n );
+				}
+			}
+		}
+
+		// each site at the end of a cavity edge loses the region between
+		//   the new corners either side of it and the old corners round it
+		double total = 0.0, sum = 0.0;
+		for( unsigned int c = 0; c < buffer.cavity.size( ); ++c ) {
+			for( unsigned int e = 3 * buffer.cavity[c]; e < 3 * buffer.cavity[c] + 3; ++e ) {
+				if( !on_boundary( buffer, e ) ) { continue; }
+				const unsigned int site = tri[next( e )];
+				double x0, y0, x, y, cx, cy, area = 0.0;
+				corner( pt, sites[tri[e]], sites[site], x0, y0 );
+				x = x0;
+				y = y0;
+				unsigned int f = e;
+				for( ;; ) {
+					corner( pt, sites[tri[f]], sites[tri[next( f )]], sites[tri[prev( f )]], cx, cy );
+					area += x * cy - cx * y;
+					x = cx;
+					y = cy;
+					f = next( f );
+					if( on_boundary( buffer, f ) ) { break; }
+					f = twin[f];
+				}
+				corner( pt, sites[site], sites[tri[next( f )]], cx, cy );
+				area += x * cy - cx * y + cx * y0 - x0 * cy;
+				area = std::fabs( area );
+				total += area;
+				sum += area * values[site];
+			}
+		}
+		if( !( total > 0.0 ) || !std::isfinite( total ) ) {
+			result = values[nearest_site( pt )];
+			return true;
+		}
+		result = T( sum / total );
+		return true;
+	}
+
+	bool interpolate( const point2<T>& pt, const std::vector<T>& values, T& result ) const {
+		query_buffer buffer;
+		return interpolate( pt, values, result, buffer );
+	}
+
+	// interpolate( ) for every query in parallel, NaN outside the hull
+	void interpolate( const std::vector<point2<T>>& queries, const std::vector<T>& values,
+	                  std::vector<T>& result, unsigned int threads = 0 ) const {
+		result.assign( queries.size( ), limit_t::quiet_NaN( ) );
+		const unsigned int block = 256;
+		const unsigned int blocks = ( queries.size( ) + block - 1 ) / block;
+		parallel_for( 0, blocks, [&]( unsigned int b ) {
+			query_buffer buffer;
+			for( unsigned int q = b * block, e = std::min<unsigned int>( q + block, queries.size( ) ); q < e; ++q ) {
+				interpolate( queries[q], values, result[q], buffer );
+			}
+		}, threads, 1 );
+	}
+
+private:
+
+	static unsigned int next( unsigned int e ) { return delaunay<T>::next_halfedge( e ); }
+	static unsigned int prev( unsigned int e ) { return delaunay<T>::prev_halfedge( e ); }
+
+	static double distance_sq( const point2<T>& a, const point2<T>& b ) {
+		const double dx = double(a.x) - b.x, dy = double(a.y) - b.y;
+		return dx * dx + dy * dy;
+	}
+
+	static void circumcentre( const point2<T>& a, const point2<T>& b, const point2<T>& c,
+	                          double& x, double& y ) {
+		const double bx = double(b.x) - a.x, by = double(b.y) - a.y;
+		const double cx = double(c.x) - a.x, cy = double(c.y) - a.y;
+		const double bl = bx * bx + by * by, cl = cx * cx + cy * cy;
+		const double d = 2.0 * ( bx * cy - by * cx );
+		x = a.x + ( cy * bl - by * cl ) / d;
+		y = a.y + ( bx * cl - cx * bl ) / d;
+	}
+
+	// circumcentre of 'pt', a and b, relative to 'pt'
+	static void corner( const point2<T>& pt, const point2<T>& a, const point2<T>& b,
+	                    double& x, double& y ) {
+		corner( pt, pt, a, b, x, y );
+	}
+
+	// circumcentre of a, b and c, relative to 'pt'
+	static void corner( const point2<T>& pt, const point2<T>& a, const point2<T>& b,
+	                    const point2<T>& c, double& x, double& y ) {
+		const double ax = double(a.x) - pt.x, ay = double(a.y) - pt.y;
+		const double bx = double(b.x) - a.x, by = double(b.y) - a.y;
+		const double cx = double(c.x) - a.x, cy = double(c.y) - a.y;
+		const double bl = bx * bx + by * by, cl = cx * cx + cy * cy;
+		const double d = 2.0 * ( bx * cy - by * cx );
+		x = ax + ( cy * bl - by * cl ) / d;
+		y = ay + ( bx * cl - cx * bl ) / d;
+	}
+
+	static bool in_cavity( const query_buffer& buffer, unsigned int t ) {
+		return std::find( buffer.cavity.begin( ), buffer.cavity.end( ), t ) != buffer.cavity.end( );
+	}
+
+	bool on_boundary( const query_buffer& buffer, unsigned int e ) const {
+		const unsigned int o = m_delaunay.halfedges( )[e];
+		return o == npos || !in_cavity( buffer, o / 3 );
+	}
+
+	// the triangle holding 'pt', or npos outside the hull. A walk that
+	//   always crosses the first edge 'pt' is beyond ends on a Delaunay
+	//   triangulation.
+	unsigned int locate( const point2<T>& pt ) const {
+		if( m_delaunay.empty( ) ) { return npos; }
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+		const std::vector<unsigned int>& tri = m_delaunay.triangles( );
+		const std::vector<unsigned int>& twin = m_delaunay.halfedges( );
+		unsigned int t = m_inedges[seed( pt )] / 3;
+		for( bool moved = true; moved; ) {
+			moved = false;
+			for( unsigned int e = 3 * t; e < 3 * t + 3 && !moved; ++e ) {
+				const point2<T>& a = sites[tri[e]];
+				const point2<T>& b = sites[tri[next( e )]];
+				if( orient2d( a.x, a.y, b.x, b.y, pt.x, pt.y ) < 0.0 ) {
+					if( twin[e] == npos ) { return npos; }
+					t = twin[e] / 3;
+					moved = true;
+				}
+			}
+		}
+		return t;
+	}
+
+	// the sites in order along their line, when there is no triangulation
+	void build_line( ) {
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+		m_line.clear( );
+		m_along.clear( );
+		if( !m_delaunay.empty( ) || sites.empty( ) ) { return; }
+
+		std::vector<unsigned int> order( sites.size( ) );
+		for( unsigned int i = 0; i < order.size( ); ++i ) { order[i] = i; }
+		std::sort( order.begin( ), order.end( ), [&]( unsigned int a, unsigned int b ) {
+			if( sites[a].x != sites[b].x ) { return sites[a].x < sites[b].x; }
+			if( sites[a].y != sites[b].y ) { return sites[a].y < sites[b].y; }
+			return a < b;
+		} );
+		for( unsigned int k = 0; k < order.size( ); ++k ) {
+			if( m_line.empty( ) || sites[order[k]] != sites[m_line.back( )] ) { m_line.push_back( order[k] ); }
+		}
+		m_along.resize( m_line.size( ) );
+		for( unsigned int k = 0; k < m_line.size( ); ++k ) { m_along[k] = along( sites[m_line[k]] ); }
+	}
+
+	// position of 'pt' projected on the line of the sites
+	double along( const point2<T>& pt ) const {
+		const point2<T>& a = m_delaunay.points( )[m_line.front( )];
+		const point2<T>& b = m_delaunay.points( )[m_line.back( )];
+		return ( double(pt.x) - a.x ) * ( double(b.x) - a.x ) + ( double(pt.y) - a.y ) * ( double(b.y) - a.y );
+	}
+
+	// how many of m_line are at or before 'pt' along the line
+	unsigned int line_position( const point2<T>& pt ) const {
+		return std::upper_bound( m_along.begin( ), m_along.end( ), along( pt ) ) - m_along.begin( );
+	}
+
+	// interpolate( ) when the sites are on a line
+	bool interpolate_line( const point2<T>& pt, const std::vector<T>& values, T& result ) const {
+		if( m_line.empty( ) ) { return false; }
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+		const unsigned int k = line_position( pt );
+		if( k == 0 ) { return false; }
+		const unsigned int i = m_line[k - 1];
+		const point2<T>& a = sites[i];
+		if( a == pt ) {
+			result = values[i];
+			return true;
+		}
+		if( k == m_line.size( ) ) { return false; }
+		const point2<T>& b = sites[m_line[k]];
+		if( orient2d( a.x, a.y, b.x, b.y, pt.x, pt.y ) != 0.0 ) { return false; }
+		const double s = ( along( pt ) - m_along[k - 1] ) / ( m_along[k] - m_along[k - 1] );
+		result = T( ( 1.0 - s ) * values[i] + s * values[m_line[k]] );
+		return true;
+	}
+
+	// about four sites per grid cell, each cell keeping one site in it
+	//   or, if empty, one from a cell near it
+	void build_grid( ) {
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+		m_grid.clear( );
+		m_columns = m_rows = 0;
+		if( m_delaunay.empty( ) ) { return; }
+
+		double l = std::numeric_limits<double>::max( ), t = l, r = -l, b = -l;
+		for( unsigned int i = 0; i < sites.size( ); ++i ) {
+			l = std::min<double>( l, sites[i].x );
+			r = std::max<double>( r, sites[i].x );
+			t = std::min<double>( t, sites[i].y );
+			b = std::max<double>( b, sites[i].y );
+		}
+		const unsigned int side = std::min( 1024u, std::max( 1u, unsigned( std::sqrt( sites.size( ) / 4.0 ) ) ) );
+		m_columns = m_rows = side;
+		m_grid_l = l;
+		m_grid_t = t;
+		m_grid_sx = r > l ? side / ( r - l ) : 0.0;
+		m_grid_sy = b > t ? side / ( b - t ) : 0.0;
+		m_grid.assign( side * side, npos );
+		for( unsigned int i = 0; i < sites.size( ); ++i ) {
+			if( m_inedges[i] != npos ) { m_grid[grid_cell( sites[i] )] = i; }
+		}
+
+		// along rows, then down columns for rows left empty
+		for( unsigned int y = 0; y < side; ++y ) {
+			unsigned int* row = &m_grid[y * side];
+			unsigned int last = npos;
+			for( unsigned int x = 0; x < side; ++x ) {
+				if( row[x] == npos ) { row[x] = last; }
+				else { last = row[x]; }
+			}
+			for( unsigned int x = side; x-- > 0; ) {
+				if( row[x] == npos ) { row[x] = last; }
+				else { last = row[x]; }
+			}
+		}
+		for( unsigned int x = 0; x < side; ++x ) {
+			unsigned int last = npos;
+			for( unsigned int y = 0; y < side; ++y ) {
+				if( m_grid[y * side + x] == npos ) { m_grid[y * side + x] = last; }
+				else { last = m_grid[y * side + x]; }
+			}
+			for( unsigned int y = side; y-- > 0; ) {
+				if( m_grid[y * side + x] == npos ) { m_grid[y * side + x] = last; }
+				else { last = m_grid[y * side + x]; }
+			}
+		}
+	}
+
+	unsigned int grid_cell( const point2<T>& pt ) const {
+		const double fx = ( pt.x - m_grid_l ) * m_grid_sx, fy = ( pt.y - m_grid_t ) * m_grid_sy;
+		const unsigned int x = fx > 0.0 ? std::min<double>( fx, m_columns - 1 ) : 0;
+		const unsigned int y = fy > 0.0 ? std::min<double>( fy, m_rows - 1 ) : 0;
+		return y * m_columns + x;
+	}
+
+	unsigned int seed( const point2<T>& pt ) const {
+		return m_grid[grid_cell( pt )];
+	}
+
+	// appends the corners of the cell of site i to 'result'
+	void cell( unsigned int i, const std::vector<double>& centres, std::vector<double>& polygon,
+	           std::vector<double>& clipped, std::vector<unsigned int>& around,
+	           std::vector<unsigned int>& neighbours, std::vector<point2<T>>& result ) const {
+		if( m_inedges[i] == npos ) { return; }
+		const std::vector<unsigned int>& tri = m_delaunay.triangles( );
+		const std::vector<unsigned int>& twin = m_delaunay.halfedges( );
+
+		// triangles and neighbours clockwise around the site
+		around.clear( );
+		neighbours.clear( );
+		bool hull = false;
+		unsigned int e = m_inedges[i];
+		do {
+			around.push_back( e / 3 );
+			neighbours.push_back( tri[e] );
+			const unsigned int f = next( e );
+			e = twin[f];
+			if( e == npos ) {
+				neighbours.push_back( tri[next( f )] );
+				hull = true;
+			}
+		} while( e != npos && e != m_inedges[i] );
+
+		bool inside = !hull;
+		for( unsigned int k = 0; k < around.size( ) && inside; ++k ) {
+			const double x = centres[2 * around[k]], y = centres[2 * around[k] + 1];
+			inside = x >= m_bounds.l && x <= m_bounds.r && y >= m_bounds.t && y <= m_bounds.b;
+		}
+		if( inside ) {
+			const std::size_t first = result.size( );
+			for( unsigned int k = around.size( ); k-- > 0; ) {
+				const point2<T> c( T( centres[2 * around[k]] ), T( centres[2 * around[k] + 1] ) );
+				if( result.size( ) == first || c != result.back( ) ) { result.push_back( c ); }
+			}
+			if( result.size( ) - first > 1 && result.back( ) == result[first] ) { result.pop_back( ); }
+			return;
+		}
+
+		clip_bounds( i, neighbours, polygon, clipped, result );
+	}
+
+	// appends the corners of the bounds cut by the bisector between site i
+	//   and each of 'neighbours'
+	void clip_bounds( unsigned int i, const std::vector<unsigned int>& neighbours,
+	                  std::vector<double>& polygon, std::vector<double>& clipped,
+	                  std::vector<point2<T>>& result ) const {
+		const std::vector<point2<T>>& sites = m_delaunay.points( );
+
+		// the bounds, relative to the site, cut by each bisector
+		const double sx = sites[i].x, sy = sites[i].y;
+		const double l = m_bounds.l - sx, r = m_bounds.r - sx, t = m_bounds.t - sy, b = m_bounds.b - sy;
+		const double box[8] = { l, t, r, t, r, b, l, b };
+		polygon.assign( box, box + 8 );
+		for( unsigned int k = 0; k < neighbours.size( ) && !polygon.empty( ); ++k ) {
+			const double nx = sites[neighbours[k]].x - sx, ny = sites[neighbours[k]].y - sy;
+			const double limit = ( nx * nx + ny * ny ) / 2.0;
+			clipped.clear( );
+			const unsigned int count = polygon.size( ) / 2;
+			for( unsigned int j = 0; j < count; ++j ) {
+				const unsigned int k2 = j + 1 == count ? 0 : j + 1;
+				const double ax = polygon[2 * j], ay = polygon[2 * j + 1];
+				const double bx = polygon[2 * k2], by = polygon[2 * k2 + 1];
+				const double da = nx * ax + ny * ay - limit, db = nx * bx + ny * by - limit;
+				if( da <= 0.0 ) {
+					clipped.push_back( ax );
+					clipped.push_back( ay );
+				}
+				if( ( da < 0.0 && db > 0.0 ) || ( da > 0.0 && db < 0.0 ) ) {
+					const double s = da / ( da - db );
+					clipped.push_back( ax + s * ( bx - ax ) );
+					clipped.push_back( ay + s * ( by - ay ) );
+				}
+			}
+			polygon.swap( clipped );
+		}
+		const std::size_t first = result.size( );
+		for( unsigned int j = 0; j < polygon.size( ) / 2; ++j ) {
+			const point2<T> c( T( sx + polygon[2 * j] ), T( sy + polygon[2 * j + 1] ) );
+			if( result.size( ) == first || c != result.back( ) ) { result.push_back( c ); }
+		}
+		if( result.size( ) - first > 1 && result.back( ) == result[first] ) { result.pop_back( ); }
+		if( result.size( ) - first < 3 ) { result.resize( first ); }
+	}
+}; // End class voronoi
+
+template<typename T>
+const unsigned int voronoi<T>::npos;
+
+}  // End namespace euclib
+
+#endif // EUBLIB_VORONOI_HPP